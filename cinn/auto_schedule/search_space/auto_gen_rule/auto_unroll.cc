@@ -17,6 +17,9 @@
 #include <glog/logging.h>
 
 #include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_printer.h"
@@ -26,7 +29,33 @@
 namespace cinn {
 namespace auto_schedule {
 
-static std::vector<int> auto_unroll_options = {0, 8, 32, 128};
+static std::vector<int> auto_unroll_options  = {0, 8, 32, 128};
+static std::vector<int> unroll_jam_options   = {1, 2, 4};
+static std::vector<int> reduce_split_options = {1, 2, 4};
+
+// sample the unrolling factors and annotate them on the root block
+static void AnnotateUnrollFactors(ir::IRSchedule* ir_schedule, Expr root_block) {
+  std::vector<std::pair<std::string, int>> factors = {
+      {ir::attr::auto_unroll_max_step, auto_unroll_options[std::rand() % auto_unroll_options.size()]},
+      {ir::attr::unroll_jam_factor, unroll_jam_options[std::rand() % unroll_jam_options.size()]},
+      {ir::attr::reduce_split_factor, reduce_split_options[std::rand() % reduce_split_options.size()]}};
+
+  // the root block is replaced by a new one after each annotation,
+  // so it is found again through an inner block which keeps its name
+  auto inner_blocks = ir::CollectIRNodesInOrder(
+      root_block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->body,
+      [](const Expr* x) { return x->As<ir::ScheduleBlockRealize>(); });
+  if (inner_blocks.empty()) {
+    ir_schedule->Annotate(root_block, factors.front().first, factors.front().second);
+    return;
+  }
+  std::string inner_name =
+      inner_blocks.front().As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name;
+  for (auto&& factor : factors) {
+    ir_schedule->Annotate(root_block, factor.first, factor.second);
+    root_block = ir_schedule->GetRootBlock(ir_schedule->GetBlock(inner_name));
+  }
+}
 
 bool AutoUnroll::MeetCondition(const ir::ScheduleBlock* schedule_block) const {
   // whether any block has reduce iter
@@ -90,8 +119,7 @@ RuleApplyType AutoUnroll::Init(ir::IRSchedule* ir_schedule) {
 void AutoUnroll::Apply(int index) {
   CHECK_LT(index, applicable_schedule_blocks_.size()) << "invalid apply index:" << index;
   auto applied_block = applicable_schedule_blocks_.at(index);
-  int max_step       = auto_unroll_options[std::rand() % auto_unroll_options.size()];
-  ir_schedule_->Annotate(applied_block, ir::attr::auto_unroll_max_step, max_step);
+  AnnotateUnrollFactors(ir_schedule_, applied_block);
   return;
 }
 
@@ -110,8 +138,7 @@ std::vector<SearchState> AutoUnroll::ApplyOnBlock(SearchState state, const std::
   SearchState new_state = state.Copy();
   Expr block_expr       = new_state->ir_schedule.GetBlock(block_name);
   Expr applied_block    = new_state->ir_schedule.GetRootBlock(block_expr);
-  int max_step          = auto_unroll_options[std::rand() % auto_unroll_options.size()];
-  new_state->ir_schedule.Annotate(applied_block, ir::attr::auto_unroll_max_step, max_step);
+  AnnotateUnrollFactors(&new_state->ir_schedule, applied_block);
 
   return {new_state};
 }
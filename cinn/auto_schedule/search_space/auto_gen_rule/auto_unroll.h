@@ -26,8 +26,9 @@ namespace auto_schedule {
 
 // This rule can be applied in a ScheduleBlock has reduce axis or has loops with non-serial type.
 // As a result, it will set a attribute with key named ir::attr::auto_unroll_max_step and value
-// indicating max permitted unrolled step in the applied ScheduleBlock. Finally, UnrollLoop pass
-// will do unroll based on actual situation.
+// indicating max permitted unrolled step in the applied ScheduleBlock, together with the factors of
+// ir::attr::unroll_jam_factor and ir::attr::reduce_split_factor to generate register-blocked kernels.
+// Finally, UnrollLoop pass will do unroll based on actual situation.
 class AutoUnroll : public AutoGenRule {
  public:
   AutoUnroll(const common::Target& target) : AutoGenRule(target) {}
@@ -96,6 +96,13 @@ TEST(AutoUnroll, UnrollableApply) {
     const int* max_step    = absl::get_if<int>(&attr_value);
     EXPECT_NE(max_step, nullptr);
     EXPECT_LE(*max_step, 128);
+    for (auto&& factor_attr : {ir::attr::unroll_jam_factor, ir::attr::reduce_split_factor}) {
+      ASSERT_EQ(applied_schedule_block->attrs.count(factor_attr), 1);
+      const int* factor = absl::get_if<int>(&applied_schedule_block->attrs.at(factor_attr));
+      ASSERT_NE(factor, nullptr);
+      EXPECT_GE(*factor, 1);
+      EXPECT_LE(*factor, 4);
+    }
     VLOG(6) << "After auto-unroll:max_step=" << *max_step << ", Ast:\n" << ir_sch->GetModule().GetExprs().front();
   };
 
@@ -23,7 +23,6 @@
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/ir/ir_visitor.h"
-#include "cinn/utils/functional.h"
 #include "cinn/utils/string.h"
 
 namespace cinn {
@@ -63,61 +62,7 @@ bool operator<(const SearchState& left, const SearchState& right) {
   return left->predicted_cost < right->predicted_cost;
 }
 
-// Visit every node by expanding all of their fields in dfs order
-class DfsWithExprsFields : public ir::IRVisitor {
- protected:
-#define __m(t__)                          \
-  void Visit(const ir::t__* x) override { \
-    for (auto* n : x->expr_fields()) {    \
-      if (n->defined()) {                 \
-        Visit(n);                         \
-      }                                   \
-    }                                     \
-  }
-
-  NODETY_FORALL(__m)
-#undef __m
-
-  void Visit(const Expr* expr) override { IRVisitor::Visit(expr); }
-};
-
-// Generate a reduce hash of a AST tree by combining hash of each AST node
-class IrNodesStructuralHash : public DfsWithExprsFields {
- public:
-  IrNodesStructuralHash(size_t init_key) : hash_key_(init_key) {}
-  size_t operator()(const Expr* expr) {
-    Visit(expr);
-    return hash_key_;
-  }
-
-  void Visit(const Expr* expr) override {
-    static decltype(ir::kIrNodeTyReprs) Node2Name = ir::kIrNodeTyReprs;
-    if (!expr->defined()) return;
-    auto type_code = static_cast<IrNodeTyUnderlyingType>(expr->node_type());
-    hash_key_      = utils::HashCombine(hash_key_, type_code);
-    DfsWithExprsFields::Visit(expr);
-  }
-
- private:
-  void Visit(const ir::_Tensor_* x) override {
-    for (auto& e : x->shape) {
-      Visit(&e);
-    }
-    DfsWithExprsFields::Visit(x->buffer.As<ir::_Buffer_>());
-  }
-
-  using IrNodeTyUnderlyingType = std::underlying_type<ir::IrNodeTy>::type;
-  size_t hash_key_;
-};
-
-size_t SearchStateHash::operator()(const SearchState& s) const {
-  size_t hash_key   = 0;
-  const auto& exprs = s->ir_schedule.GetModule().GetExprs();
-  for (auto&& expr : exprs) {
-    hash_key = IrNodesStructuralHash(hash_key)(&expr);
-  }
-  return hash_key;
-}
+size_t SearchStateHash::operator()(const SearchState& s) const { return s->ir_schedule.GetStructuralHash(); }
 
 bool SearchStateEqual::operator()(const SearchState& lhs, const SearchState& rhs) const {
   const auto& lhs_exprs = lhs->ir_schedule.GetModule().GetExprs();
@@ -42,7 +42,7 @@ class SearchState : public common::Shared<_SearchState_> {
   // compare function for two states
   friend bool operator<(const SearchState& left, const SearchState& right);
 
-  // Deep copy a SearchState
+  // Copy a SearchState, the ASTs of the IRSchedule are shared until either copy schedules them
   SearchState Copy() const;
 };
 
@@ -62,7 +62,8 @@ struct _SearchState_ : public common::Object {
   static constexpr char* __type_info__ = "auto_schedule_state";
 };
 
-// SearchStateHash hash functor that visits every AST node and combine their hash of node_type in dfs order
+// SearchStateHash hash functor that combines the hash of node_type of every AST node in dfs order, the hash is cached
+// by the IRSchedule until it is scheduled again
 struct SearchStateHash {
   size_t operator()(const SearchState& s) const;
 };
@@ -126,5 +126,31 @@ TEST(TestSearchState, SearchStateHash_Equal) {
   ASSERT_FALSE(equal_functor(a_plus_const_state1, a_plus_b_state));
 }
 
+TEST(TestSearchState, SearchStateHash_Cached) {
+  Target target = common::DefaultHostTarget();
+
+  ir::Expr M(32);
+  ir::Expr N(32);
+  lang::Placeholder<float> A("A", {M, N});
+  ir::Tensor B = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + ir::Expr(2.f); }, "B");
+  auto funcs = lang::LowerVec("A_plus_const", poly::CreateStages({A, B}), {A, B}, {}, {}, nullptr, target, true);
+  ASSERT_EQ(funcs.size(), 1);
+
+  SearchState state(ir::IRSchedule(ir::ModuleExpr({funcs.front()->body})));
+  SearchState copied = state.Copy();
+  SearchStateHash hash_functor;
+  size_t origin_hash = hash_functor(state);
+  ASSERT_EQ(origin_hash, ir::StructuralHash(funcs.front()->body));
+  ASSERT_EQ(hash_functor(copied), origin_hash);
+
+  // the cached hash is invalidated once the state is scheduled
+  auto loops = copied->ir_schedule.GetLoops("B");
+  copied->ir_schedule.Split(loops.front(), {4, -1});
+  ASSERT_NE(hash_functor(copied), origin_hash);
+  ASSERT_EQ(hash_functor(copied), ir::StructuralHash(copied->ir_schedule.GetModule().GetExprs().front()));
+  ASSERT_EQ(hash_functor(state), origin_hash);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
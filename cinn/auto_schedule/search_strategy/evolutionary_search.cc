@@ -21,6 +21,7 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "cinn/auto_schedule/database/database.h"
@@ -29,13 +30,43 @@
 #include "cinn/auto_schedule/task/task_registry.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/tuning.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/utils/sized_multi_set.h"
 #include "cinn/utils/string.h"
 
+DECLARE_bool(auto_schedule_use_cost_model);
+
 namespace cinn {
 namespace auto_schedule {
 
+namespace {
+
+// Whether a kernel of \p module_expr launches more threads than \p target supports, which happens if the mutated
+// tile sizes enlarge the loops bound to the GPU threads.
+bool ExceedMaxThreads(const ir::ModuleExpr& module_expr, const common::Target& target) {
+  if (target.arch != common::Target::Arch::NVGPU) {
+    return false;
+  }
+  for (auto&& expr : module_expr.GetExprs()) {
+    int extents[3] = {1, 1, 1};
+    ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+      auto* loop = x->As<ir::For>();
+      if (loop && loop->is_gpu_thread_binded() && loop->extent.is_constant()) {
+        int& extent = extents[loop->bind_info().offset];
+        extent      = std::max(extent, loop->extent.as_int32());
+      }
+      return false;
+    });
+    if (extents[0] * extents[1] * extents[2] > target.max_num_threads()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 EvolutionarySearch::EvolutionarySearch(const TuneTask& tune_task, const ExprCostModel& cost_model, Database* database)
     : tune_task_(tune_task), cost_model_(cost_model), database_(database) {
   search_space_ = std::make_unique<SearchSpace>(tune_task);
@@ -63,7 +94,10 @@ std::vector<SearchState> EvolutionarySearch::SearchModuleExprBests(const TuningO
   init_population.insert(init_population.end(), init_sketch.begin(), init_sketch.end());
 
   std::vector<SearchState> picked_bests =
-      Evolve(init_population, options.evolution_cross_over_num, options.num_samples_per_iteration);
+      Evolve(init_population,
+             options.evolution_cross_over_num,
+             options.num_samples_per_iteration,
+             options.evolution_trace_mutate_prob);
   VLOG(4) << JoinStatesDebugString("EvolutionarySearch::Evolve", picked_bests, /*verbose=*/VLOG_IS_ON(5));
   return picked_bests;
 }
@@ -100,28 +134,60 @@ std::vector<SearchState> EvolutionarySearch::InitSketch(int num, const std::stri
 
 SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const SearchState& state2) {
   // TODO(CtfGo): tracing CrossOver with IRSchedule
-  std::vector<ir::Expr> cross_over_exprs;
-  std::vector<ir::Expr> father_exprs = state1->ir_schedule.GetModule().GetExprs();
-  std::vector<ir::Expr> mother_exprs = state2->ir_schedule.GetModule().GetExprs();
+  std::vector<const ir::IRSchedule*> cross_over_sources;
+  size_t father_expr_num = state1->ir_schedule.GetModule().GetExprs().size();
+  size_t mother_expr_num = state2->ir_schedule.GetModule().GetExprs().size();
 
-  CHECK_EQ(father_exprs.size(), mother_exprs.size())
+  CHECK_EQ(father_expr_num, mother_expr_num)
       << "CrossOver ModuleExpr in EvolutionarySearch must have same number of AST";
 
-  for (size_t i = 0; i < father_exprs.size(); ++i) {
+  for (size_t i = 0; i < father_expr_num; ++i) {
     if (rand() % 2 == 0) {
-      cross_over_exprs.push_back(optim::IRCopy(father_exprs[i]));
+      cross_over_sources.push_back(&state1->ir_schedule);
     } else {
-      cross_over_exprs.push_back(optim::IRCopy(mother_exprs[i]));
+      cross_over_sources.push_back(&state2->ir_schedule);
     }
   }
-  auto res = SearchState(ir::IRSchedule(ir::ModuleExpr(cross_over_exprs)));
+  // the ASTs are shared with the parents until either side schedules them
+  auto res = SearchState(ir::IRSchedule::Combine(cross_over_sources));
   VLOG(4) << JoinStatesDebugString("EvolutionarySearch::CrossOver", {state1, state2, res}, /*verbose=*/VLOG_IS_ON(5));
   return res;
 }
 
+SearchState EvolutionarySearch::MutateTrace(const SearchState& state) {
+  const auto& task_key = tune_task_.serialized_key;
+  if (!InitialTaskRegistry::Global()->Has(task_key)) {
+    return SearchState();
+  }
+  ir::proto::ScheduleDesc trace = state->ir_schedule.GetTraceDesc().ToProto();
+  if (trace.steps_size() == 0 || !mutate_tile_size_.Apply(&trace)) {
+    return SearchState();
+  }
+  // the IR is only re-materialized for the traces never generated before
+  size_t trace_hash = std::hash<std::string>()(trace.SerializeAsString());
+  if (!visited_traces_.insert(trace_hash).second) {
+    VLOG(6) << "Skip the visited trace:\n" << trace.DebugString();
+    return SearchState();
+  }
+
+  ir::IRSchedule ir_sch(optim::IRCopy(InitialTaskRegistry::Global()->Get(task_key)->module_expr));
+  ir::ScheduleDesc::ReplayWithProto(trace, &ir_sch);
+  if (ExceedMaxThreads(ir_sch.GetModule(), tune_task_.target)) {
+    VLOG(6) << "Skip the trace exceeding the max number of threads:\n" << trace.DebugString();
+    return SearchState();
+  }
+  SearchState ret(std::move(ir_sch), SearchState::NOT_INIT_COST, state->applicable_rules);
+  if (FLAGS_auto_schedule_use_cost_model) {
+    ret->predicted_cost = cost_model_.Predict(ret->ir_schedule.GetModule(), tune_task_.target);
+  }
+  VLOG(4) << JoinStatesDebugString("EvolutionarySearch::MutateTrace", {state, ret}, /*verbose=*/VLOG_IS_ON(5));
+  return ret;
+}
+
 std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchState>& population,
                                                     int cross_over_num,
-                                                    int ret_num) {
+                                                    int ret_num,
+                                                    float trace_mutate_prob) {
   VLOG(4) << utils::StringFormat(
       "Evolve with population size=%lu,cross_over_num:%lu,ret_num:%lu", population.size(), cross_over_num, ret_num);
   int generation_num = population.size();
@@ -141,7 +207,14 @@ std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchStat
 
   utils::SizedMultiSet<SearchState> evolution_with_cost(ret_num);
   for (size_t i = 0; i < evolution.size(); ++i) {
-    evolution_with_cost.Push(search_space_->GetScheduleMutate(evolution[i], cost_model_));
+    SearchState mutated;
+    if (static_cast<float>(rand()) / RAND_MAX < trace_mutate_prob) {
+      mutated = MutateTrace(evolution[i]);
+    }
+    if (!mutated.defined()) {
+      mutated = search_space_->GetScheduleMutate(evolution[i], cost_model_);
+    }
+    evolution_with_cost.Push(mutated);
   }
 
   return evolution_with_cost.ReturnAsContainer<std::vector<SearchState>>();
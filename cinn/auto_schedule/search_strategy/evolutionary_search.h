@@ -15,12 +15,14 @@
 #pragma once
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/database/database.h"
 #include "cinn/auto_schedule/search_space/search_space.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_tile_size.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/tuning.h"
 #include "cinn/ir/ir_schedule.h"
@@ -103,7 +105,17 @@ class EvolutionarySearch {
 
   SearchState CrossOver(const SearchState& state1, const SearchState& state2);
 
-  std::vector<SearchState> Evolve(const std::vector<SearchState>& population, int cross_over_num, int ret_num);
+  /**
+   * \brief Mutate a decision recorded in the trace of the state and replay the mutated trace on the initial ModuleExpr.
+   * @param state The state to mutate.
+   * @return The new state, or an undefined state if the trace can't be mutated or the mutated trace has been visited.
+   */
+  SearchState MutateTrace(const SearchState& state);
+
+  std::vector<SearchState> Evolve(const std::vector<SearchState>& population,
+                                  int cross_over_num,
+                                  int ret_num,
+                                  float trace_mutate_prob);
 
   std::vector<SearchState> PickNextGenerationEpsGreedy(const std::vector<SearchState>& population,
                                                        const std::vector<SearchState>& random_init,
@@ -117,6 +129,9 @@ class EvolutionarySearch {
   Database* database_;               // not owned
   // used to depuplicate states with the same structural IR
   std::unordered_set<SearchState, SearchStateHash, SearchStateEqual> visited_candidates_;
+  // hashes of the mutated traces, a trace is only replayed to IR the first time it is generated
+  std::unordered_set<size_t> visited_traces_;
+  MutateTileSize mutate_tile_size_;
 };
 
 }  // namespace auto_schedule
@@ -0,0 +1,44 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+
+#include "cinn/ir/schedule_desc.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * Base class for rules of mutating a schedule trace. A rule changes one decision recorded in the trace, such as the
+ * factors of a Split, and the mutated trace is replayed on the initial ModuleExpr of the task to get the new schedule,
+ * so the mutation keeps all the other scheduling steps of the trace unchanged.
+ */
+class MutateRule {
+ public:
+  MutateRule()          = default;
+  virtual ~MutateRule() = default;
+
+  // Mutate one decision of the trace in place.
+  // Returns false if the trace has no decision this rule can mutate, the trace is unchanged in that case.
+  virtual bool Apply(ir::proto::ScheduleDesc* trace) = 0;
+
+  // Returns the name of the rule, used for debug.
+  virtual std::string GetRuleName() const = 0;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,134 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_tile_size.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+// Returns the index of the "factors" attribute if the tile sizes of the Split step can be mutated, otherwise -1.
+int MutableFactorsIndex(const ir::proto::ScheduleDesc_Step& step, const std::unordered_set<std::string>& fixed_loops) {
+  if (step.type() != "Split" && step.type() != "SplitWithName") {
+    return -1;
+  }
+  for (const auto& output : step.outputs()) {
+    if (fixed_loops.count(output)) {
+      return -1;
+    }
+  }
+  for (int i = 0; i < step.attrs_size(); ++i) {
+    const auto& attr = step.attrs(i);
+    if (attr.name() != "factors" || attr.dtype() != ir::proto::ScheduleDesc_Attr_DataType_INTS ||
+        attr.ints_size() < 2) {
+      continue;
+    }
+    bool has_non_trivial = false;
+    for (int factor : attr.ints()) {
+      if (factor <= 0) {
+        return -1;
+      }
+      has_non_trivial = has_non_trivial || factor > 1;
+    }
+    return has_non_trivial ? i : -1;
+  }
+  return -1;
+}
+
+std::vector<int> PrimeFactors(int n) {
+  std::vector<int> res;
+  for (int p = 2; p * p <= n; ++p) {
+    if (n % p == 0) {
+      res.push_back(p);
+      while (n % p == 0) {
+        n /= p;
+      }
+    }
+  }
+  if (n > 1) {
+    res.push_back(n);
+  }
+  return res;
+}
+
+}  // namespace
+
+bool MutateTileSize::Apply(ir::proto::ScheduleDesc* trace) {
+  // the vectorize factor is recorded as an attribute of the Vectorize step, and the loops bound to the GPU blocks or
+  // threads are fused only if the product of their extents doesn't exceed the max number of threads, so these loops,
+  // directly or through a Fuse step, must keep their extents
+  std::unordered_set<std::string> fixed_loops;
+  for (int i = trace->steps_size() - 1; i >= 0; --i) {
+    const auto& step = trace->steps(i);
+    bool fixed       = step.type() == "Vectorize" || step.type() == "Bind";
+    if (step.type() == "Fuse") {
+      fixed = std::any_of(
+          step.outputs().begin(), step.outputs().end(), [&](const std::string& x) { return fixed_loops.count(x); });
+    }
+    if (fixed) {
+      for (const auto& input : step.inputs()) {
+        fixed_loops.insert(input.arguments().begin(), input.arguments().end());
+      }
+    }
+  }
+
+  // pairs of (step index, attribute index) of the mutable factors
+  std::vector<std::pair<int, int>> candidates;
+  for (int i = 0; i < trace->steps_size(); ++i) {
+    int attr_idx = MutableFactorsIndex(trace->steps(i), fixed_loops);
+    if (attr_idx >= 0) {
+      candidates.emplace_back(i, attr_idx);
+    }
+  }
+  if (candidates.empty()) {
+    VLOG(6) << "No tile size can be mutated";
+    return false;
+  }
+
+  const auto& picked = candidates.at(rand() % candidates.size());
+  auto* factors      = trace->mutable_steps(picked.first)->mutable_attrs(picked.second)->mutable_ints();
+
+  std::vector<int> sources;
+  for (int i = 0; i < factors->size(); ++i) {
+    if (factors->Get(i) > 1) {
+      sources.push_back(i);
+    }
+  }
+  int src = sources.at(rand() % sources.size());
+  int dst = rand() % (factors->size() - 1);
+  if (dst >= src) {
+    ++dst;
+  }
+  std::vector<int> primes = PrimeFactors(factors->Get(src));
+  int moved               = primes.at(rand() % primes.size());
+
+  VLOG(6) << "Move factor " << moved << " of step " << picked.first << " from tile " << src << " to tile " << dst;
+  factors->Set(src, factors->Get(src) / moved);
+  factors->Set(dst, factors->Get(dst) * moved);
+  return true;
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,45 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_rule.h"
+#include "cinn/ir/schedule_desc.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * Mutate the tile sizes chosen by a Split step of the trace. A prime factor of one tile is moved to another tile of the
+ * same loop, so the product of the factors stays equal to the loop extent and the replay is always valid.
+ *
+ * Splits with an inferred factor (-1) and splits whose loops are vectorized or bound to the GPU blocks or threads
+ * afterward, directly or through a Fuse step, are kept unchanged. The loops are tracked by their names in the trace,
+ * which change when the loops are rebuilt, e.g. by Reorder, so the replayed IR should still be checked against the
+ * thread limit of the target.
+ */
+class MutateTileSize : public MutateRule {
+ public:
+  MutateTileSize() = default;
+
+  bool Apply(ir::proto::ScheduleDesc* trace) override;
+
+  std::string GetRuleName() const override { return "MutateTileSize"; }
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
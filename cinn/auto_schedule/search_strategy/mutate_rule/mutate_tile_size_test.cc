@@ -0,0 +1,141 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_tile_size.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_desc.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+ir::ModuleExpr CreateAddModule() {
+  Expr M(32);
+  Expr N(128);
+
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(i, j); }, "C");
+
+  std::vector<ir::LoweredFunc> funcs = lang::LowerVec(
+      "TestMutateTileSize", CreateStages({C}), {A, B, C}, {}, {}, nullptr, common::DefaultHostTarget(), true);
+  return ir::ModuleExpr({funcs[0]->body});
+}
+
+std::vector<int> GetFactors(const ir::proto::ScheduleDesc& trace, int step_idx) {
+  for (const auto& attr : trace.steps(step_idx).attrs()) {
+    if (attr.name() == "factors") {
+      return std::vector<int>(attr.ints().begin(), attr.ints().end());
+    }
+  }
+  return {};
+}
+
+TEST(MutateTileSize, Basic) {
+  srand(0);
+  Context::Global().ResetNameId();
+  ir::ModuleExpr initial_module = CreateAddModule();
+
+  ir::IRSchedule ir_sch(optim::IRCopy(initial_module));
+  auto loops = ir_sch.GetLoops("C");
+  ir_sch.Split(loops[1], {4, 8, 4});
+  ir::proto::ScheduleDesc trace = ir_sch.GetTraceDesc().ToProto();
+  ASSERT_EQ(trace.steps(1).type(), "Split");
+
+  MutateTileSize mutator;
+  for (int i = 0; i < 10; ++i) {
+    ir::proto::ScheduleDesc mutated = trace;
+    ASSERT_TRUE(mutator.Apply(&mutated));
+    std::vector<int> factors = GetFactors(mutated, 1);
+    ASSERT_EQ(factors.size(), 3);
+    EXPECT_NE(factors, GetFactors(trace, 1));
+    EXPECT_EQ(factors[0] * factors[1] * factors[2], 128);
+
+    // the mutated trace is replayed on the initial module and the new loops take the mutated tile sizes
+    ir::IRSchedule replayed(optim::IRCopy(initial_module));
+    ir::ScheduleDesc::ReplayWithProto(mutated, &replayed);
+    auto new_loops = replayed.GetLoops("C");
+    ASSERT_EQ(new_loops.size(), 4);
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_EQ(new_loops[j + 1].As<ir::For>()->extent.as_int32(), factors[j]);
+    }
+  }
+}
+
+TEST(MutateTileSize, SkipFixedSplits) {
+  srand(0);
+  Context::Global().ResetNameId();
+  ir::ModuleExpr initial_module = CreateAddModule();
+  MutateTileSize mutator;
+
+  // the factors can't be mutated if one of them is inferred
+  ir::IRSchedule inferred_sch(optim::IRCopy(initial_module));
+  inferred_sch.Split(inferred_sch.GetLoops("C")[1], {-1, 8});
+  ir::proto::ScheduleDesc inferred_trace = inferred_sch.GetTraceDesc().ToProto();
+  EXPECT_FALSE(mutator.Apply(&inferred_trace));
+
+  // the extent of a vectorized loop is kept
+  ir::IRSchedule vectorized_sch(optim::IRCopy(initial_module));
+  auto splited = vectorized_sch.Split(vectorized_sch.GetLoops("C")[1], {16, 8});
+  vectorized_sch.Vectorize(splited[1], 8);
+  ir::proto::ScheduleDesc vectorized_trace = vectorized_sch.GetTraceDesc().ToProto();
+  EXPECT_FALSE(mutator.Apply(&vectorized_trace));
+}
+
+TEST(MutateTileSize, SkipBoundSplits) {
+  srand(0);
+  Context::Global().ResetNameId();
+  ir::ModuleExpr initial_module = CreateAddModule();
+  MutateTileSize mutator;
+
+  // a GPU style schedule: the inner tile of j is bound to the threads directly, and the tiles of i are fused and
+  // bound to the blocks, so none of their extents can be changed without checking the thread limit
+  ir::IRSchedule gpu_sch(optim::IRCopy(initial_module));
+  auto j_tiles = gpu_sch.Split(gpu_sch.GetLoops("C")[1], {4, 32});
+  gpu_sch.Bind(j_tiles[1], "threadIdx.x");
+  auto i_tiles = gpu_sch.Split(gpu_sch.GetLoops("C")[0], {2, 16});
+  auto fused   = gpu_sch.Fuse({i_tiles[0], i_tiles[1]});
+  gpu_sch.Bind(fused, "blockIdx.x");
+  ir::proto::ScheduleDesc bound_trace = gpu_sch.GetTraceDesc().ToProto();
+  EXPECT_FALSE(mutator.Apply(&bound_trace));
+
+  // only the split of the loop not bound is mutated
+  gpu_sch.Split(gpu_sch.GetLoops("C")[1], {2, 2});
+  ir::proto::ScheduleDesc trace = gpu_sch.GetTraceDesc().ToProto();
+  ASSERT_EQ(trace.steps(trace.steps_size() - 1).type(), "Split");
+  for (int i = 0; i < 10; ++i) {
+    ir::proto::ScheduleDesc mutated = trace;
+    ASSERT_TRUE(mutator.Apply(&mutated));
+    for (int step_idx = 0; step_idx + 1 < trace.steps_size(); ++step_idx) {
+      EXPECT_EQ(GetFactors(mutated, step_idx), GetFactors(trace, step_idx));
+    }
+    EXPECT_NE(GetFactors(mutated, trace.steps_size() - 1), GetFactors(trace, trace.steps_size() - 1));
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -180,7 +180,8 @@ std::vector<SearchState> TaskOptimizer::SearchOneRound(const TuningOptions& opti
 }
 
 ir::LoweredFunc TaskOptimizer::FuncWithUpdatedBody(const ir::LoweredFunc& old_func, ir::Expr& body) {
-  ir::ModuleExpr mod_expr(std::vector<ir::Expr>({body}));
+  // the body may be shared by other SearchStates, so schedule and optimize a copy of it
+  ir::ModuleExpr mod_expr(std::vector<ir::Expr>({optim::IRCopy(body)}));
   ir::IRSchedule ir_sch(mod_expr);
 
   // temp_bufs may be deleted during auto tuning (such as auto inline),
@@ -66,6 +66,14 @@ struct TuningOptions {
   // The number of samples generated by cross over
   int evolution_cross_over_num = 10;
 
+  // The probability to mutate a sample by changing one decision recorded in
+  // its schedule trace, such as a tile size, and replaying the trace on the
+  // initial ModuleExpr. Otherwise, or if the trace has no such decision, the
+  // sample is mutated by applying a random AutoGenRule. It is disabled by
+  // default since each mutation copies the initial ModuleExpr and replays the
+  // whole trace, which costs more than applying a rule on the sample.
+  float evolution_trace_mutate_prob = 0.0f;
+
   // The fraction of random samples in num_samples_per_iteration.
   // So the num_samples_per_iteration would have (1 - eps_greedy) best
   // samples from evolutionary search and eps_greedy random samples.
@@ -328,6 +328,8 @@ void CodeGenC::Visit(const ir::Call *op) {
     PrintCall_buffer_malloc(op);
   } else if (op->name == runtime::intrinsic::pod_values_to_array_repr) {
     PrintCall_pod_values_to_array(op);
+  } else if (op->name == runtime::intrinsic::prefetch_repr) {
+    PrintCall_prefetch(op);
   } else if (op->is_intrinsic_call()) {
     os() << op->name << "(";
     PrintCallArgs(op);
@@ -407,6 +409,18 @@ void CodeGenC::PrintCall_get_address(const ir::Call *op) {
   }
 }
 
+void CodeGenC::PrintCall_prefetch(const ir::Call *op) {
+  CHECK_EQ(op->read_args.size(), 3UL);
+  CHECK(op->read_args[0].As<ir::Load>()) << "The address to prefetch should be given by a Load";
+  os() << "__builtin_prefetch(&";
+  Print(op->read_args[0]);
+  os() << ", ";
+  Print(op->read_args[1]);
+  os() << ", ";
+  Print(op->read_args[2]);
+  os() << ")";
+}
+
 void CodeGenC::PrintCall_pod_values_to_array(const ir::Call *op) {
   CHECK(!op->read_args.empty());
   CHECK_EQ(op->write_args.size(), 1UL);
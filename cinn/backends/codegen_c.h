@@ -95,6 +95,7 @@ class CodeGenC : public ir::IrPrinter {
   void PrintCall_cinn_pod_value_to_(const ir::Call* op);
   void PrintCall_get_address(const ir::Call* op);
   void PrintCall_pod_values_to_array(const ir::Call* op);
+  void PrintCall_prefetch(const ir::Call* op);
   // @}
 
 #define __DEFINE_VISIT(op__) void Visit(const ir::op__* op) override;
@@ -18,6 +18,8 @@
 
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/common/context.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/profiler.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/codegen_cuda_host.h"
@@ -28,6 +30,7 @@
 #endif
 
 DECLARE_string(cinn_source_code_save_path);
+DECLARE_bool(cinn_tiered_jit);
 
 namespace cinn {
 namespace backends {
@@ -35,6 +38,17 @@ using ir::Module;
 
 static constexpr int DebugLogMaxLen = 30000;
 
+namespace {
+// The functions of a module are compiled by multiple threads if FLAGS_cinn_compile_num_threads is set.
+ExecutionOptions GetExecutionOptions() {
+  ExecutionOptions options;
+  options.num_compile_threads = utils::GetCompileThreadNum();
+  return options;
+}
+}  // namespace
+
+Compiler::Compiler(const Target& target) : target_(target), engine_(ExecutionEngine::Create(GetExecutionOptions())) {}
+
 void Compiler::Build(const Module& module, const std::string& code) {
   if (target_.arch == Target::Arch::NVGPU) {
     CompileCudaModule(module, code);
@@ -80,8 +94,12 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
   VLOG(3) << "[CUDA] host module:\n" << host_module;
 
   VLOG(3) << "[CUDA] device module:\n" << device_module;
-  CodeGenCUDA_Dev codegen(target_);
-  auto source_code = codegen.Compile(device_module);
+  std::string source_code;
+  {
+    utils::RecordEvent record_codegen("CodeGenCUDA_Dev", utils::EventType::kCodeGen);
+    CodeGenCUDA_Dev codegen(target_);
+    source_code = codegen.Compile(device_module);
+  }
   if (!code.empty()) source_code = code;
   if (FLAGS_cinn_source_code_save_path.empty()) {
     if (source_code.size() > DebugLogMaxLen) {
@@ -103,7 +121,11 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
 
   backends::nvrtc::Compiler compiler;
 
-  auto ptx = compiler(source_code);
+  std::string ptx;
+  {
+    utils::RecordEvent record_nvrtc("nvrtc::Compiler", utils::EventType::kCompile);
+    ptx = compiler(source_code);
+  }
   CHECK(!ptx.empty());
 
   // TODO(Superjomn) Whether to support multiple CUDA modules?
@@ -119,7 +141,7 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
     symbols.RegisterVar(kernel_fn_name + "_ptr_", reinterpret_cast<void*>(fn_kernel));
   }
 
-  engine_ = ExecutionEngine::Create(ExecutionOptions(), std::move(symbols));
+  engine_ = ExecutionEngine::Create(GetExecutionOptions(), std::move(symbols));
   engine_->Link<CodeGenCUDA_Host>(host_module);
 
 #else
@@ -127,11 +149,21 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
 #endif
 }
 
-void Compiler::CompileX86Module(const Module& module) { engine_->Link<CodeGenX86>(module); }
+void Compiler::CompileX86Module(const Module& module) {
+  if (FLAGS_cinn_tiered_jit && module.buffers().empty() && module.submodules().empty()) {
+    tiered_jit_ = std::make_unique<TieredJIT>(module);
+    return;
+  }
+  engine_->Link<CodeGenX86>(module);
+}
 
 void Compiler::ExportObject(const std::string& path) { engine_->ExportObject(path); }
 
 void* Compiler::Lookup(absl::string_view fn_name) {
+  if (tiered_jit_) {
+    auto* function = tiered_jit_->Lookup(fn_name);
+    return function ? function->address() : nullptr;
+  }
   CHECK(engine_);
   if (engine_->Lookup(fn_name) != nullptr) {
     return engine_->Lookup(fn_name);
@@ -139,5 +171,9 @@ void* Compiler::Lookup(absl::string_view fn_name) {
   return nullptr;
 }
 
+TieredFunction* Compiler::LookupTiered(absl::string_view fn_name) {
+  return tiered_jit_ ? tiered_jit_->Lookup(fn_name) : nullptr;
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -22,6 +22,7 @@
 #include "cinn/backends/llvm/codegen_llvm.h"
 #include "cinn/backends/llvm/execution_engine.h"
 #include "cinn/backends/llvm/simple_jit.h"
+#include "cinn/backends/llvm/tiered_jit.h"
 #include "cinn/lang/packed_func.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/runtime/cuda/cuda_module.h"
@@ -53,18 +54,26 @@ class Compiler final {
    */
   void* Lookup(absl::string_view fn_name);
 
+  /**
+   * Retrieve a function compiled by the tiered JIT by \p fn_name, whose address is switched to the optimized version
+   * once it is ready.
+   * @return the function or null if the tiered JIT is not used or it does not exist.
+   */
+  TieredFunction* LookupTiered(absl::string_view fn_name);
+
  private:
   void CompileCudaModule(const ir::Module& module, const std::string& code = "");
 
   void CompileX86Module(const ir::Module& module);
 
-  explicit Compiler(const Target& target) : target_(target), engine_(ExecutionEngine::Create(ExecutionOptions())) {}
+  explicit Compiler(const Target& target);
 
   CINN_DISALLOW_COPY_AND_ASSIGN(Compiler);
 
  private:
   Target target_;
   std::unique_ptr<ExecutionEngine> engine_;
+  std::unique_ptr<TieredJIT> tiered_jit_;
 
 #ifdef CINN_WITH_CUDA
   std::unique_ptr<runtime::cuda::CUDAModule> cuda_module_;
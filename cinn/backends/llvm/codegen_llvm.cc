@@ -654,6 +654,8 @@ llvm::Value *CodeGenLLVM::Visit(const ir::ScheduleBlockRealize *) { CINN_NOT_IMP
 llvm::Value *CodeGenLLVM::Visit(const ir::Call *op) {
   if (op->name == runtime::intrinsic::debug_log_repr) {
     return EmitCall_debug_info(op);
+  } else if (op->name == runtime::intrinsic::prefetch_repr) {
+    return EmitCall_prefetch(op);
   } else if (op->is_extern_call()) {
     auto emitter_id     = ExternFuncID{backend_llvm_host, op->name.c_str()};
     const auto &fn_name = ExternFunctionEmitterRegistry::Global().Lookup(emitter_id);
@@ -1091,6 +1093,25 @@ llvm::Value *CodeGenLLVM::EmitCall_debug_info(const ir::Call *op) {
   return Call(callee, args, "call debug_info");
 }
 
+llvm::Value *CodeGenLLVM::EmitCall_prefetch(const ir::Call *op) {
+  CHECK_EQ(op->read_args.size(), 3UL);
+  auto *load = op->read_args[0].As<ir::Load>();
+  CHECK(load) << "The address to prefetch should be given by a Load, but got " << op->read_args[0];
+  llvm::Value *array = GetVar(load->name());
+  Expr index         = load->index();
+  // the address may be out of the buffer, which is allowed by prefetch, so GEP is not inbounds here
+  llvm::Value *ptr = BitCast(GEP(array, Visit(&index)), ll_void_p_ty(), "prefetch_addr");
+
+  std::vector<llvm::Value *> args{ptr, Visit(&op->read_args[1]), Visit(&op->read_args[2]), ll_const_int32(1)};
+  std::vector<llvm::Type *> arg_types;
+  for (auto *arg : args) {
+    arg_types.push_back(arg->getType());
+  }
+  llvm::Function *fn = GetIntrinsicDecl(llvm::Intrinsic::prefetch, b_->getVoidTy(), arg_types);
+  CHECK(fn) << "Cannot find intrinsic declaration of prefetch";
+  return b_->CreateCall(fn, args);
+}
+
 llvm::Value *CodeGenLLVM::GetVar(const std::string &name, bool lazy) {
   auto symbol = symbol_table_->Lookup(name);
   if (!lazy) {
@@ -48,11 +48,14 @@
 #include <llvm/Transforms/Scalar/Reassociate.h>
 #include <llvm/Transforms/Scalar/SimplifyCFG.h>
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "cinn/backends/codegen_cuda_host.h"
 #include "cinn/backends/llvm/cinn_runtime_llvm_ir.h"
@@ -63,6 +66,8 @@
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/runtime/intrinsic.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/profiler.h"
 
 namespace cinn::backends {
 namespace {
@@ -85,6 +90,61 @@ void InitializeLLVMPasses() {
   // llvm::initializeTarget(registry);
   // llvm::initializeCodeGenPreparePass(registry);
 }
+
+// The levels above 2 keep the default code generation of LLVM, they only differ in the IR optimizations.
+llvm::CodeGenOpt::Level GetCodeGenOptLevel(int opt_level) {
+  if (opt_level <= 0) {
+    return llvm::CodeGenOpt::None;
+  }
+  return opt_level == 1 ? llvm::CodeGenOpt::Less : llvm::CodeGenOpt::Default;
+}
+
+// The code is position independent if \p pic, so that the emitted object can be linked into a shared library.
+std::unique_ptr<llvm::TargetMachine> CreateHostTargetMachine(int opt_level, bool pic = false) {
+  auto machine_builder = llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost());
+  machine_builder.setCodeGenOptLevel(GetCodeGenOptLevel(opt_level));
+  if (pic) {
+    machine_builder.setRelocationModel(llvm::Reloc::PIC_);
+  }
+  return llvm::cantFail(machine_builder.createTargetMachine());
+}
+
+// Generate the LLVM IR of \p module with the runtime IR in \p ctx.
+template <typename CodeGenT>
+std::unique_ptr<llvm::Module> GenerateLLVMModule(const ir::Module &module, llvm::LLVMContext *ctx) {
+  llvm::SMDiagnostic error;
+  auto m          = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, *ctx);
+  auto b          = std::make_unique<llvm::IRBuilder<>>(*ctx);
+  auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
+  VLOG(3) << "ir_emitter->Compile(module) Begin";
+  {
+    utils::RecordEvent record_codegen("CodeGenLLVM", utils::EventType::kCodeGen);
+    ir_emitter->Compile(module);
+  }
+  VLOG(3) << "ir_emitter->Compile(module) Succeed!";
+  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
+  return m;
+}
+
+void OptimizeLLVMModule(llvm::Module *m, llvm::TargetMachine *machine, int opt_level) {
+  {
+    utils::RecordEvent record_optimize("LLVMModuleOptimizer", utils::EventType::kCompile);
+    LLVMModuleOptimizer optimize(machine, opt_level, {}, true);
+    optimize(m);
+  }
+  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
+  for (auto &f : *m) {
+    VLOG(5) << "function: " << DumpToString(f);
+  }
+}
+
+void EmitObjectFile(llvm::Module *m, llvm::TargetMachine *machine, llvm::SmallVectorImpl<char> *buffer) {
+  llvm::raw_svector_ostream rawstream(*buffer);
+  llvm::legacy::PassManager pass_manager;
+  machine->addPassesToEmitFile(pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
+  utils::RecordEvent record_emit("EmitObjectFile", utils::EventType::kCompile);
+  pass_manager.run(*m);
+}
 }  // namespace
 void NaiveObjectCache::notifyObjectCompiled(const llvm::Module *m, llvm::MemoryBufferRef obj_buffer) {
   cached_objects_[m->getModuleIdentifier()] =
@@ -118,8 +178,12 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
 
   auto engine = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true, std::move(module_symbols));
 
+  engine->num_compile_threads_ = std::max(config.num_compile_threads, 1);
+  engine->opt_level_           = config.opt_level;
+
   auto compile_layer_creator = [&engine](llvm::orc::JITTargetMachineBuilder jtmb)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+    jtmb.setCodeGenOptLevel(GetCodeGenOptLevel(engine->opt_level_));
     auto machine = llvm::cantFail(jtmb.createTargetMachine());
     VLOG(1) << "create llvm compile layer";
     VLOG(1) << "Target Name: " << machine->getTarget().getName();
@@ -155,29 +219,18 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
 
 template <typename CodeGenT>
 void ExecutionEngine::Link(const ir::Module &module) {
-  llvm::SMDiagnostic error;
-  auto ctx        = std::make_unique<llvm::LLVMContext>();
-  auto m          = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, *ctx);
-  auto b          = std::make_unique<llvm::IRBuilder<>>(*ctx);
-  auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
-  VLOG(3) << "ir_emitter->Compile(module) Begin";
-  ir_emitter->Compile(module);
-  VLOG(3) << "ir_emitter->Compile(module) Succeed!";
-  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
-
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
-  optimize(m.get());
-  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
-  for (auto &f : *m) {
-    VLOG(5) << "function: " << DumpToString(f);
+  // the globals of the buffers and submodules are shared by the functions, so they are linked as one LLVM module.
+  int num_threads = std::min<int>(num_compile_threads_, module->functions.size());
+  if (num_threads > 1 && module->buffers.empty() && module->submodules.empty()) {
+    LinkAsObjects<CodeGenT>(module, num_threads);
+    return;
   }
 
-  llvm::raw_svector_ostream rawstream(buffer_);
-  llvm::legacy::PassManager pass_manager;
-  machine->addPassesToEmitFile(pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
-  pass_manager.run(*m);
+  auto ctx     = std::make_unique<llvm::LLVMContext>();
+  auto m       = GenerateLLVMModule<CodeGenT>(module, ctx.get());
+  auto machine = CreateHostTargetMachine(opt_level_, /*pic=*/true);
+  OptimizeLLVMModule(m.get(), machine.get(), opt_level_);
+  EmitObjectFile(m.get(), machine.get(), &buffer_);
 
   CHECK(AddModule(std::move(m), std::move(ctx)));
 
@@ -192,6 +245,50 @@ void ExecutionEngine::Link(const ir::Module &module) {
   }
 }
 
+template <typename CodeGenT>
+void ExecutionEngine::LinkAsObjects(const ir::Module &module, int num_objects) {
+  int num_threads = std::max(std::min<int>(num_objects, module->functions.size()), 1);
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> objects(num_threads);
+  auto worker = [&](int idx) {
+    // the functions are dealt round-robin to balance the shards
+    ir::Module shard = ir::_Module_::Make(module->name + "_" + std::to_string(idx), module->target);
+    std::unordered_set<std::string> exported;
+    for (int i = idx; i < module->functions.size(); i += num_threads) {
+      shard->functions.push_back(module->functions[i]);
+      exported.insert(module->functions[i].as_lowered_func()->name);
+    }
+
+    // the LLVMContext and TargetMachine are not thread-safe, each worker owns its own
+    llvm::LLVMContext ctx;
+    auto m       = GenerateLLVMModule<CodeGenT>(shard, &ctx);
+    auto machine = CreateHostTargetMachine(opt_level_);
+    m->setDataLayout(machine->createDataLayout());
+    m->setTargetTriple(machine->getTargetTriple().str());
+    // every shard carries a copy of the runtime IR, which must not clash with the other shards in the JIT.
+    for (auto &f : *m) {
+      if (!f.isDeclaration() && !exported.count(f.getName().str())) {
+        f.setLinkage(llvm::GlobalValue::InternalLinkage);
+      }
+    }
+    for (auto &g : m->globals()) {
+      if (!g.isDeclaration()) {
+        g.setLinkage(llvm::GlobalValue::InternalLinkage);
+      }
+    }
+    OptimizeLLVMModule(m.get(), machine.get(), opt_level_);
+
+    llvm::SmallVector<char, 0> object;
+    EmitObjectFile(m.get(), machine.get(), &object);
+    objects[idx] = std::make_unique<llvm::SmallVectorMemoryBuffer>(std::move(object));
+  };
+  utils::parallel_run(worker, utils::SequenceDispatcher(0, num_threads), num_threads);
+
+  std::lock_guard<std::mutex> lock(mu_);
+  for (auto &object : objects) {
+    llvm::cantFail(jit_->addObjectFile(std::move(object)));
+  }
+}
+
 bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context) {
   module->setDataLayout(jit_->getDataLayout());
   if (false) {
@@ -210,12 +307,15 @@ bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module, std::uniqu
 }
 
 void ExecutionEngine::ExportObject(const std::string &path) {
+  CHECK(!buffer_.empty()) << "No object to export, the modules linked in parallel are not kept as one object";
   FILE *of = fopen(path.c_str(), "w");
   fwrite(buffer_.data(), 1, buffer_.size(), of);
   fclose(of);
 }
 
 void *ExecutionEngine::Lookup(absl::string_view name) {
+  // the module is compiled and linked by the JIT when its first symbol is looked up
+  utils::RecordEvent record_lookup("ExecutionEngine::Lookup", utils::EventType::kCompile);
   std::lock_guard<std::mutex> lock(mu_);
   if (auto symbol = jit_->lookup(AsStringRef(name))) {
     return reinterpret_cast<void *>(symbol->getAddress());
@@ -241,5 +341,8 @@ void ExecutionEngine::RegisterRuntimeSymbols() {
 template void ExecutionEngine::Link<CodeGenLLVM>(const ir::Module &module);
 template void ExecutionEngine::Link<CodeGenX86>(const ir::Module &module);
 template void ExecutionEngine::Link<CodeGenCUDA_Host>(const ir::Module &module);
+template void ExecutionEngine::LinkAsObjects<CodeGenLLVM>(const ir::Module &module, int num_objects);
+template void ExecutionEngine::LinkAsObjects<CodeGenX86>(const ir::Module &module, int num_objects);
+template void ExecutionEngine::LinkAsObjects<CodeGenCUDA_Host>(const ir::Module &module, int num_objects);
 
 }  // namespace cinn::backends
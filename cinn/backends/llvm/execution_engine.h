@@ -62,8 +62,9 @@ class NaiveObjectCache : public llvm::ObjectCache {
 struct ExecutionOptions {
   int opt_level{3};
   bool enable_debug_info{false};
+  // the number of threads generating and optimizing the LLVM IR of the functions of a module in Link
+  int num_compile_threads{1};
   // TODO(fc500110)
-  // int num_compile_threads{1};
   // bool enable_fast_math;
 };
 
@@ -75,9 +76,21 @@ class ExecutionEngine {
 
   void *Lookup(absl::string_view name);
 
+  /**
+   * Compile the functions of \p module and add them to the JIT. If the engine is created with multiple
+   * num_compile_threads, the functions are split into one LLVM module per thread, each is generated, optimized and
+   * emitted as an object in its own LLVMContext concurrently, and the objects are linked by the JIT.
+   */
   template <typename CodeGenT = CodeGenLLVM>
   void Link(const ir::Module &module);
 
+  /**
+   * Compile the functions of \p module into \p num_objects objects concurrently and add them to the JIT. Unlike Link,
+   * the runtime IR is internalized in each object, so it can be called repeatedly on one engine.
+   */
+  template <typename CodeGenT = CodeGenLLVM>
+  void LinkAsObjects(const ir::Module &module, int num_objects);
+
   void ExportObject(const std::string &path);
 
   bool AddModule(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context);
@@ -99,6 +112,8 @@ class ExecutionEngine {
   std::unique_ptr<llvm::orc::LLJIT> jit_;
   std::unique_ptr<NaiveObjectCache> cache_;
   RuntimeSymbols module_symbols_;
+  int num_compile_threads_{1};
+  int opt_level_{3};
 };
 
 }  // namespace cinn::backends
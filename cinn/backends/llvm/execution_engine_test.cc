@@ -29,9 +29,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <iomanip>
 #include <memory>
 #include <random>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -325,5 +327,55 @@ TEST(ExecutionEngine, call_extern) {
   }
 }
 
+TEST(ExecutionEngine, link_in_parallel) {
+  ir::Expr M(kM);
+  ir::Expr N(kN);
+
+  Placeholder<float> x("x", {M, N});
+  Placeholder<float> y("y", {M, N});
+
+  // more functions than threads, so some shards hold several functions
+  std::vector<std::string> names = {"fn_add", "fn_sub", "fn_mul"};
+
+  auto add_out = Compute(
+      {M, N}, [=](Var i, Var j) { return x(i, j) + y(i, j); }, "add_out");
+  auto sub_out = Compute(
+      {M, N}, [=](Var i, Var j) { return x(i, j) - y(i, j); }, "sub_out");
+  auto mul_out = Compute(
+      {M, N}, [=](Var i, Var j) { return x(i, j) * y(i, j); }, "mul_out");
+
+  Module::Builder builder("module0", common::DefaultHostTarget());
+  builder.AddFunction(Lower(names[0], CreateStages({add_out}), {x, y, add_out}));
+  builder.AddFunction(Lower(names[1], CreateStages({sub_out}), {x, y, sub_out}));
+  builder.AddFunction(Lower(names[2], CreateStages({mul_out}), {x, y, mul_out}));
+
+  ExecutionOptions options;
+  options.num_compile_threads = 2;
+  auto engine                 = backends::ExecutionEngine::Create(options);
+  engine->Link(builder.Build());
+
+  auto _ab_bb_cb_ = CreateTestBuffer();  // NOLINT
+  auto &ab        = std::get<0>(_ab_bb_cb_);
+  auto &bb        = std::get<1>(_ab_bb_cb_);
+  auto &cb        = std::get<2>(_ab_bb_cb_);
+  auto *ad        = reinterpret_cast<float *>(ab->memory);
+  auto *bd        = reinterpret_cast<float *>(bb->memory);
+  auto *cd        = reinterpret_cast<float *>(cb->memory);
+
+  std::vector<std::function<float(float, float)>> expects = {
+      std::plus<float>(), std::minus<float>(), std::multiplies<float>()};
+  for (int k = 0; k < names.size(); ++k) {
+    auto fn = reinterpret_cast<void (*)(void *, int32_t)>(engine->Lookup(names[k]));
+    ASSERT_NE(fn, nullptr) << names[k];
+
+    cinn_pod_value_t a_arg(ab), b_arg(bb), c_arg(cb);
+    cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+    fn(args, 3);
+    for (int i = 0; i < kM * kN; i++) {
+      ASSERT_NEAR(cd[i], expects[k](ad[i], bd[i]), 1e-5) << names[k];
+    }
+  }
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -0,0 +1,104 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/backends/llvm/tiered_jit.h"
+
+#include <glog/logging.h>
+
+#include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace backends {
+
+TieredJIT::TieredJIT(const ir::Module& module, int baseline_opt_level)
+    : target_(module.target()), module_name_(module.name()), lowered_funcs_(module.functions()) {
+  CHECK(module.buffers().empty() && module.submodules().empty())
+      << "The tiered JIT only recompiles the functions of a module";
+  {
+    utils::RecordEvent record_baseline("TieredJIT::Baseline", utils::EventType::kCompile);
+    ExecutionOptions options;
+    options.opt_level           = baseline_opt_level;
+    options.num_compile_threads = utils::GetCompileThreadNum();
+    baseline_engine_            = ExecutionEngine::Create(options);
+    baseline_engine_->Link<CodeGenX86>(module);
+  }
+
+  for (auto& func : lowered_funcs_) {
+    auto function               = std::make_unique<TieredFunction>();
+    function->name_             = func->name;
+    function->baseline_address_ = baseline_engine_->Lookup(func->name);
+    CHECK(function->baseline_address_) << "Can't find the function " << func->name << " in the baseline JIT";
+    function->address_.store(function->baseline_address_);
+    functions_.emplace_back(std::move(function));
+  }
+
+  optimized_engine_ = ExecutionEngine::Create(ExecutionOptions());
+  thread_           = std::thread(&TieredJIT::OptimizeInBackground, this);
+}
+
+TieredJIT::~TieredJIT() {
+  stopped_ = true;
+  Wait();
+}
+
+TieredFunction* TieredJIT::Lookup(absl::string_view name) {
+  for (auto& function : functions_) {
+    if (function->name() == name) {
+      return function.get();
+    }
+  }
+  return nullptr;
+}
+
+void TieredJIT::Wait() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void TieredJIT::OptimizeInBackground() {
+  while (!stopped_) {
+    // the hotness keeps changing while the functions run, so the next function is picked after each recompilation.
+    int next = -1;
+    for (int i = 0; i < functions_.size(); ++i) {
+      if (!functions_[i]->optimized_ && (next < 0 || functions_[i]->hotness() > functions_[next]->hotness())) {
+        next = i;
+      }
+    }
+    if (next < 0) {
+      break;
+    }
+
+    auto* function           = functions_[next].get();
+    ir::Module single_module = ir::_Module_::Make(module_name_ + "_" + function->name(), target_);
+    single_module->functions.push_back(lowered_funcs_[next]);
+    {
+      utils::RecordEvent record_optimize("TieredJIT::Optimize", utils::EventType::kCompile);
+      optimized_engine_->LinkAsObjects<CodeGenX86>(single_module, 1);
+    }
+    void* address = optimized_engine_->Lookup(function->name());
+    CHECK(address) << "Can't find the function " << function->name() << " in the optimized JIT";
+    function->address_.store(address, std::memory_order_release);
+    function->optimized_ = true;
+    ++num_optimized_;
+    VLOG(3) << "The function " << function->name() << " is switched to O3 after " << function->hotness() << " calls";
+  }
+}
+
+}  // namespace backends
+}  // namespace cinn
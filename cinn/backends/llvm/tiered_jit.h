@@ -0,0 +1,96 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <absl/strings/string_view.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "cinn/ir/lowered_func.h"
+#include "cinn/ir/module.h"
+
+namespace cinn {
+namespace backends {
+
+class ExecutionEngine;
+
+//! A function compiled by the TieredJIT, its address is switched to the optimized version once that is ready.
+class TieredFunction {
+ public:
+  //! Count one call of the function and get its current address.
+  void* Call() {
+    hotness_.fetch_add(1, std::memory_order_relaxed);
+    return address_.load(std::memory_order_acquire);
+  }
+
+  void* address() const { return address_.load(std::memory_order_acquire); }
+  //! The address of the baseline version, which is fixed before the recompilation starts.
+  void* baseline_address() const { return baseline_address_; }
+  int64_t hotness() const { return hotness_.load(std::memory_order_relaxed); }
+  const std::string& name() const { return name_; }
+
+ private:
+  friend class TieredJIT;
+
+  std::string name_;
+  void* baseline_address_{nullptr};
+  std::atomic<void*> address_{nullptr};
+  std::atomic<int64_t> hotness_{0};
+  bool optimized_{false};
+};
+
+/**
+ * TieredJIT cuts the time to the first run of a module on X86. The module is compiled at a low optimization level at
+ * first, so its functions are ready soon. Then a background thread recompiles the functions at O3 one at a time,
+ * always picking the hottest function that is not optimized yet, and publishes each new address atomically.
+ */
+class TieredJIT {
+ public:
+  /**
+   * Link \p module at \p baseline_opt_level and start recompiling its functions at O3 in the background.
+   */
+  explicit TieredJIT(const ir::Module& module, int baseline_opt_level = 0);
+  ~TieredJIT();
+
+  //! Get the function \p name, nullptr if it is not in the module.
+  TieredFunction* Lookup(absl::string_view name);
+
+  //! Wait until all the functions are recompiled at O3.
+  void Wait();
+
+  //! The number of the functions whose O3 versions are ready.
+  int num_optimized() const { return num_optimized_.load(); }
+
+ private:
+  void OptimizeInBackground();
+
+  Target target_;
+  std::string module_name_;
+  std::vector<ir::LoweredFunc> lowered_funcs_;
+  std::vector<std::unique_ptr<TieredFunction>> functions_;
+  std::unique_ptr<ExecutionEngine> baseline_engine_;
+  std::unique_ptr<ExecutionEngine> optimized_engine_;
+  std::atomic<bool> stopped_{false};
+  std::atomic<int> num_optimized_{0};
+  std::thread thread_;
+};
+
+}  // namespace backends
+}  // namespace cinn
@@ -0,0 +1,87 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/backends/llvm/tiered_jit.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/ir/module.h"
+
+namespace cinn {
+namespace backends {
+
+TEST(TieredJIT, SwitchToOptimized) {
+  Expr M(64);
+  Expr N(32);
+
+  Placeholder<float> x("x", {M, N});
+  Placeholder<float> y("y", {M, N});
+
+  auto add_out = Compute(
+      {M, N}, [=](Var i, Var j) { return x(i, j) + y(i, j); }, "add_out");
+  auto mul_out = Compute(
+      {M, N}, [=](Var i, Var j) { return x(i, j) * y(i, j); }, "mul_out");
+
+  ir::Module::Builder builder("module0", common::DefaultHostTarget());
+  builder.AddFunction(Lower("fn_add", CreateStages({add_out}), {x, y, add_out}));
+  builder.AddFunction(Lower("fn_mul", CreateStages({mul_out}), {x, y, mul_out}));
+
+  auto* x_buf = common::BufferBuilder(Float(32), {64, 32}).set_random().Build();
+  auto* y_buf = common::BufferBuilder(Float(32), {64, 32}).set_random().Build();
+  auto* z_buf = common::BufferBuilder(Float(32), {64, 32}).set_zero().Build();
+  auto args   = common::ArgsBuilder().Add(x_buf).Add(y_buf).Add(z_buf).Build();
+  auto* xd    = reinterpret_cast<float*>(x_buf->memory);
+  auto* yd    = reinterpret_cast<float*>(y_buf->memory);
+  auto* zd    = reinterpret_cast<float*>(z_buf->memory);
+
+  auto check = [&](TieredFunction* function, bool is_add) {
+    auto fn = reinterpret_cast<void (*)(void*, int32_t)>(function->Call());
+    fn(args.data(), args.size());
+    for (int i = 0; i < 64 * 32; ++i) {
+      ASSERT_NEAR(zd[i], is_add ? xd[i] + yd[i] : xd[i] * yd[i], 1e-5);
+    }
+  };
+
+  TieredJIT jit(builder.Build());
+  ASSERT_EQ(jit.Lookup("fn_none"), nullptr);
+  auto* fn_add = jit.Lookup("fn_add");
+  auto* fn_mul = jit.Lookup("fn_mul");
+  ASSERT_NE(fn_add, nullptr);
+  ASSERT_NE(fn_mul, nullptr);
+
+  // the baseline versions can run while the functions are recompiled
+  ASSERT_NE(fn_add->baseline_address(), nullptr);
+  check(fn_add, true);
+  check(fn_mul, false);
+
+  jit.Wait();
+  EXPECT_EQ(jit.num_optimized(), 2);
+  EXPECT_NE(fn_add->address(), fn_add->baseline_address());
+  check(fn_add, true);
+  check(fn_mul, false);
+  EXPECT_EQ(fn_add->hotness(), 2);
+
+  cinn_buffer_free(nullptr, x_buf);
+  cinn_buffer_free(nullptr, y_buf);
+  cinn_buffer_free(nullptr, z_buf);
+}
+
+}  // namespace backends
+}  // namespace cinn
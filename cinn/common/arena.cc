@@ -0,0 +1,126 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/common/arena.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace cinn {
+namespace common {
+
+namespace {
+
+thread_local Arena* current_arena = nullptr;
+
+// The header before each object remembers where its memory comes from, it keeps the object aligned to kAlignment.
+struct alignas(Arena::kAlignment) AllocHeader {
+  Arena* arena;
+};
+
+}  // namespace
+
+Arena* Arena::Current() { return current_arena; }
+
+Arena::Arena(bool single_threaded, size_t block_size) : single_threaded_(single_threaded), block_size_(block_size) {}
+
+Arena::~Arena() {
+  for (char* block : blocks_) {
+    std::free(block);
+  }
+}
+
+void* Arena::Allocate(size_t bytes) {
+  bytes = (bytes + kAlignment - 1) / kAlignment * kAlignment;
+  if (static_cast<size_t>(end_ - cur_) < bytes) {
+    // the allocation larger than a block takes a block of its own.
+    size_t size = std::max(bytes, block_size_);
+    char* block = reinterpret_cast<char*>(std::aligned_alloc(kAlignment, size));
+    CHECK(block) << "Failed to allocate " << size << " bytes for the arena";
+    blocks_.push_back(block);
+    cur_ = block;
+    end_ = block + size;
+  }
+  void* p           = cur_;
+  cur_             += bytes;
+  allocated_bytes_ += bytes;
+  ++num_allocations_;
+  if (single_threaded_) {
+    num_refs_.store(num_refs_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  } else {
+    num_refs_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return p;
+}
+
+void Arena::Release() {
+  int64_t num_refs;
+  if (single_threaded_) {
+    num_refs = num_refs_.load(std::memory_order_relaxed) - 1;
+    num_refs_.store(num_refs, std::memory_order_relaxed);
+  } else {
+    num_refs = num_refs_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+  }
+  if (num_refs == 0) {
+    delete this;
+  }
+}
+
+Object* Arena::GetConstant(uint64_t type_tag, uint64_t value_bits) const {
+  auto it = constants_.find(ConstantKey{type_tag, value_bits});
+  return it == constants_.end() ? nullptr : it->second.get();
+}
+
+void Arena::AddConstant(uint64_t type_tag, uint64_t value_bits, Object* constant) {
+  constants_.emplace(ConstantKey{type_tag, value_bits}, Shared<Object>(constant));
+}
+
+ArenaScope::ArenaScope(bool single_threaded, size_t block_size)
+    : arena_(new Arena(single_threaded, block_size)), prev_(current_arena) {
+  current_arena = arena_;
+}
+
+ArenaScope::~ArenaScope() {
+  CHECK_EQ(current_arena, arena_) << "The ArenaScopes should be destructed in the reverse order of construction";
+  current_arena = prev_;
+  VLOG(4) << "Release the arena of " << arena_->allocated_bytes() << " bytes with " << arena_->constants_.size()
+          << " constants";
+  // the constants hold the references of the objects in the arena.
+  arena_->constants_.clear();
+  arena_->Release();
+}
+
+void* ArenaAllocate(size_t bytes) {
+  Arena* arena = current_arena;
+  void* mem    = arena ? arena->Allocate(sizeof(AllocHeader) + bytes) : std::malloc(sizeof(AllocHeader) + bytes);
+  CHECK(mem) << "Failed to allocate " << bytes << " bytes";
+  auto* header  = reinterpret_cast<AllocHeader*>(mem);
+  header->arena = arena;
+  return header + 1;
+}
+
+void ArenaFree(void* p) {
+  if (!p) return;
+  auto* header = reinterpret_cast<AllocHeader*>(p) - 1;
+  if (header->arena) {
+    header->arena->Release();
+  } else {
+    std::free(header);
+  }
+}
+
+}  // namespace common
+}  // namespace cinn
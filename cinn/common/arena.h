@@ -0,0 +1,126 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/common/object.h"
+#include "cinn/common/shared.h"
+
+namespace cinn {
+namespace common {
+
+/**
+ * Arena is a bump allocator for the objects created during one compilation, e.g. the IR nodes of the lowered
+ * functions, which replaces a malloc and free per object by a pointer bump and a counter decrement.
+ *
+ * The memory of an arena is not reused when one object is freed, all the blocks are freed together once the arena is
+ * released by its ArenaScope and all the objects allocated in it are freed, so the objects can safely outlive the
+ * scope that created them.
+ */
+class Arena {
+ public:
+  static constexpr size_t kAlignment = 16;
+
+  //! Get the arena of the innermost ArenaScope of the current thread, nullptr if there is none.
+  static Arena* Current();
+
+  /**
+   * Allocate \p bytes aligned to kAlignment from the arena, it should only be called by the thread owning the arena.
+   * Each allocation should be given back by Release.
+   */
+  void* Allocate(size_t bytes);
+
+  //! Release one allocation, or the reference of the owning scope, and free the arena once nothing refers to it.
+  void Release();
+
+  //! Whether all the objects allocated in the arena are used only by the thread owning the arena.
+  bool single_threaded() const { return single_threaded_; }
+
+  //! The bytes allocated in the arena, used for profiling.
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+  //! The number of the allocations made in the arena, used for profiling.
+  size_t num_allocations() const { return num_allocations_; }
+
+  //! Hash-consing of the immutable constants created in the arena, keyed by the type tag and the bits of the value.
+  // @{
+  Object* GetConstant(uint64_t type_tag, uint64_t value_bits) const;
+  void AddConstant(uint64_t type_tag, uint64_t value_bits, Object* constant);
+  // @}
+
+ private:
+  friend class ArenaScope;
+
+  Arena(bool single_threaded, size_t block_size);
+  ~Arena();
+
+  struct ConstantKey {
+    uint64_t type_tag;
+    uint64_t value_bits;
+    bool operator==(const ConstantKey& other) const {
+      return type_tag == other.type_tag && value_bits == other.value_bits;
+    }
+  };
+  struct ConstantKeyHash {
+    size_t operator()(const ConstantKey& key) const { return key.type_tag * 31 + key.value_bits; }
+  };
+
+  bool single_threaded_;
+  size_t block_size_;
+  std::vector<char*> blocks_;
+  char* cur_{};
+  char* end_{};
+  size_t allocated_bytes_{};
+  size_t num_allocations_{};
+  //! The number of the live allocations, plus one for the owning scope.
+  std::atomic<int64_t> num_refs_{1};
+  std::unordered_map<ConstantKey, Shared<Object>, ConstantKeyHash> constants_;
+};
+
+/**
+ * ArenaScope makes a new Arena the current arena of the calling thread during its lifetime, the scopes can be nested.
+ *
+ * @param single_threaded Whether the objects created in the scope are never shared with other threads, so that they
+ * can use the non-atomic reference counts.
+ */
+class ArenaScope {
+ public:
+  explicit ArenaScope(bool single_threaded = true, size_t block_size = 64 * 1024);
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+  ~ArenaScope();
+
+  Arena* arena() const { return arena_; }
+
+ private:
+  Arena* arena_;
+  Arena* prev_;
+};
+
+/**
+ * Allocate the memory of an object from the current arena, or from the heap if there is no ArenaScope, the memory
+ * should be freed by ArenaFree.
+ */
+void* ArenaAllocate(size_t bytes);
+
+//! Free the memory allocated by ArenaAllocate.
+void ArenaFree(void* p);
+
+}  // namespace common
+}  // namespace cinn
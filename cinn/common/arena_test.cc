@@ -0,0 +1,87 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/common/arena.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace common {
+
+TEST(Arena, allocate) {
+  ArenaScope scope(/*single_threaded=*/true, /*block_size=*/256);
+  auto* arena = Arena::Current();
+  ASSERT_EQ(arena, scope.arena());
+
+  std::vector<void*> ptrs;
+  for (size_t bytes : {1, 24, 100, 300, 7}) {
+    void* p = ArenaAllocate(bytes);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % Arena::kAlignment, 0);
+    ptrs.push_back(p);
+  }
+  EXPECT_GT(arena->allocated_bytes(), 0);
+  for (void* p : ptrs) {
+    ArenaFree(p);
+  }
+}
+
+TEST(Arena, nested_scope) {
+  ASSERT_EQ(Arena::Current(), nullptr);
+  {
+    ArenaScope outer;
+    {
+      ArenaScope inner(/*single_threaded=*/false);
+      ASSERT_EQ(Arena::Current(), inner.arena());
+      ASSERT_FALSE(Arena::Current()->single_threaded());
+    }
+    ASSERT_EQ(Arena::Current(), outer.arena());
+  }
+  ASSERT_EQ(Arena::Current(), nullptr);
+}
+
+TEST(Arena, node_outlives_scope) {
+  Expr sum;
+  {
+    ArenaScope scope;
+    Var x("x");
+    sum = ir::Add::Make(x, Expr(1.f));
+  }
+  // the arena is freed only after the last node allocated in it.
+  auto* add = sum.As<ir::Add>();
+  ASSERT_TRUE(add);
+  ASSERT_EQ(add->b().as_float(), 1.f);
+}
+
+TEST(Arena, intern_constants) {
+  {
+    ArenaScope scope;
+    ASSERT_TRUE(Expr(1).same_as(Expr(1)));
+    ASSERT_TRUE(Expr(2.5f).same_as(Expr(2.5f)));
+    ASSERT_FALSE(Expr(1).same_as(Expr(1L)));
+    ASSERT_FALSE(Expr(1.f).same_as(Expr(1.0)));
+    ASSERT_FALSE(Expr(1).same_as(Expr(2)));
+
+    // the nodes of a single-threaded arena use the non-atomic reference counts.
+    ASSERT_FALSE(Expr(1).ptr()->__ref_count__.atomic());
+  }
+  ASSERT_FALSE(Expr(1).same_as(Expr(1)));
+  ASSERT_TRUE(Expr(1).ptr()->__ref_count__.atomic());
+}
+
+}  // namespace common
+}  // namespace cinn
@@ -26,6 +26,8 @@ class Shared;
  * Object is the basic element in the CINN, with `Shared` wrapper, the object can be shared accross the system.
  */
 struct Object {
+  virtual ~Object() = default;
+
   //! Get the type representation of this object.
   virtual const char* type_info() const = 0;
 
@@ -25,14 +25,31 @@ class RefCount {
   using value_type = int32_t;
   RefCount()       = default;
 
-  value_type Inc() { return ++count_; }
-  value_type Dec() { return --count_; }
+  value_type Inc() {
+    if (!atomic_) return Store(count_.load(std::memory_order_relaxed) + 1);
+    return count_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+  value_type Dec() {
+    if (!atomic_) return Store(count_.load(std::memory_order_relaxed) - 1);
+    return count_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+  }
   bool is_zero() const { return 0 == count_; }
   std::string to_string() { return std::to_string(count_.load()); }
   int32_t val() const { return count_; }
 
+  //! Use the plain loads and stores instead of the atomic read-modify-writes, only if the owner object is never shared
+  //! across threads.
+  void set_atomic(bool atomic) { atomic_ = atomic; }
+  bool atomic() const { return atomic_; }
+
  private:
+  value_type Store(value_type v) {
+    count_.store(v, std::memory_order_relaxed);
+    return v;
+  }
+
   std::atomic<value_type> count_{0};
+  bool atomic_{true};
 };
 
 class Object;
@@ -63,6 +63,7 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
       hlir::framework::ApplyPass(ctx->graph.get(), "AlterLayout");
     }
 #endif
+    hlir::framework::ApplyPass(ctx->graph.get(), "PrePackWeights");
     hlir::framework::ApplyPass(ctx->graph.get(), "ConstPropagate");
     hlir::framework::ApplyPasses(ctx->graph.get(), DefaultOpFusionPasses());
   }
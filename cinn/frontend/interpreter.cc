@@ -108,7 +108,11 @@ void Interpreter::Impl::Build(const Target& target, const std::string& model_nam
     fetch_var_ids.insert(var_map_.at(name)->id);
   }
 
-  auto graph = Optimize(program_.get(), fetch_var_ids, target);
+  auto optimize_options = DefaultTrainingOptimizeOptions();
+  // the parameters of the loaded model are constant, so pack the weights and evaluate the subgraphs depending on
+  // parameters only once in PreRun.
+  optimize_options.graph_passes.insert(optimize_options.graph_passes.begin(), {"PrePackWeights", "ConstPropagate"});
+  auto graph = Optimize(program_.get(), fetch_var_ids, target, optimize_options);
   // auto graph                 = std::make_shared<hlir::framework::Graph>(*program_, target);
   graph->attrs["model_name"] = std::make_shared<absl::any>(model_name);
   scope_                     = hlir::framework::BuildScope(target, graph, scope_);
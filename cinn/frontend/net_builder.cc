@@ -597,6 +597,10 @@ Variable NetBuilder::Softmax(const Variable& a,
   return CustomInstr("softmax", {a}, {{"axes", axes}, {"mode", mode}, {"data_format", data_format}}).front();
 }
 
+Variable NetBuilder::FlashAttention(const Variable& q, const Variable& k, const Variable& v, float scale) {
+  return CustomInstr("flash_attention", {q, k, v}, {{"scale", scale}}).front();
+}
+
 Variable NetBuilder::DropoutInfer(const Variable& a, float dropout_prob, const std::string& dropout_implementation) {
   return CustomInstr(
              "dropout_infer", {a}, {{"dropout_prob", dropout_prob}, {"dropout_implementation", dropout_implementation}})
@@ -706,6 +706,17 @@ class NetBuilder {
                    const std::string& mode        = "fast",
                    const std::string& data_format = "AnyLayout");
 
+  /**
+   * @brief This operator computes the fused attention `softmax(scale * q * k^T) * v` without materializing the
+   * attention scores, only supported on x86.
+   * @param q The queries of shape [..., seq_q, head_dim].
+   * @param k The keys of shape [..., seq_k, head_dim].
+   * @param v The values of shape [..., seq_k, head_dim_v].
+   * @param scale The scale applied to the scores before the softmax. Default is 1.0f.
+   * @return Output of shape [..., seq_q, head_dim_v].
+   */
+  Variable FlashAttention(const Variable& q, const Variable& k, const Variable& v, float scale = 1.0f);
+
   // *******************************************
   // Type converter Operator
   /**
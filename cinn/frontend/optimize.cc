@@ -28,18 +28,30 @@
 #include "cinn/hlir/pass/use_pass.h"
 
 DECLARE_bool(cinn_use_fill_constant_folding);
+DECLARE_bool(cinn_use_algebraic_simplifier);
+DECLARE_bool(cinn_use_common_subexpression_elimination);
 DECLARE_bool(cinn_use_op_fusion);
+DECLARE_bool(cinn_use_horizontal_fusion);
 DECLARE_bool(cinn_use_cudnn_conv);
 DECLARE_bool(cinn_use_cublas_gemm);
 DECLARE_bool(cinn_check_fusion_accuracy_pass);
+DECLARE_int64(cinn_rematerialization_memory_budget);
 
 namespace cinn {
 namespace frontend {
 
 OptimizeOptions DefaultTrainingOptimizeOptions() {
   OptimizeOptions options;
+  options.program_passes.emplace_back("BatchNormFolding");
+  options.program_passes.emplace_back("FlashAttentionRewriter");
   options.program_passes.emplace_back("Decomposer");
   options.program_passes.emplace_back("RemoveIdentity");
+  if (FLAGS_cinn_use_algebraic_simplifier) {
+    options.program_passes.emplace_back("AlgebraicSimplifier");
+  }
+  if (FLAGS_cinn_use_common_subexpression_elimination) {
+    options.program_passes.emplace_back("CommonSubexpressionElimination");
+  }
 
   options.program_passes.emplace_back("CastCollapsing");
   options.program_passes.emplace_back("TransposeCollapsing");
@@ -49,6 +61,7 @@ OptimizeOptions DefaultTrainingOptimizeOptions() {
   options.program_passes.emplace_back("GemmRewriter");
   options.program_passes.emplace_back("TransposeFoldingOutput");
   options.program_passes.emplace_back("GemmRewriter");
+  options.program_passes.emplace_back("GemmEpilogueFusion");
 
   options.program_passes.emplace_back("FillConstantRewriter");
   if (FLAGS_cinn_use_fill_constant_folding) {
@@ -71,8 +84,15 @@ OptimizeOptions DefaultTrainingOptimizeOptions() {
 #endif
 
   if (FLAGS_cinn_use_op_fusion) {
+    // the recomputed ops only save memory when they are fused into their consumers
+    if (FLAGS_cinn_rematerialization_memory_budget > 0) {
+      options.graph_passes.push_back("Rematerialization");
+    }
     options.graph_passes.push_back("OpFusionPass");
     options.graph_passes.push_back("FusionMergePass");
+    if (FLAGS_cinn_use_horizontal_fusion) {
+      options.graph_passes.push_back("HorizontalFusionPass");
+    }
   } else {
     options.graph_passes.push_back("BuildNonFusedGroupsPass");
   }
@@ -91,6 +111,9 @@ std::vector<std::string> DefaultOpFusionPasses() {
   std::vector<std::string> passes;
   if (FLAGS_cinn_use_op_fusion) {
     passes = {"OpFusionPass", "FusionMergePass"};
+    if (FLAGS_cinn_use_horizontal_fusion) {
+      passes.push_back("HorizontalFusionPass");
+    }
   }
   return passes;
 }
@@ -0,0 +1,321 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+
+DECLARE_bool(cinn_algebraic_simplifier_fast_math);
+
+namespace cinn::frontend::pass {
+
+// Pass `AlgebraicSimplifier` rewrites the instructions of program by algebraic identities:
+//   x * 1, 1 * x, x / 1, x + 0, 0 + x, x - 0 => x
+//   exp(log(x)), log(exp(x))                  => x only if FLAGS_cinn_algebraic_simplifier_fast_math is set
+//   reduce_sum(broadcast_to(x))               => scale(x) if only the broadcasted axes are reduced
+//   reduce_max/min/all/any(broadcast_to(x))   => x if only the broadcasted axes are reduced
+//   reshape(reshape(x))                       => reshape(x)
+//   scale(scale(x))                           => scale(x)
+// The instructions left unused by the rewriting are removed, the useless reshape and scale are removed by
+// `RemoveIdentity`.
+class AlgebraicSimplifierPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+  using OutputToOpMap = std::unordered_map<std::string, Instruction*>;
+
+ protected:
+  void Clear() override {}
+
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) const override {
+    VLOG(3) << "-- Before AlgebraicSimplifierPass:\n" << *program;
+    OutputToOpMap out2instr;
+    // the output of removed instruction to the variable it equals to
+    std::unordered_map<std::string, Variable> replaced_vars;
+    // the instructions whose users may have been redirected by the rewriting
+    std::unordered_set<Instruction*> maybe_unused;
+    std::unordered_set<Instruction*> remove_instrs;
+
+    for (size_t i = 0; i < program->size(); ++i) {
+      auto* instr = &(*program)[i];
+      for (auto& in : (*instr)->inputs) {
+        if (replaced_vars.count(in->id)) {
+          in = replaced_vars.at(in->id);
+        }
+      }
+
+      const Variable* equal_var = nullptr;
+      if (SimplifyToInput(*instr, out2instr, &equal_var, &maybe_unused) ||
+          SimplifyReduceOfBroadcast(instr, out2instr, &equal_var, &maybe_unused)) {
+        // copy the variable, it may refer to the input of `instr` which is replaced below
+        auto var             = *equal_var;
+        const auto output_id = (*instr)->outputs.front()->id;
+        if (fetch_ids.count(output_id)) {
+          VLOG(4) << "The instruction " << *instr << " equals to " << var->id << " but fetched, replace with identity.";
+          ReplaceWithIdentity(instr, var);
+        } else {
+          VLOG(4) << "The instruction " << *instr << " equals to " << var->id << ", remove.";
+          replaced_vars.emplace(output_id, var);
+          remove_instrs.insert(instr);
+          continue;
+        }
+      } else {
+        FoldReshape(instr, out2instr, &maybe_unused);
+        FoldScale(instr, out2instr, &maybe_unused);
+      }
+
+      for (const auto& out : (*instr)->outputs) {
+        out2instr[out->id] = instr;
+      }
+    }
+
+    // remove the instructions whose outputs are not used any more after rewriting
+    std::unordered_set<std::string> used_ids(fetch_ids.begin(), fetch_ids.end());
+    for (int i = program->size() - 1; i >= 0; --i) {
+      auto* instr = &(*program)[i];
+      if (remove_instrs.count(instr)) {
+        continue;
+      }
+      auto is_used = [&](const Variable& var) { return used_ids.count(var->id) > 0; };
+      if (maybe_unused.count(instr) && std::none_of((*instr)->outputs.begin(), (*instr)->outputs.end(), is_used)) {
+        VLOG(4) << "The instruction " << *instr << " is unused after simplifying, remove.";
+        remove_instrs.insert(instr);
+        continue;
+      }
+      for (const auto& in : (*instr)->inputs) {
+        used_ids.insert(in->id);
+      }
+    }
+
+    NetBuilder builder("algebraic_simplifier_builder");
+    for (auto& var : program->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < program->size(); ++i) {
+      if (!remove_instrs.count(&(*program)[i])) {
+        builder.AppendInstruction((*program)[i]);
+      }
+    }
+    *program = builder.Build();
+    VLOG(3) << "-- After AlgebraicSimplifierPass:\n" << *program;
+  }
+
+ private:
+  Instruction* GetProducer(const Variable& var, const OutputToOpMap& out2instr) const {
+    return out2instr.count(var->id) ? out2instr.at(var->id) : nullptr;
+  }
+
+  // whether the variable is filled with `value` by a fill_constant
+  bool IsConstant(const Variable& var, float value, const OutputToOpMap& out2instr) const {
+    auto* producer = GetProducer(var, out2instr);
+    if (!producer || (*producer)->op_type != "fill_constant") {
+      return false;
+    }
+    const auto& attr = (*producer)->attrs.at("value");
+    return absl::holds_alternative<float>(attr) && absl::get<float>(attr) == value;
+  }
+
+  // the rewriting keeps the output shape and dtype, so the result can only be replaced by a variable with the same
+  bool IsSameVariable(const Variable& lhs, const Variable& rhs) const {
+    return lhs->shape == rhs->shape && lhs->type == rhs->type;
+  }
+
+  // whether the instruction always equals to one of its inputs or the input of its producer
+  bool SimplifyToInput(const Instruction& instr,
+                       const OutputToOpMap& out2instr,
+                       const Variable** equal_var,
+                       std::unordered_set<Instruction*>* maybe_unused) const {
+    if (instr->inputs.empty() || instr->outputs.size() != 1) {
+      return false;
+    }
+    const auto& op_type = instr->op_type;
+    const auto& inputs  = instr->inputs;
+    const auto& out     = instr->outputs.front();
+
+    // the constant operand and its neutral value of the binary ops
+    static std::unordered_map<std::string, float> right_neutral = {
+        {"elementwise_mul", 1.0f}, {"divide", 1.0f}, {"elementwise_add", 0.0f}, {"substract", 0.0f}};
+    static std::unordered_map<std::string, float> left_neutral = {{"elementwise_mul", 1.0f}, {"elementwise_add", 0.0f}};
+    if (inputs.size() == 2) {
+      if (right_neutral.count(op_type) && IsConstant(inputs[1], right_neutral.at(op_type), out2instr) &&
+          IsSameVariable(inputs[0], out)) {
+        *equal_var = &inputs[0];
+        maybe_unused->insert(GetProducer(inputs[1], out2instr));
+        return true;
+      }
+      if (left_neutral.count(op_type) && IsConstant(inputs[0], left_neutral.at(op_type), out2instr) &&
+          IsSameVariable(inputs[1], out)) {
+        *equal_var = &inputs[1];
+        maybe_unused->insert(GetProducer(inputs[0], out2instr));
+        return true;
+      }
+      return false;
+    }
+
+    // the pairs of unary ops which are the inverse function of each other, but only where log(x) is defined and exp(x)
+    // doesn't overflow, so they are folded only in the fast math mode.
+    static std::unordered_map<std::string, std::string> inverse_ops = {{"exp", "log"}, {"log", "exp"}};
+    if (FLAGS_cinn_algebraic_simplifier_fast_math && inputs.size() == 1 && inverse_ops.count(op_type)) {
+      auto* producer = GetProducer(inputs[0], out2instr);
+      if (producer && (*producer)->op_type == inverse_ops.at(op_type) &&
+          IsSameVariable((*producer)->inputs.front(), out)) {
+        *equal_var = &(*producer)->inputs.front();
+        maybe_unused->insert(producer);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // reducing the axes produced by broadcast_to only accumulates the copies of x
+  bool SimplifyReduceOfBroadcast(Instruction* instr,
+                                 const OutputToOpMap& out2instr,
+                                 const Variable** equal_var,
+                                 std::unordered_set<Instruction*>* maybe_unused) const {
+    // reducing the copies of an element by these reducers results in the element itself
+    static std::unordered_set<std::string> idempotent_reduces = {
+        "reduce_max", "reduce_min", "reduce_all", "reduce_any"};
+
+    const auto& op_type = (*instr)->op_type;
+    if (op_type != "reduce_sum" && !idempotent_reduces.count(op_type)) {
+      return false;
+    }
+    auto* broadcast = GetProducer((*instr)->inputs.front(), out2instr);
+    if (!broadcast || (*broadcast)->op_type != "broadcast_to") {
+      return false;
+    }
+    const auto& x = (*broadcast)->inputs.front();
+    if (!IsSameVariable(x, (*instr)->outputs.front())) {
+      return false;
+    }
+
+    const auto& in_shape       = (*instr)->inputs.front()->shape;
+    const auto& broadcast_axes = broadcast->GetAttrs<std::vector<int>>("broadcast_axes");
+
+    // an empty `dim` means reducing all axes
+    auto dim = (*instr)->attrs.count("dim") ? instr->GetAttrs<std::vector<int>>("dim") : std::vector<int>{};
+    std::vector<bool> is_reduced(in_shape.size(), dim.empty());
+    for (auto axis : dim) {
+      is_reduced[axis < 0 ? axis + in_shape.size() : axis] = true;
+    }
+
+    // each axis of x should either be kept, or be of extent 1 and reduced
+    std::vector<bool> from_x(in_shape.size(), false);
+    for (int i = 0; i < broadcast_axes.size(); ++i) {
+      if (i > 0 && broadcast_axes[i] <= broadcast_axes[i - 1]) {
+        return false;
+      }
+      if (is_reduced[broadcast_axes[i]] && x->shape[i] != 1) {
+        return false;
+      }
+      from_x[broadcast_axes[i]] = true;
+    }
+    int factor = 1;
+    for (int i = 0; i < in_shape.size(); ++i) {
+      if (!is_reduced[i] && !from_x[i]) {
+        return false;
+      }
+      factor *= is_reduced[i] ? in_shape[i] : 1;
+    }
+
+    maybe_unused->insert(broadcast);
+    if (idempotent_reduces.count(op_type)) {
+      *equal_var = &x;
+      return true;
+    }
+
+    VLOG(4) << "Rewrite " << *instr << " into scale of " << x->id << " by " << factor;
+    (*instr)->op_type = "scale";
+    (*instr)->inputs  = {x};
+    (*instr)->attrs.clear();
+    (*instr)->attrs_ordered.clear();
+    instr->SetAttr("scale", static_cast<float>(factor));
+    instr->SetAttr("bias", 0.0f);
+    instr->SetAttr("bias_after_scale", true);
+    return false;
+  }
+
+  void FoldReshape(Instruction* instr,
+                   const OutputToOpMap& out2instr,
+                   std::unordered_set<Instruction*>* maybe_unused) const {
+    if ((*instr)->op_type != "reshape") {
+      return;
+    }
+    auto* producer = GetProducer((*instr)->inputs.front(), out2instr);
+    if (!producer || (*producer)->op_type != "reshape") {
+      return;
+    }
+    VLOG(4) << "Fold " << *producer << " into " << *instr;
+    (*instr)->inputs.front() = (*producer)->inputs.front();
+    // the shape attribute may contain 0 which refers to the extent of input, use the inferred shape instead
+    instr->SetAttr("shape", (*instr)->outputs.front()->shape);
+    maybe_unused->insert(producer);
+  }
+
+  void FoldScale(Instruction* instr,
+                 const OutputToOpMap& out2instr,
+                 std::unordered_set<Instruction*>* maybe_unused) const {
+    if ((*instr)->op_type != "scale") {
+      return;
+    }
+    auto* producer = GetProducer((*instr)->inputs.front(), out2instr);
+    if (!producer || (*producer)->op_type != "scale") {
+      return;
+    }
+    // normalize both scale into `scale * x + bias`
+    auto get_scale_bias = [](const Instruction& scale) {
+      float s    = scale->attrs.count("scale") ? scale.GetAttrs<float>("scale") : 1.0f;
+      float b    = scale->attrs.count("bias") ? scale.GetAttrs<float>("bias") : 0.0f;
+      bool after = scale->attrs.count("bias_after_scale") ? scale.GetAttrs<bool>("bias_after_scale") : true;
+      return std::make_pair(s, after ? b : s * b);
+    };
+    auto inner = get_scale_bias(*producer);
+    auto outer = get_scale_bias(*instr);
+
+    VLOG(4) << "Fold " << *producer << " into " << *instr;
+    (*instr)->inputs.front() = (*producer)->inputs.front();
+    instr->SetAttr("scale", inner.first * outer.first);
+    instr->SetAttr("bias", inner.second * outer.first + outer.second);
+    instr->SetAttr("bias_after_scale", true);
+    maybe_unused->insert(producer);
+  }
+
+  void ReplaceWithIdentity(Instruction* instr, const Variable& input) const {
+    (*instr)->op_type = "identity";
+    (*instr)->inputs  = {input};
+    (*instr)->attrs.clear();
+    (*instr)->attrs_ordered.clear();
+  }
+};
+
+}  // namespace cinn::frontend::pass
+
+CINN_REGISTER_HELPER(AlgebraicSimplifier) {
+  CINN_REGISTER_PROGRAM_PASS(AlgebraicSimplifier, ::cinn::frontend::pass::AlgebraicSimplifierPass);
+
+  return true;
+}
@@ -0,0 +1,168 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+
+DECLARE_bool(cinn_algebraic_simplifier_fast_math);
+
+namespace cinn::frontend {
+
+std::vector<std::string> GetInputIds(const std::vector<Variable>& inputs) {
+  std::vector<std::string> input_ids;
+  absl::c_transform(inputs, std::back_inserter(input_ids), [](const Variable& var) { return var->id; });
+  return input_ids;
+}
+
+TEST(AlgebraicSimplifier, NeutralOperand) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto one     = builder.FillConstant<float>({4, 5, 3}, 1.0f, "one");
+  auto zero    = builder.FillConstant<float>({4, 5, 3}, 0.0f, "zero");
+  auto mul_one = builder.Multiply(x, one);
+  auto add_one = builder.Add(zero, mul_one);
+  auto out     = builder.Relu(add_one);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  // both fill_constant, multiply and add are removed
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"}, {"AlgebraicSimplifier"}};
+  CompareResult(&program, target, GetInputIds({x}), {out->id}, 4, passes, 123, true);
+}
+
+TEST(AlgebraicSimplifier, FetchedNeutralOperand) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto zero    = builder.FillConstant<float>({4, 5, 3}, 0.0f, "zero");
+  auto out     = builder.Subtract(x, zero);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  ProgramPass::Apply(&program, {out->id}, target, {"AlgebraicSimplifier"});
+  ASSERT_EQ(program.size(), 1);
+  ASSERT_EQ(program[0]->op_type, "identity");
+  ASSERT_EQ(program[0]->inputs.front()->id, std::string(x.id()));
+}
+
+TEST(AlgebraicSimplifier, ExpOfLog) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto log_x   = builder.Log(x);
+  auto exp_x   = builder.Exp(log_x);
+  auto out     = builder.Relu(exp_x);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  // exp(log(x)) is NaN rather than x for the negative x, so it is kept by default
+  ProgramPass::Apply(&program, {out->id}, target, {"AlgebraicSimplifier"});
+  ASSERT_EQ(program.size(), 3);
+
+  bool origin_flag                          = FLAGS_cinn_algebraic_simplifier_fast_math;
+  FLAGS_cinn_algebraic_simplifier_fast_math = true;
+  ProgramPass::Apply(&program, {out->id}, target, {"AlgebraicSimplifier"});
+  FLAGS_cinn_algebraic_simplifier_fast_math = origin_flag;
+  ASSERT_EQ(program.size(), 1);
+  ASSERT_EQ(program[0]->op_type, "relu");
+  ASSERT_EQ(program[0]->inputs.front()->id, std::string(x.id()));
+}
+
+TEST(AlgebraicSimplifier, ReduceOfBroadcast) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {5, 3}, "X");
+  auto x_b     = builder.BroadcastTo(x, {4, 5, 3});
+  auto sum     = builder.ReduceSum(x_b, {0});
+  auto max     = builder.ReduceMax(x_b, {0});
+  auto out     = builder.Add(sum, max);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  // the reduce_sum is rewritten into scale, the broadcast_to and reduce_max are removed
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"}, {"AlgebraicSimplifier"}};
+  CompareResult(&program, target, GetInputIds({x}), {out->id}, 2, passes, 123, true);
+}
+
+TEST(AlgebraicSimplifier, ReduceOfBroadcastKeepDim) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {1, 5, 3}, "X");
+  auto x_b     = builder.BroadcastTo(x, {4, 5, 3});
+  auto out     = builder.ReduceSum(x_b, {0}, true);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"}, {"AlgebraicSimplifier"}};
+  CompareResult(&program, target, GetInputIds({x}), {out->id}, 1, passes, 123, true);
+}
+
+TEST(AlgebraicSimplifier, ReduceNotBroadcastedAxis) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {5, 3}, "X");
+  auto x_b     = builder.BroadcastTo(x, {4, 5, 3});
+  auto out     = builder.ReduceSum(x_b, {1});
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  ProgramPass::Apply(&program, {out->id}, target, {"AlgebraicSimplifier"});
+  ASSERT_EQ(program.size(), 2);
+  ASSERT_EQ(program[1]->op_type, "reduce_sum");
+}
+
+TEST(AlgebraicSimplifier, ConsecutiveReshape) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto x_1     = builder.Reshape(x, {20, 3});
+  auto x_2     = builder.Reshape(x_1, {0, 1, 3});
+  auto out     = builder.Reshape(x_2, {4, 15});
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"}, {"AlgebraicSimplifier"}};
+  CompareResult(&program, target, GetInputIds({x}), {out->id}, 2, passes, 123, true);
+}
+
+TEST(AlgebraicSimplifier, ConsecutiveScale) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto x_1     = builder.Scale(x, 2.0f, 1.0f, true);
+  auto x_2     = builder.Scale(x_1, 4.0f, 3.0f, false);
+  auto out     = builder.Scale(x_2, 0.5f, -2.0f, true);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"}, {"AlgebraicSimplifier"}};
+  CompareResult(&program, target, GetInputIds({x}), {out->id}, 2, passes, 123, true);
+}
+
+TEST(AlgebraicSimplifier, ConsecutiveScaleWithMultiUsers) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto x_1     = builder.Scale(x, 2.0f, 1.0f, true);
+  auto x_2     = builder.Scale(x_1, 4.0f, 3.0f, false);
+  auto out     = builder.Add(x_1, x_2);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  // the first scale is still used by add
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"}, {"AlgebraicSimplifier"}};
+  CompareResult(&program, target, GetInputIds({x}), {out->id}, 0, passes, 123, true);
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,179 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cinn/common/context.h"
+#include "cinn/common/target.h"
+#include "cinn/common/type.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+
+namespace cinn::frontend::pass {
+
+// Pass `BatchNormFolding` folds the inference batch_norm into the weight of the preceding convolution:
+//   y = batch_norm(conv2d(x, w), scale, bias, mean, variance)
+// =>
+//   alpha = scale * rsqrt(variance + epsilon)
+//   y     = conv2d(x, w * alpha) + (bias - mean * alpha)
+// The folded weight and bias only depend on the parameters, so they are computed once in PreRun after
+// `ConstPropagate` if the parameters are constant.
+class BatchNormFoldingPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+  using OutputToOpMap = std::unordered_map<std::string, Instruction*>;
+  using InputToOpMap  = std::unordered_map<std::string, std::unordered_set<Instruction*>>;
+
+ protected:
+  void Clear() override {}
+
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) const override {
+    VLOG(3) << "-- Before BatchNormFoldingPass:\n" << *program;
+    OutputToOpMap out2instr;
+    InputToOpMap in2instr;
+    for (size_t i = 0; i < program->size(); ++i) {
+      auto& instr = (*program)[i];
+      for (const auto& out : instr->outputs) {
+        out2instr[out->id] = &instr;
+      }
+      for (const auto& in : instr->inputs) {
+        in2instr[in->id].insert(&instr);
+      }
+    }
+
+    // the batch_norm to the convolution folded into
+    std::unordered_map<Instruction*, Instruction*> bn2conv;
+    std::unordered_set<Instruction*> folded_convs;
+    for (size_t i = 0; i < program->size(); ++i) {
+      auto* bn   = &(*program)[i];
+      auto* conv = GetFoldableConv(bn, fetch_ids, out2instr, in2instr);
+      if (conv) {
+        bn2conv.emplace(bn, conv);
+        folded_convs.insert(conv);
+      }
+    }
+    if (bn2conv.empty()) {
+      return;
+    }
+
+    NetBuilder builder("batch_norm_folding_builder");
+    for (auto& var : program->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < program->size(); ++i) {
+      auto* instr = &(*program)[i];
+      if (folded_convs.count(instr)) {
+        // the convolution is appended with the batch_norm, whose parameters may be produced after it
+        continue;
+      }
+      if (bn2conv.count(instr)) {
+        FoldBatchNorm(&builder, bn2conv.at(instr), instr);
+      } else {
+        builder.AppendInstruction(*instr);
+      }
+    }
+    *program = builder.Build();
+    VLOG(3) << "-- After BatchNormFoldingPass:\n" << *program;
+  }
+
+ private:
+  template <typename T>
+  T GetAttrOr(const Instruction& instr, const std::string& key, const T& default_value) const {
+    return instr->attrs.count(key) ? instr.GetAttrs<T>(key) : default_value;
+  }
+
+  // return the NCHW convolution producing the input of batch_norm, or nullptr if it cannot be folded
+  Instruction* GetFoldableConv(Instruction* bn,
+                               const std::unordered_set<std::string>& fetch_ids,
+                               const OutputToOpMap& out2instr,
+                               const InputToOpMap& in2instr) const {
+    if ((*bn)->op_type != "batch_norm" || (*bn)->inputs.size() != 5 || (*bn)->outputs.size() != 1 ||
+        GetAttrOr<std::string>(*bn, "data_layout", "NCHW") != "NCHW") {
+      return nullptr;
+    }
+    const auto& conv_out = (*bn)->inputs[0];
+    if (!out2instr.count(conv_out->id)) {
+      return nullptr;
+    }
+    auto* conv = out2instr.at(conv_out->id);
+    if ((*conv)->op_type != "conv2d" && (*conv)->op_type != "depthwise_conv2d") {
+      return nullptr;
+    }
+    if (GetAttrOr<std::string>(*conv, "conv_type", "forward") != "forward" ||
+        GetAttrOr<std::string>(*conv, "data_format", "NCHW") != "NCHW") {
+      return nullptr;
+    }
+    // the output of convolution is changed by folding, so it can only be read by the batch_norm
+    if (fetch_ids.count(conv_out->id) || in2instr.at(conv_out->id).size() != 1) {
+      VLOG(4) << "The output " << conv_out->id << " of convolution is used by others, cannot fold batch_norm.";
+      return nullptr;
+    }
+
+    // the weight is in OIHW layout, its first dimension is the channel of output
+    const auto& weight = (*conv)->inputs[1];
+    if (weight->shape.size() != 4 || conv_out->shape.size() != 4 || weight->shape[0] != conv_out->shape[1]) {
+      return nullptr;
+    }
+    for (int i = 1; i < 5; ++i) {
+      const auto& param = (*bn)->inputs[i];
+      if (param->type != weight->type || param->shape != std::vector<int>{weight->shape[0]}) {
+        return nullptr;
+      }
+    }
+    return conv_out->type == weight->type ? conv : nullptr;
+  }
+
+  void FoldBatchNorm(NetBuilder* builder, Instruction* conv, Instruction* bn) const {
+    const auto& weight   = (*conv)->inputs[1];
+    const auto& scale    = (*bn)->inputs[1];
+    const auto& bias     = (*bn)->inputs[2];
+    const auto& mean     = (*bn)->inputs[3];
+    const auto& variance = (*bn)->inputs[4];
+    auto epsilon         = GetAttrOr<float>(*bn, "epsilon", 1e-5f);
+
+    VLOG(4) << "Fold " << *bn << " into " << *conv;
+    auto epsilon_1d = builder->FillConstant(
+        variance->shape, epsilon, common::UniqName("epsilon"), common::Type2Str(variance->type));
+    // alpha = scale * rsqrt(variance + epsilon), shape = [c]
+    auto alpha = builder->Multiply(scale, builder->Rsqrt(builder->Add(variance, epsilon_1d)));
+    // folded_weight = weight * alpha, shape = [c, i, h, w]
+    auto folded_weight = builder->Multiply(weight, builder->BroadcastTo(alpha, weight->shape, {0}));
+    // folded_bias = bias - mean * alpha, shape = [c]
+    auto folded_bias = builder->Subtract(bias, builder->Multiply(mean, alpha));
+
+    (*conv)->inputs[1] = folded_weight;
+    builder->AppendInstruction(*conv);
+
+    // y = conv2d(x, folded_weight) + folded_bias, which keeps the output variable of batch_norm
+    const auto& conv_out = (*conv)->outputs[0];
+    Instruction add("elementwise_add", {conv_out, builder->BroadcastTo(folded_bias, conv_out->shape, {1})});
+    add.SetAttr("axis", -1);
+    add->outputs = (*bn)->outputs;
+    builder->AppendInstruction(add);
+  }
+};
+
+}  // namespace cinn::frontend::pass
+
+CINN_REGISTER_HELPER(BatchNormFolding) {
+  CINN_REGISTER_PROGRAM_PASS(BatchNormFolding, ::cinn::frontend::pass::BatchNormFoldingPass);
+
+  return true;
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+
+namespace cinn::frontend {
+
+std::vector<std::string> GetInputIds(const Program& program) {
+  std::vector<std::string> input_ids;
+  absl::c_transform(program.GetInputs(), std::back_inserter(input_ids), [](const Variable& var) { return var->id; });
+  return input_ids;
+}
+
+// y = batch_norm(conv2d(x, w), scale, bias, mean, variance), return the program and the id of conv2d and y.
+Program BuildConvBatchNorm(std::string* conv_id, std::string* out_id) {
+  NetBuilder builder("net_builder");
+  auto x        = builder.CreateInput(Float(32), {2, 3, 8, 8}, "X");
+  auto w        = builder.CreateInput(Float(32), {4, 3, 3, 3}, "W");
+  auto scale    = builder.CreateInput(Float(32), {4}, "Scale");
+  auto bias     = builder.CreateInput(Float(32), {4}, "Bias");
+  auto mean     = builder.CreateInput(Float(32), {4}, "Mean");
+  auto variance = builder.CreateInput(Float(32), {4}, "Variance");
+  auto conv     = builder.Conv2d(x, w, {1, 1}, {1, 1});
+  auto out      = builder.BatchNorm(conv, scale, bias, mean, variance, 1e-5f, 0.9f, "NCHW", true).front();
+  *conv_id      = conv->id;
+  *out_id       = out->id;
+  return builder.Build();
+}
+
+TEST(BatchNormFolding, FoldIntoConv2d) {
+  auto target = common::DefaultTarget();
+  std::string conv_id, out_id;
+  std::vector<std::string> graph_passes = {"OpFusionPass", "FusionMergePass"};
+
+  auto program = BuildConvBatchNorm(&conv_id, &out_id);
+  ProgramPass::Apply(&program, {out_id}, target, {"Decomposer"});
+  auto origin_out = RunProgram(program, target, GetInputIds(program), {out_id}, graph_passes, 123);
+
+  program = BuildConvBatchNorm(&conv_id, &out_id);
+  ProgramPass::Apply(&program, {out_id}, target, {"BatchNormFolding"});
+  VLOG(1) << "Program after BatchNormFolding:\n" << program;
+  // the batch_norm is replaced by a bias add after the convolution
+  ASSERT_EQ(program[program.size() - 2]->op_type, "conv2d");
+  ASSERT_EQ(program[program.size() - 1]->op_type, "elementwise_add");
+  ASSERT_EQ(program[program.size() - 1]->outputs.front()->id, out_id);
+
+  ProgramPass::Apply(&program, {out_id}, target, {"Decomposer"});
+  auto folded_out = RunProgram(program, target, GetInputIds(program), {out_id}, graph_passes, 123);
+
+  ASSERT_EQ(origin_out.size(), folded_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_NEAR(origin_out[i], folded_out[i], 1e-4 * std::max(1.0f, std::abs(origin_out[i]))) << " i is " << i;
+  }
+}
+
+TEST(BatchNormFolding, ConvOutputFetched) {
+  auto target = common::DefaultTarget();
+  std::string conv_id, out_id;
+
+  auto program     = BuildConvBatchNorm(&conv_id, &out_id);
+  auto origin_size = program.size();
+  ProgramPass::Apply(&program, {conv_id, out_id}, target, {"BatchNormFolding"});
+  ASSERT_EQ(program.size(), origin_size);
+  ASSERT_EQ(program[program.size() - 1]->op_type, "batch_norm");
+}
+
+}  // namespace cinn::frontend
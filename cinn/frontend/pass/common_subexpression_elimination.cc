@@ -0,0 +1,145 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/utils/string.h"
+
+namespace cinn::frontend::pass {
+
+// Pass `CommonSubexpressionElimination` hash-conses the instructions of program: an instruction which has the same
+// op type, inputs and attributes as a previous one is removed, and its users read the outputs of the previous one.
+class CommonSubexpressionEliminationPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void Clear() override {}
+
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) const override {
+    VLOG(3) << "-- Before CommonSubexpressionEliminationPass:\n" << *program;
+    // the instructions with the same key are the candidates of common subexpression
+    std::unordered_map<std::string, std::vector<Instruction*>> key2instrs;
+    // the output of removed instruction to the equivalent output of the kept instruction
+    std::unordered_map<std::string, Variable> replaced_vars;
+    std::unordered_set<Instruction*> remove_instrs;
+
+    for (size_t i = 0; i < program->size(); ++i) {
+      auto* instr = &(*program)[i];
+      // the instructions are visited in topological order, so the inputs have been replaced already
+      for (auto& in : (*instr)->inputs) {
+        if (replaced_vars.count(in->id)) {
+          in = replaced_vars.at(in->id);
+        }
+      }
+      if (hlir::framework::IsNondeterministicOp((*instr)->op_type) || (*instr)->outputs.empty()) {
+        continue;
+      }
+
+      auto& candidates = key2instrs[GetKey(*instr)];
+      auto it          = std::find_if(candidates.begin(), candidates.end(), [&](Instruction* other) {
+        return IsEquivalent(*instr, *other);
+      });
+      if (it == candidates.end()) {
+        candidates.emplace_back(instr);
+        continue;
+      }
+
+      const auto& outputs = (*instr)->outputs;
+      const auto& kept    = (**it)->outputs;
+      int num_fetched     = std::count_if(
+          outputs.begin(), outputs.end(), [&](const Variable& var) { return fetch_ids.count(var->id); });
+      if (num_fetched > 0 && outputs.size() > 1) {
+        // cannot replace the instruction with identity, skip
+        VLOG(4) << "The instruction " << *instr << " is the same as " << **it << " but its outputs are fetched, skip.";
+        continue;
+      }
+
+      for (size_t j = 0; j < outputs.size(); ++j) {
+        replaced_vars.emplace(outputs[j]->id, kept[j]);
+      }
+      if (num_fetched > 0) {
+        VLOG(4) << "The instruction " << *instr << " is the same as " << **it << " but fetched, replace with identity.";
+        (*instr)->op_type = "identity";
+        (*instr)->inputs  = {kept.front()};
+        (*instr)->attrs.clear();
+        (*instr)->attrs_ordered.clear();
+      } else {
+        VLOG(4) << "The instruction " << *instr << " is the same as " << **it << ", remove.";
+        remove_instrs.insert(instr);
+      }
+    }
+
+    NetBuilder builder("common_subexpression_elimination_builder");
+    for (auto& var : program->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < program->size(); ++i) {
+      if (!remove_instrs.count(&(*program)[i])) {
+        builder.AppendInstruction((*program)[i]);
+      }
+    }
+    *program = builder.Build();
+    VLOG(3) << "-- After CommonSubexpressionEliminationPass:\n" << *program;
+  }
+
+ private:
+  // the key only contains the op type and inputs, the attributes are compared in `IsEquivalent`
+  std::string GetKey(const Instruction& instr) const {
+    std::vector<std::string> input_ids;
+    for (const auto& in : instr->inputs) {
+      input_ids.emplace_back(in->id);
+    }
+    return instr->op_type + "(" + utils::Join(input_ids, ",") + ")";
+  }
+
+  bool IsEquivalent(const Instruction& lhs, const Instruction& rhs) const {
+    if (lhs->op_type != rhs->op_type || lhs->inputs.size() != rhs->inputs.size() ||
+        lhs->outputs.size() != rhs->outputs.size() || lhs->attrs != rhs->attrs) {
+      return false;
+    }
+    for (size_t i = 0; i < lhs->inputs.size(); ++i) {
+      if (lhs->inputs[i]->id != rhs->inputs[i]->id) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < lhs->outputs.size(); ++i) {
+      if (lhs->outputs[i]->type != rhs->outputs[i]->type || lhs->outputs[i]->shape != rhs->outputs[i]->shape) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace cinn::frontend::pass
+
+CINN_REGISTER_HELPER(CommonSubexpressionElimination) {
+  CINN_REGISTER_PROGRAM_PASS(CommonSubexpressionElimination,
+                             ::cinn::frontend::pass::CommonSubexpressionEliminationPass);
+
+  return true;
+}
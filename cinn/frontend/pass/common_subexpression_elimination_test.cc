@@ -0,0 +1,99 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+
+namespace cinn::frontend {
+
+std::vector<std::string> GetInputIds(const std::vector<Variable>& inputs) {
+  std::vector<std::string> input_ids;
+  absl::c_transform(inputs, std::back_inserter(input_ids), [](const Variable& var) { return var->id; });
+  return input_ids;
+}
+
+TEST(CommonSubexpressionElimination, RemoveDuplicateChain) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto y       = builder.CreateInput(Float(32), {5, 3}, "Y");
+  auto y_b1    = builder.BroadcastTo(y, {4, 5, 3});
+  auto y_b2    = builder.BroadcastTo(y, {4, 5, 3});
+  auto add_1   = builder.Add(x, y_b1);
+  auto add_2   = builder.Add(x, y_b2);
+  auto sum_1   = builder.ReduceSum(add_1, {1});
+  auto sum_2   = builder.ReduceSum(add_2, {1});
+  auto out     = builder.Multiply(sum_1, sum_2);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  // the second broadcast_to, elementwise_add and reduce_sum are removed one after another
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"},
+                                                                       {"CommonSubexpressionElimination"}};
+  CompareResult(&program, target, GetInputIds({x, y}), {out->id}, 3, passes, 123, true);
+}
+
+TEST(CommonSubexpressionElimination, DifferentAttribute) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto sum_1   = builder.ReduceSum(x, {1});
+  auto sum_2   = builder.ReduceSum(x, {1}, true);
+  auto sum_3   = builder.ReduceSum(x, {1});
+  auto reshape = builder.Reshape(sum_2, {4, 3});
+  auto add     = builder.Add(sum_1, reshape);
+  auto out     = builder.Add(add, sum_3);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  // only the third reduce_sum is removed as the second one keeps the reduced dimension
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"},
+                                                                       {"CommonSubexpressionElimination"}};
+  CompareResult(&program, target, GetInputIds({x}), {out->id}, 1, passes, 123, true);
+}
+
+TEST(CommonSubexpressionElimination, FetchedDuplicate) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto relu_1  = builder.Relu(x);
+  auto relu_2  = builder.Relu(x);
+  auto out     = builder.Add(relu_1, relu_2);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  ProgramPass::Apply(&program, {relu_2->id, out->id}, target, {"CommonSubexpressionElimination"});
+  ASSERT_EQ(program.size(), 3);
+  ASSERT_EQ(program[1]->op_type, "identity");
+  ASSERT_EQ(program[2]->inputs[0]->id, relu_1->id);
+  ASSERT_EQ(program[2]->inputs[1]->id, relu_1->id);
+}
+
+TEST(CommonSubexpressionElimination, KeepRandomOp) {
+  NetBuilder builder("net_builder");
+  auto x_1     = builder.GaussianRandom({4, 5}, 0.0f, 1.0f, 123, "float32");
+  auto x_2     = builder.GaussianRandom({4, 5}, 0.0f, 1.0f, 123, "float32");
+  auto out     = builder.Add(x_1, x_2);
+  auto program = builder.Build();
+
+  auto target = common::DefaultTarget();
+  ProgramPass::Apply(&program, {out->id}, target, {"CommonSubexpressionElimination"});
+  ASSERT_EQ(program.size(), 3);
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,200 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/pass/instr_chain_rewriter_base.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// FlashAttentionRewriter replaces the attention written as separate matmul, scale and softmax instructions by the
+// fused flash_attention, which streams over the keys with an online softmax instead of writing and re-reading the
+// [seq_q, seq_k] scores:
+//
+//   matmul(Q, K, trans_b = true, alpha)
+//          | var0
+//        scale
+//          | var1                     =>      flash_attention(Q, K, V, scale = alpha * scale)
+//   softmax(axes = {-1})                                   | var3
+//          | var2
+//     matmul(var2, V)
+//          | var3
+//
+// K may also be transposed by a separate transpose of its last two axes, and the scale is optional and should have no
+// bias. The pass should run before the Decomposer, which expands the softmax. Every replaced variable should be used
+// only by the next instruction of the chain and not be fetched.
+class FlashAttentionRewriterPass : public InstrChainRewriterBase {
+ public:
+  using InstrChainRewriterBase::InstrChainRewriterBase;
+
+ protected:
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    // the flash_attention op is only implemented by the extern kernel on x86.
+    if (target.arch != Target::Arch::X86 || !prog->size()) {
+      return;
+    }
+    CollectInfo(*prog);
+
+    int rewritten_num = 0;
+    for (int i = 0; i < prog->size(); ++i) {
+      if ((*prog)[i]->op_type == "softmax" && RewriteAttention(prog, i, fetch_ids)) {
+        ++rewritten_num;
+      }
+    }
+    VLOG(3) << "FlashAttentionRewriter rewrites " << rewritten_num << " attentions.";
+    if (!rewritten_num) {
+      return;
+    }
+
+    RemoveInstructions(prog, "flash_attention_rewriter_builder");
+    VLOG(4) << "After FlashAttentionRewriter: " << *prog;
+  }
+
+ private:
+  bool IsPlainMatmul(const Instruction& instr, bool trans_b) const {
+    auto get_bool = [&](const char* key) { return instr->attrs.count(key) && instr.GetAttrs<bool>(key); };
+    return instr->op_type == "matmul" && instr->inputs.size() == 2U && instr->outputs.size() == 1U &&
+           !instr->attrs.count("epilogue_activation") && !get_bool("trans_a") && get_bool("trans_b") == trans_b &&
+           !get_bool("trans_out");
+  }
+
+  bool IsLastTwoAxesTranspose(const Instruction& instr) const {
+    if (instr->op_type != "transpose" || !instr->attrs.count("axis")) {
+      return false;
+    }
+    auto axis = instr.GetAttrs<std::vector<int>>("axis");
+    int rank  = axis.size();
+    if (rank < 2) {
+      return false;
+    }
+    for (int i = 0; i < rank - 2; ++i) {
+      if (axis[i] != i) {
+        return false;
+      }
+    }
+    return axis[rank - 2] == rank - 1 && axis[rank - 1] == rank - 2;
+  }
+
+  // The flash_attention takes Q [..., seq_q, head_dim], K [..., seq_k, head_dim] and V [..., seq_k, head_dim_v] with
+  // the same batch dimensions, the matmul broadcasting is not supported.
+  bool IsAttentionShape(const Variable& q, const Variable& k, const Variable& v) const {
+    const auto& q_shape = q->shape;
+    const auto& k_shape = k->shape;
+    const auto& v_shape = v->shape;
+    if (q_shape.size() < 2U || q_shape.size() != k_shape.size() || q_shape.size() != v_shape.size()) {
+      return false;
+    }
+    if (!std::equal(q_shape.begin(), q_shape.end() - 2, k_shape.begin()) ||
+        !std::equal(q_shape.begin(), q_shape.end() - 2, v_shape.begin())) {
+      return false;
+    }
+    return q_shape.back() == k_shape.back() && k_shape[k_shape.size() - 2] == v_shape[v_shape.size() - 2] &&
+           q->type == Float(32) && k->type == Float(32) && v->type == Float(32);
+  }
+
+  bool RewriteAttention(Program* prog, int softmax_idx, const std::unordered_set<std::string>& fetch_ids) {
+    auto& softmax = (*prog)[softmax_idx];
+    if (softmax->inputs.size() != 1U || softmax->outputs.size() != 1U) {
+      return false;
+    }
+    auto scores = softmax->inputs[0];
+    auto probs  = softmax->outputs[0];
+    int rank    = scores->shape.size();
+    auto axes   = softmax->attrs.count("axes") ? softmax.GetAttrs<std::vector<int>>("axes") : std::vector<int>{-1};
+    if (axes.size() != 1U || (axes[0] != -1 && axes[0] != rank - 1)) {
+      return false;
+    }
+
+    // the matmul of the probabilities and V.
+    int pv_idx = GetOnlyUser(*prog, probs, fetch_ids);
+    if (pv_idx < 0) {
+      return false;
+    }
+    auto& pv_matmul = (*prog)[pv_idx];
+    float pv_alpha  = pv_matmul->attrs.count("alpha") ? pv_matmul.GetAttrs<float>("alpha") : 1.0f;
+    if (!IsPlainMatmul(pv_matmul, false) || pv_matmul->inputs[0].get() != probs.get() || pv_alpha != 1.0f) {
+      return false;
+    }
+
+    // walk back through the scales to the matmul of Q and K.
+    std::vector<_Instruction_*> removed_instrs{softmax.get()};
+    float scale  = 1.0f;
+    Variable var = scores;
+    int qk_idx   = GetProducer(var);
+    while (qk_idx >= 0 && IsIntermediate(var, fetch_ids) && (*prog)[qk_idx]->op_type == "scale") {
+      auto& scale_instr = (*prog)[qk_idx];
+      if (scale_instr->attrs.count("bias") && scale_instr.GetAttrs<float>("bias") != 0.0f) {
+        return false;
+      }
+      scale *= scale_instr->attrs.count("scale") ? scale_instr.GetAttrs<float>("scale") : 1.0f;
+      removed_instrs.push_back(scale_instr.get());
+      var    = scale_instr->inputs[0];
+      qk_idx = GetProducer(var);
+    }
+    if (qk_idx < 0 || !IsIntermediate(var, fetch_ids)) {
+      return false;
+    }
+    auto& qk_matmul = (*prog)[qk_idx];
+    bool trans_k    = IsPlainMatmul(qk_matmul, true);
+    if (!trans_k && !IsPlainMatmul(qk_matmul, false)) {
+      return false;
+    }
+    scale *= qk_matmul->attrs.count("alpha") ? qk_matmul.GetAttrs<float>("alpha") : 1.0f;
+    removed_instrs.push_back(qk_matmul.get());
+
+    auto q = qk_matmul->inputs[0];
+    auto k = qk_matmul->inputs[1];
+    auto v = pv_matmul->inputs[1];
+    if (!trans_k) {
+      // K^T is computed by a transpose of the last two axes of K, which has not been folded into the matmul yet.
+      int transpose_idx = GetProducer(k);
+      if (transpose_idx < 0 || !IsIntermediate(k, fetch_ids) || !IsLastTwoAxesTranspose((*prog)[transpose_idx])) {
+        return false;
+      }
+      removed_instrs.push_back((*prog)[transpose_idx].get());
+      k = (*prog)[transpose_idx]->inputs[0];
+    }
+    if (!IsAttentionShape(q, k, v)) {
+      return false;
+    }
+
+    VLOG(4) << "Rewrite the attention ending with " << pv_matmul << " into flash_attention with scale " << scale;
+    pv_matmul->op_type = "flash_attention";
+    pv_matmul->inputs  = {q, k, v};
+    pv_matmul->attrs.clear();
+    pv_matmul->attrs_ordered.clear();
+    pv_matmul.SetAttr("scale", scale);
+    removed_instrs_.insert(removed_instrs.begin(), removed_instrs.end());
+    return true;
+  }
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(FlashAttentionRewriter) {
+  CINN_REGISTER_PROGRAM_PASS(FlashAttentionRewriter, fp::FlashAttentionRewriterPass);
+
+  return true;
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+
+namespace cinn::frontend {
+
+// out = softmax(scale(matmul(q, k^T))) * v, k^T is computed by a transpose if transpose_k is set.
+Program BuildAttention(const std::vector<int>& q_shape,
+                       const std::vector<int>& k_shape,
+                       bool transpose_k,
+                       std::vector<std::string>* input_ids,
+                       std::string* scores_id,
+                       std::string* out_id) {
+  NetBuilder builder("net_builder");
+  auto q     = builder.CreateInput(Float(32), q_shape, "Q");
+  auto k     = builder.CreateInput(Float(32), k_shape, "K");
+  auto v     = builder.CreateInput(Float(32), k_shape, "V");
+  Variable s = transpose_k ? builder.Matmul(q, builder.Transpose(k, {0, 1, 3, 2})) : builder.Matmul(q, k, false, true);
+  auto p     = builder.Softmax(builder.Scale(s, 0.01f));
+  auto out   = builder.Matmul(p, v);
+  *input_ids = {std::string(q.id()), std::string(k.id()), std::string(v.id())};
+  *scores_id = s->id;
+  *out_id    = out->id;
+  return builder.Build();
+}
+
+void CheckAttentionRewriting(bool transpose_k, const std::vector<int>& q_shape, const std::vector<int>& k_shape) {
+  auto target = common::DefaultHostTarget();
+  std::vector<std::string> input_ids;
+  std::string scores_id, out_id;
+  std::vector<std::string> graph_passes = {"OpFusionPass", "FusionMergePass"};
+
+  auto program = BuildAttention(q_shape, k_shape, transpose_k, &input_ids, &scores_id, &out_id);
+  ProgramPass::Apply(&program, {out_id}, target, {"Decomposer"});
+  auto origin_out = RunProgram(program, target, input_ids, {out_id}, graph_passes, 123);
+
+  program = BuildAttention(q_shape, k_shape, transpose_k, &input_ids, &scores_id, &out_id);
+  ProgramPass::Apply(&program, {out_id}, target, {"FlashAttentionRewriter"});
+  VLOG(1) << "Program after FlashAttentionRewriter:\n" << program;
+  ASSERT_EQ(program.size(), 1);
+  ASSERT_EQ(program[0]->op_type, "flash_attention");
+  ASSERT_EQ(program[0]->outputs.front()->id, out_id);
+
+  ProgramPass::Apply(&program, {out_id}, target, {"Decomposer"});
+  auto fused_out = RunProgram(program, target, input_ids, {out_id}, graph_passes, 123);
+
+  ASSERT_EQ(origin_out.size(), fused_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_NEAR(origin_out[i], fused_out[i], 1e-4 * std::max(1.0f, std::abs(origin_out[i]))) << " i is " << i;
+  }
+}
+
+TEST(FlashAttentionRewriter, MatmulTransB) {
+  if (IsCompiledWithCUDA()) {
+    return;
+  }
+  CheckAttentionRewriting(false, {2, 3, 40, 16}, {2, 3, 70, 16});
+}
+
+TEST(FlashAttentionRewriter, MatmulTransposeK) {
+  if (IsCompiledWithCUDA()) {
+    return;
+  }
+  CheckAttentionRewriting(true, {1, 2, 33, 8}, {1, 2, 65, 8});
+}
+
+TEST(FlashAttentionRewriter, ScoresFetched) {
+  if (IsCompiledWithCUDA()) {
+    return;
+  }
+  std::vector<std::string> input_ids;
+  std::string scores_id, out_id;
+  auto program     = BuildAttention({2, 3, 40, 16}, {2, 3, 70, 16}, false, &input_ids, &scores_id, &out_id);
+  auto origin_size = program.size();
+  ProgramPass::Apply(&program, {scores_id, out_id}, common::DefaultHostTarget(), {"FlashAttentionRewriter"});
+  ASSERT_EQ(program.size(), origin_size);
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,176 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gflags/gflags.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/pass/instr_chain_rewriter_base.h"
+#include "cinn/runtime/cpu/packed_gemm.h"
+#include "glog/logging.h"
+
+DECLARE_bool(cinn_use_packed_gemm);
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// GemmEpilogueFusionPass folds the elementwise chain following a matmul or mul into the epilogue of the gemm extern
+// call, so that the result is scaled, biased and activated while the output block is still in cache instead of by
+// separate kernels re-reading the whole output:
+//
+//      matmul(A, B)
+//          | var0
+//        scale                                  matmul(A, B, bias)
+//          | var1                      =>  {alpha *= scale, epilogue_activation = relu}
+//   elementwise_add(var1, bias)                       | var3
+//          | var2
+//        relu
+//          | var3
+//
+// The scale is folded into alpha only before the bias is added, the bias must be of shape [N] and broadcast along the
+// last axis, and the chain ends at the activation. Every folded variable should be used only by the next instruction
+// of the chain and not be fetched.
+class GemmEpilogueFusionPass : public InstrChainRewriterBase {
+ public:
+  using InstrChainRewriterBase::InstrChainRewriterBase;
+
+ protected:
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+#ifdef CINN_WITH_MKL_CBLAS
+    // the MKL gemm has no epilogue.
+    bool use_packed_gemm = false;
+#else
+    bool use_packed_gemm = FLAGS_cinn_use_packed_gemm;
+#endif
+    if (target.arch != Target::Arch::X86 || !use_packed_gemm || !prog->size()) {
+      return;
+    }
+    CollectInfo(*prog);
+
+    int fused_num = 0;
+    for (int i = 0; i < prog->size(); ++i) {
+      auto& instr = (*prog)[i];
+      if ((instr->op_type == "matmul" || instr->op_type == "mul") && FuseEpilogue(prog, i, fetch_ids)) {
+        ++fused_num;
+      }
+    }
+    VLOG(3) << "GemmEpilogueFusion folds the epilogues of " << fused_num << " gemms.";
+    if (!fused_num) {
+      return;
+    }
+
+    RemoveInstructions(prog, "gemm_epilogue_fusion_builder");
+    VLOG(4) << "After GemmEpilogueFusion: " << *prog;
+  }
+
+ private:
+  bool IsGemmFusible(const Instruction& gemm) const {
+    if (gemm->inputs.size() != 2U || gemm->outputs.size() != 1U || gemm->attrs.count("epilogue_activation") ||
+        gemm->outputs[0]->type != Float(32)) {
+      return false;
+    }
+    if (gemm->op_type == "matmul") {
+      bool trans_out = gemm->attrs.count("trans_out") && gemm.GetAttrs<bool>("trans_out");
+      auto a_dim     = gemm->inputs[0]->shape.size();
+      auto b_dim     = gemm->inputs[1]->shape.size();
+      return !trans_out && a_dim == b_dim && (a_dim == 2U || a_dim == 3U);
+    }
+    // mul flattens its inputs by x_num_col_dims and y_num_col_dims, only the plain 2-D case is handled.
+    return gemm->inputs[0]->shape.size() == 2U && gemm->inputs[1]->shape.size() == 2U;
+  }
+
+  bool FuseEpilogue(Program* prog, int gemm_idx, const std::unordered_set<std::string>& fetch_ids) {
+    auto& gemm = (*prog)[gemm_idx];
+    if (!IsGemmFusible(gemm)) {
+      return false;
+    }
+    // the bias is only supported by the 2-D packed gemm.
+    std::vector<int> shape = gemm->outputs[0]->shape;
+    bool bias_supported    = shape.size() == 2U;
+
+    float alpha    = gemm->attrs.count("alpha") ? gemm.GetAttrs<float>("alpha") : 1.0f;
+    int activation = cinn_gemm_activation_none;
+    Variable bias;
+    Variable out = gemm->outputs[0];
+    std::vector<_Instruction_*> fused_instrs;
+    while (activation == cinn_gemm_activation_none) {
+      int user_idx = GetOnlyUser(*prog, out, fetch_ids);
+      if (user_idx < 0) {
+        break;
+      }
+      auto& user = (*prog)[user_idx];
+      if (user->op_type == "scale") {
+        float scale      = user->attrs.count("scale") ? user.GetAttrs<float>("scale") : 1.0f;
+        float scale_bias = user->attrs.count("bias") ? user.GetAttrs<float>("bias") : 0.0f;
+        if (scale_bias != 0.0f || bias.get()) {
+          break;
+        }
+        alpha *= scale;
+      } else if (user->op_type == "elementwise_add") {
+        auto& other = user->inputs[0].get() == out.get() ? user->inputs[1] : user->inputs[0];
+        int axis    = user->attrs.count("axis") ? user.GetAttrs<int>("axis") : -1;
+        // the bias should be ready before the gemm runs.
+        bool bias_ready = GetProducer(other) < gemm_idx;
+        if (!bias_supported || bias.get() || other->shape != std::vector<int>{shape.back()} ||
+            (axis != -1 && axis != static_cast<int>(shape.size()) - 1) || !bias_ready) {
+          break;
+        }
+        bias = other;
+      } else if (user->op_type == "relu") {
+        activation = cinn_gemm_activation_relu;
+      } else if (user->op_type == "relu6") {
+        if (user->attrs.count("threshold") && user.GetAttrs<float>("threshold") != 6.0f) {
+          break;
+        }
+        activation = cinn_gemm_activation_relu6;
+      } else if (user->op_type == "sigmoid") {
+        activation = cinn_gemm_activation_sigmoid;
+      } else {
+        break;
+      }
+      fused_instrs.push_back(user.get());
+      out = user->outputs[0];
+    }
+    if (fused_instrs.empty()) {
+      return false;
+    }
+
+    VLOG(4) << "Fold " << fused_instrs.size() << " instructions into the epilogue of " << gemm;
+    if (bias.get()) {
+      gemm->inputs.push_back(bias);
+    }
+    gemm.SetAttr("alpha", alpha);
+    gemm.SetAttr("epilogue_activation", activation);
+    gemm->outputs[0] = out;
+    removed_instrs_.insert(fused_instrs.begin(), fused_instrs.end());
+    return true;
+  }
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(GemmEpilogueFusion) {
+  CINN_REGISTER_PROGRAM_PASS(GemmEpilogueFusion, fp::GemmEpilogueFusionPass);
+
+  return true;
+}
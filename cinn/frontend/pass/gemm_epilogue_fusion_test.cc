@@ -0,0 +1,105 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+
+namespace cinn::frontend {
+
+OptimizeConfig GemmEpilogueFusionConfig() {
+  return OptimizeConfig({{"RemoveIdentity"}, {"GemmEpilogueFusion"}},
+                        {{"OpFusionPass", "FusionMergePass"}, {"OpFusionPass", "FusionMergePass"}});
+}
+
+TEST(GemmEpilogueFusion, MatmulBiasRelu) {
+  if (IsCompiledWithCUDA()) {
+    return;
+  }
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto b       = builder.CreateInput(Float(32), {32, 24}, "B");
+  auto bias    = builder.CreateInput(Float(32), {24}, "Bias");
+  auto c       = builder.Matmul(a, b);
+  auto d       = builder.Add(c, bias);
+  auto out     = builder.Relu(d);
+  auto program = builder.Build();
+
+  common::Target target = common::DefaultHostTarget();
+  std::vector<std::string> input_ids{std::string(a.id()), std::string(b.id()), std::string(bias.id())};
+  CompareResult(&program, target, input_ids, {out->id}, 2, GemmEpilogueFusionConfig(), 123, true);
+}
+
+TEST(GemmEpilogueFusion, MulScaleBiasRelu) {
+  if (IsCompiledWithCUDA()) {
+    return;
+  }
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto b       = builder.CreateInput(Float(32), {32, 24}, "B");
+  auto bias    = builder.CreateInput(Float(32), {24}, "Bias");
+  auto c       = builder.Mul(a, b);
+  auto d       = builder.Scale(c, 0.5f);
+  auto e       = builder.Add(d, bias, 1);
+  auto out     = builder.Relu(e);
+  auto program = builder.Build();
+
+  common::Target target = common::DefaultHostTarget();
+  std::vector<std::string> input_ids{std::string(a.id()), std::string(b.id()), std::string(bias.id())};
+  CompareResult(&program, target, input_ids, {out->id}, 3, GemmEpilogueFusionConfig(), 123, true);
+}
+
+TEST(GemmEpilogueFusion, BatchedMatmulRelu) {
+  if (IsCompiledWithCUDA()) {
+    return;
+  }
+  // the residual add of shape [B, M, N] is not a bias, only the relu is folded into the batched gemm.
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {3, 8, 6}, "A");
+  auto b       = builder.CreateInput(Float(32), {3, 6, 7}, "B");
+  auto f       = builder.CreateInput(Float(32), {3, 8, 7}, "F");
+  auto c       = builder.Matmul(a, b);
+  auto d       = builder.Relu(c);
+  auto out     = builder.Add(d, f);
+  auto program = builder.Build();
+
+  common::Target target = common::DefaultHostTarget();
+  std::vector<std::string> input_ids{std::string(a.id()), std::string(b.id()), std::string(f.id())};
+  CompareResult(&program, target, input_ids, {out->id}, 1, GemmEpilogueFusionConfig(), 123, true);
+}
+
+TEST(GemmEpilogueFusion, FetchedOutputNotFused) {
+  if (IsCompiledWithCUDA()) {
+    return;
+  }
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto b       = builder.CreateInput(Float(32), {32, 24}, "B");
+  auto bias    = builder.CreateInput(Float(32), {24}, "Bias");
+  auto c       = builder.Matmul(a, b);
+  auto out     = builder.Add(c, bias);
+  auto program = builder.Build();
+
+  common::Target target = common::DefaultHostTarget();
+  std::vector<std::string> input_ids{std::string(a.id()), std::string(b.id()), std::string(bias.id())};
+  CompareResult(&program, target, input_ids, {c->id, out->id}, 0, GemmEpilogueFusionConfig(), 123, true);
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,102 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// InstrChainRewriterBase is the base of the passes folding a chain of instructions into one of them. It records the
+// producer and the number of uses of every variable, and rebuilds the program without the instructions folded away.
+class InstrChainRewriterBase : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void Clear() override {
+    removed_instrs_.clear();
+    output2instr_.clear();
+    var_used_count_.clear();
+  }
+
+  void CollectInfo(const Program& prog) {
+    for (int i = 0; i < prog.size(); ++i) {
+      auto& instr = prog[i];
+      for (auto& var : instr->outputs) {
+        output2instr_.emplace(var.get(), i);
+      }
+      for (auto& var : instr->inputs) {
+        var_used_count_[var.get()]++;
+      }
+    }
+  }
+
+  // Whether the var is used only once and not fetched, so that it can be removed after the rewriting.
+  bool IsIntermediate(const Variable& var, const std::unordered_set<std::string>& fetch_ids) const {
+    return !fetch_ids.count(var->id) && var_used_count_.count(var.get()) && var_used_count_.at(var.get()) == 1;
+  }
+
+  // Return the instruction producing the var, or -1 if the var is an input of the program.
+  int GetProducer(const Variable& var) const {
+    return output2instr_.count(var.get()) ? output2instr_.at(var.get()) : -1;
+  }
+
+  // Return the only instruction using the var, or -1 if the var is not an intermediate one.
+  int GetOnlyUser(const Program& prog, const Variable& var, const std::unordered_set<std::string>& fetch_ids) const {
+    if (!IsIntermediate(var, fetch_ids)) {
+      return -1;
+    }
+    for (int i = 0; i < prog.size(); ++i) {
+      for (auto& in : prog[i]->inputs) {
+        if (in.get() == var.get()) {
+          return i;
+        }
+      }
+    }
+    return -1;
+  }
+
+  // Rebuild the program without the instructions in removed_instrs_.
+  void RemoveInstructions(Program* prog, const std::string& builder_name) const {
+    NetBuilder builder(builder_name);
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (int i = 0; i < prog->size(); ++i) {
+      auto& instr = (*prog)[i];
+      if (!removed_instrs_.count(instr.get())) {
+        builder.AppendInstruction(instr);
+      }
+    }
+    *prog = builder.Build();
+  }
+
+  std::unordered_set<_Instruction_*> removed_instrs_;
+  std::unordered_map<_Variable_*, int> output2instr_;
+  std::unordered_map<_Variable_*, int> var_used_count_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
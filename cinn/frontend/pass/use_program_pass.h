@@ -22,7 +22,12 @@ CINN_USE_REGISTER(RemoveIdentity)
 CINN_USE_REGISTER(TransposeCollapsing)
 CINN_USE_REGISTER(TransposeFoldingInput)
 CINN_USE_REGISTER(GemmRewriter)
+CINN_USE_REGISTER(GemmEpilogueFusion)
 CINN_USE_REGISTER(TransposeFoldingOutput)
 CINN_USE_REGISTER(FillConstantRewriter)
 CINN_USE_REGISTER(FillConstantFolding)
 CINN_USE_REGISTER(CastCollapsing)
+CINN_USE_REGISTER(AlgebraicSimplifier)
+CINN_USE_REGISTER(CommonSubexpressionElimination)
+CINN_USE_REGISTER(BatchNormFolding)
+CINN_USE_REGISTER(FlashAttentionRewriter)
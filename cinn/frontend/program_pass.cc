@@ -16,6 +16,8 @@
 
 #include <unordered_set>
 
+#include "cinn/utils/profiler.h"
+
 namespace cinn {
 namespace frontend {
 
@@ -29,11 +31,14 @@ void ProgramPass::Apply(Program* prog,
     fpass.push_back(pass);
   }
   for (const auto* pass : fpass) {
+    utils::RecordEvent record_pass(pass->name(), utils::EventType::kProgram);
     int before = prog->size();
     VLOG(1) << "Before ApplyPass: " << pass->name();
     pass->ApplyImpl(prog, fetch_ids, target);
     const_cast<ProgramPass*>(pass)->Clear();
     int after = prog->size();
+    record_pass.AddArg("instructions_before", before);
+    record_pass.AddArg("instructions_after", after);
     VLOG(1) << "Apply " << pass->name() << " pass, program size: " << before << " -> " << after
             << ", diff: " << after - before;
   }
@@ -0,0 +1,186 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/hlir/framework/aot_compiler.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#include "cinn/utils/string.h"
+
+DECLARE_string(cinn_aot_runtime_library);
+DECLARE_string(cinn_aot_link_libraries);
+DECLARE_string(cinn_aot_cxx);
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+const char* kModelHeader = R"ROC(// Generated by CINN, do not edit.
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Create an instance of the model with its own buffers, returns NULL if the embedded params are invalid.
+void* model_create(void);
+
+// Run all the instructions of the model once.
+void model_run(void* model);
+
+// The memory of the buffer of the variable `name`, returns NULL if there is no such variable.
+void* model_get_data(void* model, const char* name);
+
+void model_destroy(void* model);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+)ROC";
+
+// The entry of the shared library, which embeds the param file and registers the kernels to the aot_runtime.
+std::string GenerateModelEntry(const std::string& name,
+                               const std::string& params_path,
+                               const std::vector<std::string>& fn_names) {
+  std::stringstream ss;
+  ss << "// Generated by CINN, do not edit.\n";
+  ss << "#include \"" << name << ".h\"\n\n";
+  ss << "extern \"C\" {\n";
+  ss << "void* load_program_from_memory(const void*, int, const char**, void**, int);\n";
+  ss << "void run_program(void*);\n";
+  ss << "void* get_buffer_memory(void*, const char*);\n";
+  ss << "void destroy_program(void*);\n\n";
+  for (auto& fn_name : fn_names) {
+    ss << "void " << fn_name << "(void*, int);\n";
+  }
+  ss << "\n__attribute__((visibility(\"hidden\"))) extern const char cinn_model_params_begin[];\n";
+  ss << "__attribute__((visibility(\"hidden\"))) extern const char cinn_model_params_end[];\n";
+  ss << "}\n\n";
+
+  ss << "__asm__(\".section .rodata\\n\"\n";
+  ss << "        \".balign 16\\n\"\n";
+  ss << "        \".hidden cinn_model_params_begin\\n\"\n";
+  ss << "        \".hidden cinn_model_params_end\\n\"\n";
+  ss << "        \"cinn_model_params_begin:\\n\"\n";
+  ss << "        \".incbin \\\"" << params_path << "\\\"\\n\"\n";
+  ss << "        \"cinn_model_params_end:\\n\"\n";
+  ss << "        \".previous\\n\");\n\n";
+
+  ss << "static const char* kSymbolNames[] = {\n";
+  for (auto& fn_name : fn_names) {
+    ss << "    \"" << fn_name << "\",\n";
+  }
+  ss << "};\n";
+  ss << "static void* kSymbolAddresses[] = {\n";
+  for (auto& fn_name : fn_names) {
+    ss << "    reinterpret_cast<void*>(&" << fn_name << "),\n";
+  }
+  ss << "};\n\n";
+
+  ss << "extern \"C\" {\n";
+  ss << "void* model_create(void) {\n";
+  ss << "  return load_program_from_memory(cinn_model_params_begin,\n";
+  ss << "                                  cinn_model_params_end - cinn_model_params_begin,\n";
+  ss << "                                  kSymbolNames,\n";
+  ss << "                                  kSymbolAddresses,\n";
+  ss << "                                  " << fn_names.size() << ");\n";
+  ss << "}\n\n";
+  ss << "void model_run(void* model) { run_program(model); }\n\n";
+  ss << "void* model_get_data(void* model, const char* name) { return get_buffer_memory(model, name); }\n\n";
+  ss << "void model_destroy(void* model) { destroy_program(model); }\n";
+  ss << "}\n";
+  return ss.str();
+}
+
+// Quote \p arg as a single word of the shell command.
+std::string ShellQuote(const std::string& arg) {
+  std::string quoted = "'";
+  for (char c : arg) {
+    if (c == '\'') {
+      quoted += "'\\''";
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "'";
+}
+
+void WriteFile(const std::string& path, const std::string& content) {
+  std::ofstream of(path);
+  CHECK(of.is_open()) << "Failed to open " << path;
+  of << content;
+}
+
+}  // namespace
+
+void ExportSharedLibrary(GraphCompiler* graph_compiler,
+                         Program* program,
+                         const std::vector<std::string>& persistent_vars,
+                         const std::string& output_dir,
+                         const std::string& name) {
+  CHECK(!FLAGS_cinn_aot_runtime_library.empty())
+      << "The flag cinn_aot_runtime_library should be set to the path of libaot_runtime.a first";
+  // the name is used in the generated code and the directory is embedded into the assembly by .incbin
+  auto is_identifier_char = [](unsigned char c) { return std::isalnum(c) || c == '_'; };
+  CHECK(!name.empty() && std::all_of(name.begin(), name.end(), is_identifier_char))
+      << "The name of the library should only contain letters, digits and underscores, but got: " << name;
+  CHECK(output_dir.find_first_of("\"\\\n") == std::string::npos)
+      << "The output directory should not contain quotes, backslashes or newlines, but got: " << output_dir;
+  std::vector<std::string> fn_names;
+  std::unordered_set<std::string> visited;
+  for (auto& instr : program->GetRunInstructions()) {
+    CHECK(instr->target_.arch == Target::Arch::X86) << "Only the programs on X86 can be compiled ahead of time";
+    for (auto& fn_name : instr->GetFnNames()) {
+      if (visited.insert(fn_name).second) {
+        fn_names.push_back(fn_name);
+      }
+    }
+  }
+
+  std::string prefix  = output_dir + "/" + name;
+  std::string library = output_dir + "/lib" + name + ".so";
+  program->Export(persistent_vars, prefix + ".params");
+  graph_compiler->ExportObject(prefix + ".o");
+  WriteFile(prefix + ".h", kModelHeader);
+  WriteFile(prefix + "_entry.cc", GenerateModelEntry(name, prefix + ".params", fn_names));
+
+  // the kernels call back into the aot_runtime to launch the parallel loops, which are run by OpenMP, and to compute
+  // the builtin extern functions. All the symbols should be resolved at link time, so the external libraries the
+  // runtime depends on are listed explicitly.
+  std::string command = FLAGS_cinn_aot_cxx + " -shared -fPIC -O2 -Wl,--no-undefined -o " + ShellQuote(library) + " " +
+                        ShellQuote(prefix + "_entry.cc") + " " + ShellQuote(prefix + ".o") + " " +
+                        ShellQuote(FLAGS_cinn_aot_runtime_library);
+  for (auto& lib : utils::Split(FLAGS_cinn_aot_link_libraries, ",")) {
+    if (!lib.empty()) command += " " + ShellQuote(lib);
+  }
+  command += " -fopenmp -ldl";
+  VLOG(3) << "Link the shared library: " << command;
+  CHECK_EQ(std::system(command.c_str()), 0) << "Failed to link the shared library " << library << " by: " << command;
+  LOG(INFO) << "The program is compiled ahead of time into " << library;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,54 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph_compiler.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * Compile \p program ahead of time into the shared library `<output_dir>/lib<name>.so` with the C header
+ * `<output_dir>/<name>.h`, so that it runs without LLVM and without any JIT at startup.
+ *
+ * The library links the kernels compiled by \p graph_compiler, the buffers of all the variables with the values of
+ * \p persistent_vars embedded as weights, and the aot_runtime, i.e. the tiny_runtime which allocates the other buffers
+ * and runs the instructions in order together with the builtin kernels the compiled code calls. It is linked without
+ * undefined symbols, so it only depends on the C/C++ runtime, OpenMP and FLAGS_cinn_aot_link_libraries. It is driven
+ * by the stable API declared in the header:
+ *
+ *   void* model_create(void);
+ *   void model_run(void* model);
+ *   void* model_get_data(void* model, const char* name);
+ *   void model_destroy(void* model);
+ *
+ * The program should have run once, so that all the buffers are sized and the persistent variables hold their values.
+ * The kernels must be compiled into one object, i.e. neither with FLAGS_cinn_tiered_jit nor with
+ * FLAGS_cinn_compile_num_threads other than 1. Only the X86 target is supported.
+ */
+void ExportSharedLibrary(GraphCompiler* graph_compiler,
+                         Program* program,
+                         const std::vector<std::string>& persistent_vars,
+                         const std::string& output_dir,
+                         const std::string& name = "model");
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,139 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/hlir/framework/aot_compiler.h"
+
+#include <dlfcn.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/optimize.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+using common::Float;
+
+// The undefined symbols of the CINN kernels and runtime in the shared library \p path, which should be resolved by
+// the library itself instead of the process loading it.
+std::string UndefinedCinnSymbols(const std::string& path) {
+  std::string symbols;
+  FILE* pipe = popen(("nm -D -u " + path + " | grep cinn_").c_str(), "r");
+  CHECK(pipe) << "Failed to run nm on " << path;
+  char line[512];
+  while (fgets(line, sizeof(line), pipe)) {
+    symbols += line;
+  }
+  pclose(pipe);
+  return symbols;
+}
+
+// Export \p program with the inputs \p persistent_vars embedded into the shared library, then feed \p input to it
+// and check the output \p output_id against the one computed by \p program.
+void CheckSharedLibrary(GraphCompiler* gc,
+                        Program* program,
+                        Scope* scope,
+                        const std::vector<std::string>& persistent_vars,
+                        const std::string& input,
+                        const std::string& output_id,
+                        const std::string& name) {
+  auto target = common::DefaultHostTarget();
+  ExportSharedLibrary(gc, program, persistent_vars, ".", name);
+  std::string library = "./lib" + name + ".so";
+  EXPECT_EQ(UndefinedCinnSymbols(library), "");
+
+  void* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+  ASSERT_NE(handle, nullptr) << dlerror();
+  auto model_create   = reinterpret_cast<void* (*)()>(dlsym(handle, "model_create"));
+  auto model_run      = reinterpret_cast<void (*)(void*)>(dlsym(handle, "model_run"));
+  auto model_get_data = reinterpret_cast<void* (*)(void*, const char*)>(dlsym(handle, "model_get_data"));
+  auto model_destroy  = reinterpret_cast<void (*)(void*)>(dlsym(handle, "model_destroy"));
+  ASSERT_TRUE(model_create && model_run && model_get_data && model_destroy);
+
+  void* model = model_create();
+  ASSERT_NE(model, nullptr);
+  EXPECT_EQ(model_get_data(model, "unknown"), nullptr);
+  auto input_data = GetTensorData<float>(scope->GetTensor(input), target);
+  std::memcpy(model_get_data(model, input.c_str()), input_data.data(), input_data.size() * sizeof(float));
+  model_run(model);
+
+  auto expect = GetTensorData<float>(scope->GetTensor(output_id), target);
+  auto* out   = reinterpret_cast<float*>(model_get_data(model, output_id.c_str()));
+  ASSERT_NE(out, nullptr);
+  for (int i = 0; i < expect.size(); ++i) {
+    ASSERT_NEAR(out[i], expect[i], 1e-5);
+  }
+
+  model_destroy(model);
+  dlclose(handle);
+}
+
+TEST(AOTCompiler, ExportSharedLibrary) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto b = builder.CreateInput(Float(32), {32}, "B");
+  auto c = builder.Add(a, b, 1);
+  auto d = builder.Relu(c);
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = frontend::Optimize(&program, {}, target);
+  auto scope   = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  SetRandData<float>(scope->GetTensor("A"), target);
+  SetRandData<float>(scope->GetTensor("B"), target);
+  runtime_program->Execute();
+
+  // B is embedded as a weight, A is fed to the library
+  CheckSharedLibrary(&gc, runtime_program.get(), scope.get(), {"B"}, "A", d->id, "aot_model");
+}
+
+TEST(AOTCompiler, ExportMatmul) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto b = builder.CreateInput(Float(32), {32, 24}, "B");
+  auto c = builder.Matmul(a, b);
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = frontend::Optimize(&program, {}, target);
+  auto scope   = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  SetRandData<float>(scope->GetTensor("A"), target);
+  SetRandData<float>(scope->GetTensor("B"), target);
+  runtime_program->Execute();
+
+  // the gemm kernel is called as an extern function, which should be linked into the library from the aot_runtime
+  CheckSharedLibrary(&gc, runtime_program.get(), scope.get(), {"B"}, "A", c->id, "aot_matmul");
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
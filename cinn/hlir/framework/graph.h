@@ -97,6 +97,8 @@ class Graph : public cinn::common::Graph {
     std::vector<std::shared_ptr<Group>> fused_sub_groups;
     // if as sub-group, used for belong groups.
     std::unordered_set<std::shared_ptr<Group>, SharedGroupHasher, SharedGroupComparator> belong_groups;
+    // independent groups packed into one kernel by horizontal fusion pass, lowered one by one.
+    std::vector<std::shared_ptr<Group>> horizontal_groups;
 
     // for op lowering.
     std::vector<std::string> input_names;
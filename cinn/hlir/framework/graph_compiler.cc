@@ -17,20 +17,32 @@
 #include <absl/container/flat_hash_map.h>
 
 #include <memory>
+#include <numeric>
 #include <unordered_set>
 
 #include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/common/arena.h"
 #include "cinn/common/context.h"
 #include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/op_flops.h"
 #include "cinn/hlir/framework/op_lowering.h"
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/pe/schedule.h"
+#include "cinn/ir/ir_compare.h"
+#include "cinn/ir/ir_mutator.h"
 #include "cinn/lang/lower.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 #include "cinn/poly/stage.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/profiler.h"
 
 DECLARE_bool(cinn_ir_schedule);
 DECLARE_int32(cinn_parallel_compile_size);
+DECLARE_bool(cinn_inplace_buffer_reuse);
+DECLARE_bool(cinn_ir_arena);
+DECLARE_string(cinn_compile_profile_path);
+DECLARE_string(cinn_runtime_profile_path);
+DECLARE_bool(cinn_tiered_jit);
 
 namespace cinn {
 namespace hlir {
@@ -73,7 +85,10 @@ Program::Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_pt
   }
 }
 
+Program::~Program() { utils::SaveProgramEventsReport(FLAGS_cinn_runtime_profile_path, this); }
+
 void Program::PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  utils::ScopedEventOwner event_owner(this);
   for (auto& ins : prerun_instrs_) {
     ins->Run(name2podargs);
   }
@@ -208,6 +223,7 @@ void Program::Export(const std::vector<std::string>& persistent_vars, const std:
 }
 
 void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache) {
+  utils::ScopedEventOwner event_owner(this);
   for (auto& ins : instrs_) {
     ins->Run(name2podargs, false, stream, use_cache);
   }
@@ -220,6 +236,7 @@ void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podarg
 }
 
 void Program::ExecuteTest(int repeat_) {
+  utils::ScopedEventOwner event_owner(this);
   cinn::utils::Timer timer1;
   for (int i = 0; i < 100; i++) {
     for (auto& ins : instrs_) {
@@ -705,6 +722,18 @@ void GraphCompiler::CompileOptions::Apply(const auto_schedule::TuningResult& tun
 GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::CompileOptions& options,
                                                       std::unordered_set<std::string>&& fetch_var_ids,
                                                       void* stream) {
+  // the IR built during this compilation is allocated from one arena, which is freed once all of it has died.
+  std::unique_ptr<common::ArenaScope> arena_scope;
+  if (FLAGS_cinn_ir_arena) {
+    // the tiered JIT recompiles the functions in a background thread
+    bool single_threaded =
+        !FLAGS_cinn_parallel_compile_size && utils::GetCompileThreadNum() == 1 && !FLAGS_cinn_tiered_jit;
+    arena_scope          = std::make_unique<common::ArenaScope>(single_threaded);
+  }
+  // the report covers the passes run since the last build, and is saved after the event of this build is recorded.
+  utils::ScopedEventsReport events_report(FLAGS_cinn_compile_profile_path);
+  utils::RecordEvent record_build("GraphCompiler::Build", utils::EventType::kCompile);
+
   if (FLAGS_cinn_parallel_compile_size) {
     if (options.with_instantiate_variables) {
       VLOG(3) << "Initantiate all variables on compile-time";
@@ -713,7 +742,7 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
         auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
         auto& tensor = absl::get<Tensor>(*var);
         if (reuse_vars_map_.count(name)) {
-          auto src_var_name = reuse_vars_map_.at(name);
+          auto src_var_name = GetReuseRoot(std::string({name.data(), name.size()}));
           auto* src_var     = scope_->Var<Tensor>(src_var_name);
           auto& src_tensor  = absl::get<Tensor>(*src_var);
           tensor->set_buffer(src_tensor->get_buffer());
@@ -781,13 +810,23 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
       auto& dtype_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
       auto& shape_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
 
-      OpLowerer op_lowerer(dtype_dict, shape_dict, target_);
       for (auto& group : graph_->fusion_groups) {
         VLOG(3) << "group_id is : " << group->group_id << ", and its number is : " << group->nodes.size();
         groups.push_back(std::move(group->CollectNodes()));
-        local_lowered_funcs.emplace_back(std::move(op_lowerer.Lower(group)));
-        CHECK_EQ(local_lowered_funcs.back().size(), 1) << "Lowerd Function Is Not Equal 1!";
-        VLOG(3) << local_lowered_funcs.back()[0];
+      }
+      // the groups are lowered independently, so they are lowered by multiple threads if
+      // FLAGS_cinn_compile_num_threads is set.
+      int num_groups = graph_->fusion_groups.size();
+      local_lowered_funcs.resize(num_groups);
+      auto lower_group = [&](int idx) {
+        OpLowerer op_lowerer(dtype_dict, shape_dict, target_);
+        local_lowered_funcs[idx] = op_lowerer.Lower(graph_->fusion_groups[idx]);
+        CHECK_EQ(local_lowered_funcs[idx].size(), 1) << "Lowerd Function Is Not Equal 1!";
+      };
+      utils::parallel_run(
+          lower_group, utils::SequenceDispatcher(0, num_groups), utils::GetCompileThreadNum(num_groups));
+      for (auto& lowered_func : local_lowered_funcs) {
+        VLOG(3) << lowered_func[0];
       }
     } else {
       VLOG(3) << "fusion_groups is empty";
@@ -829,6 +868,7 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   auto build_module = m_builder_.Build();
   VLOG(3) << "End of m_builder_.Build()";
   if (this->target_.arch == Target::Arch::X86) {
+    utils::RecordEvent record_codegen("CodeGenCX86", utils::EventType::kCodeGen);
     CodeGenCX86 codegen(this->target_, CodeGenCX86::Feature::AVX512);
     codegen.SetInlineBuiltinCodes(false);
     auto out = codegen.Compile(build_module, CodeGenC::OutputKind::CImpl);
@@ -840,6 +880,10 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   auto instructions = BuildInstructions(groups, options.groups.empty() ? graph_->fusion_groups : options.groups);
 
   VLOG(3) << "End of BuildInstructions";
+  // the buffers are only shared when the variables are instantiated here
+  if (options.with_instantiate_variables && FLAGS_cinn_inplace_buffer_reuse) {
+    AnalyzeInplaceReuse(groups, lowered_funcs, instructions);
+  }
   if (options.remove_unused_variables) {
     RemoveInvalidVariables(instructions);
   }
@@ -855,7 +899,7 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
       auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
       auto& tensor = absl::get<Tensor>(*var);
       if (reuse_vars_map_.count(name)) {
-        auto src_var_name = reuse_vars_map_.at(name);
+        auto src_var_name = GetReuseRoot(std::string({name.data(), name.size()}));
         auto* src_var     = scope_->Var<Tensor>(src_var_name);
         auto& src_tensor  = absl::get<Tensor>(*src_var);
         tensor->set_buffer(src_tensor->get_buffer());
@@ -865,6 +909,11 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
     }
   }
 
+  if (arena_scope) {
+    record_build.AddArg("arena_allocations", arena_scope->arena()->num_allocations());
+    record_build.AddArg("arena_bytes", arena_scope->arena()->allocated_bytes());
+  }
+
   GraphCompiler::CompilationResult result;
   result.runtime_program.reset(new Program(scope_, std::move(instructions)));
   return result;
@@ -1186,10 +1235,12 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
       // So try to find the rest kernel, if it exist.
       SetSubKernels(instr.get(), fuse_name);
 
+      // the fused instruction can only be pre_run if all the fused nodes are pre_run.
+      instr->pre_run = true;
       for (int j = 0; j < group.size(); j++) {
         auto node = group[j];
-        if (node->attrs.attr_store.count("pre_run") && absl::get<bool>(node->attrs.attr_store["pre_run"]) == true) {
-          instr->pre_run = true;
+        if (!node->attrs.attr_store.count("pre_run") || !absl::get<bool>(node->attrs.attr_store["pre_run"])) {
+          instr->pre_run = false;
         }
       }
       // explicitly call Finalize of the instruction after all assignments on it were done
@@ -1197,6 +1248,19 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
       instructions.push_back(std::move(instr));
     }
   }
+  auto& shape_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  for (int idx = 0; idx < groups.size(); ++idx) {
+    instructions[idx]->estimated_flops = EstimateFlops(groups[idx], shape_dict);
+  }
+  if (FLAGS_cinn_tiered_jit) {
+    for (auto& instr : instructions) {
+      std::vector<backends::TieredFunction*> tiered_fns;
+      for (auto& fn_name : instr->GetFnNames()) {
+        tiered_fns.push_back(compiler_->LookupTiered(fn_name));
+      }
+      instr->SetTieredFuncs(std::move(tiered_fns));
+    }
+  }
   return instructions;
 }
 
@@ -1240,6 +1304,156 @@ void GraphCompiler::RemoveInvalidVariables(const std::vector<std::unique_ptr<Ins
   });
 }
 
+std::string GraphCompiler::GetReuseRoot(const std::string& name) const {
+  auto root = name;
+  while (reuse_vars_map_.count(root)) {
+    root = reuse_vars_map_.at(root);
+  }
+  return root;
+}
+
+namespace {
+
+// Check whether the output can be computed in place into the buffer of the input: each element of the input should
+// only be loaded by the store writing the same element of the output, so it is dead before being overwritten.
+class InplaceSafetyChecker : public ir::IRMutator<> {
+ public:
+  InplaceSafetyChecker(const std::string& input, const std::string& output) : input_(input), output_(output) {}
+
+  bool operator()(Expr* expr) {
+    ir::IRMutator<>::Visit(expr, expr);
+    return safe_ && has_store_;
+  }
+
+ private:
+  static bool IsTensor(const Expr& tensor, const std::string& name) {
+    auto* tensor_node = tensor.As<ir::_Tensor_>();
+    return tensor_node && tensor_node->name == name;
+  }
+
+  void Visit(const ir::Store* op, Expr* expr) override {
+    if (IsTensor(op->tensor, input_)) {
+      safe_ = false;
+      return;
+    }
+    if (!IsTensor(op->tensor, output_)) {
+      ir::IRMutator<>::Visit(op, expr);
+      return;
+    }
+    has_store_ = true;
+    // the loads in indices are visited out of the store, so an indirect access of the input is not in place
+    auto* node = expr->As<ir::Store>();
+    for (auto& index : node->indices) {
+      ir::IRMutator<>::Visit(&index, &index);
+    }
+    store_index_ = op->index();
+    ir::IRMutator<>::Visit(&node->value, &node->value);
+    store_index_ = Expr();
+  }
+
+  void Visit(const ir::Load* op, Expr* expr) override {
+    if (IsTensor(op->tensor, input_) &&
+        (!store_index_.defined() || !ir::IrEqualVisitor().Compare(op->index(), store_index_))) {
+      safe_ = false;
+    }
+    ir::IRMutator<>::Visit(op, expr);
+  }
+
+  const std::string& input_;
+  const std::string& output_;
+  Expr store_index_;
+  bool has_store_ = false;
+  bool safe_      = true;
+};
+
+}  // namespace
+
+void GraphCompiler::AnalyzeInplaceReuse(const std::vector<std::vector<Node*>>& groups,
+                                        const std::vector<std::vector<ir::LoweredFunc>>& lowered_funcs,
+                                        const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  CHECK_EQ(groups.size(), instructions.size());
+  CHECK_EQ(lowered_funcs.size(), instructions.size());
+  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+
+  // the buffers can be overwritten only if they are produced by an instruction running every time and not fetched,
+  // the feeds, parameters and the results of PreRun are kept.
+  std::unordered_set<std::string> produced_roots, kept_roots;
+  // the last step reading or writing the buffer
+  absl::flat_hash_map<std::string, int> last_used;
+  for (int step = 0; step < instructions.size(); ++step) {
+    for (const auto& args : instructions[step]->GetInArgs()) {
+      for (const auto& name : args) {
+        last_used[GetReuseRoot(name)] = step;
+      }
+    }
+    for (const auto& args : instructions[step]->GetOutArgs()) {
+      for (const auto& name : args) {
+        auto root       = GetReuseRoot(name);
+        last_used[root] = step;
+        if (instructions[step]->pre_run) {
+          kept_roots.insert(root);
+        } else {
+          produced_roots.insert(root);
+        }
+      }
+    }
+  }
+  for (const auto& name : fetch_var_ids_) {
+    kept_roots.insert(GetReuseRoot(name));
+  }
+
+  auto get_bytes = [this](const std::string& name) -> int64_t {
+    auto* var = scope_->FindVar(name);
+    if (!var) {
+      return -1;
+    }
+    auto& tensor = absl::get<Tensor>(*var);
+    return tensor->shape().numel() * tensor->type().bytes();
+  };
+
+  int reused_num = 0;
+  for (int step = 0; step < instructions.size(); ++step) {
+    auto& instr = instructions[step];
+    if (instr->pre_run || instr->GetFnNames().size() != 1 || lowered_funcs[step].size() != 1) {
+      continue;
+    }
+    // only the ops computing each output element from the input elements independently can be in place
+    auto kind = std::accumulate(groups[step].begin(), groups[step].end(), 0, [&](int kind, const Node* node) {
+      return std::max<int>(kind, op_pattern_dict.Find(node->op()) ? op_pattern_dict[node->op()] : kNonFusible);
+    });
+    if (kind > kInjective) {
+      continue;
+    }
+
+    std::unordered_set<std::string> reused_roots;
+    auto body = lowered_funcs[step].front()->body;
+    for (const auto& out : instr->GetOutArgs().front()) {
+      if (reuse_vars_map_.count(out) || get_bytes(out) <= 0) {
+        continue;
+      }
+      for (const auto& in : instr->GetInArgs().front()) {
+        auto root = GetReuseRoot(in);
+        if (reused_roots.count(root) || !produced_roots.count(root) || kept_roots.count(root) ||
+            last_used.at(root) != step || get_bytes(in) != get_bytes(out) ||
+            !InplaceSafetyChecker(in, out)(&body)) {
+          continue;
+        }
+        VLOG(3) << "The output " << out << " of " << instr->GetFnNames().front() << " reuses the buffer of " << in;
+        reuse_vars_map_[out] = in;
+        reused_roots.insert(root);
+        // the buffer of input lives as long as the output now
+        last_used[root] = std::max(last_used.at(root), last_used.at(out));
+        if (kept_roots.count(out)) {
+          kept_roots.insert(root);
+        }
+        ++reused_num;
+        break;
+      }
+    }
+  }
+  VLOG(3) << reused_num << " outputs are computed in place into the buffers of their inputs";
+}
+
 static void BufferMallocWithCallback(void* args, int num_args) {
   cinn_pod_value_t* pod_args = static_cast<cinn_pod_value_t*>(args);
   for (int i = 0; i < num_args; ++i) {
@@ -1265,18 +1479,21 @@ void GraphCompiler::AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<In
   for (auto step = 0; step < instructions.size(); ++step) {
     const auto& instr = instructions.at(step);
 
+    // the variables sharing a buffer are handled as their root variable owning the buffer
     for (const auto& args : instr->GetInArgs()) {
       for (const auto& var_name : args) {
+        auto root = GetReuseRoot(var_name);
         // use try_emplace to record the first time a variable appearance
-        variable_first_used.try_emplace(var_name, step);
+        variable_first_used.try_emplace(root, step);
         // will update until last time a variable used
-        variable_last_used[var_name] = step;
+        variable_last_used[root] = step;
       }
     }
     for (const auto& args : instr->GetOutArgs()) {
       for (const auto& var_name : args) {
-        variable_first_used.try_emplace(var_name, step);
-        variable_last_used[var_name] = step;
+        auto root = GetReuseRoot(var_name);
+        variable_first_used.try_emplace(root, step);
+        variable_last_used[root] = step;
       }
     }
   }
@@ -52,6 +52,9 @@ class Program {
    */
   Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_ptr<Instruction>>&& instrs);
 
+  //! Save the report of the instructions run by this program if FLAGS_cinn_runtime_profile_path is set.
+  ~Program();
+
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr);
 
   void Export(const std::vector<std::string>& persistent_vars, const std::string& filename);
@@ -114,7 +117,10 @@ class GraphCompiler final {
   CompilationResult Build(const CompileOptions& options,
                           std::unordered_set<std::string>&& fetch_var_ids = {},
                           void* stream                                    = nullptr);
-  void ExportObject(const std::string& path) { compiler_->ExportObject(path); }
+  void ExportObject(const std::string& path) {
+    CHECK(compiler_) << "No object to export, the programs built by the ParallelCompiler are not linked as one module";
+    compiler_->ExportObject(path);
+  }
 
   std::unique_ptr<Program> Build(const std::string& code = "");
 
@@ -165,6 +171,16 @@ class GraphCompiler final {
   // applying on variables after no instruction will use them anymore
   void InsertBufferHandlers(std::vector<std::unique_ptr<Instruction>>* instructions);
 
+  // compute the outputs of the elementwise, broadcast and injective instructions in place into the buffer of an input
+  // which is not used after them, if the lowered function only loads each element of the input where it stores the
+  // same element of the output.
+  void AnalyzeInplaceReuse(const std::vector<std::vector<Node*>>& groups,
+                           const std::vector<std::vector<ir::LoweredFunc>>& lowered_funcs,
+                           const std::vector<std::unique_ptr<Instruction>>& instructions);
+
+  // the variable owning the buffer shared by the variable `name`, it is `name` itself if the buffer is not shared
+  std::string GetReuseRoot(const std::string& name) const;
+
  private:
   // parallel compiler
   std::shared_ptr<ParallelCompiler> parallel_compiler_;
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/optimize.h"
 #include "cinn/frontend/program_pass.h"
@@ -117,6 +119,41 @@ TEST(GraphCompilerTest, TestInsertBufferHandlers) {
             used_variable_names);
 }
 
+TEST(GraphCompilerTest, TestInplaceReuse) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto b = builder.Exp(a);
+  auto c = builder.Relu(b);
+  auto d = builder.Scale(c, 2.0f);
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  // run the ops one by one without fusion
+  auto graph = Optimize(&program, {d->id}, target, frontend::OptimizeOptions());
+  auto scope = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  auto runtime_program               = gc.Build(options, {d->id}).runtime_program;
+
+  // the input A is fed and kept, the others are computed in place into the buffer of b
+  auto a_tensor = scope->GetTensor(static_cast<frontend::Variable>(a)->id);
+  auto b_tensor = scope->GetTensor(b->id);
+  auto d_tensor = scope->GetTensor(d->id);
+  EXPECT_NE(a_tensor->get_buffer(), b_tensor->get_buffer());
+  EXPECT_EQ(b_tensor->get_buffer(), scope->GetTensor(c->id)->get_buffer());
+  EXPECT_EQ(b_tensor->get_buffer(), d_tensor->get_buffer());
+
+  SetRandData<float>(a_tensor, target);
+  runtime_program->Execute();
+  auto a_data = GetTensorData<float>(a_tensor, target);
+  auto d_data = GetTensorData<float>(d_tensor, target);
+  for (int i = 0; i < a_data.size(); ++i) {
+    ASSERT_NEAR(d_data[i], 2.0f * std::exp(a_data[i]), 1e-5 * (1 + d_data[i]));
+  }
+}
+
 #ifdef CINN_WITH_CUDA
 std::vector<float> test_mul(
     const std::vector<float>& A, const std::vector<float>& B, int M, int K, int N, bool trans_a, bool trans_b) {
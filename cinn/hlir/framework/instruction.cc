@@ -70,7 +70,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
                       bool dryrun,
                       void* stream,
                       bool use_cache) {
-  utils::RecordEvent record_run(function_name_);
+  utils::RecordEvent record_run(function_name_, utils::EventType::kInstruction);
   CHECK(finalized_flag_) << "Instruction must be finalized before run";
   if (function_name_ == "no_run") {
     VLOG(2) << "skip instruction";
@@ -80,11 +80,22 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
   VLOG(2) << "Run function " << function_name_;
 
   {
-    utils::RecordEvent record_args("PrepareArgs");
+    utils::RecordEvent record_args("PrepareArgs", utils::EventType::kInstruction);
     if (!use_cache || args_cached_.size() != size()) {
       UpdateArgsCache(name2podargs);
     }
   }
+  if (record_run.recorded()) {
+    record_run.AddArg("flops", static_cast<int64_t>(estimated_flops));
+    record_run.AddArg("bytes", ArgsBytes());
+  }
+
+  // the functions of the tiered JIT are switched to their optimized versions once ready
+  for (int idx = 0; idx < tiered_fns_.size(); ++idx) {
+    if (tiered_fns_[idx]) {
+      fn_ptrs_[idx] = tiered_fns_[idx]->Call();
+    }
+  }
 
   utils::ProfilerRangePush("Compute");
 #if defined(CINN_WITH_CUDA) && !defined(CINN_WITH_CUDNN)
@@ -217,6 +228,13 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
 #endif
   utils::ProfilerRangePop();
 
+#ifdef CINN_WITH_CUDA
+  // the kernels are launched asynchronously, wait for them to measure the time of this instruction.
+  if (record_run.recorded() && !dryrun && target_.arch == Target::Arch::NVGPU) {
+    CUDA_CALL(cudaStreamSynchronize(static_cast<cudaStream_t>(stream)));
+  }
+#endif
+
   if (FLAGS_cinn_self_check_accuracy) {
     CheckResults(name2podargs, stream);
   }
@@ -229,6 +247,19 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
   //   }
 }
 
+int64_t Instruction::ArgsBytes() const {
+  int64_t bytes = 0;
+  for (auto& pod_args : args_cached_) {
+    for (auto& pod_arg : pod_args) {
+      if (pod_arg.type_code() == ::cinn_type_code<cinn_buffer_t*>()) {
+        cinn_buffer_t* buffer = pod_arg;
+        bytes                += buffer->num_elements() * buffer->type.bytes();
+      }
+    }
+  }
+  return bytes;
+}
+
 void Instruction::CheckResults(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream) {
 #ifdef CINN_WITH_CUDA
   cudaStreamSynchronize(static_cast<cudaStream_t>(stream));
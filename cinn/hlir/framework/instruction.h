@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "cinn/backends/cuda_util.h"
+#include "cinn/backends/llvm/tiered_jit.h"
 #include "cinn/hlir/framework/scope.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/runtime/cuda/cuda_util.h"
@@ -64,6 +65,15 @@ class Instruction {
     fn_names_.push_back(name);
   }
 
+  /**
+   * Set the functions compiled by the tiered JIT, one for each LoweredFunc or null if it is not compiled by the
+   * tiered JIT. Their calls are counted and they are switched to the optimized versions by Run once ready.
+   */
+  void SetTieredFuncs(std::vector<backends::TieredFunction*> tiered_fns) {
+    CHECK_EQ(tiered_fns.size(), fn_ptrs_.size());
+    tiered_fns_ = std::move(tiered_fns);
+  }
+
   // explicitly finalize the instruction, and can't append function again after call it
   void Finalize();
 
@@ -112,6 +122,9 @@ class Instruction {
       out_args_.erase(out_args_.begin() + flag);
       fn_ptrs_.erase(fn_ptrs_.begin() + flag);
       fn_names_.erase(fn_names_.begin() + flag);
+      if (!tiered_fns_.empty()) {
+        tiered_fns_.erase(tiered_fns_.begin() + flag);
+      }
     }
   }
 
@@ -128,9 +141,13 @@ class Instruction {
   std::vector<std::string> str_attrs;
   bool pre_run = false;
   Target target_;
+  //! The FLOPs estimated from the ops of this instruction, used to report the achieved GFLOP/s when profiling.
+  double estimated_flops = 0;
 
  protected:
   void CheckResults(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr, void* stream = nullptr);
+  //! The total size in bytes of the buffers read and written by this instruction.
+  int64_t ArgsBytes() const;
 
  private:
   bool finalized_flag_ = false;
@@ -142,6 +159,7 @@ class Instruction {
   std::vector<std::vector<cinn_pod_value_t>> args_cached_;
 
   std::vector<void*> fn_ptrs_{};
+  std::vector<backends::TieredFunction*> tiered_fns_;
   std::vector<std::string> fn_names_;
 };
 
@@ -178,6 +178,27 @@ NodeData* InsertGraphOpNodeBefore(
   return input_node_out;
 }
 
+void ReplaceGraphOpNodeInput(Node* op_node, NodeData* old_data, NodeData* new_data) {
+  CHECK(op_node);
+  CHECK(old_data);
+  CHECK(new_data);
+  std::vector<common::GraphNode*> old_sources;
+  for (auto& link : op_node->inlinks_in_order(true)) {
+    auto* source = link->source();
+    // unlink and relink afterwards to make sure the order
+    source->UnLinkSingleTo(op_node);
+    old_sources.push_back(source);
+  }
+  for (auto* source : old_sources) {
+    if (source == old_data) {
+      new_data->LinkTo(op_node);
+    } else {
+      source->LinkTo(op_node);
+    }
+  }
+  op_node->inlinks_in_order(true);
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -208,6 +208,8 @@ NodeData *InsertGraphOpNodeAfter(
 // insert op_node before out_data
 NodeData *InsertGraphOpNodeBefore(
     common::Graph *graph, Node *insert_node, Node *input_node, NodeData *dst_data, int pos);
+// replace the input old_data of op_node with new_data, keeping the order of the inputs
+void ReplaceGraphOpNodeInput(Node *op_node, NodeData *old_data, NodeData *new_data);
 
 }  // namespace framework
 }  // namespace hlir
@@ -22,6 +22,7 @@
 #include <memory>
 #include <mutex>  //NOLINT
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -243,6 +244,13 @@ bool OpValueType<ValueType>::Find(const Operator* op) const {
   CINN_STR_CONCAT(CINN_REGISTER_VAR_DEF(OpName), __COUNTER__) = \
       ::cinn::hlir::framework::OpRegistry::Global()->__REGISTER_OR_GET__(#OpName)
 
+//! Whether the op generates different outputs in each run even with the same inputs and attributes, e.g. the random
+//! ops, so that it should be neither merged with another one, evaluated in advance nor recomputed.
+inline bool IsNondeterministicOp(const std::string& op_name) {
+  static const std::unordered_set<std::string> nondeterministic_ops = {"gaussian_random", "uniform_random", "randint"};
+  return nondeterministic_ops.count(op_name);
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -0,0 +1,110 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/hlir/framework/op_flops.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+double Numel(const shape_t& shape) {
+  return std::accumulate(shape.begin(), shape.end(), 1.0, std::multiplies<double>());
+}
+
+template <typename T>
+T GetNodeAttr(const Node* node, const std::string& key, T default_value) {
+  auto iter = node->attrs.attr_store.find(key);
+  if (iter == node->attrs.attr_store.end()) {
+    return default_value;
+  }
+  const T* value = absl::get_if<T>(&iter->second);
+  return value ? *value : default_value;
+}
+
+double NodeFlops(const Node* node, const absl::flat_hash_map<std::string, shape_t>& shape_dict) {
+  std::vector<shape_t> in_shapes, out_shapes;
+  for (auto& link : node->inlinks_in_order()) {
+    auto* data = link->source()->safe_as<NodeData>();
+    if (data && shape_dict.count(data->id())) {
+      in_shapes.push_back(shape_dict.at(data->id()));
+    }
+  }
+  for (auto& link : node->outlinks_in_order()) {
+    auto* data = link->sink()->safe_as<NodeData>();
+    if (data && shape_dict.count(data->id())) {
+      out_shapes.push_back(shape_dict.at(data->id()));
+    }
+  }
+  if (out_shapes.empty()) {
+    return 0;
+  }
+
+  const std::string& op_name = node->op()->name;
+  double out_numel           = Numel(out_shapes[0]);
+  if ((op_name == "matmul" || op_name == "cublas_matmul" || op_name == "cublas_gemm") && in_shapes.size() >= 2 &&
+      !in_shapes[0].empty()) {
+    const auto& a_shape = in_shapes[0];
+    bool trans_a        = GetNodeAttr<bool>(node, "trans_a", false);
+    int k               = a_shape.size() == 1 ? a_shape[0] : (trans_a ? a_shape[a_shape.size() - 2] : a_shape.back());
+    return 2.0 * out_numel * k;
+  }
+  if (op_name == "mul" && in_shapes.size() >= 2) {
+    const auto& a_shape = in_shapes[0];
+    int x_num_col_dims  = GetNodeAttr<int>(node, "x_num_col_dims", 1);
+    double k            = 1;
+    for (int i = x_num_col_dims; i < a_shape.size(); ++i) {
+      k *= a_shape[i];
+    }
+    return 2.0 * out_numel * k;
+  }
+  if ((op_name == "conv2d" || op_name == "depthwise_conv2d") && in_shapes.size() >= 2 && !in_shapes[1].empty() &&
+      in_shapes[1][0] > 0) {
+    // the weight is [out_channels, in_channels / groups, kernel_h, kernel_w], so each output element reduces over
+    // all the weights of its output channel.
+    const auto& w_shape = in_shapes[1];
+    return 2.0 * out_numel * Numel(w_shape) / w_shape[0];
+  }
+
+  double numel = 0;
+  for (auto& shape : in_shapes) {
+    numel = std::max(numel, Numel(shape));
+  }
+  for (auto& shape : out_shapes) {
+    numel = std::max(numel, Numel(shape));
+  }
+  return numel;
+}
+
+}  // namespace
+
+double EstimateFlops(const std::vector<Node*>& nodes, const absl::flat_hash_map<std::string, shape_t>& shape_dict) {
+  double flops = 0;
+  for (auto* node : nodes) {
+    if (node && node->op()) {
+      flops += NodeFlops(node, shape_dict);
+    }
+  }
+  return flops;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
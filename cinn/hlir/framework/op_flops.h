@@ -0,0 +1,39 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * Estimate the floating point operations of running the nodes once, which is reported with the measured time by the
+ * runtime profiler. The matrix multiplications and convolutions count a multiply and an add for each element of the
+ * reduction, the other ops count one operation for each element of the largest of their inputs and outputs.
+ */
+double EstimateFlops(const std::vector<Node*>& nodes, const absl::flat_hash_map<std::string, shape_t>& shape_dict);
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -14,7 +14,10 @@
 
 #include "cinn/hlir/framework/op_lowering.h"
 
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/optim/ir_copy.h"
 #include "cinn/optim/transform_gpu_forloop.h"
+#include "cinn/utils/profiler.h"
 
 DECLARE_bool(cinn_ir_schedule);
 
@@ -104,6 +107,7 @@ std::vector<ir::LoweredFunc> OpLowerer::LowerWithoutSchedule(GroupPtr& group) {
 }
 
 std::vector<ir::LoweredFunc> OpLowerer::Lower(GroupPtr& group) {
+  utils::RecordEvent record_lower("OpLowerer::Lower", utils::EventType::kLower, group->GetFuncName());
   VLOG(3) << "Lowering Group : " << group->group_id << " , Op Pattern : " << group->op_pattern_kind;
   if (FLAGS_cinn_ir_schedule) {
     switch (group->op_pattern_kind) {
@@ -226,33 +230,48 @@ std::vector<ir::LoweredFunc> OpLowerer::IRLowerOp(IRComputeFunction compute,
   poly::StageMap stages;
   std::vector<ir::Tensor> arg_tensors;
   std::unordered_map<std::string, ir::Tensor> tensor_map;
+  // the groups packed by horizontal fusion are computed and scheduled one by one.
+  std::vector<GroupPtr> lower_groups = group->horizontal_groups;
+  if (lower_groups.empty()) {
+    lower_groups.push_back(group);
+  }
   // do compute.
   VLOG(3) << "group->fused_sub_groups.size() is : " << group->fused_sub_groups.size();
   std::vector<Expr> ast_exprs;
-  if (group->fused_sub_groups.size() == 0) {
-    ast_exprs = (this->*compute)(stages, arg_tensors, tensor_map, group, group, /*apply_impl_schedule = */ true);
-  } else {
-    for (auto& sub_group : group->fused_sub_groups) {
-      auto exprs = (this->*compute)(stages, arg_tensors, tensor_map, group, sub_group, /*apply_impl_schedule = */ true);
+  for (auto& lower_group : lower_groups) {
+    if (lower_group->fused_sub_groups.size() == 0) {
+      auto exprs = (this->*compute)(
+          stages, arg_tensors, tensor_map, lower_group, lower_group, /*apply_impl_schedule = */ true);
       ast_exprs.insert(ast_exprs.end(), exprs.begin(), exprs.end());
+    } else {
+      for (auto& sub_group : lower_group->fused_sub_groups) {
+        auto exprs = (this->*compute)(
+            stages, arg_tensors, tensor_map, lower_group, sub_group, /*apply_impl_schedule = */ true);
+        ast_exprs.insert(ast_exprs.end(), exprs.begin(), exprs.end());
+      }
     }
   }
   ir::ModuleExpr mod_expr(ast_exprs);
   ir::IRSchedule ir_sch(mod_expr);
   ir_sch.MergeExprs();
 
-  Node* first  = nullptr;
-  Node* second = nullptr;
   // do schedule.
   VLOG(3) << "Before IRLowerOp schedule, ir is: \n" << ir_sch.GetModule().GetExprs().at(0);
-  if (group->fused_sub_groups.size() == 0) {
-    (this->*schedule)(ir_sch, tensor_map, group, group, first, second);
-  } else {
-    // do schedule from back to front.
-    for (int idx = group->fused_sub_groups.size() - 1; idx >= 0; --idx) {
-      (this->*schedule)(ir_sch, tensor_map, group, group->fused_sub_groups[idx], first, second);
+  for (auto& lower_group : lower_groups) {
+    Node* first  = nullptr;
+    Node* second = nullptr;
+    if (lower_group->fused_sub_groups.size() == 0) {
+      (this->*schedule)(ir_sch, tensor_map, lower_group, lower_group, first, second);
+    } else {
+      // do schedule from back to front.
+      for (int idx = lower_group->fused_sub_groups.size() - 1; idx >= 0; --idx) {
+        (this->*schedule)(ir_sch, tensor_map, lower_group, lower_group->fused_sub_groups[idx], first, second);
+      }
     }
   }
+  if (group->horizontal_groups.size()) {
+    IRHorizontalFuse(ir_sch, group);
+  }
   VLOG(3) << "After IRLowerOp schedule, ir is: \n" << ir_sch.GetModule().GetExprs().at(0);
   // function args
   group->input_names.clear();
@@ -298,6 +317,101 @@ std::vector<ir::LoweredFunc> OpLowerer::IRLowerOp(IRComputeFunction compute,
   return {func};
 }
 
+void OpLowerer::IRHorizontalFuse(ir::IRSchedule& ir_sch, const GroupPtr& group) {
+  auto exprs = ir_sch.GetModule().GetExprs();
+  CHECK_EQ(exprs.size(), 1U);
+  CHECK(exprs[0].As<ir::Block>());
+  auto* root_realize = exprs[0].As<ir::Block>()->stmts[0].As<ir::ScheduleBlockRealize>();
+  CHECK(root_realize);
+  auto* root_block = root_realize->schedule_block.As<ir::ScheduleBlock>();
+  CHECK(root_block);
+
+  // collect the outermost loops, each packed group should be computed at the loop nest of its master node.
+  std::vector<Expr> loops;
+  std::function<void(const Expr&)> collect_loops = [&](const Expr& expr) {
+    if (expr.As<ir::Block>()) {
+      for (auto& stmt : expr.As<ir::Block>()->stmts) {
+        collect_loops(stmt);
+      }
+    } else {
+      loops.push_back(expr);
+    }
+  };
+  collect_loops(root_block->body);
+  if (loops.size() != group->horizontal_groups.size()) {
+    VLOG(3) << "Packed groups are not computed at one loop nest each, skip merging loops of " << group->group_id;
+    return;
+  }
+
+  // the merged loop is bound to blockIdx.x on gpu and is parallel on host.
+  bool is_gpu         = target_ == common::DefaultNVGPUTarget();
+  auto is_merged_loop = [is_gpu](const Expr* expr) {
+    auto* loop = expr->As<ir::For>();
+    return loop && (is_gpu ? loop->for_type() == ir::ForType::GPUBlock : loop->is_parallel());
+  };
+
+  ir::Var index("horizontal_i");
+  std::vector<int> offsets;
+  std::vector<Expr> bodies;
+  int extent = 0;
+  for (auto& loop : loops) {
+    auto* for_node = loop.As<ir::For>();
+    if (!for_node || !common::is_zero(for_node->min) || !for_node->extent.is_constant()) {
+      VLOG(3) << "Can't merge the outermost loop of " << loop;
+      return;
+    }
+
+    Expr body;
+    offsets.push_back(extent);
+    if (is_gpu ? (for_node->for_type() == ir::ForType::GPUBlock && for_node->bind_info().offset == 0)
+               : (for_node->is_serial() || for_node->is_parallel())) {
+      // dispatch the range [offset, offset + extent) of the merged loop to the loop nest.
+      body = optim::IRCopy(for_node->body);
+      ir::ReplaceExpr(&body, {for_node->loop_var}, {Expr(index) - Expr(extent)});
+      extent += for_node->extent.as_int32();
+    } else if (is_gpu) {
+      // the loop nest only bound to threads is dispatched to one block.
+      body    = loop;
+      extent += 1;
+    } else {
+      VLOG(3) << "Can't merge the outermost loop of " << loop;
+      return;
+    }
+
+    if (!ir::CollectIRNodesWithoutTensor(body, is_merged_loop).empty()) {
+      VLOG(3) << "Can't merge the loop nest with a nested block or parallel loop : " << loop;
+      return;
+    }
+    bodies.push_back(body);
+  }
+
+  Expr dispatch = bodies.back();
+  for (int idx = bodies.size() - 2; idx >= 0; --idx) {
+    dispatch = ir::IfThenElse::Make(ir::LT::Make(Expr(index), Expr(offsets[idx + 1])), bodies[idx], dispatch);
+  }
+
+  Expr merged_loop;
+  if (is_gpu) {
+    merged_loop = ir::For::Make(index,
+                                Expr(0),
+                                Expr(extent),
+                                ir::ForType::GPUBlock,
+                                ir::DeviceAPI::GPU,
+                                ir::Block::Make({dispatch}),
+                                ir::VectorizeInfo(),
+                                ir::BindInfo(ir::ForType::GPUBlock, 0, ir::DeviceAPI::GPU));
+  } else {
+    merged_loop = ir::For::Make(index,
+                                Expr(0),
+                                Expr(extent),
+                                ir::ForType::Parallel,
+                                loops[0].As<ir::For>()->device_api,
+                                ir::Block::Make({dispatch}));
+  }
+  root_block->body = ir::Block::Make({merged_loop});
+  VLOG(3) << "Merge " << bodies.size() << " loop nests of " << group->group_id << " into one loop of " << extent;
+}
+
 // fusion op lowering
 std::vector<ir::LoweredFunc> OpLowerer::LowerOp(ComputeFunction compute, ScheduleFunction schedule, GroupPtr& group) {
   poly::StageMap stages;
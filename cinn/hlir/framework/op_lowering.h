@@ -77,6 +77,8 @@ class OpLowerer {
   std::vector<ir::LoweredFunc> IRLowerOp(IRComputeFunction, IRScheduleFunction, GroupPtr&);
   std::vector<ir::LoweredFunc> IRLowerNonFusibleOp(GroupPtr&, bool);
   std::vector<ir::LoweredFunc> IRLowerOpWithoutSchedule(IRComputeFunction, GroupPtr&);
+  // merge the outermost loops of the groups packed by horizontal fusion into one loop with a dispatch index.
+  void IRHorizontalFuse(ir::IRSchedule& ir_sch, const GroupPtr& group);
 #define DEFINE_IR_COMPUTE_SCHDULE(type)                                                        \
   std::vector<Expr> IR##type##Compute(poly::StageMap& stages,                                  \
                                       std::vector<ir::Tensor>& func_args,                      \
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <thread>
 
 #include "cinn/backends/codegen_cuda_dev.h"
@@ -24,12 +25,15 @@
 #include "cinn/backends/llvm/codegen_x86.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/common/arena.h"
 #include "cinn/common/context.h"
+#include "cinn/hlir/framework/op_flops.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/ir/module.h"
 
 DECLARE_int32(cinn_parallel_compile_size);
 DECLARE_string(cinn_source_code_save_path);
+DECLARE_bool(cinn_ir_arena);
 
 namespace cinn {
 namespace hlir {
@@ -80,6 +84,12 @@ void ParallelCompiler::SplitTask() {
 
 void RunTask(ParallelCompiler::Task* task) {
   VLOG(2) << "Stark run sub-task, Thread Id : " << std::this_thread::get_id();
+  // each worker allocates from its own arena, the results are merged by the main thread so the IR is not
+  // single-threaded.
+  std::unique_ptr<common::ArenaScope> arena_scope;
+  if (FLAGS_cinn_ir_arena) {
+    arena_scope = std::make_unique<common::ArenaScope>(/*single_threaded=*/false);
+  }
   task->Lowering();
   task->CodegenAndJit();
   task->BuildInstruction();
@@ -208,6 +218,8 @@ void ParallelCompiler::Task::BuildInstruction() {
     auto fn_ptr = engine->Lookup(group->GetFuncName());
     CHECK(fn_ptr) << "Can't find jit function : " << group->GetFuncName();
     instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), group->GetFuncName());
+    instr->estimated_flops =
+        EstimateFlops(group->CollectNodes(), graph->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape"));
 
     instr->Finalize();
     instructions.push_back(std::move(instr));
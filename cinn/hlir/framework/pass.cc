@@ -15,6 +15,7 @@
 #include "cinn/hlir/framework/pass.h"
 
 #include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/profiler.h"
 
 namespace cinn {
 namespace hlir {
@@ -37,7 +38,11 @@ void ApplyPasses(Graph* g, const std::vector<std::string>& passes) {
         CHECK(!pass_dep) << "And the attribute is provided by pass [" << pass_dep->name << "].";
       }
     }
+    utils::RecordEvent record_pass(r->name, utils::EventType::kGraph);
+    record_pass.AddArg("nodes_before", g->num_nodes());
     r->body(g);
+    record_pass.AddArg("nodes_after", g->num_nodes());
+    record_pass.AddArg("fusion_groups_after", g->fusion_groups.size());
   }
 }
 
@@ -14,7 +14,9 @@
 
 #include "cinn/hlir/pe/nn.h"
 
+#include <algorithm>
 #include <functional>
+#include <numeric>
 
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -23,6 +25,7 @@
 #include "cinn/hlir/pe/broadcast.h"
 #include "cinn/hlir/pe/elementwise.h"
 #include "cinn/hlir/pe/ir_schedule_pe.h"
+#include "cinn/hlir/pe/nn_util.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/layout.h"
@@ -154,6 +157,21 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
   CHECK_EQ(conv_type, "forward") << "cudnn is not found, backward_data/backward_filter is not supported!";
 #endif
 
+  // compute the 3x3 convs with stride 1 by winograd on x86, the weight is transformed in the kernel here, AlterLayout
+  // replaces the op by conv2d_winograd so that the constant weight is transformed only once.
+  bool use_winograd      = false;
+  int winograd_tile_size = 2;
+  if (target.arch == Target::Arch::X86 && data_format == "NCHW" && conv_type == "forward" && !use_mkldnn &&
+      inputs.size() == 2U && inputs[0]->shape.size() == 4U && inputs[1]->shape.size() == 4U) {
+    use_winograd = pe::UseWinogradConv2dCPU(ToPodVector<int>(inputs[0]->shape),
+                                            ToPodVector<int>(inputs[1]->shape),
+                                            padding,
+                                            stride,
+                                            dilation,
+                                            groups);
+    winograd_tile_size = pe::GetWinogradTileSizeCPU(output_shapes[0][2], output_shapes[0][3]);
+  }
+
   framework::CINNCompute conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
     std::vector<CINNValue> res;
     CHECK(!args.empty()) << "The input argument of conv2d compute is empty! Please check.\n";
@@ -177,7 +195,13 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
     }
     if (data_format == "NCHW") {
       // A is input: [N, C, H, W], B is filter: [C_out, C_in/group, filter_h, filter_w]
-      if (target.arch == Target::Arch::X86) {
+      if (use_winograd) {
+        auto kernel_pack = pe::Conv2d_Winograd_Weight_Transform(
+            B.as_tensor_ref(), winograd_tile_size, UniqName("winograd_kernel_pack"));
+        out = pe::Conv2d_Winograd_NCHW_CPU(
+            A.as_tensor_ref(), kernel_pack, padding[0], padding[1], winograd_tile_size, tensor_name);
+        out.push_back(kernel_pack);
+      } else if (target.arch == Target::Arch::X86) {
         if (groups == 1 && !use_mkldnn) {
           out = pe::Conv2d_NCHW_5D(A.as_tensor_ref(),
                                    B.as_tensor_ref(),
@@ -257,8 +281,8 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
       stages->InsertLazily(t);
       res.push_back(CINNValue(t));
     }
-    CHECK(out.size() == 3U || out.size() == 2U || out.size() == 5U || out.size() == 12U)
-        << "The output tensor sizes of conv2d op in conv2d op should be 2 or 3 or 5\n";
+    CHECK(out.size() == 3U || out.size() == 2U || out.size() == 5U || out.size() == 6U || out.size() == 12U)
+        << "The output tensor sizes of conv2d op in conv2d op should be 2 or 3 or 5 or 6\n";
 
     res.push_back(CINNValue(stages));
     *ret = CINNValuePack{res};
@@ -303,13 +327,20 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
           CINN_NOT_IMPLEMENTED
         }
       } else if (target.arch == Target::Arch::X86) {
+        if (use_winograd) {
+          pe::IRConv2dWinogradScheduleCPU(ir_sch, target);
+          std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
+          *ret = CINNValuePack{res};
+          return;
+        }
         CINN_NOT_IMPLEMENTED
       }
       LOG(FATAL) << "This target [" << target << "] is not supported yet.";
     } else {
       CHECK(!args.empty()) << "The input argument of conv2d schedule is empty! Please check.\n";
       CINNValuePack arg_pack = args[0];
-      CHECK(arg_pack.size() == 4UL || arg_pack.size() == 3UL || arg_pack.size() == 6UL || arg_pack.size() == 13UL);
+      CHECK(arg_pack.size() == 4UL || arg_pack.size() == 3UL || arg_pack.size() == 6UL || arg_pack.size() == 7UL ||
+            arg_pack.size() == 13UL);
       poly::StageMap stages = arg_pack.back();
       if (target.arch == Target::Arch::NVGPU) {
 #ifdef CINN_WITH_CUDNN
@@ -387,7 +418,28 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
           return;
         }
       } else if (target.arch == Target::Arch::X86) {
-        if (arg_pack.size() == 6UL) {
+        if (use_winograd) {
+          CHECK_EQ(arg_pack.size(), 7UL);
+          Expr res         = arg_pack[0];
+          Expr inverse     = arg_pack[1];
+          Expr bgemm       = arg_pack[2];
+          Expr data_pack   = arg_pack[3];
+          Expr input_pad   = arg_pack[4];
+          Expr kernel_pack = arg_pack[5];
+          pe::Conv2d_Winograd_Schedule_CPU(stages,
+                                           res.as_tensor_ref(),
+                                           inverse.as_tensor_ref(),
+                                           bgemm.as_tensor_ref(),
+                                           data_pack.as_tensor_ref(),
+                                           input_pad.as_tensor_ref(),
+                                           target);
+          // kernel_pack: [eps, nu, ci, co] -> [ci, co, eps, nu]
+          stages[kernel_pack.as_tensor_ref()]->Reorder(std::vector<int>{2, 3, 0, 1});
+          stages[kernel_pack.as_tensor_ref()]->Unroll(3);
+          stages[kernel_pack.as_tensor_ref()]->Unroll(2);
+          *ret = CINNValuePack{{arg_pack[0], CINNValue(stages)}};
+          return;
+        } else if (arg_pack.size() == 6UL) {
           Expr res              = arg_pack[0];
           Expr packed_out       = arg_pack[1];
           Expr weights_dilation = arg_pack[2];
@@ -792,6 +844,217 @@ std::vector<Type> InferDtypeForConv2dNCHWc(const std::vector<Type> &inputs_type,
   return res;
 }
 
+std::shared_ptr<OpStrategy> StrategyForWinogradWeightTransform(const framework::NodeAttr &attrs,
+                                                               const std::vector<ir::Tensor> &inputs,
+                                                               const std::vector<Type> &out_type,
+                                                               const std::vector<std::vector<int>> &output_shapes,
+                                                               const Target &target) {
+  CHECK(attrs.attr_store.count("tile_size")) << "winograd_weight_transform op finds no tile_size attr";
+  int tile_size = absl::get<int>(attrs.attr_store.at("tile_size"));
+  framework::CINNCompute transform_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of winograd_weight_transform compute is empty! Please check.\n";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 1U) << "at least 1 input tensor for winograd_weight_transform compute\n";
+    Expr A = pack_args[0];
+    CHECK(A.as_tensor());
+    std::string tensor_name = UniqName("Winograd_Weight_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(pack_args.size(), 2);
+      CHECK(pack_args[1].is_string());
+      tensor_name = pack_args[1].operator std::string();
+    }
+    auto out    = pe::Conv2d_Winograd_Weight_Transform(A.as_tensor_ref(), tile_size, tensor_name);
+    auto stages = CreateStages({A.as_tensor_ref(), out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  framework::CINNSchedule transform_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of winograd_weight_transform schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    // out: [eps, nu, ci, co] -> [ci, co, eps, nu], unroll the tile positions to fold the transform coefficients
+    if (FLAGS_cinn_ir_schedule) {
+      std::vector<Expr> vec_ast;
+      for (int i = 0; i < arg_pack.size(); i++) {
+        if (arg_pack[i].is_expr()) {
+          Expr temp = arg_pack[i];
+          vec_ast.emplace_back(temp);
+        }
+      }
+      CHECK(!vec_ast.empty());
+      ir::ModuleExpr mod_expr(vec_ast);
+      ir::IRSchedule ir_sch(mod_expr);
+      ir_sch.MergeExprs();
+      auto all_blocks = ir_sch.GetAllBlocks();
+      auto loops      = ir_sch.GetLoops(all_blocks[0]);
+      CHECK_EQ(loops.size(), 4U);
+      ir_sch.Reorder({loops[2], loops[3], loops[0], loops[1]});
+      loops = ir_sch.GetLoops(all_blocks[0]);
+      ir_sch.Unroll(loops[3]);
+      loops = ir_sch.GetLoops(all_blocks[0]);
+      ir_sch.Unroll(loops[2]);
+      std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
+      *ret = CINNValuePack{res};
+    } else {
+      CHECK_EQ(arg_pack.size(), 2UL);
+      Expr out              = arg_pack[0];
+      poly::StageMap stages = arg_pack[1];
+      CHECK(out.as_tensor());
+      stages[out.as_tensor_ref()]->Reorder(std::vector<int>{2, 3, 0, 1});
+      stages[out.as_tensor_ref()]->Unroll(3);
+      stages[out.as_tensor_ref()]->Unroll(2);
+      *ret = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+    }
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of winograd_weight_transform op is empty! Please check.";
+  strategy->AddImpl(transform_compute, transform_schedule, "strategy.winograd_weight_transform.x86", 1);
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForWinogradWeightTransform(const std::vector<shape_t> &inputs_shape,
+                                                          const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The input's shape size should be 1! Please check again.";
+  CHECK_EQ(inputs_shape[0].size(), 4U) << "The weight of winograd_weight_transform should be 4-D(OIHW).";
+  CHECK(attrs.count("tile_size")) << "winograd_weight_transform op finds no tile_size attr";
+  int tile_size = absl::get<int>(attrs.at("tile_size"));
+  int alpha     = tile_size + inputs_shape[0][2] - 1;
+  return {{alpha, alpha, inputs_shape[0][1], inputs_shape[0][0]}};
+}
+
+std::vector<Type> InferDtypeForWinogradWeightTransform(const std::vector<Type> &inputs_type,
+                                                       const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0]};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForWinogradWeightTransform(
+    const std::vector<framework::shape_t> &input_shapes,
+    const std::vector<std::string> &input_layouts,
+    const framework::NodeAttr &attrs,
+    const Target &target) {
+  CHECK_EQ(input_layouts.size(), 1U) << "The input's layouts size is not 1! Please check again.";
+  return {{""}, input_layouts};
+}
+
+std::shared_ptr<OpStrategy> StrategyForConv2dWinograd(const framework::NodeAttr &attrs,
+                                                      const std::vector<ir::Tensor> &inputs,
+                                                      const std::vector<Type> &out_type,
+                                                      const std::vector<std::vector<int>> &output_shapes,
+                                                      const Target &target) {
+  std::vector<int> padding({0, 0});
+  if (attrs.attr_store.find("padding") != attrs.attr_store.end()) {
+    padding = absl::get<std::vector<int>>(attrs.attr_store.at("padding"));
+  }
+  CHECK(attrs.attr_store.count("tile_size")) << "conv2d_winograd op finds no tile_size attr";
+  int tile_size = absl::get<int>(attrs.attr_store.at("tile_size"));
+  CHECK(target.arch == Target::Arch::X86) << "conv2d_winograd op is only used in x86";
+
+  framework::CINNCompute conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of conv2d_winograd compute is empty! Please check.\n";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 2U) << "at least 2 input tensors for conv2d_winograd compute\n";
+    Expr A = pack_args[0];
+    Expr B = pack_args[1];
+    CHECK(A.as_tensor());
+    CHECK(B.as_tensor());
+    CHECK_EQ(padding.size(), 2) << "The size of padding in conv2d_winograd op is not 2! Please check.";
+    std::string tensor_name = UniqName("Conv2d_winograd_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(pack_args.size(), 3);
+      CHECK(pack_args[2].is_string());
+      tensor_name = pack_args[2].operator std::string();
+    }
+    // A is input: [N, C, H, W], B is the transformed filter: [alpha, alpha, C_in, C_out]
+    auto out = pe::Conv2d_Winograd_NCHW_CPU(
+        A.as_tensor_ref(), B.as_tensor_ref(), padding[0], padding[1], tile_size, tensor_name);
+    auto stages = CreateStages({A.as_tensor_ref(), B.as_tensor_ref()});
+
+    std::vector<CINNValue> res;
+    CHECK_EQ(out.size(), 5U) << "The output tensor sizes of conv2d_winograd op should be 5\n";
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule conv2d_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of conv2d_winograd schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    if (FLAGS_cinn_ir_schedule) {
+      std::vector<Expr> vec_ast;
+      for (int i = 0; i < arg_pack.size(); i++) {
+        if (arg_pack[i].is_expr()) {
+          Expr temp = arg_pack[i];
+          vec_ast.emplace_back(temp);
+        }
+      }
+      CHECK(!vec_ast.empty());
+      ir::ModuleExpr mod_expr(vec_ast);
+      ir::IRSchedule ir_sch(mod_expr);
+      ir_sch.MergeExprs();
+      pe::IRConv2dWinogradScheduleCPU(ir_sch, target);
+      std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
+      *ret = CINNValuePack{res};
+    } else {
+      CHECK_EQ(arg_pack.size(), 6UL);
+      Expr res              = arg_pack[0];
+      Expr inverse          = arg_pack[1];
+      Expr bgemm            = arg_pack[2];
+      Expr data_pack        = arg_pack[3];
+      Expr input_pad        = arg_pack[4];
+      poly::StageMap stages = arg_pack.back();
+      pe::Conv2d_Winograd_Schedule_CPU(stages,
+                                       res.as_tensor_ref(),
+                                       inverse.as_tensor_ref(),
+                                       bgemm.as_tensor_ref(),
+                                       data_pack.as_tensor_ref(),
+                                       input_pad.as_tensor_ref(),
+                                       target);
+      *ret = CINNValuePack{{arg_pack[0], CINNValue(stages)}};
+    }
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of conv2d_winograd op is empty! Please check.";
+  strategy->AddImpl(conv2d_compute, conv2d_schedule, "strategy.conv2d_winograd.x86", 1);
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForConv2dWinograd(const std::vector<shape_t> &inputs_shape,
+                                                 const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The input's shape size should be 2! Please check again.";
+  CHECK_EQ(inputs_shape[0].size(), 4U) << "The input of conv2d_winograd should be 4-D(NCHW).";
+  CHECK_EQ(inputs_shape[1].size(), 4U) << "The transformed weight of conv2d_winograd should be 4-D.";
+  std::vector<int> padding({0, 0});
+  if (attrs.find("padding") != attrs.end()) {
+    padding = absl::get<std::vector<int>>(attrs.at("padding"));
+  }
+  CHECK(attrs.count("tile_size")) << "conv2d_winograd op finds no tile_size attr";
+  int tile_size = absl::get<int>(attrs.at("tile_size"));
+  // the transformed weight is [alpha, alpha, C_in, C_out] with alpha = tile_size + kernel_size - 1
+  int kernel_size = inputs_shape[1][0] - tile_size + 1;
+  int out_shape_h = inputs_shape[0][2] + 2 * padding[0] - kernel_size + 1;
+  int out_shape_w = inputs_shape[0][3] + 2 * padding[1] - kernel_size + 1;
+  return {{inputs_shape[0][0], inputs_shape[1][3], out_shape_h, out_shape_w}};
+}
+
+std::vector<Type> InferDtypeForConv2dWinograd(const std::vector<Type> &inputs_type,
+                                              const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0]};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForConv2dWinograd(const std::vector<framework::shape_t> &input_shapes,
+                                                                   const std::vector<std::string> &input_layouts,
+                                                                   const framework::NodeAttr &attrs,
+                                                                   const Target &target) {
+  CHECK_EQ(input_layouts.size(), 2U) << "The input's layouts size is not 2! Please check again.";
+  return {{"NCHW"}, input_layouts};
+}
+
 std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr &attrs,
                                                        const std::vector<ir::Tensor> &inputs,
                                                        const std::vector<Type> &out_type,
@@ -1996,6 +2259,139 @@ std::vector<std::vector<std::string>> InferLayoutForSoftmax(const std::vector<fr
   return {{input_layouts[0], input_layouts[0]}, input_layouts};
 }
 
+// Flatten the leading dimensions of the attention inputs into one batch dimension.
+std::vector<int> GetAttentionShape3D(const std::vector<int> &shape) {
+  CHECK_GE(shape.size(), 2U) << "The inputs of flash_attention should be at least 2-D! Please check.";
+  int batch = std::accumulate(shape.begin(), shape.end() - 2, 1, std::multiplies<int>());
+  return {batch, shape[shape.size() - 2], shape.back()};
+}
+
+std::shared_ptr<OpStrategy> StrategyForFlashAttention(const framework::NodeAttr &attrs,
+                                                      const std::vector<ir::Tensor> &inputs,
+                                                      const std::vector<Type> &out_type,
+                                                      const std::vector<std::vector<int>> &output_shapes,
+                                                      const Target &target) {
+  float scale = GetAttr(attrs.attr_store, "scale", 1.0f);
+  CHECK(target.arch == Target::Arch::X86) << "flash_attention is only supported on x86! Please check.";
+  CHECK_EQ(inputs.size(), 3U) << "The input tensors of flash_attention should be Q, K and V! Please check.";
+
+  const auto &output_shape = output_shapes[0];
+  std::vector<std::vector<int>> new_shapes;
+  for (auto &input : inputs) {
+    new_shapes.push_back(GetAttentionShape3D(ToPodVector<int>(input->shape)));
+  }
+
+  framework::CINNCompute attention_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of flash_attention compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 3U) << "3 input tensors for flash_attention compute";
+    std::vector<ir::Tensor> tensors;
+    for (int i = 0; i < 3; ++i) {
+      Expr tensor = pack_args[i];
+      CHECK(tensor.as_tensor());
+      tensors.push_back(tensor.as_tensor_ref());
+    }
+
+    std::string tensor_name = UniqName("FlashAttention_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(pack_args.size(), 4U);
+      CHECK(pack_args[3].is_string());
+      tensor_name = pack_args[3].operator std::string();
+    }
+
+    auto stages = CreateStages(tensors);
+    std::vector<ir::Tensor> new_tensors;
+    for (int i = 0; i < 3; ++i) {
+      new_tensors.push_back(tensors[i]->Reshape(ToCinnExprs(new_shapes[i]), stages));
+    }
+    auto out = pe::FlashAttention(new_tensors[0], new_tensors[1], new_tensors[2], scale, tensor_name, target);
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+    }
+    out[0]->Reshape(ToCinnExprs(output_shape), stages);
+
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule attention_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of flash_attention schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    // the tiling is done by the extern kernel, there is nothing to schedule.
+    if (FLAGS_cinn_ir_schedule) {
+      std::vector<Expr> vec_ast;
+      for (int i = 0; i < arg_pack.size(); i++) {
+        if (arg_pack[i].is_expr()) {
+          Expr temp = arg_pack[i];
+          vec_ast.emplace_back(temp);
+        }
+      }
+      CHECK(!vec_ast.empty());
+      ir::ModuleExpr mod_expr(vec_ast);
+      ir::IRSchedule ir_sch(mod_expr);
+      ir_sch.MergeExprs();
+      std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
+      *ret = CINNValuePack{res};
+    } else {
+      CHECK_EQ(arg_pack.size(), 3UL);
+      *ret = arg_pack;
+    }
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(attention_compute, attention_schedule, "strategy.flash_attention.x86", 1);
+
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForFlashAttention(const std::vector<shape_t> &inputs_shape,
+                                                 const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 3U) << "The inputs of flash_attention should be Q, K and V! Please check again.";
+  const auto &q_shape = inputs_shape[0];
+  const auto &k_shape = inputs_shape[1];
+  const auto &v_shape = inputs_shape[2];
+  CHECK(q_shape.size() >= 2U && q_shape.size() == k_shape.size() && q_shape.size() == v_shape.size())
+      << "The inputs of flash_attention should have the same rank, which is at least 2! Please check again.";
+  CHECK(std::equal(q_shape.begin(), q_shape.end() - 2, k_shape.begin()) &&
+        std::equal(q_shape.begin(), q_shape.end() - 2, v_shape.begin()))
+      << "The batch dimensions of Q, K and V should be the same! Please check again.";
+  CHECK_EQ(q_shape.back(), k_shape.back()) << "The head_dim of Q and K should be the same! Please check again.";
+  CHECK_EQ(k_shape[k_shape.size() - 2], v_shape[v_shape.size() - 2])
+      << "The sequence length of K and V should be the same! Please check again.";
+
+  shape_t output_shape = q_shape;
+  output_shape.back()  = v_shape.back();
+  return {output_shape};
+}
+
+std::vector<Type> InferDtypeForFlashAttention(const std::vector<Type> &inputs_type,
+                                              const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 3U) << "The inputs of flash_attention should be Q, K and V! Please check again.";
+  for (auto &type : inputs_type) {
+    CHECK_EQ(type, Float(32)) << "flash_attention only supports float32! Please check again.";
+  }
+  return {inputs_type[0]};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForFlashAttention(const std::vector<framework::shape_t> &input_shapes,
+                                                                  const std::vector<std::string> &input_layouts,
+                                                                  const framework::NodeAttr &attrs,
+                                                                  const Target &target) {
+  CHECK_EQ(input_layouts.size(), 3U) << "The input's layouts size is not 3! Please check again.";
+  std::vector<std::string> new_input_layouts = input_layouts;
+  for (int i = 0; i < input_shapes.size(); i++) {
+    if (input_shapes[i].size() > 4) {
+      // alter input layout back
+      new_input_layouts[i] = "NCHW";
+    }
+  }
+  return {{""}, new_input_layouts};
+}
+
 std::shared_ptr<OpStrategy> StrategyForDropoutInfer(const framework::NodeAttr &attrs,
                                                     const std::vector<ir::Tensor> &inputs,
                                                     const std::vector<Type> &out_type,
@@ -2292,6 +2688,33 @@ CINN_REGISTER_HELPER(nn_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOutFusible)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(winograd_weight_transform)
+      .describe("Transform the 4-D weight of a 3x3 convolution for the winograd algorithm on x86.")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy",
+                                                         cinn::hlir::op::StrategyForWinogradWeightTransform)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForWinogradWeightTransform))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForWinogradWeightTransform))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForWinogradWeightTransform))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(conv2d_winograd)
+      .describe("Do a 2-D convolution with an NCHW layout by winograd algorithm on x86. Weight is the transformed one.")
+      .set_num_inputs(2)  // here we consider filter as another input
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForConv2dWinograd)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForConv2dWinograd))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForConv2dWinograd))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForConv2dWinograd))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(depthwise_conv2d)
       .describe("Do a 2-D depthwise convolution with an NCHW/NHWC layout.")
       .set_num_inputs(2)  // here we consider filter as another input
@@ -2374,6 +2797,19 @@ CINN_REGISTER_HELPER(nn_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(flash_attention)
+      .describe("This operator computes the fused attention softmax(scale * Q * K^T) * V.")
+      .set_num_inputs(3)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForFlashAttention)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForFlashAttention))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForFlashAttention))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForFlashAttention))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(dropout_infer)
       .describe("Downgrade the outcome at inference or keep the same.")
       .set_num_inputs(1)
@@ -30,6 +30,7 @@
 #include "cinn/utils/string.h"
 
 DECLARE_bool(cinn_ir_schedule);
+DECLARE_bool(cinn_use_packed_gemm);
 
 namespace cinn {
 namespace hlir {
@@ -50,6 +51,13 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
   bool trans_a           = GetAttr(attr_store, "trans_a", false);
   bool trans_b           = GetAttr(attr_store, "trans_b", false);
   float alpha            = GetAttr(attr_store, "alpha", 1.0f);
+  // the bias and activation folded by the GemmEpilogueFusion pass, which are only supported by the packed gemm.
+  int activation    = GetAttr(attr_store, "epilogue_activation", 0);
+  bool has_bias     = inputs.size() == 3UL;
+  bool has_epilogue = activation != 0 || has_bias;
+
+  // the packed gemm only computes in fp32, the other types fall back to MatmulV2.
+  bool use_packed_gemm = FLAGS_cinn_use_packed_gemm && inputs[0]->type() == Float(32) && inputs[1]->type() == Float(32);
 
   const auto &shape_A = ToPodVector<int>(inputs[0]->shape);
   const auto &shape_B = ToPodVector<int>(inputs[1]->shape);
@@ -69,16 +77,23 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
     CHECK(A.as_tensor());
     CHECK(B.as_tensor());
 
+    ir::Tensor bias_tensor;
+    if (has_bias) {
+      Expr bias = pack_args[2];
+      CHECK(bias.as_tensor());
+      bias_tensor = bias.as_tensor_ref();
+    }
+
     std::string tensor_name = UniqName("MatMul");
     if (FLAGS_cinn_ir_schedule) {
-      CHECK_GE(pack_args.size(), 3);
-      CHECK(pack_args[2].is_string());
-      tensor_name = pack_args[2].operator std::string();
+      CHECK_GE(pack_args.size(), has_bias ? 4 : 3);
+      CHECK(pack_args.back().is_string());
+      tensor_name = pack_args.back().operator std::string();
     }
 
     auto tensor_A = A.as_tensor_ref();
     auto tensor_B = B.as_tensor_ref();
-    auto stages   = CreateStages({tensor_A, tensor_B});
+    auto stages   = has_bias ? CreateStages({tensor_A, tensor_B, bias_tensor}) : CreateStages({tensor_A, tensor_B});
 
     auto new_shape_A_e = ToCinnExprs(new_shape_A);
     auto new_shape_B_e = ToCinnExprs(new_shape_B);
@@ -89,11 +104,26 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
     std::vector<ir::Tensor> out;
     if (target.arch == Target::Arch::X86) {
 #ifdef CINN_WITH_MKL_CBLAS
+      CHECK(!has_epilogue) << "The epilogue of matmul is only supported by the packed gemm.";
       out = pe::MatmulMKL(new_A, new_B, trans_a, trans_b, alpha, UniqName("MatmulMKL_output"), target);
 #else
-      out = pe::MatmulV2(new_A, new_B, trans_a, trans_b, alpha, UniqName("MatmulV2_output"), target);
+      if (use_packed_gemm) {
+        out = pe::MatmulPackedGemm(new_A,
+                                   new_B,
+                                   trans_a,
+                                   trans_b,
+                                   alpha,
+                                   UniqName("MatmulPackedGemm_output"),
+                                   target,
+                                   activation,
+                                   bias_tensor);
+      } else {
+        CHECK(!has_epilogue) << "The epilogue of matmul is only supported by the packed gemm.";
+        out = pe::MatmulV2(new_A, new_B, trans_a, trans_b, alpha, UniqName("MatmulV2_output"), target);
+      }
 #endif
     } else {
+      CHECK(!has_epilogue) << "The epilogue of matmul is only supported by the packed gemm.";
       out = pe::Matmul(new_A, new_B, trans_a, trans_b, alpha, tensor_name);
     }
 
@@ -129,11 +159,13 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
         CHECK_EQ(arg_pack.size(), 3UL);
 #else
         CHECK_EQ(arg_pack.size(), 3UL);
-        Expr out     = arg_pack[0];
-        Expr packedB = arg_pack[1];
-        CHECK(packedB.as_tensor());
-        CHECK(out.as_tensor());
-        pe::MatmulScheduleCPU(stages, out.as_tensor_ref(), packedB.as_tensor_ref(), target);
+        if (!use_packed_gemm) {
+          Expr out     = arg_pack[0];
+          Expr packedB = arg_pack[1];
+          CHECK(packedB.as_tensor());
+          CHECK(out.as_tensor());
+          pe::MatmulScheduleCPU(stages, out.as_tensor_ref(), packedB.as_tensor_ref(), target);
+        }
 #endif
       }
       *ret = arg_pack;
@@ -148,18 +180,23 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
 
 std::vector<std::vector<int>> InferShapeForMatMul(const std::vector<std::vector<int>> &inputs_shape,
                                                   const framework::AttrMapType &attrs) {
-  CHECK_EQ(inputs_shape.size(), 2UL) << "The input's shape size should be 2! Please check again.";
+  CHECK(inputs_shape.size() == 2UL || inputs_shape.size() == 3UL)
+      << "The input's shape size should be 2, or 3 with the bias! Please check again.";
   bool trans_a = GetAttr(attrs, "trans_a", false);
   bool trans_b = GetAttr(attrs, "trans_b", false);
 
   VLOG(4) << "During the matmul shape inference, origin shape_A: " << utils::Join(inputs_shape[0], ", ");
   VLOG(4) << "During the matmul shape inference, origin shape_B: " << utils::Join(inputs_shape[1], ", ");
 
-  const auto &new_shape = pe::utils::GetMatmulNewShapes(inputs_shape, trans_a, trans_b);
+  const auto &new_shape = pe::utils::GetMatmulNewShapes({inputs_shape[0], inputs_shape[1]}, trans_a, trans_b);
 
   const auto &new_shape_A  = new_shape[0];
   const auto &new_shape_B  = new_shape[1];
   const auto &output_shape = new_shape[2];
+  if (inputs_shape.size() == 3UL) {
+    CHECK(inputs_shape[2] == std::vector<int>{output_shape.back()})
+        << "The bias of matmul should be of shape [" << output_shape.back() << "]! Please check again.";
+  }
 
   VLOG(4) << "During the matmul shape inference, new_shape_A: " << utils::Join(new_shape_A, ", ");
   VLOG(4) << "During the matmul shape inference, new_shape_B: " << utils::Join(new_shape_B, ", ");
@@ -170,8 +207,11 @@ std::vector<std::vector<int>> InferShapeForMatMul(const std::vector<std::vector<
 }
 
 std::vector<Type> InferDtypeForMatMul(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
-  CHECK_EQ(inputs_type.size(), 2UL) << "The input's type size should be 2! Please check again.";
-  CHECK_EQ(inputs_type[0], inputs_type[1]) << "The input's types should be equal! Please check again.";
+  CHECK(inputs_type.size() == 2UL || inputs_type.size() == 3UL)
+      << "The input's type size should be 2, or 3 with the bias! Please check again.";
+  for (auto &type : inputs_type) {
+    CHECK_EQ(inputs_type[0], type) << "The input's types should be equal! Please check again.";
+  }
 
   std::vector<Type> res{inputs_type[0]};
   return res;
@@ -181,8 +221,9 @@ std::vector<std::vector<std::string>> InferLayoutForMatMul(const std::vector<fra
                                                            const std::vector<std::string> &input_layouts,
                                                            const framework::NodeAttr &attrs,
                                                            const Target &target) {
-  CHECK_EQ(input_layouts.size(), 2U) << "The input's layouts size is not 2! Please check again.";
-  CHECK_EQ(input_shapes.size(), 2U) << "mul should have 2 input shapes";
+  CHECK(input_layouts.size() == 2U || input_layouts.size() == 3U)
+      << "The input's layouts size is not 2 or 3! Please check again.";
+  CHECK_EQ(input_shapes.size(), input_layouts.size()) << "mul should have the same number of shapes and layouts";
   std::vector<std::string> new_input_layouts = input_layouts;
   for (int i = 0; i < input_shapes.size(); i++) {
     if (input_shapes[i].size() > 4) {
@@ -482,11 +523,19 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
                                            const std::vector<Type> &out_type,
                                            const std::vector<std::vector<int>> &output_shapes,
                                            const Target &target) {
-  CHECK_EQ(inputs.size(), 2UL) << "mul should have 2 input";
+  CHECK(inputs.size() == 2UL || inputs.size() == 3UL) << "mul should have 2 input, or 3 with the bias";
   const auto &attr_store = attrs.attr_store;
   int x_num_col_dims     = GetAttr(attr_store, "x_num_col_dims", 1);
   int y_num_col_dims     = GetAttr(attr_store, "y_num_col_dims", 1);
   bool is_infer          = GetAttr(attr_store, "is_infer", false);
+  float alpha            = GetAttr(attr_store, "alpha", 1.0f);
+  // the bias and activation folded by the GemmEpilogueFusion pass, which are only supported by the packed gemm.
+  int activation    = GetAttr(attr_store, "epilogue_activation", 0);
+  bool has_bias     = inputs.size() == 3UL;
+  bool has_epilogue = activation != 0 || has_bias;
+
+  // the packed gemm only computes in fp32, the other types fall back to MatmulV2.
+  bool use_packed_gemm = FLAGS_cinn_use_packed_gemm && inputs[0]->type() == Float(32) && inputs[1]->type() == Float(32);
 
   const auto &shape_A = ToPodVector<int>(inputs[0]->shape);
   const auto &shape_B = ToPodVector<int>(inputs[1]->shape);
@@ -506,9 +555,16 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
     CHECK(A.as_tensor());
     CHECK(B.as_tensor());
 
+    ir::Tensor bias_tensor;
+    if (has_bias) {
+      Expr bias = pack_args[2];
+      CHECK(bias.as_tensor());
+      bias_tensor = bias.as_tensor_ref();
+    }
+
     auto A_tensor = A.as_tensor_ref();
     auto B_tensor = B.as_tensor_ref();
-    auto stages   = CreateStages({A_tensor, B_tensor});
+    auto stages   = has_bias ? CreateStages({A_tensor, B_tensor, bias_tensor}) : CreateStages({A_tensor, B_tensor});
 
     auto new_shape_A_e = ToCinnExprs(new_shape_A);
     auto new_shape_B_e = ToCinnExprs(new_shape_B);
@@ -525,12 +581,19 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
 
     if (target.arch == Target::Arch::X86) {
 #ifdef CINN_WITH_MKL_CBLAS
-      out = pe::MatmulMKL(new_A, new_B, false, is_infer, 1.0f, tensor_name, target);
+      CHECK(!has_epilogue) << "The epilogue of mul is only supported by the packed gemm.";
+      out = pe::MatmulMKL(new_A, new_B, false, is_infer, alpha, tensor_name, target);
 #else
-      out = pe::MatmulV2(new_A, new_B, false, is_infer, 1.0f, tensor_name, target);
+      if (use_packed_gemm) {
+        out = pe::MatmulPackedGemm(new_A, new_B, false, is_infer, alpha, tensor_name, target, activation, bias_tensor);
+      } else {
+        CHECK(!has_epilogue) << "The epilogue of mul is only supported by the packed gemm.";
+        out = pe::MatmulV2(new_A, new_B, false, is_infer, alpha, tensor_name, target);
+      }
 #endif
     } else {
-      out = pe::Matmul(new_A, new_B, false, is_infer, 1.0f, tensor_name);
+      CHECK(!has_epilogue) << "The epilogue of mul is only supported by the packed gemm.";
+      out = pe::Matmul(new_A, new_B, false, is_infer, alpha, tensor_name);
     }
 
     std::vector<CINNValue> res;
@@ -565,11 +628,13 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
         CHECK_EQ(arg_pack.size(), 3UL);
 #else
         CHECK_EQ(arg_pack.size(), 3UL);
-        Expr out     = arg_pack[0];
-        Expr packedB = arg_pack[1];
-        CHECK(packedB.as_tensor());
-        CHECK(out.as_tensor());
-        pe::MatmulScheduleCPU(stages, out.as_tensor_ref(), packedB.as_tensor_ref(), target);
+        if (!use_packed_gemm) {
+          Expr out     = arg_pack[0];
+          Expr packedB = arg_pack[1];
+          CHECK(packedB.as_tensor());
+          CHECK(out.as_tensor());
+          pe::MatmulScheduleCPU(stages, out.as_tensor_ref(), packedB.as_tensor_ref(), target);
+        }
 #endif
       }
       *ret = arg_pack;
@@ -584,7 +649,8 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
 
 std::vector<std::vector<int>> InferShapeForMul(const std::vector<std::vector<int>> &inputs_shape,
                                                const framework::AttrMapType &attrs) {
-  CHECK_EQ(inputs_shape.size(), 2U) << "The input's shape size should be 2! Please check again.";
+  CHECK(inputs_shape.size() == 2U || inputs_shape.size() == 3U)
+      << "The input's shape size should be 2, or 3 with the bias! Please check again.";
   CHECK_GE(inputs_shape[0].size(), 2U) << "Input matrix X's dim should be >= 2! Please check.";
   CHECK_GE(inputs_shape[1].size(), 2U) << "Input matrix Y's dim should be >= 2! Please check.";
 
@@ -595,11 +661,16 @@ std::vector<std::vector<int>> InferShapeForMul(const std::vector<std::vector<int
   int y_num_col_dims = GetAttr(attrs, "y_num_col_dims", 1);
   bool is_infer      = GetAttr(attrs, "is_infer", false);
 
-  const auto &new_shape = pe::utils::GetMulNewShapes(inputs_shape, x_num_col_dims, y_num_col_dims, is_infer);
+  const auto &new_shape =
+      pe::utils::GetMulNewShapes({inputs_shape[0], inputs_shape[1]}, x_num_col_dims, y_num_col_dims, is_infer);
 
   const auto &new_shape_A  = new_shape[0];
   const auto &new_shape_B  = new_shape[1];
   const auto &output_shape = new_shape[2];
+  if (inputs_shape.size() == 3U) {
+    CHECK(inputs_shape[2] == std::vector<int>{output_shape.back()})
+        << "The bias of mul should be of shape [" << output_shape.back() << "]! Please check again.";
+  }
 
   VLOG(4) << "During the mul shape inference, new_shape_A: " << utils::Join(new_shape_A, ", ");
   VLOG(4) << "During the mul shape inference, new_shape_B: " << utils::Join(new_shape_B, ", ");
@@ -614,8 +685,11 @@ std::vector<std::vector<int>> InferShapeForMul(const std::vector<std::vector<int
 }
 
 std::vector<Type> InferDtypeForMul(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
-  CHECK_EQ(inputs_type.size(), 2U) << "The input's type size should be 2! Please check again.";
-  CHECK_EQ(inputs_type[0], inputs_type[1]) << "The input's types should be equal! Please check again.";
+  CHECK(inputs_type.size() == 2U || inputs_type.size() == 3U)
+      << "The input's type size should be 2, or 3 with the bias! Please check again.";
+  for (auto &type : inputs_type) {
+    CHECK_EQ(inputs_type[0], type) << "The input's types should be equal! Please check again.";
+  }
 
   return {inputs_type[0]};
 }
@@ -624,8 +698,9 @@ std::vector<std::vector<std::string>> InferLayoutForMul(const std::vector<framew
                                                         const std::vector<std::string> &input_layouts,
                                                         const framework::NodeAttr &attrs,
                                                         const Target &target) {
-  CHECK_EQ(input_layouts.size(), 2U) << "The input's layouts size is not 2! Please check again.";
-  CHECK_EQ(input_shapes.size(), 2U) << "mul should have 2 input shapes";
+  CHECK(input_layouts.size() == 2U || input_layouts.size() == 3U)
+      << "The input's layouts size is not 2 or 3! Please check again.";
+  CHECK_EQ(input_shapes.size(), input_layouts.size()) << "mul should have the same number of shapes and layouts";
   std::vector<std::string> new_input_layouts = input_layouts;
   for (int i = 0; i < input_shapes.size(); i++) {
     if (input_shapes[i].size() > 4) {
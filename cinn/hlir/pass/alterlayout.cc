@@ -12,11 +12,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/pass/use_pass.h"
+#include "cinn/hlir/pe/nn_util.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/layout.h"
 #include "cinn/utils/string.h"
@@ -124,6 +132,538 @@ std::vector<framework::shape_t> UpdateInferInfos(Node* node,
   return infershapes;
 }
 
+// replace the op node by the new node with the same inputs, the first out var is kept and the others are created
+void ReplaceOpNode(Graph* graph, Node* node, Node* new_node, int num_outputs) {
+  auto& old_inlinks  = node->inlinks_in_order(true);
+  auto& old_outlinks = node->outlinks_in_order(true);
+  for (auto& link : old_inlinks) {
+    auto source = link->source();
+    source->UnLinkSingleTo(node);
+    source->LinkTo(new_node);
+  }
+  int count = 0;
+  Shared<Node> node_ptr(new_node);
+  for (auto& link : old_outlinks) {
+    auto sink = link->sink();
+    node->UnLinkSingleTo(sink);
+    if (!count) {
+      // keep the first out var and its outlinks
+      auto out_var = sink->safe_as<NodeData>();
+      CHECK(out_var);
+      out_var->source_node = node_ptr;
+      new_node->LinkTo(out_var);
+    }
+    count++;
+  }
+  for (int i = 1; i < num_outputs; i++) {
+    auto* new_out = new NodeData(node_ptr, i, 0, common::UniqName(new_node->id() + "_out_" + std::to_string(i)));
+    graph->RegisterNode(new_out->id(), new_out);
+    new_node->as<common::GraphNode>()->LinkTo(new_out);
+  }
+  graph->RegisterNode(new_node->id(), new_node);
+}
+
+// alter the conv2d to conv2d_winograd if it is suitable for winograd, see pe::UseWinogradConv2dCPU. The weight is
+// transformed by an individual winograd_weight_transform op, which is hoisted to PreRun by PrePackWeights if the weight
+// is constant.
+bool AlterConv2dToWinograd(Graph* graph,
+                           Node* node,
+                           const OpValueType<InferShapeFunc>& op_infershape,
+                           const OpValueType<InferTypeFunc>& op_infertype,
+                           const OpValueType<InferLayoutFunc>& op_inferlayout,
+                           absl::flat_hash_map<std::string, framework::shape_t>* shape_dict,
+                           absl::flat_hash_map<std::string, Type>* type_dict,
+                           absl::flat_hash_map<std::string, std::string>* layout_dict) {
+  auto& attr_store = node->attrs.attr_store;
+  std::vector<int> padding({0, 0});
+  std::vector<int> stride({1, 1});
+  std::vector<int> dilation({1, 1});
+  int groups = 1;
+  if (attr_store.find("padding") != attr_store.end()) {
+    padding = absl::get<std::vector<int>>(attr_store.at("padding"));
+  }
+  if (attr_store.find("stride") != attr_store.end()) {
+    stride = absl::get<std::vector<int>>(attr_store.at("stride"));
+  }
+  if (attr_store.find("dilation") != attr_store.end()) {
+    dilation = absl::get<std::vector<int>>(attr_store.at("dilation"));
+  }
+  if (attr_store.find("groups") != attr_store.end()) {
+    groups = absl::get<int>(attr_store.at("groups"));
+  }
+  if (attr_store.find("use_mkldnn") != attr_store.end() && absl::get<bool>(attr_store.at("use_mkldnn"))) {
+    return false;
+  }
+  auto& conv_inlinks = node->inlinks_in_order(true);
+  CHECK_EQ(conv_inlinks.size(), 2U) << "conv2d should have 2 inputs";
+  auto* input_data  = conv_inlinks[0]->source()->safe_as<NodeData>();
+  auto* weight_data = conv_inlinks[1]->source()->safe_as<NodeData>();
+  CHECK(input_data);
+  CHECK(weight_data);
+  CHECK(shape_dict->count(input_data->id())) << input_data->id() << " has no infershape";
+  CHECK(shape_dict->count(weight_data->id())) << weight_data->id() << " has no infershape";
+  CHECK(type_dict->count(input_data->id())) << input_data->id() << " has no infertype";
+  CHECK(type_dict->count(weight_data->id())) << weight_data->id() << " has no infertype";
+  auto input_shape  = shape_dict->at(input_data->id());
+  auto weight_shape = shape_dict->at(weight_data->id());
+  auto input_type   = type_dict->at(input_data->id());
+  auto weight_type  = type_dict->at(weight_data->id());
+  if (weight_shape.size() != 4U || (input_shape.size() != 4U && input_shape.size() != 5U)) {
+    return false;
+  }
+  // the input may have been altered to NCHWxc by the previous conv2d
+  framework::shape_t nchw_shape = input_shape;
+  if (input_shape.size() == 5U) {
+    nchw_shape = {input_shape[0], input_shape[1] * input_shape[4], input_shape[2], input_shape[3]};
+  }
+  if (!pe::UseWinogradConv2dCPU(nchw_shape, weight_shape, padding, stride, dilation, groups)) {
+    return false;
+  }
+  int tile_size = pe::GetWinogradTileSizeCPU(nchw_shape[2] + 2 * padding[0] - weight_shape[2] + 1,
+                                             nchw_shape[3] + 2 * padding[1] - weight_shape[3] + 1);
+  VLOG(3) << "alter " << node->id() << " to conv2d_winograd with tile size " << tile_size;
+
+  if (input_shape.size() == 5U) {
+    CHECK(layout_dict->count(input_data->id())) << input_data->id() << " should have out_layout attr";
+    std::string src_input_layout = layout_dict->at(input_data->id());
+    Node* input_trans_node;
+    NodeData* output_data;
+    std::tie(input_trans_node, output_data) =
+        InsertLayoutTransformNodeAfter(graph,
+                                       input_data,
+                                       node,
+                                       0,
+                                       src_input_layout,
+                                       "NCHW",
+                                       common::UniqName(node->op()->name + "_input_layout_tranform"));
+    UpdateInferInfos(input_trans_node,
+                     {input_shape},
+                     {input_type},
+                     {src_input_layout},
+                     graph->target_,
+                     op_infershape,
+                     op_infertype,
+                     op_inferlayout,
+                     shape_dict,
+                     type_dict,
+                     layout_dict);
+  }
+
+  // insert winograd_weight_transform
+  std::string trans_op_type = "winograd_weight_transform";
+  auto weight_trans_node    = new Node(Operator::Get(trans_op_type), trans_op_type, common::UniqName(trans_op_type));
+  InsertGraphOpNodeAfter(graph, weight_trans_node, weight_data, node, 1);
+  weight_trans_node->attrs.attr_store["tile_size"] = tile_size;
+
+  std::string weight_layout = layout_dict->count(weight_data->id()) ? layout_dict->at(weight_data->id()) : "";
+  auto trans_out_shapes     = UpdateInferInfos(weight_trans_node,
+                                           {weight_shape},
+                                           {weight_type},
+                                           {weight_layout},
+                                           graph->target_,
+                                           op_infershape,
+                                           op_infertype,
+                                           op_inferlayout,
+                                           shape_dict,
+                                           type_dict,
+                                           layout_dict);
+
+  // replace conv2d to conv2d_winograd
+  std::string new_op_type    = "conv2d_winograd";
+  Node* new_node             = new Node(Operator::Get(new_op_type), new_op_type, common::UniqName(new_op_type));
+  new_node->attrs.attr_store = attr_store;
+  ReplaceOpNode(graph, node, new_node, 1);
+  new_node->attrs.attr_store["tile_size"] = tile_size;
+  UpdateInferInfos(new_node,
+                   {nchw_shape, trans_out_shapes[0]},
+                   {input_type, weight_type},
+                   {"NCHW", ""},
+                   graph->target_,
+                   op_infershape,
+                   op_infertype,
+                   op_inferlayout,
+                   shape_dict,
+                   type_dict,
+                   layout_dict);
+  return true;
+}
+
+int64_t GetVarBytes(const std::string& id,
+                    const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict,
+                    const absl::flat_hash_map<std::string, Type>& type_dict) {
+  CHECK(shape_dict.count(id)) << id << " finds no infershape";
+  CHECK(type_dict.count(id)) << id << " finds no infertype";
+  const auto& shape = shape_dict.at(id);
+  return std::accumulate(shape.begin(), shape.end(), 1L, std::multiplies<int64_t>()) * type_dict.at(id).bytes();
+}
+
+bool IsLayoutTransform(const Node* node) { return node && node->op()->name == "layout_transform"; }
+
+std::string GetLayoutAttr(const Node* node, const std::string& name) {
+  CHECK(node->attrs.attr_store.count(name)) << node->id() << " finds no " << name << " attr";
+  return absl::get<std::string>(node->attrs.attr_store.at(name));
+}
+
+// unlink the layout_transform op and let its consumers read new_input instead, the unlinked nodes are removed by
+// Graph::ClearUnlinkedNodes finally
+void RemoveLayoutTransformNode(Node* trans_node, NodeData* new_input) {
+  auto* input  = trans_node->inlinks_in_order(true)[0]->source()->safe_as<NodeData>();
+  auto* output = trans_node->outlinks_in_order(true)[0]->sink()->safe_as<NodeData>();
+  CHECK(input);
+  CHECK(output);
+  std::vector<Node*> consumers;
+  for (auto& link : output->outlinks()) {
+    auto* consumer = link->sink()->safe_as<Node>();
+    if (std::find(consumers.begin(), consumers.end(), consumer) == consumers.end()) {
+      consumers.push_back(consumer);
+    }
+  }
+  for (auto* consumer : consumers) {
+    framework::ReplaceGraphOpNodeInput(consumer, output, new_input);
+  }
+  input->UnLinkSingleTo(trans_node);
+  trans_node->UnLinkSingleTo(output);
+}
+
+// insert a layout_transform for each input of dst_node reading input_data
+void InsertLayoutTransformNodesAfter(Graph* graph,
+                                     NodeData* input_data,
+                                     Node* dst_node,
+                                     const std::string& src_layout,
+                                     const std::string& dst_layout,
+                                     const OpValueType<InferShapeFunc>& op_infershape,
+                                     const OpValueType<InferTypeFunc>& op_infertype,
+                                     const OpValueType<InferLayoutFunc>& op_inferlayout,
+                                     absl::flat_hash_map<std::string, framework::shape_t>* shape_dict,
+                                     absl::flat_hash_map<std::string, Type>* type_dict,
+                                     absl::flat_hash_map<std::string, std::string>* layout_dict) {
+  while (true) {
+    auto& inlinks = dst_node->inlinks_in_order(true);
+    auto it       = std::find_if(inlinks.begin(), inlinks.end(), [&](const common::Shared<common::GraphEdge>& link) {
+      return link->source() == input_data;
+    });
+    if (it == inlinks.end()) {
+      break;
+    }
+    Node* trans_node;
+    NodeData* output_data;
+    std::tie(trans_node, output_data) =
+        InsertLayoutTransformNodeAfter(graph,
+                                       input_data,
+                                       dst_node,
+                                       it - inlinks.begin(),
+                                       src_layout,
+                                       dst_layout,
+                                       common::UniqName(input_data->id() + "_layout_tranform"));
+    UpdateInferInfos(trans_node,
+                     {shape_dict->at(input_data->id())},
+                     {type_dict->at(input_data->id())},
+                     {src_layout},
+                     graph->target_,
+                     op_infershape,
+                     op_infertype,
+                     op_inferlayout,
+                     shape_dict,
+                     type_dict,
+                     layout_dict);
+  }
+}
+
+// infer the shapes, types and layouts of the node again from its current inputs
+void UpdateInferInfosFromInputs(Graph* graph,
+                                Node* node,
+                                const OpValueType<InferShapeFunc>& op_infershape,
+                                const OpValueType<InferTypeFunc>& op_infertype,
+                                const OpValueType<InferLayoutFunc>& op_inferlayout,
+                                absl::flat_hash_map<std::string, framework::shape_t>* shape_dict,
+                                absl::flat_hash_map<std::string, Type>* type_dict,
+                                absl::flat_hash_map<std::string, std::string>* layout_dict) {
+  std::vector<framework::shape_t> input_shapes;
+  std::vector<Type> input_types;
+  std::vector<std::string> input_layouts;
+  for (auto& link : node->inlinks_in_order(true)) {
+    auto* source = link->source();
+    CHECK(shape_dict->count(source->id())) << source->id() << " finds no infershape";
+    CHECK(type_dict->count(source->id())) << source->id() << " finds no infertype";
+    input_shapes.push_back(shape_dict->at(source->id()));
+    input_types.push_back(type_dict->at(source->id()));
+    input_layouts.push_back(layout_dict->count(source->id()) ? layout_dict->at(source->id()) : "");
+  }
+  UpdateInferInfos(node,
+                   input_shapes,
+                   input_types,
+                   input_layouts,
+                   graph->target_,
+                   op_infershape,
+                   op_infertype,
+                   op_inferlayout,
+                   shape_dict,
+                   type_dict,
+                   layout_dict);
+}
+
+// Whether \p var is an output of the graph, whose layout is transformed back to NCHW finally. They are the fetched
+// vars, or the output of \p last_node if nothing is fetched.
+bool IsGraphOutput(const Graph* graph, const NodeData* var, const Node* last_node) {
+  if (graph->outputs.empty()) {
+    return var->source_node.get() == last_node;
+  }
+  return std::find(graph->outputs.begin(), graph->outputs.end(), var) != graph->outputs.end();
+}
+
+// the elementwise ops compute each output element from the same elements of the inputs, so they can run in any layout
+bool IsLayoutAgnostic(const Node* node, const OpValueType<framework::OpPatternKind>& op_pattern_dict) {
+  if (!op_pattern_dict.Find(node->op()) || node->op()->name == "broadcast_to" || node->outlinks().size() != 1U) {
+    return false;
+  }
+  auto kind = op_pattern_dict[node->op()];
+  return kind == framework::kElementWise || kind == framework::kBroadcast;
+}
+
+// Switch the region of layout agnostic ops back to NCHW if it saves the bytes transformed on the boundaries of the
+// region: the NCHW inputs are read directly instead of being transformed to the blocked layout, while the blocked
+// inputs and the blocked consumers need layout transforms now.
+bool SwitchRegionToNCHW(Graph* graph,
+                        const std::vector<Node*>& region,
+                        const Node* last_node,
+                        const OpValueType<InferShapeFunc>& op_infershape,
+                        const OpValueType<InferTypeFunc>& op_infertype,
+                        const OpValueType<InferLayoutFunc>& op_inferlayout,
+                        absl::flat_hash_map<std::string, framework::shape_t>* shape_dict,
+                        absl::flat_hash_map<std::string, Type>* type_dict,
+                        absl::flat_hash_map<std::string, std::string>* layout_dict) {
+  std::unordered_set<const Node*> region_set(region.begin(), region.end());
+  auto in_region = [&](const common::GraphNode* node) { return region_set.count(node->safe_as<Node>()); };
+  auto layout    = absl::get<std::vector<std::string>>(region[0]->attrs.attr_store.at("out_layouts"))[0];
+
+  int64_t keep_bytes = 0, switch_bytes = 0;
+  std::set<std::pair<Node*, NodeData*>> nchw_inputs, blocked_inputs, blocked_outputs;
+  std::unordered_set<const NodeData*> counted_vars;
+  std::vector<Node*> output_trans_nodes;
+  for (auto* node : region) {
+    if (absl::get<std::vector<std::string>>(node->attrs.attr_store.at("out_layouts"))[0] != layout) {
+      return false;
+    }
+    for (auto& link : node->inlinks_in_order(true)) {
+      auto* var      = link->source()->safe_as<NodeData>();
+      auto* producer = var->source_node.get();
+      if (producer && region_set.count(producer)) {
+        continue;
+      }
+      if (IsLayoutTransform(producer) && GetLayoutAttr(producer, "src_layout") == "NCHW" &&
+          GetLayoutAttr(producer, "dst_layout") == layout) {
+        // the transform is removed if it is only read by the region
+        bool only_in_region = std::all_of(var->outlinks().begin(), var->outlinks().end(), [&](auto& out_link) {
+          return in_region(out_link->sink());
+        });
+        if (only_in_region && counted_vars.insert(var).second) {
+          keep_bytes += GetVarBytes(var->id(), *shape_dict, *type_dict);
+        }
+        nchw_inputs.emplace(node, var);
+      } else if (layout_dict->count(var->id()) && layout_dict->at(var->id()) == layout) {
+        if (counted_vars.insert(var).second) {
+          switch_bytes += GetVarBytes(var->id(), *shape_dict, *type_dict);
+        }
+        blocked_inputs.emplace(node, var);
+      } else {
+        // such as the inputs broadcasted along the blocked axis
+        return false;
+      }
+    }
+
+    auto* out_var   = node->outlinks_in_order(true)[0]->sink()->safe_as<NodeData>();
+    auto out_bytes  = GetVarBytes(out_var->id(), *shape_dict, *type_dict);
+    bool out_switch = false;
+    if (IsGraphOutput(graph, out_var, last_node)) {
+      // the final layout transform converting the output of graph back to NCHW
+      keep_bytes += out_bytes;
+    }
+    for (auto& link : out_var->outlinks()) {
+      auto* consumer = link->sink()->safe_as<Node>();
+      if (region_set.count(consumer)) {
+        continue;
+      }
+      if (IsLayoutTransform(consumer) && GetLayoutAttr(consumer, "dst_layout") == "NCHW") {
+        keep_bytes += out_bytes;
+        output_trans_nodes.push_back(consumer);
+        continue;
+      }
+      auto consumer_layouts  = absl::get<std::vector<std::string>>(consumer->attrs.attr_store.at("input_layouts"));
+      auto& consumer_inlinks = consumer->inlinks_in_order(true);
+      for (int i = 0; i < consumer_inlinks.size(); i++) {
+        if (consumer_inlinks[i]->source() == out_var && consumer_layouts[i] != layout) {
+          return false;
+        }
+      }
+      if (!out_switch) {
+        switch_bytes += out_bytes;
+        out_switch    = true;
+      }
+      blocked_outputs.emplace(consumer, out_var);
+    }
+  }
+  if (switch_bytes >= keep_bytes) {
+    return false;
+  }
+  VLOG(3) << "Switch the region of " << region.size() << " ops from " << layout << " to NCHW, which transforms "
+          << switch_bytes << " bytes instead of " << keep_bytes << " bytes";
+
+  for (auto& input : nchw_inputs) {
+    auto* trans_node = input.second->source_node.get();
+    auto* nchw_var   = trans_node->inlinks_in_order(true)[0]->source()->safe_as<NodeData>();
+    framework::ReplaceGraphOpNodeInput(input.first, input.second, nchw_var);
+    if (input.second->outlinks().empty()) {
+      RemoveLayoutTransformNode(trans_node, nchw_var);
+    }
+  }
+  for (auto& input : blocked_inputs) {
+    InsertLayoutTransformNodesAfter(graph,
+                                    input.second,
+                                    input.first,
+                                    layout,
+                                    "NCHW",
+                                    op_infershape,
+                                    op_infertype,
+                                    op_inferlayout,
+                                    shape_dict,
+                                    type_dict,
+                                    layout_dict);
+  }
+  for (auto* node : region) {
+    UpdateInferInfosFromInputs(
+        graph, node, op_infershape, op_infertype, op_inferlayout, shape_dict, type_dict, layout_dict);
+  }
+  for (auto* trans_node : output_trans_nodes) {
+    RemoveLayoutTransformNode(trans_node, trans_node->inlinks_in_order(true)[0]->source()->safe_as<NodeData>());
+  }
+  for (auto& output : blocked_outputs) {
+    InsertLayoutTransformNodesAfter(graph,
+                                    output.second,
+                                    output.first,
+                                    "NCHW",
+                                    layout,
+                                    op_infershape,
+                                    op_infertype,
+                                    op_inferlayout,
+                                    shape_dict,
+                                    type_dict,
+                                    layout_dict);
+  }
+  return true;
+}
+
+// AlterLayout propagates the blocked layouts of conv2d_NCHWc forward greedily, which transforms every NCHW input of the
+// following elementwise ops. Here the layout of each connected region of layout agnostic ops is chosen by the bytes
+// transformed on its boundaries instead, return the number of the regions switched to NCHW.
+int SelectRegionLayouts(Graph* graph,
+                        const OpValueType<InferShapeFunc>& op_infershape,
+                        const OpValueType<InferTypeFunc>& op_infertype,
+                        const OpValueType<InferLayoutFunc>& op_inferlayout,
+                        absl::flat_hash_map<std::string, framework::shape_t>* shape_dict,
+                        absl::flat_hash_map<std::string, Type>* type_dict,
+                        absl::flat_hash_map<std::string, std::string>* layout_dict) {
+  auto& op_pattern_dict = Operator::GetAttrs<framework::OpPatternKind>("OpPattern");
+  std::vector<Node*> op_nodes;
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto* node = graph_node->safe_as<Node>();
+    if (node) {
+      op_nodes.push_back(node);
+    }
+  }
+  if (op_nodes.empty()) {
+    return 0;
+  }
+
+  // union the blocked layout agnostic ops connected by vars into regions
+  std::unordered_map<Node*, Node*> parents;
+  std::function<Node*(Node*)> find_root = [&](Node* node) {
+    if (parents.at(node) != node) {
+      parents[node] = find_root(parents.at(node));
+    }
+    return parents.at(node);
+  };
+  for (auto* node : op_nodes) {
+    if (!IsLayoutAgnostic(node, op_pattern_dict) || !node->attrs.attr_store.count("out_layouts") ||
+        absl::get<std::vector<std::string>>(node->attrs.attr_store.at("out_layouts"))[0].size() <= 4) {
+      continue;
+    }
+    parents[node] = node;
+    for (auto& link : node->inlinks_in_order(true)) {
+      auto* producer = link->source()->safe_as<NodeData>()->source_node.get();
+      if (producer && parents.count(producer)) {
+        parents[find_root(producer)] = find_root(node);
+      }
+    }
+  }
+  std::vector<Node*> roots;
+  std::unordered_map<Node*, std::vector<Node*>> regions;
+  for (auto* node : op_nodes) {
+    if (parents.count(node)) {
+      auto* root = find_root(node);
+      if (!regions.count(root)) {
+        roots.push_back(root);
+      }
+      regions[root].push_back(node);
+    }
+  }
+
+  int switched_num = 0;
+  for (auto* root : roots) {
+    switched_num += SwitchRegionToNCHW(graph,
+                                       regions.at(root),
+                                       op_nodes.back(),
+                                       op_infershape,
+                                       op_infertype,
+                                       op_inferlayout,
+                                       shape_dict,
+                                       type_dict,
+                                       layout_dict);
+  }
+  return switched_num;
+}
+
+// Remove the layout_transform ops converting a var back to the layout before the previous layout_transform, and merge
+// the ones converting the same var to the same layout, return the number of the removed ops.
+int EliminateRedundantLayoutTransforms(Graph* graph) {
+  int removed_num = 0;
+  absl::flat_hash_map<std::string, NodeData*> transformed_vars;
+  auto is_output = [graph](const NodeData* var) {
+    return std::find(graph->outputs.begin(), graph->outputs.end(), var) != graph->outputs.end();
+  };
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!IsLayoutTransform(node) || node->inlinks().empty()) {
+      continue;
+    }
+    auto* input  = node->inlinks_in_order(true)[0]->source()->safe_as<NodeData>();
+    auto* output = node->outlinks_in_order(true)[0]->sink()->safe_as<NodeData>();
+    if (is_output(output)) {
+      continue;
+    }
+    auto dst_layout = GetLayoutAttr(node, "dst_layout");
+    auto* producer  = input->source_node.get();
+    if (IsLayoutTransform(producer) && GetLayoutAttr(producer, "src_layout") == dst_layout) {
+      auto* origin = producer->inlinks_in_order(true)[0]->source()->safe_as<NodeData>();
+      RemoveLayoutTransformNode(node, origin);
+      ++removed_num;
+      if (input->outlinks().empty() && !is_output(input)) {
+        transformed_vars.erase(origin->id() + "->" + GetLayoutAttr(producer, "dst_layout"));
+        RemoveLayoutTransformNode(producer, origin);
+        ++removed_num;
+      }
+      continue;
+    }
+    auto key = input->id() + "->" + dst_layout;
+    if (transformed_vars.count(key)) {
+      RemoveLayoutTransformNode(node, transformed_vars.at(key));
+      ++removed_num;
+      continue;
+    }
+    transformed_vars[key] = output;
+  }
+  return removed_num;
+}
+
 void AlterLayoutPass(Graph* graph) {
   // alterlayout only in X86 for it's specific layout requirements
   if (graph->target_.arch == Target::Arch::X86) {
@@ -182,6 +722,17 @@ void AlterLayoutPass(Graph* graph) {
             // not NCHW such as NHWC or has already been altered layout
             continue;
           }
+          if (AlterConv2dToWinograd(graph,
+                                    node,
+                                    op_infershape,
+                                    op_inferdtype,
+                                    op_inferlayout,
+                                    &shape_dict,
+                                    &type_dict,
+                                    &layout_dict)) {
+            has_altered = true;
+            continue;
+          }
           has_altered             = true;
           std::string new_op_type = node->op()->name + "_NCHWc";
           // alter conv2d op to conv2d_NCHWc
@@ -336,36 +887,8 @@ void AlterLayoutPass(Graph* graph) {
             conv2d_NCHWc_inputlayouts.push_back(layout_dict[weight_node->id()]);
           }
           // replace conv2d to conv2d_NCHWc
-          auto infershapes   = op_infershape[new_node->op()](conv2d_NCHWc_inputshapes, new_node->attrs.attr_store);
-          auto& old_inlinks  = node->inlinks_in_order(true);
-          auto& old_outlinks = node->outlinks_in_order(true);
-          for (auto& link : old_inlinks) {
-            auto source = link->source();
-            source->UnLinkSingleTo(node);
-            source->LinkTo(new_node);
-          }
-          std::vector<Node*> next_ops;
-          int count = 0;
-          Shared<Node> node_ptr(new_node);
-          for (auto& link : old_outlinks) {
-            auto sink = link->sink();
-            node->UnLinkSingleTo(sink);
-            if (!count) {
-              // keep the first out var and its outlinks
-              auto out_var = sink->safe_as<NodeData>();
-              CHECK(out_var);
-              out_var->source_node = node_ptr;
-              new_node->LinkTo(out_var);
-            }
-            count++;
-          }
-          for (int i = 1; i < infershapes.size(); i++) {
-            auto* new_out =
-                new NodeData(node_ptr, i, 0, common::UniqName(new_node->id() + "_out_" + std::to_string(i)));
-            graph->RegisterNode(new_out->id(), new_out);
-            new_node->as<common::GraphNode>()->LinkTo(new_out);
-          }
-          graph->RegisterNode(new_node->id(), new_node);
+          auto infershapes = op_infershape[new_node->op()](conv2d_NCHWc_inputshapes, new_node->attrs.attr_store);
+          ReplaceOpNode(graph, node, new_node, infershapes.size());
           // update conv2d_NCHWc's infershape, infertype, inferlayout and set attrs
           UpdateInferInfos(new_node,
                            conv2d_NCHWc_inputshapes,
@@ -575,54 +1098,78 @@ void AlterLayoutPass(Graph* graph) {
       }
     }
     if (has_altered) {
+      int switched_num = SelectRegionLayouts(
+          graph, op_infershape, op_inferdtype, op_inferlayout, &shape_dict, &type_dict, &layout_dict);
+      int removed_num = EliminateRedundantLayoutTransforms(graph);
+      VLOG(3) << switched_num << " regions are switched to NCHW and " << removed_num
+              << " redundant layout transforms are removed";
+      graph->ClearUnlinkedNodes(&shape_dict, &type_dict, &layout_dict);
+
       // final layout transform
-      store_nodes = std::get<0>(graph->topological_order());
-      for (int i = store_nodes.size() - 1; i >= 0; i--) {
-        auto* node = store_nodes[i]->safe_as<Node>();
-        if (node) {
-          CHECK(node->attrs.attr_store.count("out_layouts")) << node->id() << " finds no out_layouts attr";
-          auto out_layouts = absl::get<std::vector<std::string>>(node->attrs.attr_store.at("out_layouts"));
-          CHECK(!out_layouts.empty());
-          if (out_layouts[0].size() > 4) {
-            // recover the layout finally, NCHWxc->NCHW, only first output
-            auto outlinks = node->outlinks_in_order(true);
-            CHECK(!outlinks.empty());
-            auto* out_node         = outlinks[0]->sink();
-            std::string dst_layout = "NCHW";
-            CHECK(layout_dict.count(out_node->id())) << out_node->id() << " finds no out_layout";
-            std::string src_layout = layout_dict[out_node->id()];
-            // insert layout_transform
-            NodeData* temp_out;
-            Node* trans_node;
-            CHECK(shape_dict.count(out_node->id())) << out_node->id() << " finds no infershape";
-            CHECK(type_dict.count(out_node->id())) << out_node->id() << " finds no infertype";
-            auto shape = shape_dict[out_node->id()];
-            auto type  = type_dict[out_node->id()];
-            // insert layout transform before the output var to keep the final original output var
-            std::tie(trans_node, temp_out) =
-                InsertLayoutTransformNodeBefore(graph,
-                                                node,
-                                                out_node->safe_as<NodeData>(),
-                                                0,
-                                                src_layout,
-                                                dst_layout,
-                                                common::UniqName(node->op()->name + "_final_layout_tranform"));
-            shape_dict[temp_out->id()]  = shape;
-            type_dict[temp_out->id()]   = type;
-            layout_dict[temp_out->id()] = src_layout;
-            UpdateInferInfos(trans_node,
-                             {shape},
-                             {type},
-                             {src_layout},
-                             graph->target_,
-                             op_infershape,
-                             op_inferdtype,
-                             op_inferlayout,
-                             &shape_dict,
-                             &type_dict,
-                             &layout_dict);
+      store_nodes     = std::get<0>(graph->topological_order());
+      Node* last_node = nullptr;
+      for (auto* graph_node : store_nodes) {
+        if (graph_node->safe_as<Node>()) {
+          last_node = graph_node->safe_as<Node>();
+        }
+      }
+      for (auto* graph_node : store_nodes) {
+        auto* node = graph_node->safe_as<Node>();
+        if (!node) {
+          continue;
+        }
+        auto outlinks = node->outlinks_in_order(true);
+        CHECK(!outlinks.empty());
+        auto* out_node = outlinks[0]->sink()->safe_as<NodeData>();
+        if (!IsGraphOutput(graph, out_node, last_node)) {
+          continue;
+        }
+        CHECK(node->attrs.attr_store.count("out_layouts")) << node->id() << " finds no out_layouts attr";
+        auto out_layouts = absl::get<std::vector<std::string>>(node->attrs.attr_store.at("out_layouts"));
+        CHECK(!out_layouts.empty());
+        if (out_layouts[0].size() > 4) {
+          // recover the layout finally, NCHWxc->NCHW, only first output
+          std::string dst_layout = "NCHW";
+          CHECK(layout_dict.count(out_node->id())) << out_node->id() << " finds no out_layout";
+          std::string src_layout = layout_dict[out_node->id()];
+          // the ops reading the output in the graph keep reading the blocked layout
+          std::vector<Node*> consumers;
+          for (auto& link : out_node->outlinks()) {
+            consumers.push_back(link->sink()->safe_as<Node>());
+          }
+          // insert layout_transform
+          NodeData* temp_out;
+          Node* trans_node;
+          CHECK(shape_dict.count(out_node->id())) << out_node->id() << " finds no infershape";
+          CHECK(type_dict.count(out_node->id())) << out_node->id() << " finds no infertype";
+          auto shape = shape_dict[out_node->id()];
+          auto type  = type_dict[out_node->id()];
+          // insert layout transform before the output var to keep the final original output var
+          std::tie(trans_node, temp_out) =
+              InsertLayoutTransformNodeBefore(graph,
+                                              node,
+                                              out_node,
+                                              0,
+                                              src_layout,
+                                              dst_layout,
+                                              common::UniqName(node->op()->name + "_final_layout_tranform"));
+          shape_dict[temp_out->id()]  = shape;
+          type_dict[temp_out->id()]   = type;
+          layout_dict[temp_out->id()] = src_layout;
+          UpdateInferInfos(trans_node,
+                           {shape},
+                           {type},
+                           {src_layout},
+                           graph->target_,
+                           op_infershape,
+                           op_inferdtype,
+                           op_inferlayout,
+                           &shape_dict,
+                           &type_dict,
+                           &layout_dict);
+          for (auto* consumer : consumers) {
+            framework::ReplaceGraphOpNodeInput(consumer, out_node, temp_out);
           }
-          break;
         }
       }
       graph->ClearUnlinkedNodes(&shape_dict, &type_dict, &layout_dict);
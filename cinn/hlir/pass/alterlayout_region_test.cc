@@ -0,0 +1,152 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+
+namespace cinn {
+namespace frontend {
+
+// The tests of the layouts chosen for the regions between the convs, see SwitchRegionToNCHW in alterlayout.cc.
+
+TEST(AlterLayoutRegion, conv_add_add) {
+  Placeholder A(Float(32), {1, 3, 224, 224}, "A");
+  Placeholder B(Float(32), {64, 3, 7, 7}, "B");
+  Placeholder C(Float(32), {1, 64, 112, 112}, "C");
+  Placeholder D(Float(32), {1, 64, 112, 112}, "D");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]        = std::vector<int>({2, 2});
+  attrs["dilation"]      = std::vector<int>({1, 1});
+  attrs["padding"]       = std::vector<int>({3, 3});
+  std::string src_layout = "NCHW";
+  attrs["data_format"]   = src_layout;
+
+  auto c = program.conv2d(A, B, attrs);
+  auto d = program.elementwise_add(c, C);
+  auto e = program.elementwise_add(d, D);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B, C, D});
+  program.Validate();
+  LOG(INFO) << "Program:\n" << program;
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+  // the adds run in NCHW: only the input and weight of conv and the output of conv are transformed, instead of C, D
+  // and the final output as well
+  int trans_num = 0;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == "layout_transform") {
+      ++trans_num;
+    }
+  }
+  ASSERT_EQ(trans_num, 3);
+  auto scope = BuildScope(target, graph);
+
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  scope->Var<hlir::framework::Tensor>("A");
+  scope->Var<hlir::framework::Tensor>("B");
+  scope->Var<hlir::framework::Tensor>("C");
+  scope->Var<hlir::framework::Tensor>("D");
+
+  auto A1 = scope->GetTensor("A");
+  auto B1 = scope->GetTensor("B");
+  auto C1 = scope->GetTensor("C");
+  auto D1 = scope->GetTensor("D");
+  SetRandData<float>(A1, target);
+  SetRandData<float>(B1, target);
+  SetRandData<float>(C1, target);
+  SetRandData<float>(D1, target);
+
+  runtime_program->Execute();
+}
+
+TEST(AlterLayoutRegion, two_outputs) {
+  Placeholder A(Float(32), {1, 3, 224, 224}, "A");
+  Placeholder B(Float(32), {64, 3, 7, 7}, "B");
+  Placeholder C(Float(32), {1, 64, 112, 112}, "C");
+  Placeholder D(Float(32), {64, 64, 3, 3}, "D");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]        = std::vector<int>({2, 2});
+  attrs["dilation"]      = std::vector<int>({1, 1});
+  attrs["padding"]       = std::vector<int>({3, 3});
+  std::string src_layout = "NCHW";
+  attrs["data_format"]   = src_layout;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs1;
+  attrs1["stride"]      = std::vector<int>({1, 1});
+  attrs1["dilation"]    = std::vector<int>({1, 1});
+  attrs1["padding"]     = std::vector<int>({1, 1});
+  attrs1["data_format"] = src_layout;
+
+  auto c = program.conv2d(A, B, attrs);
+  auto d = program.elementwise_add(c, C);
+  auto e = program.conv2d(c, D, attrs1);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B, C, D});
+  program.Validate();
+  LOG(INFO) << "Program:\n" << program;
+  // the output of add is fetched although it is produced before the last conv
+  auto graph = std::make_shared<hlir::framework::Graph>(program, std::unordered_set<std::string>{d->id, e->id}, target);
+
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+  // the add runs in NCHW, which saves transforming C to the blocked layout and its output back to NCHW as an output
+  // of the graph, both outputs are in NCHW finally
+  const auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  ASSERT_EQ(shape_dict.at(d->id).size(), 4U);
+  ASSERT_EQ(shape_dict.at(e->id).size(), 4U);
+  auto scope = BuildScope(target, graph);
+
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  scope->Var<hlir::framework::Tensor>("A");
+  scope->Var<hlir::framework::Tensor>("B");
+  scope->Var<hlir::framework::Tensor>("C");
+  scope->Var<hlir::framework::Tensor>("D");
+
+  SetRandData<float>(scope->GetTensor("A"), target);
+  SetRandData<float>(scope->GetTensor("B"), target);
+  SetRandData<float>(scope->GetTensor("C"), target);
+  SetRandData<float>(scope->GetTensor("D"), target);
+
+  runtime_program->Execute();
+}
+
+}  // namespace frontend
+}  // namespace cinn
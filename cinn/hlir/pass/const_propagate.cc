@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
+#include <unordered_set>
+
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -34,7 +37,7 @@ void ConstPropagatePass(Graph* graph) {
   auto store_nodes = std::get<0>(graph->topological_order());
   for (auto& n : store_nodes) {
     auto node = n->safe_as<Node>();
-    if (node) {
+    if (node && !framework::IsNondeterministicOp(node->op()->name)) {
       bool is_all_const = true;
       for (auto& in_edge : node->inlinks_in_order(true)) {
         auto* source_node = in_edge->source()->safe_as<NodeData>();
@@ -0,0 +1,177 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/hlir/pass/fusion_helper_base.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+// An analytic cost model of the fusion decisions. Each fusion group is regarded as a kernel whose latency is estimated
+// by the roofline of its memory traffic and computation plus the launch overhead, where the memory traffic consists
+// of the data read from outside the group and the outputs written back. A fusion is profitable if the latency of the
+// fused kernels is less than the sum of the unfused ones, which accounts for the traffic of the intermediate data
+// saved, the recomputation of the producer fused into more than one consumer and the launches saved. Besides, a fused
+// kernel should not exceed the budget of the input streams and the number of ops, which increase the pressure of the
+// cache and the registers.
+class FusionCostModel {
+ public:
+  FusionCostModel(const framework::Graph* graph, const FusionHelperBase* helper) : helper_(helper) {
+    if (graph->HasAttr("inferdtype")) {
+      dtype_dict_ = &graph->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+    }
+    if (helper->target_.arch == common::Target::Arch::NVGPU) {
+      // about 500 GB/s, 10 TFLOPS and 5 us per launch.
+      bytes_per_ns_  = 500;
+      flops_per_ns_  = 10000;
+      launch_ns_     = 5000;
+      max_streams_   = 32;
+      max_fused_ops_ = 128;
+    }
+  }
+
+  // the estimated latency in ns of the kernel computing the nodes and writing the outputs.
+  double KernelLatency(const std::unordered_set<Node*>& nodes, const std::unordered_set<Node*>& outputs) const {
+    double bytes = 0, flops = 0;
+    for (auto* input : ExternalInputs(nodes)) {
+      bytes += DataBytes(input);
+    }
+    for (auto* node : nodes) {
+      flops += NodeFlops(node);
+      if (outputs.count(node)) {
+        for (auto& link : node->outlinks()) {
+          bytes += DataBytes(link->sink()->safe_as<NodeData>());
+        }
+      }
+    }
+    return std::max(bytes / bytes_per_ns_, flops / flops_per_ns_) + launch_ns_;
+  }
+
+  double GroupLatency(const std::shared_ptr<framework::Graph::Group>& group) const {
+    auto nodes = group->CollectNodes();
+    return KernelLatency({nodes.begin(), nodes.end()}, group->output_nodes);
+  }
+
+  // the latency saved by fusing the producer into each of the consumers, where the producer is recomputed in every
+  // fused kernel and its outputs are written by the first one if they are still used by others, a negative value
+  // means the fusion is unprofitable.
+  double VerticalFusionGain(const std::shared_ptr<framework::Graph::Group>& producer,
+                            const std::vector<std::shared_ptr<framework::Graph::Group>>& consumers,
+                            bool keep_producer_outputs) const {
+    if (consumers.empty()) return 0;
+    auto producer_nodes = producer->CollectNodes();
+    double unfused      = GroupLatency(producer);
+    double fused        = 0;
+    for (int idx = 0; idx < consumers.size(); ++idx) {
+      auto consumer_nodes = consumers[idx]->CollectNodes();
+      std::unordered_set<Node*> nodes(consumer_nodes.begin(), consumer_nodes.end());
+      nodes.insert(producer_nodes.begin(), producer_nodes.end());
+      if (ExceedBudget(nodes)) {
+        VLOG(4) << "Fusing " << producer->group_id << " into " << consumers[idx]->group_id << " exceeds the budget";
+        return -1;
+      }
+      std::unordered_set<Node*> outputs = consumers[idx]->output_nodes;
+      if (idx == 0 && keep_producer_outputs) {
+        outputs.insert(producer->output_nodes.begin(), producer->output_nodes.end());
+      }
+      fused   += KernelLatency(nodes, outputs);
+      unfused += GroupLatency(consumers[idx]);
+    }
+    VLOG(4) << "Fusing " << producer->group_id << " into " << consumers.size() << " consumers, unfused latency "
+            << unfused << " ns, fused latency " << fused << " ns";
+    return unfused - fused;
+  }
+
+  // whether a kernel computing the nodes increases the pressure of the cache or the registers too much.
+  bool ExceedBudget(const std::unordered_set<Node*>& nodes) const {
+    return static_cast<int>(nodes.size()) > max_fused_ops_ ||
+           static_cast<int>(ExternalInputs(nodes).size()) > max_streams_;
+  }
+
+  bool ExceedBudget(const std::vector<std::shared_ptr<framework::Graph::Group>>& groups) const {
+    std::unordered_set<Node*> nodes;
+    for (auto& group : groups) {
+      auto group_nodes = group->CollectNodes();
+      nodes.insert(group_nodes.begin(), group_nodes.end());
+    }
+    return ExceedBudget(nodes);
+  }
+
+ private:
+  std::unordered_set<NodeData*> ExternalInputs(const std::unordered_set<Node*>& nodes) const {
+    std::unordered_set<NodeData*> inputs;
+    for (auto* node : nodes) {
+      for (auto& link : node->inlinks()) {
+        auto* input = link->source()->safe_as<NodeData>();
+        CHECK(input);
+        if (!nodes.count(input->source_node.get())) {
+          inputs.insert(input);
+        }
+      }
+    }
+    return inputs;
+  }
+
+  double DataNumel(const NodeData* data) const {
+    if (!helper_->shape_dict_.count(data->id())) return 0;
+    auto& shape = helper_->shape_dict_.at(data->id());
+    return std::accumulate(shape.begin(), shape.end(), 1.0, std::multiplies<double>());
+  }
+
+  double DataBytes(const NodeData* data) const {
+    int bytes = 4;
+    if (dtype_dict_ && dtype_dict_->count(data->id())) {
+      bytes = std::max(dtype_dict_->at(data->id()).bytes(), 1);
+    }
+    return DataNumel(data) * bytes;
+  }
+
+  // one operation for each element of the largest of the inputs and the outputs, which covers the elementwise ops as
+  // well as the reductions.
+  double NodeFlops(const Node* node) const {
+    double numel = 0;
+    for (auto& link : node->inlinks()) {
+      numel = std::max(numel, DataNumel(link->source()->safe_as<NodeData>()));
+    }
+    for (auto& link : node->outlinks()) {
+      numel = std::max(numel, DataNumel(link->sink()->safe_as<NodeData>()));
+    }
+    return numel;
+  }
+
+  const FusionHelperBase* helper_;
+  const absl::flat_hash_map<std::string, Type>* dtype_dict_{nullptr};
+
+  // the default hardware parameters of x86, about 20 GB/s, 100 GFLOPS and 0.1 us per kernel call.
+  double bytes_per_ns_ = 20;
+  double flops_per_ns_ = 100;
+  double launch_ns_    = 100;
+  // the max number of input tensors streamed by a fused kernel.
+  int max_streams_ = 16;
+  // the max number of ops in a fused kernel.
+  int max_fused_ops_ = 64;
+};
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
@@ -67,6 +67,12 @@ class FusionHelperBase {
     }
   }
 
+  // the op marked as pre_run only runs once before all the runs, so can't be fused with the op running every time.
+  static bool IsPreRunOp(const framework::Node* node) {
+    auto iter = node->attrs.attr_store.find("pre_run");
+    return iter != node->attrs.attr_store.end() && absl::get<bool>(iter->second);
+  }
+
   NodeData* GetNodeData(const Node* node) const {
     auto node_data = (*node->outlinks().begin())->sink()->safe_as<NodeData>();
     CHECK(node_data);
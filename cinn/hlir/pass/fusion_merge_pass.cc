@@ -12,8 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
+
+#include "cinn/hlir/pass/fusion_cost_model.h"
 #include "cinn/hlir/pass/fusion_merge_pass_util.h"
 
+DECLARE_bool(cinn_use_fusion_cost_model);
+
 namespace cinn {
 namespace hlir {
 namespace pass {
@@ -41,7 +46,7 @@ using ConditionFunction = std::function<bool(const FusionHelperBase*, const Grou
 // code generation.
 class FusionMergePassHelper : public FusionHelperBase {
  public:
-  FusionMergePassHelper(const Graph* graph) : FusionHelperBase(graph) {
+  FusionMergePassHelper(const Graph* graph) : FusionHelperBase(graph), cost_model_(graph, this) {
     fusion_groups_ = graph->fusion_groups;
     // init fusion relation.
     InitFusionRelation();
@@ -174,6 +179,10 @@ class FusionMergePassHelper : public FusionHelperBase {
 
     std::unordered_set<GroupPtr, Hasher, Comparator> candidates;
     for (auto& consumer : consumers) {
+      // pre_run group only runs once, keep it alone.
+      if (IsPreRunGroup(consumer)) {
+        continue;
+      }
       // relation
       auto& relation = fusion_relation_map_[consumer->op_pattern_kind];
       // check horizontal relation exist
@@ -214,6 +223,15 @@ class FusionMergePassHelper : public FusionHelperBase {
           continue;
         }
 
+        if (FLAGS_cinn_use_fusion_cost_model) {
+          GroupList fused_groups = groups;
+          fused_groups.push_back(candidate);
+          if (cost_model_.ExceedBudget(fused_groups)) {
+            VLOG(4) << "Can't fuse " << candidate->group_id << " horizontally, as it exceeds the budget!";
+            continue;
+          }
+        }
+
         groups.push_back(candidate);
         fusionable = true;
         break;
@@ -393,6 +411,12 @@ class FusionMergePassHelper : public FusionHelperBase {
         continue;
       }
 
+      // pre_run group can't fuse with the group running every time.
+      if (IsPreRunGroup(producer) != IsPreRunGroup(consumer)) {
+        VLOG(4) << "Can't fuse producer " << producer->group_id << " consumer " << consumer->group_id;
+        continue;
+      }
+
       // if condition function is false
       if (!relation.vertical_relation[consumer->op_pattern_kind](this, producer, consumer)) {
         VLOG(4) << "Can't fuse producer " << producer->group_id << " consumer " << consumer->group_id;
@@ -413,7 +437,11 @@ class FusionMergePassHelper : public FusionHelperBase {
     }
 
     if (fusionable_consumers.size()) {
-      RecomputeWithCostModel(producer, fusionable_consumers);
+      if (FLAGS_cinn_use_fusion_cost_model && !is_const_group(this, producer)) {
+        SelectConsumersWithCostModel(producer, fusionable_consumers);
+      } else {
+        RecomputeWithCostModel(producer, fusionable_consumers);
+      }
     }
 
     // if fusionable consumers exist
@@ -665,6 +693,83 @@ class FusionMergePassHelper : public FusionHelperBase {
     }
   }
 
+  // search the subsets of the fusionable consumers for the one with the max gain estimated by the cost model, the
+  // consumers out of the subset read the outputs of the producer from memory instead.
+  void SelectConsumersWithCostModel(const GroupPtr& producer,
+                                    std::unordered_set<GroupPtr, Hasher, Comparator>& fusionable_consumers) {
+    if (producer->op_pattern_kind == framework::kReduction) {
+      CHECK_EQ(fusionable_consumers.size(), 1) << "Find more than one consumer can fuse to " << producer->group_id;
+    }
+    // keep the candidates in order, so the search is deterministic.
+    GroupList candidates(fusionable_consumers.begin(), fusionable_consumers.end());
+    std::sort(candidates.begin(), candidates.end(), [this](const GroupPtr& first, const GroupPtr& second) {
+      return fusion_groups_index_[first] < fusion_groups_index_[second];
+    });
+
+    // whether the outputs of the producer are still used out of the fused consumers.
+    auto keep_producer_outputs = [&](const GroupList& fused_consumers) {
+      for (auto& node : producer->output_nodes) {
+        if (output_nodes_set_.count(node)) {
+          return true;
+        }
+      }
+      std::unordered_set<GroupPtr, Hasher, Comparator> fused_set(fused_consumers.begin(), fused_consumers.end());
+      for (auto& consumer : producer->consumer_groups) {
+        if (!fused_set.count(consumer)) {
+          return true;
+        }
+      }
+      return false;
+    };
+
+    GroupList best_consumers;
+    double best_gain   = 0;
+    auto try_consumers = [&](const GroupList& fused_consumers) {
+      double gain = cost_model_.VerticalFusionGain(producer, fused_consumers, keep_producer_outputs(fused_consumers));
+      if (gain > best_gain) {
+        best_gain      = gain;
+        best_consumers = fused_consumers;
+      }
+    };
+
+    if (candidates.size() <= kMaxSearchConsumers) {
+      // exhaustive search over all the subsets.
+      for (int mask = 1; mask < (1 << candidates.size()); ++mask) {
+        GroupList fused_consumers;
+        for (int idx = 0; idx < candidates.size(); ++idx) {
+          if ((mask >> idx) & 1) {
+            fused_consumers.push_back(candidates[idx]);
+          }
+        }
+        try_consumers(fused_consumers);
+      }
+    } else {
+      // search the prefixes of the candidates sorted by the gain of fusing into each of them.
+      std::unordered_map<GroupPtr, double, Hasher, Comparator> gains;
+      for (auto& candidate : candidates) {
+        gains[candidate] = cost_model_.VerticalFusionGain(producer, {candidate}, true);
+      }
+      std::stable_sort(candidates.begin(), candidates.end(), [&](const GroupPtr& first, const GroupPtr& second) {
+        return gains[first] > gains[second];
+      });
+      GroupList fused_consumers;
+      for (auto& candidate : candidates) {
+        fused_consumers.push_back(candidate);
+        try_consumers(fused_consumers);
+      }
+    }
+
+    VLOG(3) << "Cost model selects " << best_consumers.size() << " of " << candidates.size()
+            << " consumers to fuse producer " << producer->group_id << ", gain " << best_gain << " ns";
+    fusionable_consumers.clear();
+    fusionable_consumers.insert(best_consumers.begin(), best_consumers.end());
+  }
+
+  bool IsPreRunGroup(const GroupPtr& group) {
+    auto nodes = group->CollectNodes();
+    return std::all_of(nodes.begin(), nodes.end(), [](const Node* node) { return IsPreRunOp(node); });
+  }
+
   bool IsDependency(const GroupPtr& producer_g,
                     const GroupPtr& consumer,
                     const std::unordered_set<GroupPtr, Hasher, Comparator>& consumers) {
@@ -923,6 +1028,11 @@ class FusionMergePassHelper : public FusionHelperBase {
     std::unordered_map<framework::OpPatternKind, ConditionFunction> horizontal_relation;
   };
   std::unordered_map<framework::OpPatternKind, Relation> fusion_relation_map_;
+
+  // the cost model used if FLAGS_cinn_use_fusion_cost_model is true.
+  FusionCostModel cost_model_;
+  // the max number of consumers to search all the subsets of.
+  static constexpr int kMaxSearchConsumers = 8;
 };
 
 void FusionMergePassInternal(Graph* graph) {
@@ -12,10 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include "cinn/frontend/decomposer/test_helper.h"
 
+DECLARE_bool(cinn_use_fusion_cost_model);
+
 namespace cinn {
 namespace frontend {
 
@@ -483,5 +486,65 @@ TEST(FusionMergePass, Reduce_Test_5) {
   CHECK_EQ(graph->fusion_groups.size(), 1);
 }
 
+TEST(FusionMergePass, CostModel_ElementWise) {
+  int h = 32, w = 32;
+  NetBuilder net_builder("CostModel_ElementWise");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {h, w}, "B");
+    auto C = net_builder.CreateInput(Float(32), {h, w}, "C");
+    auto D = net_builder.CreateInput(Float(32), {h, w}, "D");
+    auto E = net_builder.Add(A, B);
+    auto F = net_builder.Add(E, C);
+    auto G = net_builder.Add(E, D);
+  }
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+  RunDecomposer(&program, target);
+
+  FLAGS_cinn_use_fusion_cost_model = true;
+  auto graph                       = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  CHECK_EQ(graph->fusion_groups.size(), 3);
+  // fusing E into both consumers saves the traffic of E as well as the launches.
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+  CHECK_EQ(graph->fusion_groups.size(), 1);
+  FLAGS_cinn_use_fusion_cost_model = false;
+}
+
+TEST(FusionMergePass, CostModel_Budget) {
+  int h = 32, w = 32;
+
+  auto build_program = [&]() {
+    NetBuilder net_builder("CostModel_Budget");
+    // create model, a chain of adds streaming 40 inputs.
+    Variable X = net_builder.CreateInput(Float(32), {h, w}, "X0");
+    for (int idx = 1; idx < 40; ++idx) {
+      X = net_builder.Add(X, net_builder.CreateInput(Float(32), {h, w}, "X" + std::to_string(idx)));
+    }
+    return net_builder.Build();
+  };
+  auto target = common::DefaultTarget();
+
+  auto program = build_program();
+  RunDecomposer(&program, target);
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  CHECK_EQ(graph->fusion_groups.size(), 1);
+
+  // the fused kernels are limited by the budget of the input streams.
+  FLAGS_cinn_use_fusion_cost_model = true;
+  program                          = build_program();
+  RunDecomposer(&program, target);
+  graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  CHECK_GT(graph->fusion_groups.size(), 1);
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+  CHECK_GT(graph->fusion_groups.size(), 1);
+  FLAGS_cinn_use_fusion_cost_model = false;
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -0,0 +1,242 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gflags/gflags.h>
+
+#include <map>
+
+#include "cinn/hlir/pass/fusion_helper_base.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::OpPatternKind;
+using framework::shape_t;
+
+using Comparator = Graph::Group::SharedGroupComparator;
+using Hasher     = Graph::Group::SharedGroupHasher;
+
+using GroupPtr  = std::shared_ptr<Graph::Group>;
+using GroupList = std::vector<GroupPtr>;
+
+// Horizontal Fusion Pass which packs the independent small Fusion-Ops into one kernel. Each Fusion-Op is still
+// lowered by its own, and the outermost loops of them are merged into one loop with a dispatch index when lowering,
+// so that the packed Fusion-Ops are launched only once.
+class HorizontalFusionPassHelper : public FusionHelperBase {
+ public:
+  HorizontalFusionPassHelper(const Graph* graph) : FusionHelperBase(graph) { fusion_groups_ = graph->fusion_groups; }
+
+  GroupList operator()() {
+    // the groups with the same depth are independent of each other.
+    std::unordered_map<GroupPtr, int, Hasher, Comparator> depths;
+    if (!InitGroupDepths(&depths)) {
+      VLOG(3) << "The fusion groups are not in topological order, skip horizontal fusion.";
+      return fusion_groups_;
+    }
+
+    std::map<int, GroupList> groups_by_depth;
+    std::map<int, GroupList> candidates_by_depth;
+    for (auto& group : fusion_groups_) {
+      if (CanPack(group)) {
+        candidates_by_depth[depths[group]].push_back(group);
+      } else {
+        groups_by_depth[depths[group]].push_back(group);
+      }
+    }
+
+    // the groups are re-ordered by depth, which is still a topological order.
+    GroupList fusion_groups;
+    int max_depth = groups_by_depth.empty() ? -1 : groups_by_depth.rbegin()->first;
+    if (!candidates_by_depth.empty()) {
+      max_depth = std::max(max_depth, candidates_by_depth.rbegin()->first);
+    }
+    for (int depth = 0; depth <= max_depth; ++depth) {
+      auto& groups = groups_by_depth[depth];
+      fusion_groups.insert(fusion_groups.end(), groups.begin(), groups.end());
+
+      auto& candidates = candidates_by_depth[depth];
+      for (int idx = 0; idx < candidates.size(); idx += kMaxPackedGroups) {
+        int end = std::min(idx + kMaxPackedGroups, static_cast<int>(candidates.size()));
+        if (end - idx == 1) {
+          fusion_groups.push_back(candidates[idx]);
+        } else {
+          fusion_groups.push_back(PackGroups(GroupList(candidates.begin() + idx, candidates.begin() + end)));
+        }
+      }
+    }
+    CHECK_LE(fusion_groups.size(), fusion_groups_.size());
+    return fusion_groups;
+  }
+
+ private:
+  // depth is the length of the longest path from the graph inputs to the group.
+  bool InitGroupDepths(std::unordered_map<GroupPtr, int, Hasher, Comparator>* depths) {
+    std::unordered_map<Node*, GroupPtr> output_node_to_group;
+    for (auto& group : fusion_groups_) {
+      for (auto node : group->output_nodes) {
+        output_node_to_group[node] = group;
+      }
+    }
+
+    for (auto& group : fusion_groups_) {
+      auto nodes = group->CollectNodes();
+      std::unordered_set<Node*> nodes_set(nodes.begin(), nodes.end());
+
+      int depth = 0;
+      for (auto node : nodes) {
+        for (auto producer : GetProducerNode(node)) {
+          if (nodes_set.count(producer) || !output_node_to_group.count(producer)) {
+            continue;
+          }
+          auto& producer_group = output_node_to_group[producer];
+          if (!depths->count(producer_group)) {
+            return false;
+          }
+          depth = std::max(depth, depths->at(producer_group) + 1);
+        }
+      }
+      (*depths)[group] = depth;
+    }
+    return true;
+  }
+
+  bool CanPack(const GroupPtr& group) {
+    // only the Elementwise/Broadcast/Injective groups share the same schedule.
+    if (static_cast<int>(group->op_pattern_kind) > static_cast<int>(framework::kInjective)) {
+      return false;
+    }
+
+    auto nodes = group->CollectNodes();
+    if (std::any_of(nodes.begin(), nodes.end(), [](const Node* node) { return IsPreRunOp(node); })) {
+      return false;
+    }
+
+    // only the small kernels are dominated by the launch overhead.
+    for (auto node : group->master_nodes) {
+      auto shape = GetNodeDataShape(node);
+      auto size  = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
+      if (size > kMaxPackedSize) {
+        return false;
+      }
+    }
+    return !group->master_nodes.empty();
+  }
+
+  GroupPtr PackGroups(const GroupList& groups) {
+    VLOG(3) << "Pack " << groups.size() << " Groups...";
+    auto packed_group = std::make_shared<Graph::Group>();
+    for (auto& group : groups) {
+      VLOG(3) << "pack group " << group->group_id << " into packed_group!";
+      // update depth
+      packed_group->max_depth = std::max(packed_group->max_depth, group->max_depth);
+      packed_group->min_depth = std::min(packed_group->min_depth, group->min_depth);
+      // update group id
+      if (packed_group->group_id.size()) {
+        packed_group->group_id += "_" + group->group_id;
+      } else {
+        packed_group->group_id = group->group_id;
+      }
+      // set op pattern kind
+      packed_group->op_pattern_kind =
+          static_cast<int>(packed_group->op_pattern_kind) >= static_cast<int>(group->op_pattern_kind)
+              ? packed_group->op_pattern_kind
+              : group->op_pattern_kind;
+      // input nodes
+      for (auto& node : group->input_nodes) {
+        if (packed_group->input_nodes.count(node.first)) {
+          packed_group->input_nodes[node.first] += node.second;
+        } else {
+          packed_group->input_nodes.insert(node);
+        }
+      }
+      // output, internal and master nodes, each group keeps its own master node.
+      packed_group->output_nodes.insert(group->output_nodes.begin(), group->output_nodes.end());
+      packed_group->internal_nodes.insert(group->internal_nodes.begin(), group->internal_nodes.end());
+      packed_group->master_nodes.insert(group->master_nodes.begin(), group->master_nodes.end());
+      // insert sub group
+      if (group->fused_sub_groups.size()) {
+        for (auto& sub_group : group->fused_sub_groups) {
+          packed_group->fused_sub_groups.push_back(sub_group);
+          sub_group->belong_groups.insert(packed_group);
+        }
+      } else {
+        packed_group->fused_sub_groups.push_back(group);
+      }
+      // producer group
+      for (auto& producer : group->producer_groups) {
+        packed_group->producer_groups.insert(producer);
+        // update producer's consumer
+        producer->consumer_groups.erase(group);
+        producer->consumer_groups.insert(packed_group);
+      }
+      // consumer group
+      for (auto& consumer : group->consumer_groups) {
+        packed_group->consumer_groups.insert(consumer);
+        // update consumer's producer
+        consumer->producer_groups.erase(group);
+        consumer->producer_groups.insert(packed_group);
+      }
+      // belongs group
+      group->belong_groups.insert(packed_group);
+      // packed group
+      packed_group->horizontal_groups.push_back(group);
+    }
+
+    CHECK(packed_group->output_nodes.size()) << "No output node is found, " << packed_group->group_id;
+    return packed_group;
+  }
+
+  GroupList fusion_groups_;
+
+  // the max number of elements of the group to pack.
+  static constexpr int kMaxPackedSize = 64 * 1024;
+  // the max number of groups packed into one kernel.
+  static constexpr int kMaxPackedGroups = 16;
+};
+
+void HorizontalFusionPassInternal(Graph* graph) {
+  if (!FLAGS_cinn_ir_schedule) {
+    VLOG(3) << "Horizontal Fusion Pass only supports the new IR schedule...!";
+    return;
+  }
+  if (graph->fusion_groups.size() <= 1) {
+    VLOG(3) << "Don't do Horizontal Fusion Pass...!";
+    return;
+  }
+
+  HorizontalFusionPassHelper horizontal_fusion_pass_helper(graph);
+  graph->fusion_groups = horizontal_fusion_pass_helper();
+  VLOG(3) << "After HorizontalFusionPass:\n" << graph->DebugGroupedGraph(std::unordered_set<std::string>{});
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(HorizontalFusionPass) {
+  CINN_REGISTER_PASS(HorizontalFusionPass)
+      .describe(
+          "Horizontal Fusion Pass which packs the independent small Fusion-Ops into one kernel with a dispatch index.")
+      .set_change_structure(false)
+      .set_body(cinn::hlir::pass::HorizontalFusionPassInternal);
+
+  return true;
+}
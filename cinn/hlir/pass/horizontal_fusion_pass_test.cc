@@ -0,0 +1,80 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+
+namespace cinn {
+namespace frontend {
+
+TEST(HorizontalFusionPass, Pack_Independent_Groups) {
+  NetBuilder net_builder("Pack_Independent_Groups");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {32}, "A");
+    auto B = net_builder.CreateInput(Float(32), {32}, "B");
+    auto C = net_builder.CreateInput(Float(32), {16, 64}, "C");
+    auto D = net_builder.CreateInput(Float(32), {16, 64}, "D");
+    auto E = net_builder.CreateInput(Float(32), {8, 8, 8}, "E");
+    auto F = net_builder.CreateInput(Float(32), {256, 512}, "F");
+    auto G = net_builder.CreateInput(Float(32), {256, 512}, "G");
+    auto H = net_builder.Add(A, B);
+    auto I = net_builder.Subtract(C, D);
+    auto J = net_builder.Relu(E);
+    // too large to be packed.
+    auto K = net_builder.Add(F, G);
+  }
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+  CHECK_EQ(graph->fusion_groups.size(), 4);
+  hlir::framework::ApplyPass(graph.get(), "HorizontalFusionPass");
+  CHECK_EQ(graph->fusion_groups.size(), 2);
+}
+
+TEST(HorizontalFusionPass, Compare_Result) {
+  NetBuilder net_builder("Compare_Result");
+  auto A = net_builder.CreateInput(Float(32), {32}, "A");
+  auto B = net_builder.CreateInput(Float(32), {32}, "B");
+  auto C = net_builder.CreateInput(Float(32), {16, 64}, "C");
+  auto D = net_builder.CreateInput(Float(32), {64}, "D");
+  auto E = net_builder.CreateInput(Float(32), {8, 8, 8}, "E");
+  auto F = net_builder.Add(A, B);
+  auto G = net_builder.Multiply(C, D);
+  auto H = net_builder.Relu(E);
+  // depends on F, can't be packed with F.
+  auto I = net_builder.Transpose(net_builder.Reshape(F, {4, 8}), {1, 0});
+  auto J = net_builder.Subtract(C, C);
+
+  auto program = net_builder.Build();
+
+  auto target = common::DefaultTarget();
+  std::vector<std::string> input_ids;
+  absl::c_transform(std::vector<absl::string_view>{A.id(), B.id(), C.id(), D.id(), E.id()},
+                    std::back_inserter(input_ids),
+                    [](absl::string_view id) { return std::string(id); });
+  OptimizeConfig passes(
+      {{}, {}}, {{"OpFusionPass", "FusionMergePass"}, {"OpFusionPass", "FusionMergePass", "HorizontalFusionPass"}});
+  CompareResult(&program, target, input_ids, {F->id, G->id, H->id, I->id, J->id}, 0, std::move(passes), 123);
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -12,9 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
+
 #include "cinn/common/type.h"
+#include "cinn/hlir/pass/fusion_cost_model.h"
 #include "cinn/hlir/pass/op_fusion_pass_util.h"
 
+DECLARE_bool(cinn_use_fusion_cost_model);
+
 namespace cinn {
 namespace hlir {
 namespace pass {
@@ -39,7 +44,7 @@ using ConditionFunction = std::function<bool(const FusionHelperBase*, const Node
 // code generation.
 class OpFusionPassHelper : public FusionHelperBase {
  public:
-  OpFusionPassHelper(const Graph* graph) : FusionHelperBase(graph) {
+  OpFusionPassHelper(const Graph* graph) : FusionHelperBase(graph), cost_model_(graph, this) {
     // init fusion relation
     InitFusionRelation();
     // filter node data, create group for each node
@@ -150,6 +155,11 @@ class OpFusionPassHelper : public FusionHelperBase {
         if (GetOpKind(producer) == framework::kNonFusible) {
           continue;
         }
+        // pre_run op can't fuse with the op running every time.
+        if (IsPreRunOp(producer) != IsPreRunOp(consumer)) {
+          VLOG(3) << "Op " << producer->id() << " and Op " << consumer->id() << " are not all pre_run.";
+          continue;
+        }
         VLOG(3) << "Producer Op: " << producer->id() << ", Op Pattern: " << GetOpKind(producer)
                 << " -> Consumer Op: " << consumer->id() << ", Op Pattern: " << GetOpKind(consumer);
         bool can_fuse = true;
@@ -165,6 +175,14 @@ class OpFusionPassHelper : public FusionHelperBase {
         }
 
         if (!can_fuse || !CanFuse(producer, consumer)) continue;
+        if (FLAGS_cinn_use_fusion_cost_model) {
+          std::unordered_set<Node*> fused_nodes = consumer_fusion->nodes_set;
+          fused_nodes.insert(producer);
+          if (cost_model_.ExceedBudget(fused_nodes)) {
+            VLOG(3) << "Can't fuse Op " << producer->id() << " into Op " << consumer->id() << ", exceeding the budget";
+            continue;
+          }
+        }
         VLOG(3) << "Fuse Op " << producer->id() << " into Op " << consumer->id();
 
         // fuse producer to fusion group
@@ -285,15 +303,15 @@ class OpFusionPassHelper : public FusionHelperBase {
     {
       FusionRelation relation;
       // producer -> consumer
-      relation.op_kind = {framework::kElementWise, framework::kInjective};
+      relation.op_kind = {framework::kElementWise, framework::kReduction, framework::kInjective};
       // producer -> fusion
       relation.fusion_op_kind = {
           // can be horizontal or vertical(Injective + Elementwise), check with same output shape.
           {framework::kElementWise, is_same_size},
           // must be horizontal relation, check with same output shape.
           {framework::kBroadcast, horizontal_with_same_size},
-          // left to fusion merge pass.
-          {framework::kReduction, no_fuse},
+          // vertical relation(Injective + Reduce), fuse as the prologue of reduce without recomputation.
+          {framework::kReduction, injective_prologue_of_reduce},
           // must be horizontal relation, check with same output shape.
           {framework::kInjective, horizontal_or_can_inline},
           // can't fuse.
@@ -344,6 +362,9 @@ class OpFusionPassHelper : public FusionHelperBase {
     std::unordered_map<framework::OpPatternKind, ConditionFunction> fusion_op_kind = {};
   };
   std::unordered_map<framework::OpPatternKind, FusionRelation> fusion_relation_map_;
+
+  // the cost model used if FLAGS_cinn_use_fusion_cost_model is true.
+  FusionCostModel cost_model_;
 };
 
 void InsertBroadcastTo(Graph* graph) {
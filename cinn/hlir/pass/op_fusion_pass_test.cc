@@ -212,6 +212,49 @@ TEST(OpFusionPass, Injective_Test_0) {
   CHECK_EQ(graph->fusion_groups.size(), 1);
 }
 
+TEST(OpFusionPass, Injective_Test_1) {
+  int h = 32, w = 64;
+  NetBuilder net_builder("Injective_Test_1");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {w, h}, "B");
+    auto C = net_builder.Transpose(A, {1, 0});
+    auto D = net_builder.Add(B, C);
+    auto E = net_builder.ReduceSum(D, {1});
+  }
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+  RunDecomposer(&program, target);
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  CHECK_EQ(graph->fusion_groups.size(), 1);
+}
+
+TEST(OpFusionPass, Injective_Test_2) {
+  int h = 32, w = 64;
+  NetBuilder net_builder("Injective_Test_2");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {w, h}, "B");
+    auto C = net_builder.Transpose(A, {1, 0});
+    auto D = net_builder.ReduceSum(C, {1});
+    auto E = net_builder.Add(B, C);
+  }
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+  RunDecomposer(&program, target);
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  // the transpose is read by both reduce and add, it is not recomputed in the reduce.
+  CHECK_EQ(graph->fusion_groups.size(), 3);
+}
+
 TEST(OpFusionPass, Test_Insert_BroadcastTo) {
   int h = 32, w = 32;
   NetBuilder net_builder("Test_Insert_BroadcastTo");
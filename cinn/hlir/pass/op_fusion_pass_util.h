@@ -216,6 +216,35 @@ CONDITION_FUNC(horizontal_or_vertical_reduce_relation) {
              : true;
 }
 
+CONDITION_FUNC(injective_prologue_of_reduce) {
+  // the injective producer only remaps the index of the reduce input, it is computed inside the loop nest of the
+  // reducer, so it must be read by the reducer alone and each of its elements must be loaded exactly once.
+  auto producer_data = helper->GetNodeData(producer);
+  if (helper->output_nodes_set_.count(producer) || producer_data->outlinks().size() != 1) {
+    return false;
+  }
+
+  Node* reducer = NULL;
+  for (auto* master : consumer->master_nodes) {
+    if (helper->GetOpKind(master) == framework::kReduction) {
+      reducer = master;
+      break;
+    }
+  }
+  CHECK(reducer) << "Can't find the reducer of group " << consumer->group_id;
+
+  // a smaller output would be broadcasted and recomputed by the reducer.
+  auto reduce_shape = helper->shape_dict_.at(helper->GetProducerNodeData(reducer)[0]->id());
+  auto reduce_size  = std::accumulate(reduce_shape.begin(), reduce_shape.end(), 1, std::multiplies<int>());
+  auto output_shape = helper->GetNodeDataShape(producer);
+  auto output_size  = std::accumulate(output_shape.begin(), output_shape.end(), 1, std::multiplies<int>());
+  if (output_size != reduce_size) {
+    return false;
+  }
+
+  return horizontal_or_vertical_reduce_relation(helper, producer, consumer);
+}
+
 CONDITION_FUNC(horizontal_or_can_inline) {
   // horizontal relation.
   if (is_horizontal_relation(helper, producer, consumer)) {
@@ -0,0 +1,113 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+namespace {
+
+// the index of the weight input of the ops whose kernels read the weight in a packed layout.
+const std::unordered_map<std::string, int>& WeightInputIndex() {
+  static std::unordered_map<std::string, int> weight_input_index = {
+      {"conv2d", 1}, {"conv2d_NCHWc", 1}, {"conv2d_winograd", 1}, {"depthwise_conv2d", 1}, {"matmul", 1}, {"mul", 1}};
+  return weight_input_index;
+}
+
+// the ops which only rearrange, convert or transform the weight into the form expected by the consumer kernel.
+const std::unordered_set<std::string>& WeightPackOps() {
+  static std::unordered_set<std::string> weight_pack_ops = {
+      "layout_transform", "transpose", "reshape", "cast", "winograd_weight_transform"};
+  return weight_pack_ops;
+}
+
+// Mark the packing ops producing the weight as pre_run if the weight can be computed from constants only,
+// return whether the weight is constant.
+bool PrePackWeight(NodeData* weight, int* packed_num) {
+  if (weight->is_const()) {
+    return true;
+  }
+  auto* producer = weight->source_node.get();
+  if (!producer || !WeightPackOps().count(producer->op()->name)) {
+    return false;
+  }
+  for (auto& in_edge : producer->inlinks_in_order(true)) {
+    auto* in_data = in_edge->source()->safe_as<NodeData>();
+    CHECK(in_data);
+    if (!PrePackWeight(in_data, packed_num)) {
+      return false;
+    }
+  }
+
+  producer->attrs.attr_store["pre_run"] = true;
+  for (auto& out_edge : producer->outlinks_in_order(true)) {
+    auto* out_data = out_edge->sink()->safe_as<NodeData>();
+    CHECK(out_data);
+    out_data->set_const(true);
+  }
+  ++(*packed_num);
+  VLOG(4) << producer->id() << " packs weight " << weight->id() << " in pre_run";
+  return true;
+}
+
+}  // namespace
+
+void PrePackWeightsPass(Graph* graph) {
+  int packed_num   = 0;
+  auto store_nodes = std::get<0>(graph->topological_order());
+  for (auto& n : store_nodes) {
+    auto node = n->safe_as<Node>();
+    if (!node || !WeightInputIndex().count(node->op()->name)) {
+      continue;
+    }
+    auto in_links = node->inlinks_in_order(true);
+    int index     = WeightInputIndex().at(node->op()->name);
+    if (index >= static_cast<int>(in_links.size())) {
+      continue;
+    }
+    auto* weight = in_links[index]->source()->safe_as<NodeData>();
+    CHECK(weight);
+    PrePackWeight(weight, &packed_num);
+  }
+  VLOG(3) << "PrePackWeights moves " << packed_num << " weight packing ops into pre_run";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(PrePackWeights) {
+  CINN_REGISTER_PASS(PrePackWeights)
+      .describe(
+          "This pass will mark the ops which pack the constant weights of conv and matmul with the attr[\"pre_run\"], "
+          "so that the packed weights are computed once in PreRun instead of in every run.")
+      .set_change_structure(false)
+      .provide_graph_attr("pre_run")
+      .set_body(cinn::hlir::pass::PrePackWeightsPass);
+  return true;
+}
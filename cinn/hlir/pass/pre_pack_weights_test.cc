@@ -0,0 +1,122 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+
+DECLARE_bool(cinn_use_winograd_conv);
+
+namespace cinn {
+namespace frontend {
+
+using hlir::framework::Scope;
+
+// run conv2d + relu with a constant weight on a hw x hw input, return the output and the number of the instructions
+// run in PreRun. Without AlterLayout, the winograd weight transform is computed inside the conv kernel.
+std::vector<float> RunConv2dRelu(bool use_winograd, int hw, bool alter_layout, int* prerun_num) {
+  bool origin_flag             = FLAGS_cinn_use_winograd_conv;
+  FLAGS_cinn_use_winograd_conv = use_winograd;
+  Placeholder A(Float(32), {1, 64, hw, hw}, "A");
+  Placeholder B(Float(32), {64, 64, 3, 3}, "B", true);
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({1, 1});
+  attrs["data_format"] = std::string("NCHW");
+
+  auto c = program.conv2d(A, B, attrs);
+  auto d = program.relu(c);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B});
+  program.Validate();
+  LOG(INFO) << "Program:\n" << program;
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  if (alter_layout) {
+    hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+    hlir::framework::ApplyPass(graph.get(), "PrePackWeights");
+  }
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+  auto scope = BuildScope(target, graph);
+
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  *prerun_num          = runtime_program->GetPreRunInstructions().size();
+  CHECK_GE(runtime_program->GetRunInstructions().size(), 1);
+
+  auto A1 = scope->GetTensor("A");
+  auto B1 = scope->GetTensor("B");
+  SetRandData<float>(A1, target, 1);
+  SetRandData<float>(B1, target, 2);
+
+  runtime_program->PreRun();
+  runtime_program->Execute();
+  FLAGS_cinn_use_winograd_conv = origin_flag;
+  return GetTensorData<float>(scope->GetTensor(d->id), target);
+}
+
+void CheckWinogradConv2d(int hw, bool alter_layout, int expect_prerun_num) {
+  int prerun_num = 0;
+  auto expect    = RunConv2dRelu(false, hw, alter_layout, &prerun_num);
+  auto out       = RunConv2dRelu(true, hw, alter_layout, &prerun_num);
+  ASSERT_EQ(prerun_num, expect_prerun_num);
+  ASSERT_EQ(out.size(), expect.size());
+  for (int i = 0; i < out.size(); i++) {
+    ASSERT_NEAR(out[i], expect[i], 1e-3 * (1 + std::abs(expect[i])));
+  }
+}
+
+TEST(PrePackWeights, conv2d_NCHWc) {
+  int prerun_num = 0;
+  RunConv2dRelu(false, 56, true, &prerun_num);
+  // only the layout_transform of the weight runs in PreRun, the conv keeps running every time.
+  ASSERT_EQ(prerun_num, 1);
+}
+
+TEST(PrePackWeights, conv2d_winograd) {
+  // F(4x4, 3x3), only the winograd_weight_transform runs in PreRun
+  CheckWinogradConv2d(56, true, 1);
+}
+
+TEST(PrePackWeights, conv2d_winograd_f2x2) {
+  // F(2x2, 3x3) is used for the outputs smaller than 8x8
+  CheckWinogradConv2d(6, true, 1);
+}
+
+TEST(PrePackWeights, conv2d_winograd_in_kernel) {
+  // without AlterLayout the weight is transformed inside the conv kernel, so nothing runs in PreRun
+  CheckWinogradConv2d(56, false, 0);
+  CheckWinogradConv2d(6, false, 0);
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,283 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/context.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+
+DECLARE_int64(cinn_rematerialization_memory_budget);
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::OpPatternKind;
+
+using dtype_dict_t = absl::flat_hash_map<std::string, common::Type>;
+using shape_dict_t = absl::flat_hash_map<std::string, framework::shape_t>;
+
+namespace {
+
+// The live range of a variable produced by an op node, the steps are the positions of the op nodes in the
+// topological order, computed in the same way as GraphCompiler::AnalyzeVariableLifeTime does on instructions.
+struct LiveRange {
+  int64_t bytes = 0;
+  int def       = 0;
+  int last      = 0;
+  // the consumers with the steps they run at
+  std::vector<std::pair<int, Node*>> uses;
+};
+
+class RematerializationPass {
+ public:
+  explicit RematerializationPass(Graph* graph)
+      : graph_(graph),
+        dtype_dict_(graph->GetMutableAttrs<dtype_dict_t>("inferdtype")),
+        shape_dict_(graph->GetMutableAttrs<shape_dict_t>("infershape")),
+        op_pattern_dict_(framework::Operator::GetAttrs<OpPatternKind>("OpPattern")) {}
+
+  // Recompute the cheap forward ops for their late consumers until the peak memory of the variables fits into the
+  // budget, return the number of the rematerialized variables. Each rematerialization moves the late uses of a
+  // variable to its recomputed copies, so the iteration ends in a bounded number of steps.
+  int operator()(int64_t budget) {
+    int remat_num = 0;
+    while (true) {
+      Analyze();
+      auto peak = std::max_element(live_bytes_.begin(), live_bytes_.end());
+      if (peak == live_bytes_.end() || *peak <= budget) {
+        break;
+      }
+      int peak_step = peak - live_bytes_.begin();
+      auto* var     = SelectVariable(peak_step);
+      if (!var) {
+        VLOG(3) << "The peak memory " << *peak << " bytes at step " << peak_step << " exceeds the budget " << budget
+                << " bytes, but no variable can be rematerialized to reduce it.";
+        break;
+      }
+      Rematerialize(var, peak_step);
+      ++remat_num;
+    }
+    return remat_num;
+  }
+
+ private:
+  OpPatternKind GetOpKind(const Node* node) const {
+    if (!op_pattern_dict_.Find(node->op())) {
+      return framework::kNonFusible;
+    }
+    auto kind = op_pattern_dict_[node->op()];
+    // as binary op was defined as broadcast, actually it should be element-wise.
+    if (kind == framework::kBroadcast && node->op()->name != "broadcast_to") {
+      return framework::kElementWise;
+    }
+    return kind;
+  }
+
+  int64_t GetNumel(const NodeData* var) const {
+    const auto& shape = shape_dict_.at(var->id());
+    return std::accumulate(shape.begin(), shape.end(), 1L, std::multiplies<int64_t>());
+  }
+
+  int64_t GetBytes(const NodeData* var) const { return GetNumel(var) * dtype_dict_.at(var->id()).bytes(); }
+
+  void Analyze() {
+    std::unordered_map<const Node*, int> node_steps;
+    vars_.clear();
+    int num_steps = 0;
+    for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node && !remat_nodes_.count(node)) {
+        node_steps[node] = num_steps++;
+      }
+      auto* var = graph_node->safe_as<NodeData>();
+      if (var && var->source_node.get() && !var->is_const()) {
+        vars_.push_back(var);
+      }
+    }
+    // a recomputed node is fused into its only consumer, so it runs at the step of the consumer.
+    std::function<int(const Node*)> get_step = [&](const Node* node) -> int {
+      if (!remat_nodes_.count(node)) {
+        return node_steps.at(node);
+      }
+      auto* output = node->outlinks_in_order().front()->sink();
+      return get_step(output->outlinks().begin()->get()->sink()->safe_as<Node>());
+    };
+
+    ranges_.clear();
+    live_bytes_.assign(num_steps + 1, 0);
+    for (auto* var : vars_) {
+      auto& range = ranges_[var];
+      range.bytes = GetBytes(var);
+      range.def   = get_step(var->source_node.get());
+      range.last  = range.def;
+      for (auto& edge : var->outlinks()) {
+        auto* consumer = edge->sink()->safe_as<Node>();
+        CHECK(consumer);
+        range.uses.emplace_back(get_step(consumer), consumer);
+        range.last = std::max(range.last, range.uses.back().first);
+      }
+      // the fetched variables live until the end of the graph
+      if (std::find(graph_->outputs.begin(), graph_->outputs.end(), var) != graph_->outputs.end()) {
+        range.last = num_steps;
+      }
+      for (int step = range.def; step <= range.last; ++step) {
+        live_bytes_[step] += range.bytes;
+      }
+    }
+  }
+
+  bool CanRecompute(const Node* producer) const {
+    if (producer->attrs.attr_store.count("pre_run") || framework::IsNondeterministicOp(producer->op()->name) ||
+        producer->outlinks().size() != 1) {
+      return false;
+    }
+    return GetOpKind(producer) <= framework::kBroadcast;
+  }
+
+  // the recomputed copy is fused into the consumer, so it does not hold a buffer across the peak
+  bool CanFuseInto(const NodeData* var, const Node* consumer) const {
+    auto kind = GetOpKind(consumer);
+    if (kind == framework::kReduction) {
+      return true;
+    }
+    if (kind > framework::kInjective) {
+      return false;
+    }
+    return GetNumel(var) == GetNumel(consumer->outlinks_in_order().front()->sink()->safe_as<NodeData>());
+  }
+
+  // Select the variable saving the most memory at the peak step when it is recomputed for the consumers after the
+  // peak step instead of being kept alive across it.
+  NodeData* SelectVariable(int peak_step) const {
+    NodeData* best_var = nullptr;
+    int64_t best_gain  = 0;
+    for (auto* var : vars_) {
+      const auto& range = ranges_.at(var);
+      if (range.def >= peak_step || range.last <= peak_step || !CanRecompute(var->source_node.get())) {
+        continue;
+      }
+      // the variable should be used before the peak step, otherwise the producer is simply scheduled too early
+      bool has_early_use = false, can_fuse = true;
+      for (auto& use : range.uses) {
+        has_early_use |= use.first < peak_step;
+        can_fuse      &= use.first < peak_step || (use.first > peak_step && CanFuseInto(var, use.second));
+      }
+      if (!has_early_use || !can_fuse) {
+        continue;
+      }
+
+      // the inputs of the producer live until the late consumers now
+      int64_t gain = range.bytes;
+      std::unordered_set<const NodeData*> inputs;
+      for (auto& edge : var->source_node->inlinks()) {
+        auto* input = edge->source()->safe_as<NodeData>();
+        auto it     = ranges_.find(input);
+        if (inputs.insert(input).second && it != ranges_.end() && it->second.last < peak_step) {
+          gain -= it->second.bytes;
+        }
+      }
+      if (gain > best_gain) {
+        best_var  = var;
+        best_gain = gain;
+      }
+    }
+    return best_var;
+  }
+
+  void Rematerialize(NodeData* var, int peak_step) {
+    auto* producer = var->source_node.get();
+    std::unordered_set<Node*> late_consumers;
+    for (auto& use : ranges_.at(var).uses) {
+      if (use.first > peak_step) {
+        late_consumers.insert(use.second);
+      }
+    }
+    for (auto* consumer : late_consumers) {
+      auto node = common::Shared<Node>(
+          new Node(producer->op(), producer->attrs.node_name, common::UniqName(producer->id() + "_remat")));
+      node->attrs.attr_store = producer->attrs.attr_store;
+      for (auto& edge : producer->inlinks_in_order()) {
+        edge->source()->LinkTo(node.get());
+      }
+      auto* output = new NodeData(node, 0, 0, common::UniqName(var->id() + "_remat"), false);
+      node->LinkTo(output);
+      graph_->RegisterNode(node->id(), node.get());
+      graph_->RegisterNode(output->id(), output);
+      dtype_dict_[output->id()] = dtype_dict_.at(var->id());
+      shape_dict_[output->id()] = shape_dict_.at(var->id());
+
+      framework::ReplaceGraphOpNodeInput(consumer, var, output);
+      remat_nodes_.insert(node.get());
+    }
+    VLOG(3) << "Rematerialize " << var->id() << " produced by " << producer->id() << " for " << late_consumers.size()
+            << " consumers after step " << peak_step;
+  }
+
+  Graph* graph_;
+  dtype_dict_t& dtype_dict_;
+  shape_dict_t& shape_dict_;
+  const framework::OpValueType<OpPatternKind>& op_pattern_dict_;
+
+  std::unordered_set<const Node*> remat_nodes_;
+  // the variables produced by the op nodes in topological order
+  std::vector<NodeData*> vars_;
+  std::unordered_map<NodeData*, LiveRange> ranges_;
+  // the total bytes of the live variables at each step
+  std::vector<int64_t> live_bytes_;
+};
+
+}  // namespace
+
+void RematerializationPassInternal(Graph* graph) {
+  if (FLAGS_cinn_rematerialization_memory_budget <= 0) {
+    VLOG(3) << "Skip Rematerialization as no memory budget is given";
+    return;
+  }
+  int remat_num = RematerializationPass(graph)(FLAGS_cinn_rematerialization_memory_budget);
+  VLOG(3) << "Rematerialization recomputes " << remat_num << " variables";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(Rematerialization) {
+  CINN_REGISTER_PASS(Rematerialization)
+      .describe(
+          "This pass recomputes the cheap elementwise and broadcast ops for their consumers far away in the graph, "
+          "such as the backward ops of training graphs, instead of keeping their outputs alive until then, so that "
+          "the peak memory of the variables fits into FLAGS_cinn_rematerialization_memory_budget. It should be "
+          "applied before OpFusionPass which fuses the recomputed ops into their consumers.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::RematerializationPassInternal);
+  return true;
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+
+DECLARE_int64(cinn_rematerialization_memory_budget);
+
+namespace cinn {
+namespace frontend {
+
+int CountOps(hlir::framework::Graph* graph, const std::string& op_type) {
+  int count = 0;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == op_type) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+TEST(Rematerialization, Recompute_Broadcast) {
+  NetBuilder net_builder("Recompute_Broadcast");
+  auto A = net_builder.CreateInput(Float(32), {64, 64}, "A");
+  auto B = net_builder.CreateInput(Float(32), {64}, "B");
+  auto C = net_builder.BroadcastTo(B, {64, 64}, {1});
+  auto D = net_builder.Add(A, C);
+  auto E = net_builder.Exp(D);
+  auto F = net_builder.Relu(E);
+  // C is kept alive across the exp and relu only for the late multiply.
+  auto G = net_builder.Multiply(F, C);
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+
+  auto budget                                = FLAGS_cinn_rematerialization_memory_budget;
+  FLAGS_cinn_rematerialization_memory_budget = 1;
+  {
+    auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+    hlir::framework::ApplyPass(graph.get(), "Rematerialization");
+    ASSERT_EQ(CountOps(graph.get(), "broadcast_to"), 2);
+    ASSERT_EQ(CountOps(graph.get(), "elementwise_mul"), 1);
+  }
+
+  std::vector<std::string> input_ids;
+  absl::c_transform(std::vector<absl::string_view>{A.id(), B.id()},
+                    std::back_inserter(input_ids),
+                    [](absl::string_view id) { return std::string(id); });
+  OptimizeConfig passes(
+      {{}, {}}, {{"OpFusionPass", "FusionMergePass"}, {"Rematerialization", "OpFusionPass", "FusionMergePass"}});
+  CompareResult(&program, target, input_ids, {G->id}, 0, std::move(passes), 123);
+  FLAGS_cinn_rematerialization_memory_budget = budget;
+}
+
+}  // namespace frontend
+}  // namespace cinn
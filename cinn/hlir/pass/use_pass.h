@@ -20,9 +20,12 @@ CINN_USE_REGISTER(InferShape)
 CINN_USE_REGISTER(OpFusion)
 CINN_USE_REGISTER(AlterLayout)
 CINN_USE_REGISTER(ConstPropagate)
+CINN_USE_REGISTER(PrePackWeights)
+CINN_USE_REGISTER(Rematerialization)
 
 CINN_USE_REGISTER(DotMerger)
 CINN_USE_REGISTER(OpFusionPass)
 CINN_USE_REGISTER(FusionMergePass)
+CINN_USE_REGISTER(HorizontalFusionPass)
 CINN_USE_REGISTER(CheckFusionAccuracyPass)
 CINN_USE_REGISTER(CustomCallPass)
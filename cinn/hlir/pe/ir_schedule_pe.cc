@@ -31,6 +31,7 @@
 #include "cinn/ir/ir_base.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/poly/isl_utils.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace hlir {
@@ -952,6 +953,44 @@ void IRCudaScheduleConv2(ir::IRSchedule &ir_sch,
   VLOG(3) << "After IRCudaScheduleConv2, expr is: " << ir_sch.GetModule().GetExprs().at(0);
 }
 
+void IRConv2dWinogradScheduleCPU(ir::IRSchedule &ir_sch, const common::Target &target) {
+  VLOG(3) << "Before IRConv2dWinogradScheduleCPU, expr is: " << ir_sch.GetModule().GetExprs().at(0);
+  std::string kernel_pack, input_pad, data_pack, inverse;
+  for (auto &block : ir_sch.GetAllBlocks()) {
+    std::string name = GetTensor(block)->name;
+    if (utils::Startswith(name, "winograd_kernel_pack")) {
+      kernel_pack = name;
+    } else if (utils::Startswith(name, "winograd_input_pad")) {
+      input_pad = name;
+    } else if (utils::Startswith(name, "winograd_data_pack")) {
+      data_pack = name;
+    } else if (utils::Startswith(name, "winograd_inverse")) {
+      inverse = name;
+    }
+  }
+  CHECK(!input_pad.empty() && !data_pack.empty() && !inverse.empty()) << "Not a winograd conv2d, please check.";
+  ir_sch.ComputeInline(ir_sch.GetBlock(input_pad));
+  // kernel_pack: [eps, nu, ci, co] and data_pack: [eps, nu, ci, p] -> [ci, co/p, eps, nu], unroll the tile positions
+  // to fold the transform coefficients. kernel_pack is absent if the weight has been transformed ahead.
+  for (auto &name : {kernel_pack, data_pack}) {
+    if (name.empty()) continue;
+    auto loops = ir_sch.GetLoops(name);
+    CHECK_GE(loops.size(), 4U);
+    ir_sch.Reorder({loops[2], loops[3], loops[0], loops[1]});
+    loops = ir_sch.GetLoops(name);
+    ir_sch.Unroll(loops[3]);
+    loops = ir_sch.GetLoops(name);
+    ir_sch.Unroll(loops[2]);
+  }
+  // inverse: [co, p, vh, vw]
+  auto loops = ir_sch.GetLoops(inverse);
+  CHECK_GE(loops.size(), 4U);
+  ir_sch.Unroll(loops[3]);
+  loops = ir_sch.GetLoops(inverse);
+  ir_sch.Unroll(loops[2]);
+  VLOG(3) << "After IRConv2dWinogradScheduleCPU, expr is: " << ir_sch.GetModule().GetExprs().at(0);
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -97,6 +97,8 @@ void IRCudaScheduleConv2(ir::IRSchedule &ir_sch,
 
 void IRCudaScheduleConv(ir::IRSchedule &ir_sch, const common::Target &target);
 
+void IRConv2dWinogradScheduleCPU(ir::IRSchedule &ir_sch, const common::Target &target);
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -213,6 +213,155 @@ std::vector<ir::Tensor> Conv2d_winograd_NCHW(const ir::Tensor &input,
   return {weights_dilation, input_pad, A, B, G, kernel_pack, input_tile, data_pack, bgemm, inverse, res};
 }
 
+namespace {
+// sum of coeff_a[i] * coeff_b[j] * load(i, j), the zero coefficients of the winograd matrices are skipped so that the
+// transforms become a few multiply-adds instead of the reductions over the full matrices.
+Expr WinogradSum(const std::vector<float> &coeff_a,
+                 const std::vector<float> &coeff_b,
+                 const Type &type,
+                 const std::function<Expr(int, int)> &load) {
+  Expr sum;
+  for (int i = 0; i < coeff_a.size(); i++) {
+    for (int j = 0; j < coeff_b.size(); j++) {
+      float coeff = coeff_a[i] * coeff_b[j];
+      if (coeff == 0.f) continue;
+      Expr term = load(i, j);
+      if (coeff != 1.f) {
+        term = term * common::make_const(type, coeff);
+      }
+      sum = sum.defined() ? sum + term : term;
+    }
+  }
+  return sum.defined() ? sum : common::make_const(type, 0);
+}
+
+// select value(k) where k == index, the selects are folded once the loop of index is unrolled.
+Expr WinogradSelect(const Expr &index, int extent, const std::function<Expr(int)> &value) {
+  Expr res = value(extent - 1);
+  for (int k = extent - 2; k >= 0; k--) {
+    res = ir::Select::Make(ir::EQ::Make(index, Expr(k)), value(k), res);
+  }
+  return res;
+}
+
+std::vector<float> MatrixColumn(const std::vector<std::vector<float>> &matrix, int col) {
+  std::vector<float> res;
+  for (auto &row : matrix) {
+    res.push_back(row[col]);
+  }
+  return res;
+}
+}  // namespace
+
+ir::Tensor Conv2d_Winograd_Weight_Transform(const ir::Tensor &weights, int tile_size, const std::string &output_name) {
+  CHECK_EQ(weights->shape.size(), 4U) << "Weight's dimension of winograd weight transform is not 4! Please check.";
+  int r = weights->shape[2].as_int32();
+  CHECK_EQ(r, weights->shape[3].as_int32()) << "winograd only supports the square kernels";
+  int alpha = tile_size + r - 1;
+  auto vals = get_winograd_val(tile_size, r);
+  CHECK_EQ(vals.size(), 3U) << "vals_size of winograd is not 3! Please check.";
+  // G: [alpha, r]
+  auto G = vals[2];
+  CHECK_EQ(static_cast<int>(G.size()), alpha);
+  return Compute(
+      {Expr(alpha), Expr(alpha), weights->shape[1], weights->shape[0]},
+      [=](Expr eps, Expr nu, Expr ci, Expr co) {
+        return WinogradSelect(eps, alpha, [&](int e) {
+          return WinogradSelect(nu, alpha, [&](int n) {
+            return WinogradSum(
+                G[e], G[n], weights->type(), [&](int i, int j) { return weights(co, ci, Expr(i), Expr(j)); });
+          });
+        });
+      },
+      output_name);
+}
+
+std::vector<ir::Tensor> Conv2d_Winograd_NCHW_CPU(const ir::Tensor &input,
+                                                 const ir::Tensor &kernel_pack,
+                                                 int pad_h,
+                                                 int pad_w,
+                                                 int tile_size,
+                                                 const std::string &output_name) {
+  CHECK_EQ(input->shape.size(), 4U) << "Input's dimension of Conv2d_Winograd_NCHW_CPU op is not 4! Please check.";
+  CHECK_EQ(kernel_pack->shape.size(), 4U)
+      << "Transformed weight's dimension of Conv2d_Winograd_NCHW_CPU op is not 4! Please check.";
+  int m     = tile_size;
+  int alpha = kernel_pack->shape[0].as_int32();
+  int r     = alpha - m + 1;
+  int N     = input->shape[0].as_int32();
+  int H     = input->shape[2].as_int32();
+  int W     = input->shape[3].as_int32();
+  int out_h = H + 2 * pad_h - r + 1;
+  int out_w = W + 2 * pad_w - r + 1;
+  int nH    = (out_h + m - 1) / m;
+  int nW    = (out_w + m - 1) / m;
+  int P     = N * nH * nW;
+
+  auto vals = get_winograd_val(m, r);
+  CHECK_EQ(vals.size(), 3U) << "vals_size of winograd is not 3! Please check.";
+  // A: [alpha, m], B: [alpha, alpha]
+  auto A = vals[0];
+  auto B = vals[1];
+
+  // pad the input to whole tiles, the tail tiles read zeros
+  auto input_pad = Compute(
+      {input->shape[0], input->shape[1], Expr(nH * m + r - 1), Expr(nW * m + r - 1)},
+      [=](Expr nn, Expr cc, Expr yy, Expr xx) {
+        auto cond = lang::logic_and({yy >= pad_h, yy < H + pad_h, xx >= pad_w, xx < W + pad_w});
+        return ir::Select::Make(cond, input(nn, cc, yy - pad_h, xx - pad_w), ir::Zero(input->type()));
+      },
+      UniqName("winograd_input_pad"));
+
+  // V = B^T * d * B
+  auto data_pack = Compute(
+      {Expr(alpha), Expr(alpha), input->shape[1], Expr(P)},
+      [=](Expr eps, Expr nu, Expr ci, Expr p) {
+        Expr n  = p / (nH * nW);
+        Expr y0 = ((p / nW) % nH) * m;
+        Expr x0 = (p % nW) * m;
+        return WinogradSelect(eps, alpha, [&](int e) {
+          return WinogradSelect(nu, alpha, [&](int v) {
+            return WinogradSum(MatrixColumn(B, e), MatrixColumn(B, v), input->type(), [&](int i, int j) {
+              return input_pad(n, ci, y0 + i, x0 + j);
+            });
+          });
+        });
+      },
+      UniqName("winograd_data_pack"));
+
+  // M = U * V, batched over the alpha x alpha positions of the tiles
+  Var ci(kernel_pack->shape[2], UniqName("ci"));
+  auto bgemm = Compute(
+      {Expr(alpha), Expr(alpha), kernel_pack->shape[3], Expr(P)},
+      [=](Expr eps, Expr nu, Expr co, Expr p) {
+        return lang::ReduceSum(kernel_pack(eps, nu, ci, co) * data_pack(eps, nu, ci, p), {ci});
+      },
+      UniqName("winograd_bgemm"));
+
+  // Y = A^T * M * A
+  auto inverse = Compute(
+      {kernel_pack->shape[3], Expr(P), Expr(m), Expr(m)},
+      [=](Expr co, Expr p, Expr vh, Expr vw) {
+        return WinogradSelect(vh, m, [&](int h) {
+          return WinogradSelect(vw, m, [&](int w) {
+            return WinogradSum(MatrixColumn(A, h), MatrixColumn(A, w), bgemm->type(), [&](int i, int j) {
+              return bgemm(Expr(i), Expr(j), co, p);
+            });
+          });
+        });
+      },
+      UniqName("winograd_inverse"));
+
+  auto res = Compute(
+      {input->shape[0], kernel_pack->shape[3], Expr(out_h), Expr(out_w)},
+      [=](Expr n, Expr co, Expr h, Expr w) {
+        return inverse(co, n * (nH * nW) + (h / m) * nW + (w / m), h % m, w % m);
+      },
+      output_name);
+
+  return {res, inverse, bgemm, data_pack, input_pad};
+}
+
 std::vector<ir::Tensor> Conv2d_NCHW(const ir::Tensor &input,
                                     const ir::Tensor &weights,
                                     int pad_h,
@@ -822,6 +971,43 @@ std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A, int axis, const std::
 }
 #endif
 
+std::vector<ir::Tensor> FlashAttention(const ir::Tensor &Q,
+                                       const ir::Tensor &K,
+                                       const ir::Tensor &V,
+                                       float scale,
+                                       const std::string &output_name,
+                                       const common::Target &target) {
+  CHECK(target.arch == Target::Arch::X86) << "flash attention should be used in the cpu environment";
+  CHECK_EQ(Q->shape.size(), 3U) << "The queries of flash attention should be of shape [batch, seq_q, head_dim]";
+  CHECK_EQ(K->shape.size(), 3U) << "The keys of flash attention should be of shape [batch, seq_k, head_dim]";
+  CHECK_EQ(V->shape.size(), 3U) << "The values of flash attention should be of shape [batch, seq_k, head_dim_v]";
+  CHECK(is_zero(Q->shape[0] - K->shape[0]) && is_zero(Q->shape[0] - V->shape[0]))
+      << "The batch sizes of the queries, keys and values should be the same";
+  CHECK(is_zero(Q->shape[2] - K->shape[2])) << "The queries and keys should have the same head_dim";
+  CHECK(is_zero(K->shape[1] - V->shape[1])) << "The keys and values should have the same sequence length";
+
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_flash_attention_fp32",
+                                {
+                                    Q->shape[0],  // batch
+                                    Q->shape[1],  // seq_q
+                                    K->shape[1],  // seq_k
+                                    Q->shape[2],  // head_dim
+                                    V->shape[2],  // head_dim_v
+                                    Expr(scale),  // scale
+                                    Q,            // Q
+                                    K,            // K
+                                    V,            // V
+                                });
+      },
+      output_name);
+  auto out = call->TupleGet(0);
+  out->WithBuffer(Q->type());
+  return {out, call};
+}
+
 /**
  * @brief Perform padding operation.
  * @param tensor The input tensor.
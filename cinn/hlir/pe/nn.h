@@ -101,6 +101,41 @@ std::vector<ir::Tensor> Conv2d_winograd_NCHW(const ir::Tensor &input,
                                              int dilation_w,
                                              const std::string &output_name = UniqName("T_Conv2d_winograd_NCHW_out"));
 
+/**
+ * @brief Transform the weight of a winograd convolution F(m x m, r x r), U = G * w * G^T, which only depends on the
+ * weight and is computed once when the weight is constant.
+ *
+ * @param weights The 4-D weight tensor {C_out, C_in, r, r}
+ * @param tile_size The output tile size m
+ * @param output_name The name of the output tensor
+ *
+ * @return the transformed weight {alpha, alpha, C_in, C_out}, where alpha = m + r - 1
+ */
+ir::Tensor Conv2d_Winograd_Weight_Transform(const ir::Tensor &weights,
+                                            int tile_size,
+                                            const std::string &output_name = UniqName("T_Winograd_Weight_out"));
+
+/**
+ * @brief Perform a 2-D convolution with an NCHW-layout using winograd algorithm on CPU, the input and output
+ * transforms are expanded to the constant coefficients of the transform matrices and the products are done by a
+ * batched gemm over the input channels.
+ *
+ * @param input The 4-D input tensor {N, C_in, H, W}
+ * @param kernel_pack The transformed weight {alpha, alpha, C_in, C_out}, see Conv2d_Winograd_Weight_Transform
+ * @param pad_h padding applied to the height of the image
+ * @param pad_w padding applied to the width of the image
+ * @param tile_size The output tile size m
+ * @param output_name The name of the output tensors
+ *
+ * @return {res, inverse, bgemm, data_pack, input_pad}
+ */
+std::vector<ir::Tensor> Conv2d_Winograd_NCHW_CPU(const ir::Tensor &input,
+                                                 const ir::Tensor &kernel_pack,
+                                                 int pad_h,
+                                                 int pad_w,
+                                                 int tile_size,
+                                                 const std::string &output_name = UniqName("T_Conv2d_winograd_out"));
+
 /**
  * @brief Perform a 2-D convolution with an NCHW-layout and support group and depthwise convolution.
  *
@@ -309,6 +344,24 @@ std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A,
                                       const std::string &output_name = UniqName("T_softmax_out"));
 #endif
 
+/**
+ * @brief Fused attention softmax(scale * Q * K^T) * V on x86 by calling the builtin flash attention kernel, which
+ * streams over the blocks of keys with an online softmax instead of materializing the attention scores.
+ *
+ * @param Q The queries of shape [batch, seq_q, head_dim].
+ * @param K The keys of shape [batch, seq_k, head_dim].
+ * @param V The values of shape [batch, seq_k, head_dim_v].
+ * @param scale The scale applied to the scores before the softmax.
+ *
+ * @return The output of shape [batch, seq_q, head_dim_v] and the extern call.
+ */
+std::vector<ir::Tensor> FlashAttention(const ir::Tensor &Q,
+                                       const ir::Tensor &K,
+                                       const ir::Tensor &V,
+                                       float scale,
+                                       const std::string &output_name = UniqName("T_flash_attention_out"),
+                                       const common::Target &target   = common::DefaultHostTarget());
+
 /**
  * @brief Perform pooling on the width dimension of the tensor.
  *        Width axis is determined by the data_format string in which 'W' means width. Only support NCW and NWC
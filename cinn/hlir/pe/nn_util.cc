@@ -16,6 +16,8 @@
 
 #include "cinn/common/ir_util.h"
 
+DECLARE_bool(cinn_use_winograd_conv);
+
 namespace cinn {
 namespace hlir {
 namespace pe {
@@ -313,6 +315,36 @@ std::vector<ir::Tensor> winograd_transform_matrices(const int& tile_size, const
   return {tensor_a, tensor_b, tensor_g};
 }
 
+bool UseWinogradConv2dCPU(const std::vector<int>& input_shape,
+                          const std::vector<int>& weight_shape,
+                          const std::vector<int>& padding,
+                          const std::vector<int>& stride,
+                          const std::vector<int>& dilation,
+                          int groups) {
+  if (!FLAGS_cinn_use_winograd_conv || input_shape.size() != 4U || weight_shape.size() != 4U) {
+    return false;
+  }
+  if (groups != 1 || weight_shape[2] != 3 || weight_shape[3] != 3) {
+    return false;
+  }
+  if (stride.size() != 2U || stride[0] != 1 || stride[1] != 1) {
+    return false;
+  }
+  if (dilation.size() != 2U || dilation[0] != 1 || dilation[1] != 1) {
+    return false;
+  }
+  if (padding.size() != 2U || padding[0] > 2 || padding[1] > 2) {
+    return false;
+  }
+  int out_h = input_shape[2] + 2 * padding[0] - 2;
+  int out_w = input_shape[3] + 2 * padding[1] - 2;
+  // the transforms cost O(C_in + C_out) per tile while the batched gemm costs O(C_in * C_out), so the direct conv is
+  // faster for the thin convs.
+  return input_shape[1] >= 16 && weight_shape[0] >= 16 && out_h >= 4 && out_w >= 4;
+}
+
+int GetWinogradTileSizeCPU(int out_h, int out_w) { return (out_h >= 8 && out_w >= 8) ? 4 : 2; }
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -36,6 +36,26 @@ std::vector<std::vector<std::vector<float>>> get_winograd_val(const int& tile_si
 
 std::vector<ir::Tensor> winograd_transform_matrices(const int& tile_size, const int& kernel_size);
 
+/**
+ * @brief Whether to compute the NCHW conv2d on x86 by winograd, which only pays off for the 3x3 convs with stride 1
+ * and enough channels to amortize the input and output transforms.
+ *
+ * @param input_shape The shape of the input {N, C_in, H, W}
+ * @param weight_shape The shape of the weight {C_out, C_in/group, filter_h, filter_w}
+ */
+bool UseWinogradConv2dCPU(const std::vector<int>& input_shape,
+                          const std::vector<int>& weight_shape,
+                          const std::vector<int>& padding,
+                          const std::vector<int>& stride,
+                          const std::vector<int>& dilation,
+                          int groups);
+
+/**
+ * @brief Choose the output tile size m of winograd F(m x m, 3 x 3) on x86, F(4x4, 3x3) saves more multiplications while
+ * F(2x2, 3x3) wastes less computation on the partial tiles of the small feature maps.
+ */
+int GetWinogradTileSizeCPU(int out_h, int out_w);
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
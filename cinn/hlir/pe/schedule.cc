@@ -1361,6 +1361,65 @@ void Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
   }
 }
 
+void Conv2d_Winograd_Schedule_CPU(poly::StageMap stages,
+                                  const ir::Tensor &res,
+                                  const ir::Tensor &inverse,
+                                  const ir::Tensor &bgemm,
+                                  const ir::Tensor &data_pack,
+                                  const ir::Tensor &input_pad,
+                                  const common::Target &target) {
+  stages[input_pad]->ComputeInline();
+  // data_pack: [eps, nu, ci, p] -> [ci, p, eps, nu], unroll the tile positions to fold the transform coefficients
+  stages[data_pack]->Reorder(std::vector<int>{2, 3, 0, 1});
+  stages[data_pack]->Unroll(3);
+  stages[data_pack]->Unroll(2);
+  stages[data_pack]->Parallel(0);
+
+  // bgemm: [eps, nu, co, p, ci] -> [eps_nu, co_outer, p_outer, ci, co_inner, p_inner]
+  int co     = bgemm->shape[2].as_int32();
+  int p      = bgemm->shape[3].as_int32();
+  int co_bn  = co % 4 == 0 ? 4 : 1;
+  int p_bn   = GetBetterSplitFactor(p, GetBasicFactor(bgemm->type(), target));
+  bool p_vec = p_bn >= 4 && p % p_bn == 0 && p != p_bn;
+  stages[bgemm]->Fuse(0, 1);
+  poly::Iterator co_outer = stages[bgemm]->axis(1);
+  poly::Iterator p_outer  = stages[bgemm]->axis(2);
+  poly::Iterator ci       = stages[bgemm]->axis(3);
+  poly::Iterator co_inner, p_inner;
+  if (co_bn > 1) {
+    std::tie(co_outer, co_inner) = stages[bgemm]->Split(co_outer, co_bn);
+  }
+  if (p_vec) {
+    std::tie(p_outer, p_inner) = stages[bgemm]->Split(p_outer, p_bn);
+  }
+  std::vector<poly::Iterator> order = {co_outer, p_outer, ci};
+  if (co_bn > 1) order.push_back(co_inner);
+  if (p_vec) order.push_back(p_inner);
+  stages[bgemm]->Reorder(order);
+  int bgemm_dims = stages[bgemm]->n_out_dims();
+  if (co_bn > 1) {
+    stages[bgemm]->Unroll(p_vec ? bgemm_dims - 2 : bgemm_dims - 1);
+  }
+  if (p_vec) {
+    stages[bgemm]->Vectorize(bgemm_dims - 1, p_bn);
+  }
+  stages[bgemm]->Parallel(0);
+  // bgemm_init
+  auto bgemm_init = bgemm->GetInitTensor(stages, target);
+  if (p_vec) {
+    stages[bgemm_init]->Vectorize(stages[bgemm_init]->n_out_dims() - 1, p_bn);
+  }
+
+  // inverse: [co, p, vh, vw]
+  stages[inverse]->Unroll(3);
+  stages[inverse]->Unroll(2);
+  stages[inverse]->Parallel(0);
+
+  // res: [n, co, h, w]
+  stages[res]->Fuse(0, 1);
+  stages[res]->Parallel(0);
+}
+
 void CudaScheduleMul(poly::StageMap stages,
                      ir::Tensor output,
                      const std::vector<int> &output_shape,
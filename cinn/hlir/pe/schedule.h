@@ -156,6 +156,14 @@ void Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
                                                 const common::Target &target,
                                                 bool do_padding);
 
+void Conv2d_Winograd_Schedule_CPU(poly::StageMap stages,
+                                  const ir::Tensor &res,
+                                  const ir::Tensor &inverse,
+                                  const ir::Tensor &bgemm,
+                                  const ir::Tensor &data_pack,
+                                  const ir::Tensor &input_pad,
+                                  const common::Target &target);
+
 void CudaScheduleMul(poly::StageMap stages,
                      ir::Tensor output,
                      const std::vector<int> &output_shape,
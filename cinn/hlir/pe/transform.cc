@@ -585,6 +585,119 @@ std::vector<Tensor> MatmulMKL(const Tensor& A,
   return {out, call};
 }
 
+std::vector<Tensor> MatmulPackedGemm(const Tensor& A,
+                                     const Tensor& B,
+                                     bool trans_a,
+                                     bool trans_b,
+                                     float alpha,
+                                     const std::string& name,
+                                     const common::Target& target,
+                                     int activation,
+                                     const Tensor& bias) {
+  CHECK(target.arch == Target::Arch::X86) << "packed gemm should be used in the cpu environment";
+  CHECK(A->type() == Float(32) && B->type() == Float(32))
+      << "packed gemm only supports float32 while the types of A and B are " << A->type() << " and " << B->type();
+  std::vector<Expr> shape_A = A->shape;
+  std::vector<Expr> shape_B = B->shape;
+  int a_dim                 = shape_A.size();
+  int b_dim                 = shape_B.size();
+  CHECK(a_dim == 3U || a_dim == 2U) << "tensor_A's dim should be 2 or 3 while current dim is " << a_dim;
+  CHECK(b_dim == 3U || b_dim == 2U) << "tensor_B's dim should be 2 or 3 while current dim is " << b_dim;
+  CHECK_EQ(a_dim, b_dim) << "tensor_A's dim should be same with tensor_B";
+  if (a_dim == 3U) {
+    CHECK_EQ(shape_A.front(), shape_B.front())
+        << "tensor A and B's batch size should be same but current batch sizes are " << shape_A.front() << " and "
+        << shape_B.front();
+  }
+
+  Expr x_width  = trans_a ? shape_A[a_dim - 2] : shape_A.back();
+  Expr y_height = trans_b ? shape_B.back() : shape_B[b_dim - 2];
+  Expr M        = trans_a ? shape_A.back() : shape_A[a_dim - 2];
+  Expr N        = trans_b ? shape_B[b_dim - 2] : shape_B.back();
+  CHECK(is_zero(x_width - y_height)) << "matrix multiplication requires x_width to be same with y_height";
+
+  ir::Tensor call;
+  if (bias.defined()) {
+    CHECK_EQ(a_dim, 2U) << "the bias of packed gemm is only supported by the 2-D matmul";
+    CHECK_EQ(bias->shape.size(), 1U) << "the bias of packed gemm should be of shape [N]";
+    CHECK(is_zero(bias->shape[0] - N)) << "the bias of packed gemm should be of shape [N]";
+    call = Compute(
+        {Expr(1)},
+        [=]() -> Expr {
+          return lang::CallExtern("cinn_cpu_packed_gemm_bias_fp32",
+                                  {
+                                      Expr(alpha),                 // alpha
+                                      M,                           // M
+                                      N,                           // N
+                                      x_width,                     // K
+                                      common::make_bool(trans_a),  // ta
+                                      common::make_bool(trans_b),  // tb
+                                      shape_A.back(),              // lda
+                                      shape_B.back(),              // ldb
+                                      N,                           // ldc
+                                      common::make_zero<float>(),  // beta
+                                      Expr(activation),            // activation
+                                      A,                           // A
+                                      B,                           // B
+                                      bias,                        // bias
+                                  });
+        },
+        UniqName("matmul_packed_gemm_bias_out"));
+  } else if (a_dim == 2U) {
+    call = Compute(
+        {Expr(1)},
+        [=]() -> Expr {
+          return lang::CallExtern("cinn_cpu_packed_gemm_fp32",
+                                  {
+                                      Expr(alpha),                 // alpha
+                                      M,                           // M
+                                      N,                           // N
+                                      x_width,                     // K
+                                      common::make_bool(trans_a),  // ta
+                                      common::make_bool(trans_b),  // tb
+                                      shape_A.back(),              // lda
+                                      shape_B.back(),              // ldb
+                                      N,                           // ldc
+                                      common::make_zero<float>(),  // beta
+                                      Expr(activation),            // activation
+                                      A,                           // A
+                                      B,                           // B
+                                  });
+        },
+        UniqName("matmul_packed_gemm_out"));
+  } else {
+    // batch matmul
+    call = Compute(
+        {Expr(1)},
+        [=]() -> Expr {
+          return lang::CallExtern("cinn_cpu_packed_gemm_batch_fp32",
+                                  {
+                                      Expr(alpha),                 // alpha
+                                      shape_A.front(),             // batch
+                                      M,                           // M
+                                      N,                           // N
+                                      x_width,                     // K
+                                      common::make_bool(trans_a),  // ta
+                                      common::make_bool(trans_b),  // tb
+                                      shape_A.back(),              // lda
+                                      shape_B.back(),              // ldb
+                                      N,                           // ldc
+                                      M * x_width,                 // a_stride
+                                      N * x_width,                 // b_stride
+                                      M * N,                       // c_stride
+                                      common::make_zero<float>(),  // beta
+                                      Expr(activation),            // activation
+                                      A,                           // A
+                                      B,                           // B
+                                  });
+        },
+        UniqName("batch_matmul_packed_gemm_out"));
+  }
+  auto out = call->TupleGet(0);
+  out->WithBuffer(A->type());
+  return {out, call};
+}
+
 int GetMulFactor(int shape, const Type& type, const common::Target& target) {
   int split_base   = GetBasicFactor(type, target);
   int split_factor = 1;
@@ -89,6 +89,22 @@ std::vector<ir::Tensor> MatmulMKL(const ir::Tensor& A,
                                   const std::string& name      = UniqName("T_Transform_MatmulMKL_out"),
                                   const common::Target& target = common::DefaultHostTarget());
 
+/**
+ * @brief Matrix multiplication on x86 by calling the builtin packed gemm, which does not depend on MKL.
+ *
+ * @param activation The cinn_gemm_activation_t applied in the epilogue of the gemm.
+ * @param bias The bias of shape [N] added in the epilogue of the gemm, only supported by the 2-D matmul.
+ */
+std::vector<ir::Tensor> MatmulPackedGemm(const ir::Tensor& A,
+                                         const ir::Tensor& B,
+                                         bool trans_a                 = false,
+                                         bool trans_b                 = false,
+                                         float alpha                  = 1,
+                                         const std::string& name      = UniqName("T_Transform_MatmulPackedGemm_out"),
+                                         const common::Target& target = common::DefaultHostTarget(),
+                                         int activation               = 0,
+                                         const ir::Tensor& bias       = ir::Tensor());
+
 int GetMulFactor(int shape, const Type& type, const common::Target& target);
 
 /**
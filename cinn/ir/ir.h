@@ -979,6 +979,12 @@ namespace attr {
 
 // max permitted steps for auto_unroll, used in unroll_loop pass
 constexpr const char* auto_unroll_max_step = "auto_unroll_max_step";
+// the factor to unroll an outer loop and jam the copies into its inner loops, used in unroll_loop pass
+constexpr const char* unroll_jam_factor = "unroll_jam_factor";
+// the number of partial accumulators to split a reduction loop into, used in unroll_loop pass
+constexpr const char* reduce_split_factor = "reduce_split_factor";
+// the number of iterations to prefetch ahead, used in insert_prefetch pass
+constexpr const char* prefetch_distance = "prefetch_distance";
 
 }  // namespace attr
 
@@ -14,6 +14,8 @@
 
 #include "cinn/ir/ir_base.h"
 
+#include <cstring>
+
 #include "cinn/common/cinn_value.h"
 #include "cinn/common/common.h"
 #include "cinn/ir/buffer.h"
@@ -55,6 +57,53 @@ std::ostream &operator<<(std::ostream &os, IrNodeTy type) {
   return os;
 }
 
+void IrNode::InitRefCount() {
+  auto *arena = common::Arena::Current();
+  if (arena && arena->single_threaded()) {
+    __ref_count__.set_atomic(false);
+  }
+}
+
+namespace {
+
+uint64_t GetTypeTag(const Type &type) {
+  return (static_cast<uint64_t>(type.type()) << 48) | (static_cast<uint64_t>(type.bits()) << 16) |
+         static_cast<uint64_t>(type.lanes());
+}
+
+// Get the constant of the type and value bits from the current arena, or create one by \p creator.
+template <typename T, typename F>
+IrNode *GetOrCreateConstant(const Type &type, uint64_t value_bits, F &&creator) {
+  auto *arena = common::Arena::Current();
+  if (!arena) {
+    return creator();
+  }
+  uint64_t type_tag = GetTypeTag(type);
+  if (auto *constant = arena->GetConstant(type_tag, value_bits)) {
+    return static_cast<T *>(constant);
+  }
+  IrNode *constant = creator();
+  arena->AddConstant(type_tag, value_bits, constant);
+  return constant;
+}
+
+}  // namespace
+
+IrNode *MakeIntImm(Type type, int64_t value) {
+  return GetOrCreateConstant<IntImm>(
+      type, static_cast<uint64_t>(value), [&]() -> IrNode * { return new IntImm(type, value); });
+}
+
+IrNode *MakeUIntImm(Type type, uint64_t value) {
+  return GetOrCreateConstant<UIntImm>(type, value, [&]() -> IrNode * { return new UIntImm(type, value); });
+}
+
+IrNode *MakeFloatImm(Type type, double value) {
+  uint64_t value_bits;
+  std::memcpy(&value_bits, &value, sizeof(value));
+  return GetOrCreateConstant<FloatImm>(type, value_bits, [&]() -> IrNode * { return new FloatImm(type, value); });
+}
+
 Expr Zero(const Type &type) {
   if (type.is_float(16)) return Expr(float16(0.f));
   if (type.is_float(32)) return Expr(0.f);
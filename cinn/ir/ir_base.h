@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "cinn/common/arena.h"
 #include "cinn/common/common.h"
 #include "cinn/common/object.h"
 #include "cinn/common/shared.h"
@@ -143,10 +144,16 @@ class IrNode : public common::Object {
   //! The operands of this operator.
   std::vector<Expr> operands;
 
-  IrNode() = default;
-  explicit IrNode(Type t) : type_(t) {}
+  IrNode() { InitRefCount(); }
+  explicit IrNode(Type t) : type_(t) { InitRefCount(); }
   virtual ~IrNode() = default;
 
+  //! The IR nodes are allocated from the arena of the current common::ArenaScope if any.
+  // @{
+  static void* operator new(size_t size) { return common::ArenaAllocate(size); }
+  static void operator delete(void* p) { common::ArenaFree(p); }
+  // @}
+
   virtual IrNodeTy node_type() const { return IrNodeTy::kUnk; }
   virtual Type type() const { return type_; }
   void set_type(Type type) { type_ = type; }
@@ -166,6 +173,10 @@ class IrNode : public common::Object {
  protected:
   static constexpr char* __type_info__ = "IRNode";
   Type type_;
+
+ private:
+  //! The nodes created in a single-threaded arena use the non-atomic reference counts.
+  void InitRefCount();
 };
 
 /**
@@ -278,6 +289,14 @@ struct StringImm : public ExprNode<StringImm> {
   static const IrNodeTy _node_type_ = IrNodeTy::StringImm;
 };
 
+//! Create the numeric constants, the equal constants created in a common::ArenaScope are shared by hash-consing, so
+//! the constants should never be mutated in place.
+// @{
+IrNode* MakeIntImm(Type type, int64_t value);
+IrNode* MakeUIntImm(Type type, uint64_t value);
+IrNode* MakeFloatImm(Type type, double value);
+// @}
+
 class Var;
 /**
  * An expression that represents some value or the result of some operations.
@@ -291,14 +310,14 @@ struct Expr : public IrNodeRef {
 
   //! Helper function to construct numeric constants of various types.
   // @{
-  explicit Expr(bool x) : IrNodeRef(new UIntImm(UInt(1), x)) {}
-  explicit Expr(int32_t x) : IrNodeRef(new IntImm(Int(32), x)) {}
-  explicit Expr(uint32_t x) : IrNodeRef(new UIntImm(UInt(32), x)) {}
-  explicit Expr(int64_t x) : IrNodeRef(new IntImm(Int(64), x)) {}
-  explicit Expr(uint64_t x) : IrNodeRef(new UIntImm(UInt(64), x)) {}
-  explicit Expr(cinn::common::float16 x) : IrNodeRef(new FloatImm(Float(16), x)) {}
-  explicit Expr(float x) : IrNodeRef(new FloatImm(Float(32), x)) {}
-  explicit Expr(double x) : IrNodeRef(new FloatImm(Float(64), x)) {}
+  explicit Expr(bool x) : IrNodeRef(MakeUIntImm(UInt(1), x)) {}
+  explicit Expr(int32_t x) : IrNodeRef(MakeIntImm(Int(32), x)) {}
+  explicit Expr(uint32_t x) : IrNodeRef(MakeUIntImm(UInt(32), x)) {}
+  explicit Expr(int64_t x) : IrNodeRef(MakeIntImm(Int(64), x)) {}
+  explicit Expr(uint64_t x) : IrNodeRef(MakeUIntImm(UInt(64), x)) {}
+  explicit Expr(cinn::common::float16 x) : IrNodeRef(MakeFloatImm(Float(16), static_cast<float>(x))) {}
+  explicit Expr(float x) : IrNodeRef(MakeFloatImm(Float(32), x)) {}
+  explicit Expr(double x) : IrNodeRef(MakeFloatImm(Float(64), x)) {}
   explicit Expr(const std::string& x) : IrNodeRef(new StringImm(x)) {}
   // @}
 
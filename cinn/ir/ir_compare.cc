@@ -15,9 +15,11 @@
 #include "cinn/ir/ir_compare.h"
 
 #include <regex>
+#include <type_traits>
 
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_printer.h"
+#include "cinn/utils/functional.h"
 
 namespace cinn {
 namespace ir {
@@ -315,5 +317,57 @@ bool IrEqualVisitor::Visit(const ScheduleBlockRealize* lhs, const Expr* other) {
   return Compare(lhs->iter_values, rhs->iter_values) && Compare(lhs->schedule_block, rhs->schedule_block);
 }
 
+namespace {
+
+// Visit every node by expanding all of their fields in dfs order
+class DfsWithExprsFields : public IRVisitor {
+ protected:
+#define __m(t__)                       \
+  void Visit(const t__* x) override {  \
+    for (auto* n : x->expr_fields()) { \
+      if (n->defined()) {              \
+        Visit(n);                      \
+      }                                \
+    }                                  \
+  }
+
+  NODETY_FORALL(__m)
+#undef __m
+
+  void Visit(const Expr* expr) override { IRVisitor::Visit(expr); }
+};
+
+// Generate a reduce hash of a AST tree by combining hash of each AST node
+class IrNodesStructuralHash : public DfsWithExprsFields {
+ public:
+  explicit IrNodesStructuralHash(size_t init_key) : hash_key_(init_key) {}
+  size_t operator()(const Expr* expr) {
+    Visit(expr);
+    return hash_key_;
+  }
+
+  void Visit(const Expr* expr) override {
+    if (!expr->defined()) return;
+    auto type_code = static_cast<IrNodeTyUnderlyingType>(expr->node_type());
+    hash_key_      = utils::HashCombine(hash_key_, type_code);
+    DfsWithExprsFields::Visit(expr);
+  }
+
+ private:
+  void Visit(const _Tensor_* x) override {
+    for (auto& e : x->shape) {
+      Visit(&e);
+    }
+    DfsWithExprsFields::Visit(x->buffer.As<_Buffer_>());
+  }
+
+  using IrNodeTyUnderlyingType = std::underlying_type<IrNodeTy>::type;
+  size_t hash_key_;
+};
+
+}  // namespace
+
+size_t StructuralHash(const Expr& expr, size_t init_key) { return IrNodesStructuralHash(init_key)(&expr); }
+
 }  // namespace ir
 }  // namespace cinn
@@ -42,5 +42,12 @@ class IrEqualVisitor : public IRVisitorBase<bool, const Expr*> {
   bool allow_name_suffix_diff_ = false;
 };
 
+/**
+ * Hash the structure of an AST by combining the types of its nodes in dfs order, so the ASTs equal by IrEqualVisitor
+ * have the same hash.
+ * @param init_key The key to combine with, which chains the hashes of several ASTs.
+ */
+size_t StructuralHash(const Expr& expr, size_t init_key = 0);
+
 }  // namespace ir
 }  // namespace cinn
@@ -30,6 +30,7 @@
 #include "cinn/common/ir_util.h"
 #include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir.h"
+#include "cinn/ir/ir_compare.h"
 #include "cinn/ir/ir_mutator.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
@@ -66,6 +67,8 @@ class ScheduleImpl {
 
   bool HasBlock(const std::string& block_name) const;
 
+  size_t GetStructuralHash() const;
+
   std::vector<Expr> GetLoops(const Expr& block) const;
   std::vector<Expr> GetLoops(const std::string& block_name) const;
   std::vector<Expr> GetAllBlocks() const;
@@ -103,12 +106,30 @@ class ScheduleImpl {
   void CopyTransformAndLoopInfo(const std::string& block_name, const std::string& block_target_name);
 
  private:
+  friend class IRSchedule;
+
   void Replace(const Expr& src_sref, const Expr& tgt_stmt);
 
   ModuleExpr module_expr_;
   bool debug_flag_{false};
+  // The ScheduleImpls whose ASTs are borrowed by this one, see IRSchedule::Combine.
+  std::vector<std::shared_ptr<ScheduleImpl>> sources_;
+  // The cached structural hash of the ASTs, invalidated once they are scheduled.
+  mutable bool structural_hash_valid_{false};
+  mutable size_t structural_hash_{0};
 };
 
+size_t ScheduleImpl::GetStructuralHash() const {
+  if (!structural_hash_valid_) {
+    structural_hash_ = 0;
+    for (auto& expr : module_expr_.GetExprs()) {
+      structural_hash_ = StructuralHash(expr, structural_hash_);
+    }
+    structural_hash_valid_ = true;
+  }
+  return structural_hash_;
+}
+
 std::vector<Expr> ScheduleImpl::Split(const Expr& loop, const std::vector<int>& factors) {
   CHECK(loop.As<ir::For>()) << "Expr param of Split must be For node! Please check.";
   auto* for_node = loop.As<ir::For>();
@@ -1822,33 +1843,111 @@ std::vector<Expr> ScheduleImpl::SamplePerfectTile(const uint32_t seed,
 IRSchedule::IRSchedule() {}
 
 IRSchedule::IRSchedule(const ModuleExpr& module_expr, bool debug_flag) {
-  impl_ = std::make_unique<ScheduleImpl>(module_expr, debug_flag);
+  impl_ = std::make_shared<ScheduleImpl>(module_expr, debug_flag);
 }
 
 IRSchedule::IRSchedule(ir::ModuleExpr&& mod_expr, ScheduleDesc&& trace)
-    : impl_(std::make_unique<ScheduleImpl>(std::move(mod_expr))), trace_(std::move(trace)) {}
+    : impl_(std::make_shared<ScheduleImpl>(std::move(mod_expr))), trace_(std::move(trace)) {}
 
-IRSchedule::IRSchedule(const IRSchedule& other)
-    : impl_(std::make_unique<ScheduleImpl>(optim::IRCopy(other.GetModule()))), trace_(other.trace_) {}
+IRSchedule::IRSchedule(const IRSchedule& other) : impl_(other.impl_), trace_(other.trace_) {}
 
 IRSchedule& IRSchedule::operator=(const IRSchedule& src) {
-  impl_  = std::make_unique<ScheduleImpl>(optim::IRCopy(src.GetModule()));
+  impl_ = src.impl_;
+  forwarded_nodes_.clear();
+  forwarded_impl_.reset();
   trace_ = src.trace_;
   return *this;
 }
 
-IRSchedule::IRSchedule(IRSchedule&& other) : impl_(std::move(other.impl_)), trace_(std::move(other.trace_)) {}
+IRSchedule::IRSchedule(IRSchedule&& other)
+    : impl_(std::move(other.impl_)),
+      forwarded_nodes_(std::move(other.forwarded_nodes_)),
+      forwarded_impl_(std::move(other.forwarded_impl_)),
+      trace_(std::move(other.trace_)) {}
 
 IRSchedule& IRSchedule::operator=(IRSchedule&& src) {
-  impl_  = std::move(src.impl_);
-  trace_ = std::move(src.trace_);
+  impl_            = std::move(src.impl_);
+  forwarded_nodes_ = std::move(src.forwarded_nodes_);
+  forwarded_impl_  = std::move(src.forwarded_impl_);
+  trace_           = std::move(src.trace_);
   return *this;
 }
 
 IRSchedule::~IRSchedule() {}
 
+IRSchedule IRSchedule::Combine(const std::vector<const IRSchedule*>& sources) {
+  std::vector<Expr> exprs;
+  std::vector<std::shared_ptr<ScheduleImpl>> borrowed;
+  auto borrow = [&borrowed](const std::shared_ptr<ScheduleImpl>& impl) {
+    if (std::find(borrowed.begin(), borrowed.end(), impl) == borrowed.end()) {
+      borrowed.push_back(impl);
+    }
+  };
+  for (size_t i = 0; i < sources.size(); ++i) {
+    const auto& source_impl = sources[i]->impl_;
+    auto source_exprs       = source_impl->GetModule().GetExprs();
+    CHECK_EQ(source_exprs.size(), sources.size()) << "The sources to combine must have the same number of ASTs";
+    exprs.push_back(source_exprs[i]);
+    // the ASTs may be borrowed by the source in turn
+    borrow(source_impl);
+    std::for_each(source_impl->sources_.begin(), source_impl->sources_.end(), borrow);
+  }
+
+  IRSchedule result;
+  result.impl_           = std::make_shared<ScheduleImpl>(ModuleExpr(std::move(exprs)));
+  result.impl_->sources_ = std::move(borrowed);
+  return result;
+}
+
+ScheduleImpl* IRSchedule::MutableImpl() {
+  ReleaseForwardedNodes();
+  // the ASTs are exclusive if neither this ScheduleImpl nor the ones it borrows from are held by other IRSchedules
+  bool exclusive = impl_.use_count() == 1;
+  for (auto& source : impl_->sources_) {
+    exclusive = exclusive && source.use_count() == 1;
+  }
+  if (exclusive) {
+    impl_->sources_.clear();
+    impl_->structural_hash_valid_ = false;
+    return impl_.get();
+  }
+
+  VLOG(6) << "Copy the ASTs shared with other IRSchedules before scheduling";
+  forwarded_nodes_.clear();
+  forwarded_impl_ = impl_;
+  std::vector<Expr> copied_exprs;
+  for (auto& expr : impl_->GetModule().GetExprs()) {
+    copied_exprs.push_back(optim::IRCopy(expr, &forwarded_nodes_));
+  }
+  impl_ = std::make_shared<ScheduleImpl>(ModuleExpr(std::move(copied_exprs)), impl_->debug_flag_);
+  return impl_.get();
+}
+
+void IRSchedule::ReleaseForwardedNodes() const {
+  // the handles obtained before the copy are not used any more once the IRSchedules sharing those ASTs are gone
+  if (!forwarded_nodes_.empty() && forwarded_impl_.expired()) {
+    VLOG(6) << "Release the " << forwarded_nodes_.size() << " nodes forwarded to the copied ASTs";
+    forwarded_nodes_.clear();
+  }
+}
+
+Expr IRSchedule::Forward(const Expr& expr) const {
+  ReleaseForwardedNodes();
+  auto it = forwarded_nodes_.find(expr.ptr());
+  return it == forwarded_nodes_.end() ? expr : it->second.second;
+}
+
+std::vector<Expr> IRSchedule::Forward(const std::vector<Expr>& exprs) const {
+  std::vector<Expr> results;
+  for (auto& expr : exprs) {
+    results.push_back(Forward(expr));
+  }
+  return results;
+}
+
 void IRSchedule::SetExprs(const std::vector<Expr>& exprs) {
-  return impl_->SetExprs(exprs);
+  // the new ASTs replace the shared ones, so nothing needs to be copied
+  impl_ = std::make_shared<ScheduleImpl>(ModuleExpr(exprs), impl_->debug_flag_);
   // no need to trace
 }
 
@@ -1857,18 +1956,24 @@ const ModuleExpr& IRSchedule::GetModule() const {
   // no need to trace
 }
 
+size_t IRSchedule::GetStructuralHash() const {
+  return impl_->GetStructuralHash();
+  // no need to trace
+}
+
 bool IRSchedule::HasBlock(const std::string& block_name) const {
   return impl_->HasBlock(block_name);
   // no need to trace
 }
 
 void IRSchedule::MergeExprs() {
-  impl_->MergeExprs();
+  auto* impl = MutableImpl();
+  impl->MergeExprs();
   trace_.Append(ScheduleDesc::Step("MergeExprs", {}, {}, {}));
 }
 
 std::vector<Expr> IRSchedule::GetLoops(const Expr& block) const {
-  auto results = impl_->GetLoops(block);
+  auto results = impl_->GetLoops(Forward(block));
   trace_.Append(ScheduleDesc::Step("GetLoops", {{"block", std::vector<Expr>({block})}}, {}, results));
   return results;
 }
@@ -1892,64 +1997,73 @@ Expr IRSchedule::GetBlock(const std::string& block_name) const {
 }
 
 std::vector<Expr> IRSchedule::Split(const Expr& loop, const std::vector<int>& factors) {
-  auto results = impl_->Split(loop, factors);
+  auto* impl   = MutableImpl();
+  auto results = impl->Split(Forward(loop), factors);
   trace_.Append(ScheduleDesc::Step("Split", {{"loop", std::vector<Expr>({loop})}}, {{"factors", factors}}, results));
   return results;
 }
 
 std::vector<Expr> IRSchedule::Split(const std::string& block_name, int loop_index, const std::vector<int>& factors) {
-  auto results = impl_->Split(block_name, loop_index, factors);
+  auto* impl   = MutableImpl();
+  auto results = impl->Split(block_name, loop_index, factors);
   trace_.Append(ScheduleDesc::Step(
       "SplitWithName", {}, {{"block_name", block_name}, {"loop_index", loop_index}, {"factors", factors}}, results));
   return results;
 }
 
 Expr IRSchedule::Fuse(const std::vector<Expr>& loops) {
-  auto result = impl_->Fuse(loops);
+  auto* impl  = MutableImpl();
+  auto result = impl->Fuse(Forward(loops));
   trace_.Append(ScheduleDesc::Step("Fuse", {{"loops", loops}}, {}, {result}));
   return result;
 }
 
 Expr IRSchedule::Fuse(const std::string& block_name, const std::vector<int>& loops_index) {
-  auto result = impl_->Fuse(block_name, loops_index);
+  auto* impl  = MutableImpl();
+  auto result = impl->Fuse(block_name, loops_index);
   trace_.Append(
       ScheduleDesc::Step("FuseWithName", {}, {{"block_name", block_name}, {"loops_index", loops_index}}, {result}));
   return result;
 }
 
 Expr IRSchedule::Fuse(const Expr& block, const std::vector<int>& loops_index) {
-  auto result = impl_->Fuse(block, loops_index);
+  auto* impl  = MutableImpl();
+  auto result = impl->Fuse(Forward(block), loops_index);
   trace_.Append(ScheduleDesc::Step(
       "FuseWithBlock", {{"block", std::vector<Expr>({block})}}, {{"loops_index", loops_index}}, {result}));
   return result;
 }
 
 void IRSchedule::ComputeAt(const Expr& block, const Expr& loop) {
-  impl_->ComputeAt(block, loop);
+  auto* impl = MutableImpl();
+  impl->ComputeAt(Forward(block), Forward(loop));
   trace_.Append(ScheduleDesc::Step(
       "ComputeAt", {{"block", std::vector<Expr>({block})}, {"loop", std::vector<Expr>({loop})}}, {}, {}));
 }
 
 void IRSchedule::SimpleComputeAt(const Expr& block, const Expr& loop) {
-  impl_->SimpleComputeAt(block, loop);
+  auto* impl = MutableImpl();
+  impl->SimpleComputeAt(Forward(block), Forward(loop));
   trace_.Append(ScheduleDesc::Step(
       "SimpleComputeAt", {{"block", std::vector<Expr>({block})}, {"loop", std::vector<Expr>({loop})}}, {}, {}));
 }
 
 void IRSchedule::ReverseComputeAt(const Expr& block, const Expr& loop) {
-  impl_->ReverseComputeAt(block, loop);
+  auto* impl = MutableImpl();
+  impl->ReverseComputeAt(Forward(block), Forward(loop));
   trace_.Append(ScheduleDesc::Step(
       "ReverseComputeAt", {{"block", std::vector<Expr>({block})}, {"loop", std::vector<Expr>({loop})}}, {}, {}));
 }
 
 Expr IRSchedule::GetRootBlock(const Expr& expr) const {
-  auto result = impl_->GetRootBlock(expr);
+  auto result = impl_->GetRootBlock(Forward(expr));
   trace_.Append(ScheduleDesc::Step("GetRootBlock", {{"expr", std::vector<Expr>({expr})}}, {}, {result}));
   return result;
 }
 
 Expr IRSchedule::CacheRead(const Expr& block, int read_buffer_index, const std::string& memory_type) {
-  auto result = impl_->CacheRead(block, read_buffer_index, memory_type);
+  auto* impl  = MutableImpl();
+  auto result = impl->CacheRead(Forward(block), read_buffer_index, memory_type);
   trace_.Append(ScheduleDesc::Step("CacheRead",
                                    {{"block", std::vector<Expr>({block})}},
                                    {{"read_buffer_index", read_buffer_index}, {"memory_type", memory_type}},
@@ -1958,7 +2072,8 @@ Expr IRSchedule::CacheRead(const Expr& block, int read_buffer_index, const std::
 }
 
 Expr IRSchedule::CacheWrite(const Expr& block, int write_buffer_index, const std::string& memory_type) {
-  auto result = impl_->CacheWrite(block, write_buffer_index, memory_type);
+  auto* impl  = MutableImpl();
+  auto result = impl->CacheWrite(Forward(block), write_buffer_index, memory_type);
   trace_.Append(ScheduleDesc::Step("CacheWrite",
                                    {{"block", std::vector<Expr>({block})}},
                                    {{"write_buffer_index", write_buffer_index}, {"memory_type", memory_type}},
@@ -1967,71 +2082,84 @@ Expr IRSchedule::CacheWrite(const Expr& block, int write_buffer_index, const std
 }
 
 void IRSchedule::SyncThreads(const Expr& ir_node, bool after_node) {
-  impl_->SyncThreads(ir_node, after_node);
+  auto* impl = MutableImpl();
+  impl->SyncThreads(Forward(ir_node), after_node);
   trace_.Append(
       ScheduleDesc::Step("SyncThreads", {{"ir_node", std::vector<Expr>({ir_node})}}, {{"after_node", after_node}}, {}));
 }
 
 void IRSchedule::SetBuffer(Expr& block, const std::string& memory_type, bool fixed) {
-  impl_->SetBuffer(block, memory_type, fixed);
+  auto* impl           = MutableImpl();
+  Expr forwarded_block = Forward(block);
+  impl->SetBuffer(forwarded_block, memory_type, fixed);
   trace_.Append(ScheduleDesc::Step(
       "SetBuffer", {{"block", std::vector<Expr>({block})}}, {{"memory_type", memory_type}, {"fixed", fixed}}, {}));
 }
 
 Expr IRSchedule::Reorder(const std::vector<Expr>& loops) {
-  Expr ret = impl_->Reorder(loops);
+  auto* impl = MutableImpl();
+  Expr ret   = impl->Reorder(Forward(loops));
   trace_.Append(ScheduleDesc::Step("Reorder", {{"loops", loops}}, {}, {ret}));
   return ret;
 }
 
 Expr IRSchedule::Reorder(const std::string& block_name, const std::vector<int>& loops_index) {
-  Expr ret = impl_->Reorder(block_name, loops_index);
+  auto* impl = MutableImpl();
+  Expr ret   = impl->Reorder(block_name, loops_index);
   trace_.Append(
       ScheduleDesc::Step("ReorderWithName", {}, {{"block_name", block_name}, {"loops_index", loops_index}}, {ret}));
   return ret;
 }
 
 Expr IRSchedule::Reorder(const Expr& block, const std::vector<int>& loops_index) {
-  Expr ret = impl_->Reorder(block, loops_index);
+  auto* impl = MutableImpl();
+  Expr ret   = impl->Reorder(Forward(block), loops_index);
   trace_.Append(ScheduleDesc::Step(
       "ReorderWithBlock", {{"block", std::vector<Expr>({block})}}, {{"loops_index", loops_index}}, {ret}));
   return ret;
 }
 
 void IRSchedule::Parallel(const Expr& loop) {
-  impl_->Parallel(loop);
+  auto* impl = MutableImpl();
+  impl->Parallel(Forward(loop));
   trace_.Append(ScheduleDesc::Step("Parallel", {{"loop", std::vector<Expr>({loop})}}, {}, {}));
 }
 
 void IRSchedule::Vectorize(const Expr& loop, int factor) {
-  impl_->Vectorize(loop, factor);
+  auto* impl = MutableImpl();
+  impl->Vectorize(Forward(loop), factor);
   trace_.Append(ScheduleDesc::Step("Vectorize", {{"loop", std::vector<Expr>({loop})}}, {{"factor", factor}}, {}));
 }
 
 void IRSchedule::Unroll(const Expr& loop) {
-  impl_->Unroll(loop);
+  auto* impl = MutableImpl();
+  impl->Unroll(Forward(loop));
   trace_.Append(ScheduleDesc::Step("Unroll", {{"loop", std::vector<Expr>({loop})}}, {}, {}));
 }
 
 void IRSchedule::ComputeInline(const Expr& schedule_block) {
-  impl_->ComputeInline(schedule_block);
+  auto* impl = MutableImpl();
+  impl->ComputeInline(Forward(schedule_block));
   trace_.Append(ScheduleDesc::Step("ComputeInline", {{"schedule_block", std::vector<Expr>({schedule_block})}}, {}, {}));
 }
 
 void IRSchedule::Bind(const Expr& loop, const std::string& thread_axis) {
-  impl_->Bind(loop, thread_axis);
+  auto* impl = MutableImpl();
+  impl->Bind(Forward(loop), thread_axis);
   trace_.Append(ScheduleDesc::Step("Bind", {{"loop", std::vector<Expr>({loop})}}, {{"thread_axis", thread_axis}}, {}));
 }
 
 Expr IRSchedule::Rfactor(const Expr& rf_loop, int rf_axis) {
-  auto result = impl_->Rfactor(rf_loop, rf_axis);
+  auto* impl  = MutableImpl();
+  auto result = impl->Rfactor(Forward(rf_loop), rf_axis);
   trace_.Append(
       ScheduleDesc::Step("Rfactor", {{"rf_loop", std::vector<Expr>({rf_loop})}}, {{"rf_axis", rf_axis}}, {result}));
   return result;
 }
 
 void IRSchedule::Annotate(const Expr& block, const std::string& key, const attr_t& value) {
-  impl_->Annotate(block, key, value);
+  auto* impl = MutableImpl();
+  impl->Annotate(Forward(block), key, value);
 
 #define TRACE_ANNOTATE_ITEM(data_type, step_name)                                            \
   if (absl::holds_alternative<data_type>(value)) {                                           \
@@ -2051,28 +2179,33 @@ void IRSchedule::Annotate(const Expr& block, const std::string& key, const attr_
 }
 
 void IRSchedule::Unannotate(Expr& block, const std::string& key) {
-  impl_->Unannotate(block, key);
+  auto* impl           = MutableImpl();
+  Expr forwarded_block = Forward(block);
+  impl->Unannotate(forwarded_block, key);
   trace_.Append(ScheduleDesc::Step("Unannotate", {{"block", std::vector<Expr>({block})}}, {{"key", key}}, {}));
 }
 
 void IRSchedule::FlattenLoops(const std::vector<Expr>& loops, const bool force_flat) {
-  impl_->FlattenLoops(loops, force_flat);
+  auto* impl = MutableImpl();
+  impl->FlattenLoops(Forward(loops), force_flat);
   trace_.Append(
       ScheduleDesc::Step("FlattenLoops", {{"loop", std::vector<Expr>({loops})}}, {{"force_flat", force_flat}}, {}));
 }
 
 void IRSchedule::CopyTransformAndLoopInfo(const Expr& block, const Expr& block_target) {
-  impl_->CopyTransformAndLoopInfo(block, block_target);
+  auto* impl = MutableImpl();
+  impl->CopyTransformAndLoopInfo(Forward(block), Forward(block_target));
   // don't support to trace, because we can't ensure both blocks are from the same ModuleExpr
 }
 
 void IRSchedule::CopyTransformAndLoopInfo(const std::string& block_name, const std::string& block_target_name) {
-  impl_->CopyTransformAndLoopInfo(block_name, block_target_name);
+  auto* impl = MutableImpl();
+  impl->CopyTransformAndLoopInfo(block_name, block_target_name);
   // don't support to trace, because we can't ensure both blocks are from the same ModuleExpr
 }
 
 std::vector<Expr> IRSchedule::SamplePerfectTile(const Expr& loop, int n, int max_innermost_factor) {
-  auto result = impl_->SamplePerfectTile(ir::RandomSeedController::seed, loop, n, max_innermost_factor);
+  auto result = impl_->SamplePerfectTile(ir::RandomSeedController::seed, Forward(loop), n, max_innermost_factor);
   trace_.Append(ScheduleDesc::Step("SamplePerfectTile",
                                    {{"loop", std::vector<Expr>({loop})}},
                                    {{"n", n}, {"max_innermost_factor", max_innermost_factor}},
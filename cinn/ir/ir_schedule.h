@@ -16,6 +16,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -59,6 +60,10 @@ class ModuleExpr {
  * Schedule primitves are implmented by ScheduleImpl manipulating the AST - IR(Expr).
  * To support serializing and replaying, each schedule primitive should append a ScheduleDesc::Step to
  * the trace_ in its corresponding function implment.
+ *
+ * The copies of an IRSchedule share the ASTs until one of them applies a schedule primitive, which copies the ASTs
+ * first (copy-on-write), so forking an IRSchedule in search is cheap. The Exprs obtained from the ASTs before they are
+ * copied are still accepted by the schedule primitives, and are mapped to their copies.
  */
 class ScheduleImpl;
 class IRSchedule {
@@ -72,6 +77,14 @@ class IRSchedule {
   IRSchedule& operator=(IRSchedule&& src);
   ~IRSchedule();
 
+  /**
+   * \brief Create an IRSchedule whose i-th AST is the i-th AST of sources[i], the ASTs are shared with the sources
+   * until either side schedules them.
+   * @param sources The IRSchedules providing the ASTs, all of them should have sources.size() ASTs.
+   * @return The combined IRSchedule with an empty trace.
+   */
+  static IRSchedule Combine(const std::vector<const IRSchedule*>& sources);
+
   void SetExprs(const std::vector<Expr>& exprs);
 
   //! Get the ModuleExpr stored in ScheduleImpl.
@@ -86,6 +99,9 @@ class IRSchedule {
   //! Get the ScheduleDesc that traces the scheduling process
   const ScheduleDesc& GetTraceDesc() const { return trace_; }
 
+  //! Get the structural hash of the ASTs, see ir::StructuralHash. It is cached until the ASTs are scheduled.
+  size_t GetStructuralHash() const;
+
   /**
    * \brief Get all the loops of specific Block stored in ModuleExpr.
    * @param block The block we find loop in.
@@ -367,7 +383,22 @@ class IRSchedule {
   std::vector<Expr> SamplePerfectTile(const Expr& loop, int n, int max_innermost_factor);
 
  private:
-  std::unique_ptr<ScheduleImpl> impl_;
+  //! Get the ScheduleImpl to be scheduled, the ASTs are copied first if they are shared with other IRSchedules.
+  ScheduleImpl* MutableImpl();
+
+  //! Release the nodes forwarded to the copied ASTs once no other IRSchedule shares the ASTs before the copy.
+  void ReleaseForwardedNodes() const;
+
+  //! Map the Exprs obtained before the last copy of the ASTs to their copies.
+  Expr Forward(const Expr& expr) const;
+  std::vector<Expr> Forward(const std::vector<Expr>& exprs) const;
+
+  std::shared_ptr<ScheduleImpl> impl_;
+  // each node of the ASTs before the last copy, mapped to the node and its copy. The nodes are held so their addresses
+  // are not reused, and released with the map once no other IRSchedule shares the ASTs before the copy.
+  mutable std::unordered_map<const IrNode*, std::pair<Expr, Expr>> forwarded_nodes_;
+  // the ScheduleImpl of the ASTs before the last copy
+  mutable std::weak_ptr<ScheduleImpl> forwarded_impl_;
   mutable ScheduleDesc trace_;  // trace the scheduling process
 };
 
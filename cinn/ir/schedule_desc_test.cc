@@ -168,6 +168,67 @@ TEST_F(TestScheduleDesc, Append_Replay) {
   CheckReplayResult(ir_sch, ir_sch.GetTraceDesc());
 }
 
+TEST_F(TestScheduleDesc, CopyOnWrite) {
+  lowered_funcs         = LowerCompute({32, 32}, target);
+  ir::IRSchedule ir_sch = MakeIRSchedule(lowered_funcs);
+  auto origin_expr      = utils::GetStreamCnt(ir_sch.GetModule().GetExprs().front());
+
+  // the loops are obtained before forking, and still accepted by the fork after its ASTs are copied
+  auto loops            = ir_sch.GetLoops("B");
+  ir::IRSchedule forked = ir_sch;
+  ASSERT_TRUE(forked.GetModule().GetExprs().front().same_as(ir_sch.GetModule().GetExprs().front()));
+  auto fused   = forked.Fuse(loops);
+  auto splited = forked.Split(fused, {4, -1});
+  forked.Parallel(splited.front());
+  ASSERT_FALSE(forked.GetModule().GetExprs().front().same_as(ir_sch.GetModule().GetExprs().front()));
+  ASSERT_EQ(utils::GetStreamCnt(ir_sch.GetModule().GetExprs().front()), origin_expr);
+  CheckTracingOutputs(splited, forked.GetTraceDesc());
+  CheckReplayResult(forked, forked.GetTraceDesc());
+
+  // the original one is scheduled in place once it is not shared
+  forked          = MakeIRSchedule(lowered_funcs);
+  auto origin_ptr = ir_sch.GetModule().GetExprs().front().get();
+  ir_sch.Split(loops.front(), {2, -1});
+  ASSERT_EQ(ir_sch.GetModule().GetExprs().front().get(), origin_ptr);
+  CheckReplayResult(ir_sch, ir_sch.GetTraceDesc());
+}
+
+TEST_F(TestScheduleDesc, CopyOnWriteReleasesSources) {
+  lowered_funcs         = LowerCompute({32, 32}, target);
+  ir::IRSchedule ir_sch = MakeIRSchedule(lowered_funcs);
+  ir::IRSchedule forked = ir_sch;
+  Expr origin_root      = ir_sch.GetModule().GetExprs().front();
+  int origin_ref_count  = origin_root->__ref_count__.val();
+
+  // the loops obtained before the copy are forwarded by every later primitive
+  auto loops = forked.GetLoops("B");
+  forked.Split(loops[0], {4, -1});
+  forked.Split(loops[1], {2, -1});
+  ASSERT_EQ(forked.GetLoops("B").size(), 4);
+  CheckReplayResult(forked, forked.GetTraceDesc());
+
+  // the fork releases the ASTs before its copy with the last IRSchedule sharing them, only the reference of ir_sch
+  // is dropped from the count then
+  ir_sch = MakeIRSchedule(lowered_funcs);
+  forked.Split(forked.GetLoops("B")[0], {2, -1});
+  EXPECT_EQ(origin_root->__ref_count__.val(), origin_ref_count - 1);
+}
+
+TEST_F(TestScheduleDesc, Combine) {
+  lowered_funcs         = LowerCompute({32, 32}, target);
+  ir::IRSchedule ir_sch = MakeIRSchedule(lowered_funcs);
+  auto origin_expr      = utils::GetStreamCnt(ir_sch.GetModule().GetExprs().front());
+
+  auto combined = ir::IRSchedule::Combine({&ir_sch});
+  ASSERT_TRUE(combined.GetModule().GetExprs().front().same_as(ir_sch.GetModule().GetExprs().front()));
+  ir_sch.Fuse("B", {0, 1});
+  ASSERT_EQ(utils::GetStreamCnt(combined.GetModule().GetExprs().front()), origin_expr);
+
+  combined.Split("B", 1, {4, -1});
+  CheckReplayResult(combined, combined.GetTraceDesc());
+  CheckReplayResult(ir_sch, ir_sch.GetTraceDesc());
+}
+
 // Test cases with `StepKind` prefix are to check the correctness of their StepKindInfo register
 TEST_F(TestScheduleDesc, StepKind_GetAllBlocks) {
   lowered_funcs         = LowerCompute({32, 32}, target);
@@ -26,6 +26,7 @@
 #include "cinn/ir/tensor.h"
 #include "cinn/optim/replace_var_with_expr.h"
 #include "cinn/poly/stage.h"
+#include "cinn/utils/profiler.h"
 
 namespace cinn {
 namespace lang {
@@ -88,9 +89,15 @@ Expr LowerGroup(const poly::ScheduleGroup& group,
   // get isl generated expression
   isl::set context(Context::isl_ctx(), "{:}");
   poly::AstGen gen(context, stages, group);
-  isl::ast_node ast = gen.Build();
   ir::Expr e;
-  poly::IslAstNodeToCinnExpr(ast, &e);
+  {
+    utils::RecordEvent record_ast_gen("poly::AstGen::Build", utils::EventType::kSchedule);
+    // the loops of a simple rectangular stage are generated directly, which skips the ISL AST generation.
+    if (!gen.BuildRectangular(&e)) {
+      isl::ast_node ast = gen.Build();
+      gen.ToCinnExpr(ast, &e);
+    }
+  }
   // now we get a workable expression, but the statement are something like `B(((16 * po0) + po1), po2)`, we need to
   // transform this to some realworld statement in CINN.
 
@@ -550,9 +557,13 @@ std::vector<ir::LoweredFunc> LowerImpl::operator()() {
     if (!stages_[t]->inlined()) stages.push_back(stages_[t]);
   }
 
-  auto deps     = CollectExtraDependencies();
-  auto schedule = poly::CreateSchedule(
-      stages, poly::ScheduleKind::Poly, std::vector<std::pair<std::string, std::string>>(deps.begin(), deps.end()));
+  auto deps = CollectExtraDependencies();
+  std::unique_ptr<poly::Schedule> schedule;
+  {
+    utils::RecordEvent record_schedule("poly::CreateSchedule", utils::EventType::kSchedule);
+    schedule = poly::CreateSchedule(
+        stages, poly::ScheduleKind::Poly, std::vector<std::pair<std::string, std::string>>(deps.begin(), deps.end()));
+  }
   auto func_body = GenerateFunctionBody(schedule.get());
 
   std::vector<ir::LoweredFunc> result;
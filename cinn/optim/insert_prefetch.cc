@@ -0,0 +1,210 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/insert_prefetch.h"
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/optim/ir_replace.h"
+#include "cinn/optim/ir_simplify.h"
+#include "cinn/optim/remove_schedule_block.h"
+#include "cinn/runtime/intrinsic.h"
+
+DECLARE_int32(cinn_prefetch_distance);
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+// the size of a cache line in bytes
+constexpr int kCacheLineBytes = 64;
+// the size of the private L2 cache in bytes, which is the smallest among the common X86 processors
+constexpr int kCacheBytes = 256 * 1024;
+// prefetch for read into all levels of the cache, the same as prefetcht0
+constexpr int kPrefetchRead     = 0;
+constexpr int kPrefetchLocality = 3;
+
+bool DependOn(Expr expr, const Var& var) {
+  return !ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+            return x->As<ir::_Var_>() && x->As<ir::_Var_>()->name == var->name;
+          }).empty();
+}
+
+bool IsPrefetch(const Expr* x) {
+  return x->As<ir::Call>() && x->As<ir::Call>()->name == runtime::intrinsic::prefetch_repr;
+}
+
+struct PrefetchInserter : public ir::IRMutator<Expr*> {
+  explicit PrefetchInserter(int distance) : distance_(distance) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  // update distance_ from the specific attribute of ScheduleBlock
+  void Visit(const ir::ScheduleBlock* op, Expr* expr) override {
+    int distance = distance_;
+    auto attr_it = op->attrs.find(ir::attr::prefetch_distance);
+    if (attr_it != op->attrs.end()) {
+      const int* attr_v = absl::get_if<int>(&attr_it->second);
+      if (attr_v) {
+        distance = *attr_v;
+        VLOG(5) << "prefetch_distance is updated:" << distance;
+      } else {
+        LOG(WARNING) << "Get invalid value of attr:" << ir::attr::prefetch_distance;
+      }
+    }
+    std::swap(distance_, distance);
+    ir::IRMutator<>::Visit(op, expr);
+    std::swap(distance_, distance);
+  }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    // the loops have been processed if any prefetch exists
+    if (!ir::CollectIRNodesWithoutTensor(op->body, IsPrefetch).empty()) return;
+    outer_loops_.push_back(op);
+    ir::IRMutator<>::Visit(op, expr);
+    outer_loops_.pop_back();
+    if (distance_ <= 0 || !op->is_serial()) return;
+
+    // analyse the loads with the schedule blocks removed, so they are indexed on the loop variables directly
+    Expr flatten_body = optim::IRCopy(op->body);
+    optim::RemoveScheduleBlock(&flatten_body);
+    auto inner_loops = ir::CollectIRNodesInOrder(flatten_body, [](const Expr* x) { return x->As<ir::For>(); });
+    auto loads       = ir::CollectIRNodesInOrder(flatten_body, [](const Expr* x) { return x->As<ir::Load>(); });
+    // the loads in the prefetches inserted in inner loops are skipped
+    std::set<const ir::Load*> prefetched_loads;
+    for (auto& inner_prefetch : ir::CollectIRNodesInOrder(flatten_body, IsPrefetch)) {
+      auto inner_loads = ir::CollectIRNodesInOrder(inner_prefetch, [](const Expr* x) { return x->As<ir::Load>(); });
+      for (auto& inner_load : inner_loads) {
+        prefetched_loads.insert(inner_load.As<ir::Load>());
+      }
+    }
+
+    std::vector<Expr> prefetches;
+    std::set<std::string> inserted;
+    for (auto& load : loads) {
+      auto* load_node = load.As<ir::Load>();
+      if (prefetched_loads.count(load_node) || !load_node->is_addr_tensor() || load_node->type().lanes() > 1) continue;
+      Expr index = load_node->index();
+      if (index.type().lanes() > 1 || !DependOn(index, op->loop_var)) continue;
+
+      bool is_gather = !ir::CollectIRNodesWithoutTensor(index, [&](const Expr* x) {
+                          return x->As<ir::Load>() && DependOn(*x, op->loop_var);
+                        }).empty();
+      if (!is_gather) {
+        // the addresses of the following iterations are predictable by hardware except for the large strides in
+        // innermost loops, which touch a new cache line every iteration
+        if (!inner_loops.empty()) continue;
+        Expr next_index = optim::IRCopy(index);
+        optim::IrReplace(&next_index, op->loop_var, Expr(op->loop_var) + 1);
+        Expr stride = next_index - index;
+        optim::Simplify(&stride);
+        if (!stride.is_constant()) continue;
+        if (std::abs(stride.get_constant()) * load_node->type().bytes() < kCacheLineBytes) continue;
+      }
+      if (IsReusedInCache(index, op, inner_loops)) continue;
+
+      // the loads nested in the inner loops are prefetched from the beginning of the inner ranges
+      std::vector<Expr> indices;
+      for (auto& indice : load_node->indices) {
+        indices.push_back(optim::IRCopy(indice));
+        optim::IrReplace(&indices.back(), op->loop_var, Expr(op->loop_var) + distance_);
+        for (auto& inner_loop : inner_loops) {
+          optim::IrReplace(&indices.back(), inner_loop.As<ir::For>()->loop_var, inner_loop.As<ir::For>()->min);
+        }
+      }
+      Expr prefetch = runtime::IntrinsicCall(Void(),
+                                             runtime::intrinsic::prefetch_repr,
+                                             {ir::Load::Make(load_node->tensor, indices),
+                                              Expr(kPrefetchRead),
+                                              Expr(kPrefetchLocality)});
+      // the index of a gather is loaded, which should not be out of the loop range
+      if (is_gather) {
+        prefetch = ir::IfThenElse::Make(Expr(op->loop_var) + distance_ < op->min + op->extent, prefetch);
+      }
+      std::string prefetch_repr = utils::GetStreamCnt(prefetch);
+      if (inserted.count(prefetch_repr)) continue;
+      inserted.insert(prefetch_repr);
+      VLOG(4) << "Insert prefetch in loop " << op->loop_var->name << ": " << prefetch;
+      prefetches.push_back(prefetch);
+    }
+
+    if (!prefetches.empty()) {
+      auto* node = expr->As<ir::For>();
+      prefetches.push_back(node->body);
+      node->body = ir::Block::Make(prefetches);
+    }
+  }
+
+  // Estimate whether the data loaded at the index during the loop stays in the cache until an enclosing loop loads
+  // it again, then only its first pass misses the cache. Every iteration of the loop is counted as a new cache line
+  // for each iteration of the inner loops the index depends on.
+  bool IsReusedInCache(const Expr& index, const ir::For* op, const std::vector<Expr>& inner_loops) const {
+    std::set<std::string> loop_vars = {op->loop_var->name};
+    for (auto* outer_loop : outer_loops_) {
+      loop_vars.insert(outer_loop->loop_var->name);
+    }
+    for (auto& inner_loop : inner_loops) {
+      loop_vars.insert(inner_loop.As<ir::For>()->loop_var->name);
+    }
+    // the indices on other variables, like the iterators of the enclosing schedule blocks, are not analysed
+    auto vars = ir::CollectIRNodesWithoutTensor(index, [](const Expr* x) { return x->As<ir::_Var_>(); });
+    for (auto& var : vars) {
+      if (!loop_vars.count(var.As<ir::_Var_>()->name)) return false;
+    }
+    bool reused = std::any_of(outer_loops_.begin(), outer_loops_.end(), [&](const ir::For* outer_loop) {
+      return !DependOn(index, outer_loop->loop_var);
+    });
+    if (!reused || !op->extent.is_constant()) return false;
+
+    int64_t footprint = static_cast<int64_t>(op->extent.get_constant()) * kCacheLineBytes;
+    for (auto& inner_loop : inner_loops) {
+      auto* inner_for = inner_loop.As<ir::For>();
+      if (!DependOn(index, inner_for->loop_var)) continue;
+      if (!inner_for->extent.is_constant()) return false;
+      footprint *= static_cast<int64_t>(inner_for->extent.get_constant());
+      if (footprint > kCacheBytes) return false;
+    }
+    return footprint <= kCacheBytes;
+  }
+
+  // the number of iterations to prefetch ahead
+  int distance_;
+  // the loops enclosing the visited one, from the outermost
+  std::vector<const ir::For*> outer_loops_;
+};
+
+}  // namespace
+
+void InsertPrefetch(Expr* expr, const Target& target) {
+  if (target.arch != Target::Arch::X86) return;
+  PrefetchInserter inserter(FLAGS_cinn_prefetch_distance);
+  inserter(expr);
+}
+
+}  // namespace optim
+}  // namespace cinn
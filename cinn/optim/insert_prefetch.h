@@ -0,0 +1,37 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Insert software prefetches for the loads that are expected to miss the cache on X86. In an innermost loop, a load
+ * whose stride is not less than a cache line is prefetched some iterations ahead, e.g.
+ *   for (i, 0, 100) { B[i] = A[i * 64] }
+ * is transformed to
+ *   for (i, 0, 100) { cinn_prefetch(A[(i + 8) * 64], 0, 3); B[i] = A[i * 64] }
+ * In any loop, a gather indexed by another load, such as the rows of the table in LookupTable, has the first line of
+ * its future row prefetched, which is guarded by the loop range since the index is loaded too.
+ *
+ * The distance in iterations is given by the attribute ir::attr::prefetch_distance of the enclosing ScheduleBlock, or
+ * by FLAGS_cinn_prefetch_distance otherwise, and a distance of 0 disables the prefetches.
+ */
+void InsertPrefetch(Expr* expr, const Target& target);
+
+}  // namespace optim
+}  // namespace cinn
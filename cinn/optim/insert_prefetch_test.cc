@@ -0,0 +1,154 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/insert_prefetch.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/lang/lower.h"
+#include "cinn/runtime/intrinsic.h"
+
+DECLARE_int32(cinn_prefetch_distance);
+
+namespace cinn {
+namespace optim {
+
+std::vector<Expr> CollectPrefetches(Expr expr) {
+  return ir::CollectIRNodesInOrder(expr, [](const Expr* x) {
+    return x->As<ir::Call>() && x->As<ir::Call>()->name == runtime::intrinsic::prefetch_repr;
+  });
+}
+
+TEST(InsertPrefetch, strided_load) {
+  using namespace ir;
+
+  Expr M(64);
+  Expr N(64);
+
+  Placeholder<float> A("A", {M, N});
+
+  // B = transpose(A)
+  Tensor B = Compute(
+      {N, M}, [&](Var i, Var j) { return A(j, i); }, "B");
+
+  auto stages   = CreateStages({B});
+  Target target = common::DefaultHostTarget();
+  auto func     = Lower("test_strided_load", stages, {A, B});
+  Expr body     = func->body;
+  ASSERT_TRUE(CollectPrefetches(body).empty());
+
+  FLAGS_cinn_prefetch_distance = 8;
+  InsertPrefetch(&body, target);
+  FLAGS_cinn_prefetch_distance = 0;
+  VLOG(6) << "After InsertPrefetch:\n" << body;
+
+  // A is loaded with a stride of 64 floats in the innermost loop, which is prefetched 8 iterations ahead
+  auto prefetches = CollectPrefetches(body);
+  ASSERT_EQ(prefetches.size(), 1U);
+  auto* load = prefetches[0].As<ir::Call>()->read_args[0].As<ir::Load>();
+  ASSERT_NE(load, nullptr);
+  EXPECT_EQ(load->name(), "A");
+
+  auto loops = ir::CollectIRNodesInOrder(body, [](const Expr* x) { return x->As<ir::For>(); });
+  ASSERT_EQ(loops.size(), 2U);
+  auto* inner_loop = loops[1].As<ir::For>();
+  EXPECT_EQ(utils::GetStreamCnt(load->indices[0]), utils::GetStreamCnt(Expr(inner_loop->loop_var) + 8));
+
+  // it is not inserted again
+  FLAGS_cinn_prefetch_distance = 8;
+  InsertPrefetch(&body, target);
+  FLAGS_cinn_prefetch_distance = 0;
+  EXPECT_EQ(CollectPrefetches(body).size(), 1U);
+}
+
+TEST(InsertPrefetch, reused_load) {
+  using namespace ir;
+
+  auto insert_prefetch = [](int n) {
+    Expr R(4);
+    Expr N(64);
+    Expr M(n);
+
+    Placeholder<float> A("A", {M, N});
+
+    // A is transposed for each r, so the strided loads in the innermost loop are reused by the outer loop
+    Tensor B = Compute(
+        {R, N, M}, [&](Var r, Var i, Var j) { return A(j, i); }, "B");
+
+    auto stages = CreateStages({B});
+    auto func   = Lower("test_reused_load", stages, {A, B});
+    Expr body   = func->body;
+
+    FLAGS_cinn_prefetch_distance = 8;
+    InsertPrefetch(&body, common::DefaultHostTarget());
+    FLAGS_cinn_prefetch_distance = 0;
+    VLOG(6) << "After InsertPrefetch:\n" << body;
+    return CollectPrefetches(body).size();
+  };
+
+  // the 64 lines loaded by the innermost loop stay in the cache, only the first pass of r misses them
+  EXPECT_EQ(insert_prefetch(64), 0U);
+  // the 8192 lines of 512KB are evicted before the next pass, so they are still prefetched
+  EXPECT_EQ(insert_prefetch(8192), 1U);
+}
+
+TEST(InsertPrefetch, gather) {
+  using namespace ir;
+
+  Expr M(16);
+  Expr N(64);
+  Expr V(1000);
+
+  Placeholder<int32_t> ids("ids", {M});
+  Placeholder<float> W("W", {V, N});
+
+  // C = W[ids]
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return W(ids(i), j); }, "C");
+
+  auto stages   = CreateStages({C});
+  Target target = common::DefaultHostTarget();
+  auto func     = cinn::lang::LowerVec("test_gather", stages, {ids, W, C}, {}, {}, nullptr, target, true);
+  auto ast_expr = func[0]->body;
+
+  // the prefetch is enabled by the attribute of the root block
+  InsertPrefetch(&ast_expr, target);
+  ASSERT_TRUE(CollectPrefetches(ast_expr).empty());
+  auto* block_realize  = ast_expr.As<ir::Block>()->stmts.front().As<ir::ScheduleBlockRealize>();
+  auto* schedule_block = block_realize->schedule_block.As<ir::ScheduleBlock>();
+  schedule_block->attrs.emplace(ir::attr::prefetch_distance, 4);
+  InsertPrefetch(&ast_expr, target);
+  VLOG(6) << "After InsertPrefetch:\n" << ast_expr;
+
+  // the rows of W are gathered by the outer loop, the first line of the row 4 iterations ahead is prefetched under the
+  // guard of the loop range, while the contiguous loads in the inner loop are not
+  auto guarded = ir::CollectIRNodesInOrder(ast_expr, [](const Expr* x) {
+    return x->As<ir::IfThenElse>() && !CollectPrefetches(x->As<ir::IfThenElse>()->true_case).empty();
+  });
+  ASSERT_EQ(guarded.size(), 1U);
+  auto prefetches = CollectPrefetches(ast_expr);
+  ASSERT_EQ(prefetches.size(), 1U);
+  auto* load = prefetches[0].As<ir::Call>()->read_args[0].As<ir::Load>();
+  ASSERT_NE(load, nullptr);
+  EXPECT_EQ(load->name(), "W");
+  EXPECT_EQ(utils::GetStreamCnt(load->indices[1]), "0");
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -17,6 +17,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "cinn/common/common.h"
@@ -34,8 +36,16 @@ struct IRCopyVisitor : public ir::IRVisitorBase<Expr> {
   // Use maps to unify all the copied tensors and buffers.
   std::map<std::string, ir::_Tensor_*> tensor_map;
   std::map<std::string, ir::_Buffer_*> buffer_map;
+  // Record each visited node and its copy if not null.
+  std::unordered_map<const ir::IrNode*, std::pair<Expr, Expr>>* node_map{nullptr};
 
-  Expr Visit(const Expr* op) override { return IRVisitorBase::Visit(op); }
+  Expr Visit(const Expr* op) override {
+    auto copied = IRVisitorBase::Visit(op);
+    if (node_map) {
+      node_map->emplace(op->ptr(), std::make_pair(*op, copied));
+    }
+    return copied;
+  }
 
  protected:
   // The methods of ir nodes follows the order defined in node.h
@@ -450,6 +460,12 @@ Expr IRCopy(Expr x) {
   return copied;
 }
 
+Expr IRCopy(Expr x, std::unordered_map<const ir::IrNode*, std::pair<Expr, Expr>>* node_map) {
+  IRCopyVisitor visitor;
+  visitor.node_map = node_map;
+  return visitor.Visit(&x);
+}
+
 std::vector<Expr> IRCopy(const std::vector<Expr>& x) {
   std::vector<Expr> res;
   for (auto& i : x) {
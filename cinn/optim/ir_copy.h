@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -31,6 +32,12 @@ namespace optim {
 //! Shallow copy an expression.
 Expr IRCopy(Expr x);
 
+/**
+ * Copy an expression and record each node of \p x in \p node_map, mapped to the node itself and its copy. The map
+ * keeps the source nodes alive, so no key is reused by another node while the map exists.
+ */
+Expr IRCopy(Expr x, std::unordered_map<const ir::IrNode*, std::pair<Expr, Expr>>* node_map);
+
 std::vector<Expr> IRCopy(const std::vector<Expr>& x);
 
 ir::ModuleExpr IRCopy(const ir::ModuleExpr& x);
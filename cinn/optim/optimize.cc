@@ -14,6 +14,9 @@
 
 #include "cinn/optim/optimize.h"
 
+#include <functional>
+
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_schedule_util.h"
 #include "cinn/optim/call_arg_list_to_pod_value.h"
@@ -24,6 +27,7 @@
 #include "cinn/optim/fold_cinn_call_arguments.h"
 #include "cinn/optim/if_simplify.h"
 #include "cinn/optim/insert_debug_log_callee.h"
+#include "cinn/optim/insert_prefetch.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/lower_function_call_bind_vars.h"
@@ -36,37 +40,66 @@
 #include "cinn/optim/transform_polyfor_to_for.h"
 #include "cinn/optim/unroll_loops.h"
 #include "cinn/optim/vectorize_loops.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/profiler.h"
 
 DECLARE_bool(cinn_ir_schedule);
 
 namespace cinn {
 namespace optim {
 
+namespace {
+
+// Run an optimization pass on \p e, the number of IR nodes before and after the pass is recorded with its time.
+template <typename PassT>
+void RunPass(const char* name, Expr* e, PassT&& pass) {
+  utils::RecordEvent record_pass(name, utils::EventType::kOptimize);
+  auto count_nodes = [e] { return ir::CollectIRNodesWithoutTensor(*e, [](const Expr*) { return true; }).size(); };
+  if (record_pass.recorded()) {
+    record_pass.AddArg("ir_nodes_before", count_nodes());
+  }
+  pass();
+  if (record_pass.recorded()) {
+    record_pass.AddArg("ir_nodes_after", count_nodes());
+  }
+}
+
+#define RUN_PASS(pass__, ...) RunPass(#pass__, &copied, [&] { pass__(&copied, ##__VA_ARGS__); })
+
+// Run \p passes on each function of \p module concurrently, the functions are independent of each other.
+void RunFunctionPasses(ir::_Module_* module, int num_threads, const std::function<void(Expr*)>& passes) {
+  auto worker = [&](int idx) { passes(&module->functions[idx]); };
+  utils::parallel_run(worker, utils::SequenceDispatcher(0, module->functions.size()), num_threads);
+}
+
+}  // namespace
+
 Expr Optimize(Expr e, Target target, bool runtime_debug_info) {
   CHECK(e.defined());
   auto copied = IRCopy(e);
 
-  FoldCINNCallArguments(&copied);
-  TransformPolyForToFor(&copied);
-  ReplaceConstParamToInteger(&copied);
-  CastSimplify(&copied);
-  Simplify(&copied);
-  UnrollLoop(&copied);
-  VectorizeLoops(&copied, target);
+  RUN_PASS(FoldCINNCallArguments);
+  RUN_PASS(TransformPolyForToFor);
+  RUN_PASS(ReplaceConstParamToInteger);
+  RUN_PASS(CastSimplify);
+  RUN_PASS(Simplify);
+  RUN_PASS(UnrollLoop);
+  RUN_PASS(VectorizeLoops, target);
+  RUN_PASS(InsertPrefetch, target);
 #ifdef CINN_WITH_CUDA
   if (FLAGS_cinn_ir_schedule) ir::SetCudaAxisInfo(&copied);
-  RemoveGpuForloopsAxis(&copied);
-  CudaSyncThreadsDropIfThenElse(&copied);
+  RUN_PASS(RemoveGpuForloopsAxis);
+  RUN_PASS(CudaSyncThreadsDropIfThenElse);
 #endif
 
-  RemoveNestedBlock(&copied);
+  RUN_PASS(RemoveNestedBlock);
 
-  MapExternCall(&copied, target);
-  ExternCallMultiOutputShallowStore(&copied);
+  RUN_PASS(MapExternCall, target);
+  RUN_PASS(ExternCallMultiOutputShallowStore);
 
-  CastSimplify(&copied);
-  Simplify(&copied);
-  IfSimplify(&copied);
+  RUN_PASS(CastSimplify);
+  RUN_PASS(Simplify);
+  RUN_PASS(IfSimplify);
 
   if (runtime_debug_info) {
     LOG(WARNING) << "Turn on runtime debug information output";
@@ -76,18 +109,47 @@ Expr Optimize(Expr e, Target target, bool runtime_debug_info) {
 }
 
 ir::Module Optimize(const ir::Module& module, const Target& target) {
+  // the functions are optimized in parallel, except the module-level LowerFunctionCallBindVars which reads the
+  // arguments of the callees, the buffers and submodules are rare so they fall back to the sequential passes.
+  int num_threads = utils::GetCompileThreadNum(module->functions.size());
+  if (num_threads > 1 && module->buffers.empty() && module->submodules.empty()) {
+    ir::Module res = ir::_Module_::Make(module->name, module->target);
+    res->functions = module->functions;
+    RunFunctionPasses(res.self(), num_threads, [&](Expr* func) {
+      auto copied = IRCopy(*func);
+      if (FLAGS_cinn_ir_schedule) {
+        RUN_PASS(UnrollLoop);
+        RUN_PASS(VectorizeLoops, Target());
+      }
+      RUN_PASS(RemoveScheduleBlock);
+      *func = copied;
+    });
+    {
+      Expr copied(res);
+      RUN_PASS(LowerFunctionCallBindVars);
+    }
+    RunFunctionPasses(res.self(), num_threads, [&](Expr* func) {
+      Expr& copied = *func;
+      RUN_PASS(CallArgListToPodValue);
+      RUN_PASS(LowerIntrin, target);
+    });
+    return res;
+  }
+
   auto copied = IRCopy(Expr(module));
   if (FLAGS_cinn_ir_schedule) {
-    UnrollLoop(&copied);
-    VectorizeLoops(&copied, Target());
+    RUN_PASS(UnrollLoop);
+    RUN_PASS(VectorizeLoops, Target());
   }
-  RemoveScheduleBlock(&copied);
-  LowerFunctionCallBindVars(&copied);
-  CallArgListToPodValue(&copied);
-  LowerIntrin(&copied, target);
+  RUN_PASS(RemoveScheduleBlock);
+  RUN_PASS(LowerFunctionCallBindVars);
+  RUN_PASS(CallArgListToPodValue);
+  RUN_PASS(LowerIntrin, target);
 
   return copied.as_module_ref();
 }
 
+#undef RUN_PASS
+
 }  // namespace optim
 }  // namespace cinn
@@ -14,14 +14,19 @@
 
 #include "cinn/optim/unroll_loops.h"
 
+#include <algorithm>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_compare.h"
 #include "cinn/ir/ir_mutator.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_replace.h"
+#include "cinn/optim/remove_schedule_block.h"
 
 namespace cinn {
 namespace optim {
@@ -32,23 +37,34 @@ struct UnrollMutator : public ir::IRMutator<Expr*> {
   void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
 
  private:
-  // update auto_max_step_ from the specific attribute of ScheduleBlock
+  // update auto_max_step_, unroll_jam_factor_ and reduce_split_factor_ from the specific attributes of ScheduleBlock,
+  // they take effect on the loops nested in the block. The factors of unroll-and-jam and reduction split are consumed
+  // by this pass, so that the loops transformed once are not transformed again when the pass runs repeatedly.
   void Visit(const ir::ScheduleBlock* op, Expr* expr) override {
-    auto attr_it = op->attrs.find(ir::attr::auto_unroll_max_step);
-    if (attr_it != op->attrs.end()) {
-      const int* attr_v = absl::get_if<int>(&attr_it->second);
-      if (attr_v) {
-        int value = *attr_v;
-        std::swap(auto_max_step_, value);
-        VLOG(5) << "auto_max_step is updated:" << auto_max_step_;
-        ir::IRMutator<>::Visit(op, expr);
-        std::swap(auto_max_step_, value);
-        return;
-      } else {
-        LOG(WARNING) << "Get invalid value of attr:" << ir::attr::auto_unroll_max_step;
-      }
-    }
+    int auto_max_step       = GetIntAttr(op, ir::attr::auto_unroll_max_step, auto_max_step_);
+    int unroll_jam_factor   = GetIntAttr(op, ir::attr::unroll_jam_factor, unroll_jam_factor_);
+    int reduce_split_factor = GetIntAttr(op, ir::attr::reduce_split_factor, reduce_split_factor_);
+    std::swap(auto_max_step_, auto_max_step);
+    std::swap(unroll_jam_factor_, unroll_jam_factor);
+    std::swap(reduce_split_factor_, reduce_split_factor);
     ir::IRMutator<>::Visit(op, expr);
+    std::swap(auto_max_step_, auto_max_step);
+    std::swap(unroll_jam_factor_, unroll_jam_factor);
+    std::swap(reduce_split_factor_, reduce_split_factor);
+    expr->As<ir::ScheduleBlock>()->attrs.erase(ir::attr::unroll_jam_factor);
+    expr->As<ir::ScheduleBlock>()->attrs.erase(ir::attr::reduce_split_factor);
+  }
+
+  int GetIntAttr(const ir::ScheduleBlock* op, const std::string& key, int default_value) const {
+    auto attr_it = op->attrs.find(key);
+    if (attr_it == op->attrs.end()) return default_value;
+    const int* attr_v = absl::get_if<int>(&attr_it->second);
+    if (!attr_v) {
+      LOG(WARNING) << "Get invalid value of attr:" << key;
+      return default_value;
+    }
+    VLOG(5) << key << " is updated:" << *attr_v;
+    return *attr_v;
   }
 
   // count a Store node as plain statement
@@ -59,7 +75,24 @@ struct UnrollMutator : public ir::IRMutator<Expr*> {
 
   // predicate whether a for-loop can be unrolled and do it
   void Visit(const ir::For* op, Expr* expr) override {
+    bool outer_jammed = jammed_;
+    jammed_           = false;
     IRMutator<>::Visit(op, expr);
+    // only the innermost legal loop is jammed, so a loop containing a jammed one is skipped
+    bool inner_jammed = jammed_;
+    jammed_           = outer_jammed || inner_jammed;
+    if (!inner_jammed && unroll_jam_factor_ > 1 && UnrollAndJam(op, unroll_jam_factor_, expr)) {
+      jammed_     = true;
+      flat_step_ *= unroll_jam_factor_;
+      ++not_unrolled_depth_;
+      return;
+    }
+    if (reduce_split_factor_ > 1 && SplitReduction(op, reduce_split_factor_, expr)) {
+      flat_step_ *= reduce_split_factor_;
+      ++not_unrolled_depth_;
+      return;
+    }
+
     if (op->extent.As<ir::IntImm>() == nullptr) {
       VLOG(5) << "loop to be unrolled should have a contant extent";
       return;
@@ -98,6 +131,244 @@ struct UnrollMutator : public ir::IRMutator<Expr*> {
     *expr = ir::Block::Make(body);
   }
 
+  //! Whether a loop can be partially unrolled by \p factor, that is a serial loop starting from 0 with a constant
+  //! extent divisible by the factor.
+  bool IsPartialUnrollable(const ir::For* op, int factor) const {
+    auto* min    = op->min.As<ir::IntImm>();
+    auto* extent = op->extent.As<ir::IntImm>();
+    return op->is_serial() && min && min->value == 0 && extent && extent->value > factor && extent->value % factor == 0;
+  }
+
+  //! Copy the body of a loop for \p factor consecutive iterations, the i-th copy replaces the loop variable with
+  //! `loop_var * factor + i`.
+  std::vector<Expr> CopyIterations(const ir::For* op, int factor) const {
+    std::vector<Expr> copies;
+    for (int i = 0; i < factor; ++i) {
+      copies.push_back(optim::IRCopy(op->body));
+      optim::IrReplace(&copies.back(), op->loop_var, Expr(op->loop_var) * factor + i);
+    }
+    return copies;
+  }
+
+  //! The body of a loop with the schedule blocks replaced by the statements they contain, which indexes the tensors
+  //! with the loop variables directly.
+  Expr FlattenBody(const ir::For* op) const {
+    Expr body = optim::IRCopy(op->body);
+    optim::RemoveScheduleBlock(&body);
+    while (body.As<ir::Block>() && body.As<ir::Block>()->stmts.size() == 1U) {
+      body = body.As<ir::Block>()->stmts.front();
+    }
+    return body;
+  }
+
+  bool IndicesEqual(const std::vector<Expr>& lhs, const std::vector<Expr>& rhs) const {
+    if (lhs.size() != rhs.size()) return false;
+    for (int i = 0; i < lhs.size(); ++i) {
+      if (!ir::IrEqualVisitor().Compare(lhs[i], rhs[i])) return false;
+    }
+    return true;
+  }
+
+  bool DependOn(Expr expr, const Var& var) const {
+    return !ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+              return x->As<ir::_Var_>() && x->As<ir::_Var_>()->name == var->name;
+            }).empty();
+  }
+
+  //! Whether \p index is `var * c + e` with a nonzero constant c and the expression e not depending on \p var, so
+  //! different values of the variable always get different indices.
+  bool IsInjectiveOn(const Expr& index, const Var& var) const {
+    if (index.As<ir::_Var_>()) return index.As<ir::_Var_>()->name == var->name;
+    auto injective_operand = [&](const Expr& lhs, const Expr& rhs) {
+      return (IsInjectiveOn(lhs, var) && !DependOn(rhs, var)) || (IsInjectiveOn(rhs, var) && !DependOn(lhs, var));
+    };
+    if (index.As<ir::Add>()) return injective_operand(index.As<ir::Add>()->a(), index.As<ir::Add>()->b());
+    if (index.As<ir::Sub>()) return injective_operand(index.As<ir::Sub>()->a(), index.As<ir::Sub>()->b());
+    if (index.As<ir::Mul>()) {
+      auto* mul          = index.As<ir::Mul>();
+      auto nonzero_const = [](const Expr& x) { return x.As<ir::IntImm>() && x.As<ir::IntImm>()->value != 0; };
+      return (nonzero_const(mul->b()) && IsInjectiveOn(mul->a(), var)) ||
+             (nonzero_const(mul->a()) && IsInjectiveOn(mul->b(), var));
+    }
+    return false;
+  }
+
+  /**
+   * Unroll an outer loop by \p factor and jam the copies into the inner loops, so each unrolled iteration keeps its
+   * own accumulator in the innermost body, e.g.
+   *   for (j, 0, 4) { C[j] = 0; for (k, 0, 8) { C[j] += A[j, k] } }
+   * is transformed to
+   *   for (j, 0, 2) { C[j*2] = 0; C[j*2+1] = 0; for (k, 0, 8) { C[j*2] += A[j*2, k]; C[j*2+1] += A[j*2+1, k] } }
+   * It is legal only if every store in the loop has an index which is an injective function of the loop variable and
+   * does not depend on the inner loops, so the jammed iterations never write the same position, and every tensor
+   * written in the loop is read at the positions written by the same iteration, so the iterations are independent of
+   * each other. Otherwise the loop is left to be unrolled normally.
+   */
+  bool UnrollAndJam(const ir::For* op, int factor, Expr* expr) {
+    if (!IsPartialUnrollable(op, factor)) return false;
+    if (ir::CollectIRNodesWithoutTensor(op->body, [](const Expr* x) { return x->As<ir::For>(); }).empty()) {
+      return false;
+    }
+
+    Expr flatten_body = FlattenBody(op);
+
+    auto stores = ir::CollectIRNodesWithoutTensor(flatten_body, [](const Expr* x) { return x->As<ir::Store>(); });
+    auto loads  = ir::CollectIRNodesWithoutTensor(flatten_body, [](const Expr* x) { return x->As<ir::Load>(); });
+    if (stores.empty()) return false;
+    auto inner_loops = ir::CollectIRNodesWithoutTensor(flatten_body, [](const Expr* x) { return x->As<ir::For>(); });
+
+    // an index distinguishing the positions written by different iterations of the loop
+    auto distinct_on_iterations = [&](const Expr& index) {
+      auto depend_on_inner = [&](const Expr& x) { return DependOn(index, x.As<ir::For>()->loop_var); };
+      return IsInjectiveOn(index, op->loop_var) &&
+             std::none_of(inner_loops.begin(), inner_loops.end(), depend_on_inner);
+    };
+    for (auto& store : stores) {
+      auto* store_node = store.As<ir::Store>();
+      if (std::none_of(store_node->indices.begin(), store_node->indices.end(), distinct_on_iterations)) {
+        VLOG(5) << "Can't jam loop " << op->loop_var->name << " for the store not indexed injectively on it:" << store;
+        return false;
+      }
+      for (auto& load : loads) {
+        auto* load_node = load.As<ir::Load>();
+        if (load_node->name() == store_node->name() &&
+            !IndicesEqual(load_node->indices, store_node->indices)) {
+          VLOG(5) << "Can't jam loop " << op->loop_var->name << " for the dependence between iterations on "
+                  << store_node->name();
+          return false;
+        }
+      }
+    }
+
+    VLOG(5) << "Unroll and jam loop " << op->loop_var->name << " by factor " << factor;
+    *expr = ir::For::Make(op->loop_var,
+                          op->min,
+                          Expr(op->extent.as_int32() / factor),
+                          op->for_type(),
+                          op->device_api,
+                          Jam(CopyIterations(op, factor)),
+                          op->vectorize_info(),
+                          op->bind_info());
+    return true;
+  }
+
+  /**
+   * Jam the copies of a loop body: the loops with the same range are fused into one loop whose bodies are jammed
+   * recursively, the blocks with the same number of statements are jammed statement by statement, and the others are
+   * concatenated in the order of iterations.
+   */
+  Expr Jam(const std::vector<Expr>& copies) const {
+    CHECK(!copies.empty());
+    auto* first_for = copies.front().As<ir::For>();
+    bool same_loops = std::all_of(copies.begin(), copies.end(), [&](const Expr& copy) {
+      auto* copy_for = copy.As<ir::For>();
+      return first_for && copy_for && copy_for->for_type() == first_for->for_type() &&
+             ir::IrEqualVisitor().Compare(copy_for->min, first_for->min) &&
+             ir::IrEqualVisitor().Compare(copy_for->extent, first_for->extent);
+    });
+    if (same_loops) {
+      std::vector<Expr> bodies;
+      for (auto& copy : copies) {
+        bodies.push_back(copy.As<ir::For>()->body);
+        optim::IrReplace(&bodies.back(), copy.As<ir::For>()->loop_var, first_for->loop_var);
+      }
+      return ir::For::Make(first_for->loop_var,
+                           first_for->min,
+                           first_for->extent,
+                           first_for->for_type(),
+                           first_for->device_api,
+                           Jam(bodies),
+                           first_for->vectorize_info(),
+                           first_for->bind_info());
+    }
+
+    auto* first_block = copies.front().As<ir::Block>();
+    bool same_blocks  = std::all_of(copies.begin(), copies.end(), [&](const Expr& copy) {
+      return first_block && copy.As<ir::Block>() && copy.As<ir::Block>()->stmts.size() == first_block->stmts.size();
+    });
+    if (same_blocks) {
+      std::vector<Expr> stmts;
+      for (int i = 0; i < first_block->stmts.size(); ++i) {
+        std::vector<Expr> stmt_copies;
+        for (auto& copy : copies) {
+          stmt_copies.push_back(copy.As<ir::Block>()->stmts[i]);
+        }
+        stmts.push_back(Jam(stmt_copies));
+      }
+      return ir::Block::Make(stmts);
+    }
+
+    return ir::Block::Make(copies);
+  }
+
+  /**
+   * Split the accumulation of a reduction loop into \p factor partial sums which are independent of each other,
+   * e.g.
+   *   for (k, 0, 8) { C[i] = C[i] + A[i, k] }
+   * is transformed to
+   *   for (k, 0, 2) { C[i] = C[i] + (((A[i, k*4] + A[i, k*4+1]) + (A[i, k*4+2] + A[i, k*4+3]))) }
+   * so the dependence chain on C[i] is shortened by the factor. The body of the loop should be a single store which
+   * accumulates to a position not indexed on the loop variable.
+   */
+  bool SplitReduction(const ir::For* op, int factor, Expr* expr) {
+    if (!IsPartialUnrollable(op, factor)) return false;
+    Expr flatten_body = FlattenBody(op);
+    auto* store       = flatten_body.As<ir::Store>();
+    if (!store || !store->value.As<ir::Add>()) return false;
+    if (std::any_of(store->indices.begin(), store->indices.end(), [&](const Expr& index) {
+          return DependOn(index, op->loop_var);
+        })) {
+      return false;
+    }
+
+    // find the operand loading the accumulator, the other one is the term to be accumulated
+    auto is_accumulator = [&](const Expr& operand) {
+      auto* load = operand.As<ir::Load>();
+      return load && load->name() == store->name() && IndicesEqual(load->indices, store->indices);
+    };
+    auto* add = store->value.As<ir::Add>();
+    Expr accumulator, term;
+    if (is_accumulator(add->a())) {
+      accumulator = add->a();
+      term        = add->b();
+    } else if (is_accumulator(add->b())) {
+      accumulator = add->b();
+      term        = add->a();
+    } else {
+      return false;
+    }
+    bool read_accumulator = !ir::CollectIRNodesWithoutTensor(term, [&](const Expr* x) {
+                               return x->As<ir::Load>() && x->As<ir::Load>()->name() == store->name();
+                             }).empty();
+    if (read_accumulator) return false;
+
+    std::vector<Expr> terms;
+    for (int i = 0; i < factor; ++i) {
+      terms.push_back(optim::IRCopy(term));
+      optim::IrReplace(&terms.back(), op->loop_var, Expr(op->loop_var) * factor + i);
+    }
+    // sum up the partial terms as a balanced tree
+    while (terms.size() > 1U) {
+      std::vector<Expr> sums;
+      for (int i = 0; i + 1 < terms.size(); i += 2) {
+        sums.push_back(ir::Add::Make(terms[i], terms[i + 1]));
+      }
+      if (terms.size() % 2) sums.push_back(terms.back());
+      terms.swap(sums);
+    }
+
+    VLOG(5) << "Split reduction loop " << op->loop_var->name << " by factor " << factor;
+    *expr = ir::For::Make(op->loop_var,
+                          op->min,
+                          Expr(op->extent.as_int32() / factor),
+                          op->for_type(),
+                          op->device_api,
+                          ir::Store::Make(store->tensor, ir::Add::Make(accumulator, terms.front()), store->indices),
+                          op->vectorize_info(),
+                          op->bind_info());
+    return true;
+  }
+
  private:
   // max permitted steps to be automatically unrolled in total
   int auto_max_step_ = 0;
@@ -108,6 +379,13 @@ struct UnrollMutator : public ir::IRMutator<Expr*> {
   int flat_step_ = 0;
   // the number of nested loops not to be unrolled
   int not_unrolled_depth_ = 0;
+
+  // the factor to unroll and jam an outer loop, disabled if not greater than 1
+  int unroll_jam_factor_ = 1;
+  // the number of partial sums to split a reduction loop into, disabled if not greater than 1
+  int reduce_split_factor_ = 1;
+  // whether a loop has been jammed in the visited subtree
+  bool jammed_ = false;
 };
 
 }  // namespace
@@ -19,8 +19,11 @@
 #include <vector>
 
 #include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_compare.h"
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
 
 namespace cinn {
 namespace optim {
@@ -97,5 +100,101 @@ TEST(UnrollLoops, auto_unroll) {
   EXPECT_EQ(ir_sch.GetLoops("B").size(), 1);
 }
 
+TEST(UnrollLoops, unroll_and_jam) {
+  using namespace ir;
+
+  Expr M(4);
+  Expr N(4);
+  Expr K(4);
+
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+
+  // C = A * B
+  Var k(K.as_int32(), "k0");
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return lang::ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+
+  auto stages   = CreateStages({C});
+  Target target = common::DefaultHostTarget();
+  auto func     = cinn::lang::LowerVec("test_unroll_and_jam", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  auto ast_expr = func[0]->body;
+
+  auto collect_extents = [&]() {
+    std::vector<int> extents;
+    for (auto&& loop : ir::CollectIRNodesInOrder(ast_expr, [](const Expr* x) { return x->As<ir::For>(); })) {
+      extents.push_back(loop.As<ir::For>()->extent.as_int32());
+    }
+    return extents;
+  };
+  // nothing changes without the unrolling attributes
+  UnrollLoop(&ast_expr);
+  ASSERT_EQ(collect_extents(), std::vector<int>({4, 4, 4}));
+
+  auto* block_realize  = ast_expr.As<ir::Block>()->stmts.front().As<ir::ScheduleBlockRealize>();
+  auto* schedule_block = block_realize->schedule_block.As<ir::ScheduleBlock>();
+  schedule_block->attrs.emplace(ir::attr::unroll_jam_factor, 2);
+  schedule_block->attrs.emplace(ir::attr::reduce_split_factor, 2);
+  UnrollLoop(&ast_expr);
+  VLOG(6) << "After UnrollLoop:\n" << ast_expr;
+
+  // the loop j is unrolled and jammed into the reduction loop, which is split into 2 partial sums,
+  // and the loop i is kept since the inner loop j has been jammed
+  EXPECT_EQ(collect_extents(), std::vector<int>({4, 2, 2}));
+  auto init_blocks = ir::CollectIRNodesInOrder(ast_expr, [](const Expr* x) {
+    return x->As<ir::ScheduleBlockRealize>() &&
+           x->As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name == "C__reduce_init";
+  });
+
+  auto updates = ir::CollectIRNodesInOrder(ast_expr, [](const Expr* x) {
+    return x->As<ir::Store>() && x->As<ir::Store>()->name() == "C";
+  });
+  // each of the unrolled iterations of j initializes and accumulates its own element of C
+  ASSERT_EQ(init_blocks.size(), 2U);
+  ASSERT_EQ(updates.size(), 2U);
+  EXPECT_FALSE(ir::IrEqualVisitor().Compare(init_blocks[0].As<ir::ScheduleBlockRealize>()->iter_values[1],
+                                            init_blocks[1].As<ir::ScheduleBlockRealize>()->iter_values[1]));
+  EXPECT_FALSE(
+      ir::IrEqualVisitor().Compare(updates[0].As<ir::Store>()->indices[1], updates[1].As<ir::Store>()->indices[1]));
+  // the accumulated term is the sum of 2 partial products
+  EXPECT_TRUE(updates[0].As<ir::Store>()->value.As<ir::Add>()->b().As<ir::Add>());
+
+  // the factors are consumed, so running the pass again, as the module level optimization does, changes nothing
+  EXPECT_EQ(schedule_block->attrs.count(ir::attr::unroll_jam_factor), 0U);
+  EXPECT_EQ(schedule_block->attrs.count(ir::attr::reduce_split_factor), 0U);
+  Expr unrolled = IRCopy(ast_expr);
+  UnrollLoop(&ast_expr);
+  EXPECT_TRUE(ir::IrEqualVisitor().Compare(unrolled, ast_expr));
+  EXPECT_EQ(collect_extents(), std::vector<int>({4, 2, 2}));
+}
+
+TEST(UnrollLoops, unroll_and_jam_output_dependence) {
+  using namespace ir;
+
+  Placeholder<float> A("A", std::vector<int>{{4, 4}});
+  Placeholder<float> X("X", std::vector<int>{{8}});
+  Var j("j");
+  Var k("k");
+
+  // for (j, 0, 4) { for (k, 0, 4) { X[j+k] = X[j+k] + A[j, k] } }
+  // the iteration j writes X[j+k] at the same position as the iteration j+1 at k-1, jamming them reorders the writes
+  Expr index      = Expr(j) + Expr(k);
+  Expr value      = Add::Make(Load::Make(ir::Tensor(X), {index}), Load::Make(ir::Tensor(A), {Expr(j), Expr(k)}));
+  Expr body       = Store::Make(ir::Tensor(X), value, {index});
+  Expr inner_loop = For::Make(k, Expr(0), Expr(4), ForType::Serial, DeviceAPI::Host, Block::Make({body}));
+  Expr outer_loop = For::Make(j, Expr(0), Expr(4), ForType::Serial, DeviceAPI::Host, Block::Make({inner_loop}));
+
+  Expr schedule_block = ScheduleBlock::Make({}, {}, {}, "root", Block::Make({outer_loop}));
+  schedule_block.As<ir::ScheduleBlock>()->attrs.emplace(ir::attr::unroll_jam_factor, 2);
+  Expr ast_expr = Block::Make({ScheduleBlockRealize::Make({}, schedule_block)});
+
+  UnrollLoop(&ast_expr);
+  VLOG(6) << "After UnrollLoop:\n" << ast_expr;
+  auto loops = ir::CollectIRNodesInOrder(ast_expr, [](const Expr* x) { return x->As<ir::For>(); });
+  ASSERT_EQ(loops.size(), 2U);
+  EXPECT_EQ(loops[0].As<ir::For>()->extent.as_int32(), 4);
+  EXPECT_EQ(loops[1].As<ir::For>()->extent.as_int32(), 4);
+}
+
 }  // namespace optim
 }  // namespace cinn
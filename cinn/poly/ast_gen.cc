@@ -14,12 +14,21 @@
 
 #include "cinn/poly/ast_gen.h"
 
+#include <gflags/gflags.h>
 #include <llvm/Support/FormatVariadic.h>
 
+#include <sstream>
+#include <unordered_map>
 #include <utility>
 
 #include "cinn/common/common.h"
 #include "cinn/ir/ir.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_poly_ast_cache);
+DECLARE_bool(cinn_poly_rectangular_fast_path);
 
 namespace cinn {
 namespace poly {
@@ -36,6 +45,20 @@ struct AstGen::Impl {
   //! Return a map composed of all the transforms.
   isl::union_map transform();
 
+  //! Return the schedule of the group applied to the transformed domain.
+  isl::union_map ScheduleDomain();
+
+  //! Return the schedule domain with the i-th stage named NumberedStatement(i) and the axes named by their positions.
+  isl::union_map NumberedScheduleDomain();
+
+  //! Set the transformed indices of the stages from the ones collected on the numbered statements.
+  void SetNumberedIndiceMap(const std::map<std::string, std::map<std::string, isl::ast_expr>>& numbered_indice_map);
+
+  static std::string NumberedStatement(int i) { return "_s" + std::to_string(i); }
+
+  //! Return the iterator names of the schedule dimensions, with the time dimensions unnamed.
+  std::vector<std::string> IteratorNames() const;
+
   isl::ctx ctx() const;
 
   /**
@@ -57,6 +80,7 @@ struct AstGen::Impl {
   //! tuple name -> { axis -> isl_ast }
   std::map<std::string, std::map<std::string, isl::ast_expr>> transformed_indice_map_;
   isl::union_map build_options_;
+  isl::union_map schedule_domain_;
 
   friend class AstGen;
 };
@@ -132,27 +156,134 @@ isl::union_set TransIdentityExtentToContextId(isl::union_set set) {
   return isl_union_set_from_sets(sets);
 }
 
-isl::ast_node AstGen::Build() {
+namespace {
+
+struct CachedAst {
+  isl::ast_node ast;
+  std::map<std::string, std::map<std::string, isl::ast_expr>> transformed_indice_map;
+};
+
+// The ISL objects belong to the thread local isl_ctx, so are the ASTs cached.
+std::unordered_map<std::string, CachedAst>& GetAstCache() {
+  static thread_local std::unordered_map<std::string, CachedAst> cache;
+  return cache;
+}
+
+constexpr int kMaxCachedAsts = 4096;
+
+//! Rename the ISL calls of the numbered statements to the stages.
+struct RenameIslCallMutator : public ir::IRMutator<> {
+  explicit RenameIslCallMutator(const std::map<std::string, std::string>& names) : names_(names) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::Call* op, Expr* expr) override {
+    auto* node = expr->As<ir::Call>();
+    if (node->is_isl_call() && names_.count(node->name)) {
+      node->name = names_.at(node->name);
+    }
+    ir::IRMutator<>::Visit(op, expr);
+  }
+
+  const std::map<std::string, std::string>& names_;
+};
+
+}  // namespace
+
+isl::union_map AstGen::Impl::ScheduleDomain() {
+  if (!schedule_domain_.is_null()) {
+    return schedule_domain_;
+  }
   // Collect schedule from scheduler.
-  auto schedule_map = CollectScheduleMapFromGroup(impl_->schedule_group_);
+  auto schedule_map = CollectScheduleMapFromGroup(schedule_group_);
   std::vector<isl::map> maps;
-  for (auto& stage : impl_->stages_) {
+  for (auto& stage : stages_) {
     auto it = schedule_map.find(stage->id());
     CHECK(it != std::end(schedule_map)) << "stage " << stage->id() << " not found in the map";
     maps.push_back(it->second);
   }
   auto schedule = isl_maps_to_union_map(maps);
 
+  isl::union_map transformed_schedule = transform().apply_range(schedule);
+  VLOG(4) << "transformed_schedule: " << transformed_schedule;
+  schedule_domain_ = transformed_schedule.intersect_domain(domain());
+  VLOG(4) << "domain: " << domain();
+  VLOG(4) << "transform schedule " << stages()[0]->transform();
+  VLOG(4) << "schedule: " << schedule;
+  VLOG(4) << "schedule_domain: " << schedule_domain_;
+  return schedule_domain_;
+}
+
+std::vector<std::string> AstGen::Impl::IteratorNames() const {
+  auto iterator_names = iterator_names_.empty() ? schedule_group_.dimension_names : iterator_names_;
+  return SchedulerBase::WrapIteratorNames(iterator_names);
+}
+
+isl::union_map AstGen::Impl::NumberedScheduleDomain() {
+  std::vector<isl::map> maps;
+  for (int i = 0; i < stages_.size(); i++) {
+    isl::union_set stage_domain = isl::manage(isl_union_set_from_set(stages_[i]->domain().copy()));
+    isl::union_map schedule     = ScheduleDomain().intersect_domain(stage_domain);
+
+    isl::map map = isl::manage(isl_map_from_union_map(schedule.release()));
+    map          = isl::manage(isl_map_set_tuple_name(map.release(), isl_dim_in, NumberedStatement(i).c_str()));
+    for (int j = 0; j < isl_map_dim(map.get(), isl_dim_in); j++) {
+      map = isl::manage(isl_map_set_dim_name(map.release(), isl_dim_in, j, ("i" + std::to_string(j)).c_str()));
+    }
+    for (int j = 0; j < isl_map_dim(map.get(), isl_dim_out); j++) {
+      map = isl::manage(isl_map_set_dim_name(map.release(), isl_dim_out, j, ("t" + std::to_string(j)).c_str()));
+    }
+    maps.push_back(map);
+  }
+  return isl_maps_to_union_map(maps);
+}
+
+void AstGen::Impl::SetNumberedIndiceMap(
+    const std::map<std::string, std::map<std::string, isl::ast_expr>>& numbered_indice_map) {
+  transformed_indice_map_.clear();
+  for (int i = 0; i < stages_.size(); i++) {
+    auto it = numbered_indice_map.find(NumberedStatement(i));
+    if (it == numbered_indice_map.end()) continue;
+    isl::set domain  = stages_[i]->domain();
+    auto& indice_map = transformed_indice_map_[stages_[i]->id()];
+    for (int j = 0; j < isl_set_dim(domain.get(), isl_dim_set); j++) {
+      auto index = it->second.find(std::to_string(j));
+      if (index == it->second.end() || !isl_set_has_dim_name(domain.get(), isl_dim_set, j)) continue;
+      indice_map.emplace(isl_set_get_dim_name(domain.get(), isl_dim_set, j), index->second);
+      indice_map.emplace(index->first, index->second);
+    }
+  }
+}
+
+isl::ast_node AstGen::Build() {
+  // the statements and their axes are numbered in the schedule, so the stages differing only in names share one AST.
+  auto schedule_domain = impl_->NumberedScheduleDomain();
+  auto iterator_names  = impl_->IteratorNames();
+
+  // the AST only depends on the printed ISL objects and the iterator names.
+  std::string cache_key;
+  if (FLAGS_cinn_poly_ast_cache) {
+    std::stringstream ss;
+    ss << ctx().get() << ";" << impl_->context_ << ";" << schedule_domain << ";" << utils::Join(iterator_names, ",");
+    if (!impl_->build_options_.is_null()) ss << ";" << impl_->build_options_;
+    cache_key = ss.str();
+
+    auto it = GetAstCache().find(cache_key);
+    if (it != GetAstCache().end()) {
+      VLOG(4) << "Reuse the cached AST of " << schedule_domain;
+      impl_->SetNumberedIndiceMap(it->second.transformed_indice_map);
+      return it->second.ast;
+    }
+  }
+
   // Build it.
   auto ast_build = isl::ast_build::from_context(impl_->context_);
 
   if (!impl_->build_options_.is_null())
-    ast_build = isl::manage(isl_ast_build_set_options(ast_build.release(), impl_->build_options_.release()));
+    ast_build = isl::manage(isl_ast_build_set_options(ast_build.release(), impl_->build_options_.copy()));
 
   // Set iterators names for readable code.
-  auto iterator_names =
-      impl_->iterator_names_.empty() ? impl_->schedule_group_.dimension_names : impl_->iterator_names_;
-  iterator_names   = SchedulerBase::WrapIteratorNames(iterator_names);
   isl::id_list ids = isl::manage(isl_id_list_alloc(ctx().get(), iterator_names.size()));
   for (int i = 0; i < iterator_names.size(); i++) {
     ids = isl::manage(isl_id_list_add(ids.release(), isl_id_alloc(ctx().get(), iterator_names[i].c_str(), nullptr)));
@@ -160,34 +291,147 @@ isl::ast_node AstGen::Build() {
   ast_build = isl::manage(isl_ast_build_set_iterators(ast_build.release(), ids.release()));
 
   // collect iterator map
-  auto get_domain_by_name = [this](const std::string& name) -> isl::set {
-    auto ele_it = std::find_if(
-        impl_->stages_.begin(), impl_->stages_.end(), [&name](const Shared<Stage>& ele) { return ele->id() == name; });
-    CHECK(ele_it != std::end(impl_->stages_));
-    return (*ele_it)->domain();
-  };
-
+  std::map<std::string, std::map<std::string, isl::ast_expr>> numbered_indice_map;
   auto collect = [&](isl::ast_node node, isl::ast_build build) -> isl::ast_node {
     auto tuple_name = detail::GetTupleName(node.get());
-    auto indice_map = impl_->ExtractIslTransformedIndiceMap(get_domain_by_name(tuple_name), build.get());
-    impl_->transformed_indice_map_[tuple_name] = indice_map;
+    // the domain of the numbered statement, whose axes are named by their positions.
+    isl::map schedule = isl::manage(isl_map_from_union_map(isl_ast_build_get_schedule(build.get())));
+    isl::set domain   = isl::manage(isl_map_domain(schedule.release()));
+    numbered_indice_map[tuple_name] = impl_->ExtractIslTransformedIndiceMap(domain, build.get());
     return node;
   };
 
   ast_build = ast_build.set_at_each_domain(collect);
 
-  isl::union_map transformed_schedule = impl_->transform().apply_range(schedule);
-  VLOG(4) << "transformed_schedule: " << transformed_schedule;
-  auto schedule_domain = transformed_schedule.intersect_domain(impl_->domain());
-  VLOG(4) << "domain: " << impl_->domain();
-  VLOG(4) << "transform schedule " << impl_->stages()[0]->transform();
-  VLOG(4) << "schedule: " << schedule;
-  VLOG(4) << "schedule_domain: " << schedule_domain;
   auto ast = ast_build.node_from_schedule_map(schedule_domain);
   VLOG(2) << "AST:\n" << isl_ast_node_to_C_str(ast.get());
+  impl_->SetNumberedIndiceMap(numbered_indice_map);
+
+  if (FLAGS_cinn_poly_ast_cache) {
+    auto& cache = GetAstCache();
+    if (cache.size() >= kMaxCachedAsts) {
+      cache.clear();
+    }
+    cache[cache_key] = CachedAst{ast, numbered_indice_map};
+  }
   return ast;
 }
 
+void AstGen::ToCinnExpr(const isl::ast_node& ast, ir::Expr* expr) const {
+  IslAstNodeToCinnExpr(ast, expr);
+  std::map<std::string, std::string> statement_names;
+  for (int i = 0; i < impl_->stages_.size(); i++) {
+    statement_names[Impl::NumberedStatement(i)] = impl_->stages_[i]->id();
+  }
+  RenameIslCallMutator rename(statement_names);
+  rename(expr);
+}
+
+bool AstGen::BuildRectangular(ir::Expr* expr) {
+  CHECK(expr);
+  if (!FLAGS_cinn_poly_rectangular_fast_path || impl_->stages_.size() != 1 || !impl_->build_options_.is_null() ||
+      isl_set_plain_is_universe(impl_->context_.get()) != isl_bool_true) {
+    return false;
+  }
+
+  // the domain should be a box of constant bounds.
+  auto& stage     = impl_->stages_.front();
+  isl::set domain = stage->domain();
+  if (isl_set_dim(domain.get(), isl_dim_param) != 0) {
+    return false;
+  }
+  const int n_dims = isl_set_dim(domain.get(), isl_dim_set);
+  isl::set box     = isl::manage(isl_set_universe(isl_set_get_space(domain.get())));
+  std::vector<int> lower_bounds(n_dims);
+  std::vector<int> upper_bounds(n_dims);
+  for (int i = 0; i < n_dims; i++) {
+    if (!isl_set_axis_has_noparam_constant_bound(domain.get(), i)) {
+      return false;
+    }
+    auto range      = isl_set_get_axis_range(domain.get(), i);
+    lower_bounds[i] = std::get<0>(range).get_num_si();
+    upper_bounds[i] = std::get<1>(range).get_num_si();
+    box             = isl::manage(isl_set_lower_bound_si(box.release(), isl_dim_set, i, lower_bounds[i]));
+    box             = isl::manage(isl_set_upper_bound_si(box.release(), isl_dim_set, i, upper_bounds[i]));
+  }
+  if (isl_set_is_equal(domain.get(), box.get()) != isl_bool_true) {
+    return false;
+  }
+
+  // each output dimension of the schedule should be either a constant or an axis of the domain, and every axis of
+  // more than one iteration should be scheduled exactly once.
+  isl::map schedule        = isl::manage(isl_map_from_union_map(impl_->ScheduleDomain().release()));
+  isl::set schedule_domain = isl::manage(isl_map_domain(schedule.copy()));
+  if (isl_set_is_equal(schedule_domain.get(), domain.get()) != isl_bool_true) {
+    return false;
+  }
+  auto iterator_names = impl_->IteratorNames();
+  std::vector<std::pair<int, std::string>> loops;  // axis, iterator name
+  std::vector<bool> scheduled(n_dims, false);
+  for (int i = 0; i < isl_map_dim(schedule.get(), isl_dim_out); i++) {
+    isl::val fixed = isl::manage(isl_map_plain_get_val_if_fixed(schedule.get(), isl_dim_out, i));
+    if (!fixed.is_null() && isl_val_is_int(fixed.get()) == isl_bool_true) {
+      continue;
+    }
+    int axis = -1;
+    for (int j = 0; j < n_dims && axis < 0; j++) {
+      isl::map equated = isl::manage(isl_map_equate(schedule.copy(), isl_dim_in, j, isl_dim_out, i));
+      if (isl_map_is_equal(equated.get(), schedule.get()) == isl_bool_true) {
+        axis = j;
+      }
+    }
+    if (axis < 0 || scheduled[axis]) {
+      return false;
+    }
+    scheduled[axis] = true;
+    if (lower_bounds[axis] == upper_bounds[axis]) {
+      continue;
+    }
+    if (i >= iterator_names.size() || iterator_names[i].empty()) {
+      return false;
+    }
+    loops.emplace_back(axis, iterator_names[i]);
+  }
+  for (int j = 0; j < n_dims; j++) {
+    if (!scheduled[j] && lower_bounds[j] != upper_bounds[j]) {
+      return false;
+    }
+  }
+
+  // ISL eliminates the loops of one iteration and replaces their iterators with the constants.
+  std::vector<Expr> indices(n_dims);
+  std::map<std::string, isl::ast_expr> indice_map;
+  for (int j = 0; j < n_dims; j++) {
+    isl::ast_expr index = isl::manage(isl_ast_expr_from_val(isl_val_int_from_si(ctx().get(), lower_bounds[j])));
+    indices[j]          = Expr(lower_bounds[j]);
+    for (auto& loop : loops) {
+      if (loop.first == j) {
+        index      = isl::manage(isl_ast_expr_from_id(isl_id_alloc(ctx().get(), loop.second.c_str(), nullptr)));
+        indices[j] = ir::Var(loop.second);
+      }
+    }
+    if (isl_set_has_dim_name(domain.get(), isl_dim_set, j)) {
+      indice_map.emplace(isl_set_get_dim_name(domain.get(), isl_dim_set, j), index);
+      indice_map.emplace(std::to_string(j), index);
+    }
+  }
+  impl_->transformed_indice_map_[stage->id()] = indice_map;
+
+  *expr = ir::Call::Make(Float(32), stage->id(), indices, {}, ir::CallType::ISL, ir::FunctionRef(), 0);
+  for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+    ir::Var iter(it->second);
+    *expr = ir::PolyFor::Make(iter,
+                              Expr(lower_bounds[it->first]),
+                              ir::LE::Make(iter, Expr(upper_bounds[it->first])),
+                              Expr(1),
+                              ir::ForType::Serial,
+                              ir::DeviceAPI::Host,
+                              ir::Block::Make({*expr}));
+  }
+  VLOG(2) << "Generate the loops of " << stage->id() << " without ISL:\n" << *expr;
+  return true;
+}
+
 AstGen& AstGen::SetIteratorNames(const std::vector<std::string>& names) {
   impl_->iterator_names_ = names;
   return *this;
@@ -428,6 +672,9 @@ void IslAstExprToCinnExpr(const isl::ast_expr& node, ir::Expr* expr) {
 
       auto set_ops_ptype = [&](ir::Type type) {
         for (auto& op : ops) {
+          if (op.type() == type) continue;
+          // the constants may be shared by hash-consing, retype a copy instead.
+          if (op.is_constant()) op = optim::IRCopy(op);
           op->set_type(type);
         }
       };
@@ -501,6 +748,7 @@ void IslAstExprToCinnExpr(const isl::ast_expr& node, ir::Expr* expr) {
           break;
         case isl_ast_op_select:
           CHECK_EQ(ops.size(), 3UL) << "In ir::Select, the ops size should be 3";
+          if (ops[0].is_constant()) ops[0] = optim::IRCopy(ops[0]);
           ops[0]->set_type(Bool());
           *expr = ir::Select::Make(ops[0], ops[1], ops[2]);
           break;
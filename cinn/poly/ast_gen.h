@@ -52,8 +52,22 @@ class AstGen {
 
   isl::ctx ctx() const;
 
+  /**
+   * Generate the ISL AST, which is memoized on each thread by the printed schedule. The statements are numbered in
+   * it, so that the stages differing only in names share one AST, use ToCinnExpr to get them named after the stages.
+   */
   isl::ast_node Build();
 
+  //! Transform the AST generated by Build to Expr, with the ISL calls named after the stages.
+  void ToCinnExpr(const isl::ast_node& ast, ir::Expr* expr) const;
+
+  /**
+   * Generate the loop nest of a single stage whose domain is a box and whose schedule keeps its axes in order, the
+   * same as the one converted from the ISL AST but without calling ISL to build it.
+   * @return false if the stages are not that simple, then Build should be used instead.
+   */
+  bool BuildRectangular(ir::Expr* expr);
+
   //! Get the map from original CINN iterators to the transformed actual ISL ast nodes.
   const std::map<std::string, isl::ast_expr>& axis2ast(const std::string& tuple_name) const;
 
@@ -14,11 +14,18 @@
 
 #include "cinn/poly/ast_gen.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <string>
+
+#include "cinn/cinn.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_printer.h"
 
+DECLARE_bool(cinn_poly_ast_cache);
+DECLARE_bool(cinn_poly_rectangular_fast_path);
+
 namespace cinn {
 namespace poly {
 
@@ -40,5 +47,50 @@ TEST(TransIdentityExtentToContextId, basic1) {
   LOG(INFO) << new_set;
 }
 
+TEST(AstGen, BuildRectangular) {
+  auto lower = [](bool fast_path) {
+    FLAGS_cinn_poly_rectangular_fast_path = fast_path;
+    Expr M(16);
+    Expr N(32);
+    lang::Placeholder<float> A("A", {M, N});
+    auto B = lang::Compute(
+        {M, N}, [=](Var i, Var j) { return A(i, j) + 1.f; }, "B");
+    // the loop of the axis with one iteration is eliminated
+    auto C = lang::Compute(
+        {Expr(1), N}, [=](Var i, Var j) { return A(i, j) * 2.f; }, "C");
+    return utils::GetStreamCnt(lang::Lower("fn_b", CreateStages({B}), {A, B})) +
+           utils::GetStreamCnt(lang::Lower("fn_c", CreateStages({C}), {A, C}));
+  };
+
+  FLAGS_cinn_poly_ast_cache = false;
+  auto expect               = lower(false);
+  EXPECT_EQ(lower(true), expect);
+  FLAGS_cinn_poly_ast_cache = true;
+}
+
+TEST(AstGen, CacheAst) {
+  auto lower = [](const std::string& name) {
+    Expr M(16);
+    Expr N(32);
+    lang::Placeholder<float> A("A", {M, N});
+    auto B = lang::Compute(
+        {M, N}, [=](Var i, Var j) { return A(i, j) + 1.f; }, name);
+    // the split stage is not rectangular, so its AST is built by ISL
+    auto stages = CreateStages({B});
+    stages[B]->Split(1, 4);
+    return utils::GetStreamCnt(lang::Lower("fn", stages, {A, B}));
+  };
+
+  FLAGS_cinn_poly_ast_cache = false;
+  auto expect_b             = lower("B");
+  auto expect_c             = lower("C");
+  FLAGS_cinn_poly_ast_cache = true;
+  // the first lowering fills the cache, which is hit by the second one
+  EXPECT_EQ(lower("B"), expect_b);
+  EXPECT_EQ(lower("B"), expect_b);
+  // the stage of another name reuses the AST, with its own name in the statements
+  EXPECT_EQ(lower("C"), expect_c);
+}
+
 }  // namespace poly
 }  // namespace cinn
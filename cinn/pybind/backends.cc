@@ -38,7 +38,8 @@ void BindExecutionEngine(py::module *m) {
   py::class_<ExecutionOptions> options(*m, "ExecutionOptions");
   options.def(py::init<>())
       .def_readwrite("opt_level", &ExecutionOptions::opt_level)
-      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info);
+      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info)
+      .def_readwrite("num_compile_threads", &ExecutionOptions::num_compile_threads);
 
   auto lookup = [](ExecutionEngine &self, absl::string_view name) {
     auto *function_ptr    = reinterpret_cast<void (*)(void **, int32_t)>(self.Lookup(name));
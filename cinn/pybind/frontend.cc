@@ -585,6 +585,12 @@ void BindFrontend(pybind11::module *m) {
            py::arg("axes")        = std::vector<int>{-1},
            py::arg("mode")        = "fast",
            py::arg("data_format") = "AnyLayout")
+      .def("flash_attention",
+           &NetBuilder::FlashAttention,
+           py::arg("q"),
+           py::arg("k"),
+           py::arg("v"),
+           py::arg("scale") = 1.0f)
       .def("dropout_infer",
            &NetBuilder::DropoutInfer,
            py::arg("x"),
@@ -16,8 +16,10 @@
 
 #include <vector>
 
+#ifndef CINN_AOT_RUNTIME
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/common/cas.h"
+#endif
 
 namespace {
 
@@ -100,6 +102,7 @@ void cinn_cpu_mkl_gemm_batch_fp32(float alpha,
                     &batch_size);
 }
 
+#ifndef CINN_AOT_RUNTIME
 CINN_REGISTER_HELPER(cinn_cpu_mkl) {
   using namespace cinn;  // NOLINT
   using backends::FunctionProto;
@@ -185,3 +188,4 @@ CINN_REGISTER_HELPER(cinn_cpu_mkl) {
 
   return true;
 }
+#endif  // CINN_AOT_RUNTIME
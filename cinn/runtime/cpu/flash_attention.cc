@@ -0,0 +1,218 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/flash_attention.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#ifndef CINN_AOT_RUNTIME
+#include "cinn/backends/extern_func_jit_register.h"
+#include "cinn/common/cas.h"
+#endif
+#include "cinn/runtime/cpu/thread_backend.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+namespace {
+
+// A kBlockQ x head_dim block of Q and its kBlockQ x head_dim_v accumulator stay in L1/L2, while the kBlockK x head_dim
+// blocks of K and V are streamed through, so each key and value is loaded once per query block instead of once per
+// query row.
+constexpr int kBlockQ = 32;
+constexpr int kBlockK = 64;
+
+struct AttentionContext {
+  int seq_q;
+  int seq_k;
+  int head_dim;
+  int head_dim_v;
+  float scale;
+  const float* Q;
+  const float* K;
+  const float* V;
+  float* O;
+  int num_q_blocks;
+  int num_blocks;
+};
+
+inline float Dot(const float* a, const float* b, int n) {
+  float sum = 0.f;
+  for (int i = 0; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+// Compute the rows [q0, q0 + bq) of one batch, the running max and sum of each row rescale the partial output whenever
+// a later key block raises the max.
+void AttentionBlock(const AttentionContext& ctx, int b, int q0, int bq, float* scores, float* row_max, float* row_sum) {
+  const float* q = ctx.Q + (static_cast<size_t>(b) * ctx.seq_q + q0) * ctx.head_dim;
+  const float* k = ctx.K + static_cast<size_t>(b) * ctx.seq_k * ctx.head_dim;
+  const float* v = ctx.V + static_cast<size_t>(b) * ctx.seq_k * ctx.head_dim_v;
+  float* o       = ctx.O + (static_cast<size_t>(b) * ctx.seq_q + q0) * ctx.head_dim_v;
+
+  std::fill(row_max, row_max + bq, -std::numeric_limits<float>::infinity());
+  std::fill(row_sum, row_sum + bq, 0.f);
+  std::fill(o, o + bq * ctx.head_dim_v, 0.f);
+  for (int k0 = 0; k0 < ctx.seq_k; k0 += kBlockK) {
+    int bk = std::min(kBlockK, ctx.seq_k - k0);
+    for (int i = 0; i < bq; ++i) {
+      const float* q_row = q + i * ctx.head_dim;
+      float* s_row       = scores + i * kBlockK;
+      float block_max    = -std::numeric_limits<float>::infinity();
+      for (int j = 0; j < bk; ++j) {
+        s_row[j]  = ctx.scale * Dot(q_row, k + (k0 + j) * ctx.head_dim, ctx.head_dim);
+        block_max = std::max(block_max, s_row[j]);
+      }
+
+      float new_max    = std::max(row_max[i], block_max);
+      float correction = std::exp(row_max[i] - new_max);
+      float block_sum  = 0.f;
+      for (int j = 0; j < bk; ++j) {
+        s_row[j]   = std::exp(s_row[j] - new_max);
+        block_sum += s_row[j];
+      }
+      row_max[i] = new_max;
+      row_sum[i] = row_sum[i] * correction + block_sum;
+
+      float* o_row = o + i * ctx.head_dim_v;
+      if (correction != 1.f) {
+        for (int c = 0; c < ctx.head_dim_v; ++c) {
+          o_row[c] *= correction;
+        }
+      }
+      for (int j = 0; j < bk; ++j) {
+        const float* v_row = v + (k0 + j) * ctx.head_dim_v;
+        float p            = s_row[j];
+        for (int c = 0; c < ctx.head_dim_v; ++c) {
+          o_row[c] += p * v_row[c];
+        }
+      }
+    }
+  }
+  for (int i = 0; i < bq; ++i) {
+    float inv_sum = 1.f / row_sum[i];
+    float* o_row  = o + i * ctx.head_dim_v;
+    for (int c = 0; c < ctx.head_dim_v; ++c) {
+      o_row[c] *= inv_sum;
+    }
+  }
+}
+
+int AttentionTask(int task_id, int num_task, void* datas) {
+  auto* ctx = reinterpret_cast<AttentionContext*>(datas);
+  std::vector<float> scores(kBlockQ * kBlockK);
+  float row_max[kBlockQ];
+  float row_sum[kBlockQ];
+  for (int block = task_id; block < ctx->num_blocks; block += num_task) {
+    int b  = block / ctx->num_q_blocks;
+    int q0 = (block % ctx->num_q_blocks) * kBlockQ;
+    AttentionBlock(*ctx, b, q0, std::min(kBlockQ, ctx->seq_q - q0), scores.data(), row_max, row_sum);
+  }
+  return 0;
+}
+
+}  // namespace
+
+void FlashAttention(int batch,
+                    int seq_q,
+                    int seq_k,
+                    int head_dim,
+                    int head_dim_v,
+                    float scale,
+                    const float* Q,
+                    const float* K,
+                    const float* V,
+                    float* O) {
+  if (batch <= 0 || seq_q <= 0 || head_dim_v <= 0) return;
+  if (seq_k <= 0) {
+    std::fill(O, O + static_cast<size_t>(batch) * seq_q * head_dim_v, 0.f);
+    return;
+  }
+
+  int num_q_blocks = (seq_q + kBlockQ - 1) / kBlockQ;
+  AttentionContext ctx{seq_q, seq_k, head_dim, head_dim_v, scale, Q, K, V, O, num_q_blocks, batch * num_q_blocks};
+  int num_task = std::min(max_concurrency(), ctx.num_blocks);
+  if (num_task <= 1) {
+    AttentionTask(0, 1, &ctx);
+  } else {
+    cinn_backend_parallel_launch(AttentionTask, &ctx, num_task);
+  }
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
+
+void cinn_cpu_flash_attention_fp32(int batch,
+                                   int seq_q,
+                                   int seq_k,
+                                   int head_dim,
+                                   int head_dim_v,
+                                   float scale,
+                                   cinn_buffer_t* Q,
+                                   cinn_buffer_t* K,
+                                   cinn_buffer_t* V,
+                                   cinn_buffer_t* O) {
+  cinn::runtime::cpu::FlashAttention(batch,
+                                     seq_q,
+                                     seq_k,
+                                     head_dim,
+                                     head_dim_v,
+                                     scale,
+                                     reinterpret_cast<float*>(Q->memory),
+                                     reinterpret_cast<float*>(K->memory),
+                                     reinterpret_cast<float*>(V->memory),
+                                     reinterpret_cast<float*>(O->memory));
+}
+
+#ifndef CINN_AOT_RUNTIME
+CINN_REGISTER_HELPER(cinn_cpu_flash_attention) {
+  using namespace cinn;  // NOLINT
+  using backends::FunctionProto;
+  auto host_target = common::DefaultHostTarget();
+
+  FunctionProto::shape_inference_t inference_shape_attention = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 9UL) << "Wrong number of arguments passed in";
+    std::vector<Expr> shape;
+    shape.push_back(common::AutoSimplify(args[0]));
+    shape.push_back(common::AutoSimplify(args[1]));
+    shape.push_back(common::AutoSimplify(args[4]));
+    return shape;
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_flash_attention_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // batch
+      .AddInputType<int>()              // seq_q
+      .AddInputType<int>()              // seq_k
+      .AddInputType<int>()              // head_dim
+      .AddInputType<int>()              // head_dim_v
+      .AddInputType<float>()            // scale
+      .AddInputType<cinn_buffer_t*>()   // Q
+      .AddInputType<cinn_buffer_t*>()   // K
+      .AddInputType<cinn_buffer_t*>()   // V
+      .AddOutputType<cinn_buffer_t*>()  // O
+      .SetShapeInference(inference_shape_attention)
+      .End();
+
+  return true;
+}
+#endif  // CINN_AOT_RUNTIME
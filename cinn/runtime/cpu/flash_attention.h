@@ -0,0 +1,60 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+//! \file This file defines a builtin fused attention kernel, softmax(scale * Q * K^T) * V, on CPU.
+#include "cinn/runtime/cinn_runtime.h"
+
+extern "C" {
+
+/**
+ * \brief Compute the attention O = softmax(scale * Q * K^T) * V of each batch, row-major, where Q is of shape
+ * [batch, seq_q, head_dim], K of shape [batch, seq_k, head_dim], V of shape [batch, seq_k, head_dim_v] and O of shape
+ * [batch, seq_q, head_dim_v].
+ *
+ * The keys and values are streamed block by block with an online softmax, so the [seq_q, seq_k] score matrix is never
+ * materialized. The blocks of queries are multi-threaded by `cinn_backend_parallel_launch`.
+ */
+void cinn_cpu_flash_attention_fp32(int batch,
+                                   int seq_q,
+                                   int seq_k,
+                                   int head_dim,
+                                   int head_dim_v,
+                                   float scale,
+                                   cinn_buffer_t* Q,
+                                   cinn_buffer_t* K,
+                                   cinn_buffer_t* V,
+                                   cinn_buffer_t* O);
+}  // extern "C"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+//! The fused attention on raw pointers, the arguments have the same meaning as those of
+//! `cinn_cpu_flash_attention_fp32`.
+void FlashAttention(int batch,
+                    int seq_q,
+                    int seq_k,
+                    int head_dim,
+                    int head_dim_v,
+                    float scale,
+                    const float* Q,
+                    const float* K,
+                    const float* V,
+                    float* O);
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
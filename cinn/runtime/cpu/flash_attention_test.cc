@@ -0,0 +1,193 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/flash_attention.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cinn/backends/llvm/simple_jit.h"
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/runtime/cpu/use_extern_funcs.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+void NaiveAttention(int batch,
+                    int seq_q,
+                    int seq_k,
+                    int head_dim,
+                    int head_dim_v,
+                    float scale,
+                    const float *Q,
+                    const float *K,
+                    const float *V,
+                    float *O) {
+  std::vector<float> p(seq_k);
+  for (int b = 0; b < batch; ++b) {
+    for (int i = 0; i < seq_q; ++i) {
+      const float *q = Q + (b * seq_q + i) * head_dim;
+      float max_v    = -1e30f;
+      for (int j = 0; j < seq_k; ++j) {
+        const float *k = K + (b * seq_k + j) * head_dim;
+        float sum      = 0.f;
+        for (int c = 0; c < head_dim; ++c) {
+          sum += q[c] * k[c];
+        }
+        p[j]  = scale * sum;
+        max_v = std::max(max_v, p[j]);
+      }
+      float sum = 0.f;
+      for (int j = 0; j < seq_k; ++j) {
+        p[j] = std::exp(p[j] - max_v);
+        sum += p[j];
+      }
+      float *o = O + (b * seq_q + i) * head_dim_v;
+      for (int c = 0; c < head_dim_v; ++c) {
+        float acc = 0.f;
+        for (int j = 0; j < seq_k; ++j) {
+          acc += p[j] * V[(b * seq_k + j) * head_dim_v + c];
+        }
+        o[c] = acc / sum;
+      }
+    }
+  }
+}
+
+std::vector<float> RandomVector(int size) {
+  std::vector<float> res(size);
+  for (auto &v : res) {
+    v = static_cast<float>(rand()) / RAND_MAX * 4.f - 2.f;  // NOLINT
+  }
+  return res;
+}
+
+TEST(FlashAttention, compare_with_naive) {
+  // cover the full and partial query and key blocks, as well as a single key
+  for (int batch : {1, 3}) {
+    for (int seq_q : {1, 32, 45}) {
+      for (int seq_k : {1, 64, 150}) {
+        for (int head_dim : {8, 17}) {
+          int head_dim_v = head_dim + 3;
+          float scale    = 1.f / std::sqrt(static_cast<float>(head_dim));
+          auto Q         = RandomVector(batch * seq_q * head_dim);
+          auto K         = RandomVector(batch * seq_k * head_dim);
+          auto V         = RandomVector(batch * seq_k * head_dim_v);
+          std::vector<float> expect(batch * seq_q * head_dim_v);
+          std::vector<float> out(expect.size());
+          NaiveAttention(batch, seq_q, seq_k, head_dim, head_dim_v, scale, Q.data(), K.data(), V.data(), expect.data());
+          FlashAttention(batch, seq_q, seq_k, head_dim, head_dim_v, scale, Q.data(), K.data(), V.data(), out.data());
+          for (int i = 0; i < expect.size(); ++i) {
+            ASSERT_NEAR(out[i], expect[i], 1e-4 * (1 + std::abs(expect[i])))
+                << "batch=" << batch << ", seq_q=" << seq_q << ", seq_k=" << seq_k << ", head_dim=" << head_dim
+                << ", i=" << i;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(cinn_cpu_flash_attention_fp32, test) {
+  Expr B(2);
+  Expr M(40);
+  Expr N(70);
+  Expr D(16);
+
+  Placeholder<float> Q("Q", {B, M, D});
+  Placeholder<float> K("K", {B, N, D});
+  Placeholder<float> V("V", {B, N, D});
+
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_flash_attention_fp32",
+                                {
+                                    B,            // batch
+                                    M,            // seq_q
+                                    N,            // seq_k
+                                    D,            // head_dim
+                                    D,            // head_dim_v
+                                    Expr(0.25f),  // scale
+                                    Q.tensor(),   // Q
+                                    K.tensor(),   // K
+                                    V.tensor(),   // V
+                                });
+      },
+      "extern_call");
+
+  auto out = call->TupleGet(0);
+  out->WithBuffer(Float(32));
+
+  auto stages = CreateStages({call, out});
+
+  auto target = common::DefaultHostTarget();
+  target.arch = Target::Arch::X86;
+  ir::Module::Builder builder("module0", target);
+
+  auto func = Lower("fn", stages, {Q, K, V, out, call});
+  builder.AddFunction(func);
+
+  LOG(INFO) << "func:\n" << func;
+
+  auto jit    = backends::SimpleJIT::Create();
+  auto module = builder.Build();
+
+  jit->Link(module, /*optimize=*/true);
+  auto fn     = jit->Lookup("fn");
+  auto fn_ptr = reinterpret_cast<void (*)(void *, int32_t)>(fn);
+
+  int b       = B.as_int32();
+  int m       = M.as_int32();
+  int n       = N.as_int32();
+  int d       = D.as_int32();
+  auto *Q_buf = common::BufferBuilder(Float(32), {b, m, d}).set_random().Build();
+  auto *K_buf = common::BufferBuilder(Float(32), {b, n, d}).set_random().Build();
+  auto *V_buf = common::BufferBuilder(Float(32), {b, n, d}).set_random().Build();
+  auto *O_buf = common::BufferBuilder(Float(32), {b, m, d}).set_zero().Build();
+
+  auto args = common::ArgsBuilder().Add(Q_buf).Add(K_buf).Add(V_buf).Add(O_buf).Build();
+
+  fn_ptr(args.data(), args.size());
+
+  std::vector<float> expect(b * m * d, 0.f);
+  NaiveAttention(b,
+                 m,
+                 n,
+                 d,
+                 d,
+                 0.25f,
+                 reinterpret_cast<float *>(Q_buf->memory),
+                 reinterpret_cast<float *>(K_buf->memory),
+                 reinterpret_cast<float *>(V_buf->memory),
+                 expect.data());
+  auto *O_data = reinterpret_cast<float *>(O_buf->memory);
+  for (int i = 0; i < expect.size(); ++i) {
+    ASSERT_NEAR(O_data[i], expect[i], 1e-4 * (1 + std::abs(expect[i])));
+  }
+
+  cinn_buffer_free(nullptr, Q_buf);
+  cinn_buffer_free(nullptr, K_buf);
+  cinn_buffer_free(nullptr, V_buf);
+  cinn_buffer_free(nullptr, O_buf);
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
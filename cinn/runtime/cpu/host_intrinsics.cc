@@ -17,8 +17,10 @@
 #include <glog/logging.h>
 #include <math.h>
 
+#ifndef CINN_AOT_RUNTIME
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/function_prototype.h"
+#endif
 
 #ifdef CINN_WITH_MKL_CBLAS
 #include "cinn/runtime/cpu/mkl_math.h"
@@ -147,6 +149,7 @@ inline int64_t FN_INT64(popc)(int64_t x) { return __builtin_popcountll(x); }
 #undef FN_INT64
 }
 
+#ifndef CINN_AOT_RUNTIME
 CINN_REGISTER_HELPER(host_intrinsics) {
   auto host_target = cinn::common::DefaultHostTarget();
   using cinn::backends::FunctionProto;
@@ -284,3 +287,4 @@ CINN_REGISTER_HELPER(host_intrinsics) {
 
   return true;
 }
+#endif  // CINN_AOT_RUNTIME
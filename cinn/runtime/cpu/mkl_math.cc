@@ -14,23 +14,25 @@
 
 #include "cinn/runtime/cpu/mkl_math.h"
 
-#include <glog/logging.h>
 #include <mkl.h>
 #include <mkl_vml_functions.h>
 
 #include <cmath>
 
+#include "cinn/runtime/cpu/host_intrinsics.h"
+
+#ifndef CINN_AOT_RUNTIME
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/function_prototype.h"
-#include "cinn/runtime/cpu/host_intrinsics.h"
+#endif
 
 #define CINN_MKL_VECTOR_MATH_FP(fn__, name__)                                                                    \
   void cinn_mkl_##name__##_v_fp32(cinn_buffer_t *x, cinn_buffer_t *out) {                                        \
-    CHECK_EQ(x->num_elements(), out->num_elements());                                                            \
+    CINN_CHECK_EQ(x->num_elements(), out->num_elements());                                                       \
     vs##fn__(x->num_elements(), reinterpret_cast<float *>(x->memory), reinterpret_cast<float *>(out->memory));   \
   }                                                                                                              \
   void cinn_mkl_##name__##_v_fp64(cinn_buffer_t *x, cinn_buffer_t *out) {                                        \
-    CHECK_EQ(x->num_elements(), out->num_elements());                                                            \
+    CINN_CHECK_EQ(x->num_elements(), out->num_elements());                                                       \
     vd##fn__(x->num_elements(), reinterpret_cast<double *>(x->memory), reinterpret_cast<double *>(out->memory)); \
   }
 
@@ -58,6 +60,7 @@ CINN_MKL_VECTOR_MATH_FP(Tanh, tanh);
 // CINN_MKL_VECTOR_MATH_FP(Atan, atan);
 // CINN_MKL_VECTOR_MATH_FP(Atanh, atanh);
 
+#ifndef CINN_AOT_RUNTIME
 CINN_REGISTER_HELPER(mkl_math) {
   using cinn::backends::FunctionProto;
 
@@ -103,3 +106,4 @@ CINN_REGISTER_HELPER(mkl_math) {
 
   return true;
 }
+#endif  // CINN_AOT_RUNTIME
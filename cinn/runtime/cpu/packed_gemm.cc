@@ -0,0 +1,568 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/packed_gemm.h"
+
+#if defined(__AVX__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifndef CINN_AOT_RUNTIME
+#include "cinn/backends/extern_func_jit_register.h"
+#include "cinn/common/cas.h"
+#endif
+#include "cinn/runtime/cpu/thread_backend.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+namespace {
+
+// The register block of the micro-kernel is kMR x kNR, the cache blocks follow the BLIS convention:
+// a kKC x kNC panel of B stays in L3, a kMC x kKC block of A stays in L2 and a kKC x kNR micro-panel of B in L1.
+#if defined(__AVX512F__)
+constexpr int kMR = 6;
+constexpr int kNR = 32;
+#elif defined(__AVX__) && defined(__FMA__)
+constexpr int kMR = 6;
+constexpr int kNR = 16;
+#else
+constexpr int kMR = 4;
+constexpr int kNR = 8;
+#endif
+constexpr int kMC = kMR * 16;
+constexpr int kKC = 256;
+constexpr int kNC = kNR * 128;
+
+constexpr int kAlignment = 64;
+
+struct AlignedBuffer {
+  explicit AlignedBuffer(size_t size) {
+    size_t bytes = (size * sizeof(float) + kAlignment - 1) / kAlignment * kAlignment;
+    data         = reinterpret_cast<float*>(aligned_alloc(kAlignment, bytes));
+  }
+  AlignedBuffer(AlignedBuffer&& other) : data(other.data) { other.data = nullptr; }
+  AlignedBuffer(const AlignedBuffer&) = delete;
+  AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+  ~AlignedBuffer() { free(data); }
+
+  float* data{};
+};
+
+inline float GetA(const float* A, int lda, bool ta, int i, int k) { return ta ? A[k * lda + i] : A[i * lda + k]; }
+inline float GetB(const float* B, int ldb, bool tb, int k, int j) { return tb ? B[j * ldb + k] : B[k * ldb + j]; }
+
+// Pack the mc x kc block of op(A) starting at (ic, pc) into micro-panels of kMR rows, zero-padding the last one.
+void PackA(const float* A, int lda, bool ta, int ic, int pc, int mc, int kc, float* packed) {
+  for (int ir = 0; ir < mc; ir += kMR) {
+    int mr = std::min(kMR, mc - ir);
+    for (int k = 0; k < kc; ++k) {
+      for (int i = 0; i < mr; ++i) {
+        packed[k * kMR + i] = GetA(A, lda, ta, ic + ir + i, pc + k);
+      }
+      for (int i = mr; i < kMR; ++i) {
+        packed[k * kMR + i] = 0.f;
+      }
+    }
+    packed += kMR * kc;
+  }
+}
+
+// Pack the kc x nr micro-panel of op(B) starting at (pc, jc) into a contiguous kc x kNR block.
+void PackBPanel(const float* B, int ldb, bool tb, int pc, int jc, int kc, int nr, float* packed) {
+  for (int k = 0; k < kc; ++k) {
+    if (!tb && nr == kNR) {
+      std::memcpy(packed + k * kNR, B + (pc + k) * ldb + jc, kNR * sizeof(float));
+      continue;
+    }
+    for (int j = 0; j < nr; ++j) {
+      packed[k * kNR + j] = GetB(B, ldb, tb, pc + k, jc + j);
+    }
+    for (int j = nr; j < kNR; ++j) {
+      packed[k * kNR + j] = 0.f;
+    }
+  }
+}
+
+// C[kMR, kNR] += alpha * packed_a[kc, kMR]^T * packed_b[kc, kNR]
+#if defined(__AVX512F__)
+void MicroKernel(int kc, float alpha, const float* pa, const float* pb, float* c, int ldc) {
+  __m512 acc[kMR][2];
+  for (int i = 0; i < kMR; ++i) {
+    acc[i][0] = _mm512_setzero_ps();
+    acc[i][1] = _mm512_setzero_ps();
+  }
+  for (int k = 0; k < kc; ++k) {
+    __m512 b0 = _mm512_load_ps(pb);
+    __m512 b1 = _mm512_load_ps(pb + 16);
+    for (int i = 0; i < kMR; ++i) {
+      __m512 a  = _mm512_set1_ps(pa[i]);
+      acc[i][0] = _mm512_fmadd_ps(a, b0, acc[i][0]);
+      acc[i][1] = _mm512_fmadd_ps(a, b1, acc[i][1]);
+    }
+    pa += kMR;
+    pb += kNR;
+  }
+  __m512 valpha = _mm512_set1_ps(alpha);
+  for (int i = 0; i < kMR; ++i) {
+    float* row = c + i * ldc;
+    _mm512_storeu_ps(row, _mm512_fmadd_ps(valpha, acc[i][0], _mm512_loadu_ps(row)));
+    _mm512_storeu_ps(row + 16, _mm512_fmadd_ps(valpha, acc[i][1], _mm512_loadu_ps(row + 16)));
+  }
+}
+#elif defined(__AVX__) && defined(__FMA__)
+void MicroKernel(int kc, float alpha, const float* pa, const float* pb, float* c, int ldc) {
+  __m256 acc[kMR][2];
+  for (int i = 0; i < kMR; ++i) {
+    acc[i][0] = _mm256_setzero_ps();
+    acc[i][1] = _mm256_setzero_ps();
+  }
+  for (int k = 0; k < kc; ++k) {
+    __m256 b0 = _mm256_load_ps(pb);
+    __m256 b1 = _mm256_load_ps(pb + 8);
+    for (int i = 0; i < kMR; ++i) {
+      __m256 a  = _mm256_broadcast_ss(pa + i);
+      acc[i][0] = _mm256_fmadd_ps(a, b0, acc[i][0]);
+      acc[i][1] = _mm256_fmadd_ps(a, b1, acc[i][1]);
+    }
+    pa += kMR;
+    pb += kNR;
+  }
+  __m256 valpha = _mm256_set1_ps(alpha);
+  for (int i = 0; i < kMR; ++i) {
+    float* row = c + i * ldc;
+    _mm256_storeu_ps(row, _mm256_fmadd_ps(valpha, acc[i][0], _mm256_loadu_ps(row)));
+    _mm256_storeu_ps(row + 8, _mm256_fmadd_ps(valpha, acc[i][1], _mm256_loadu_ps(row + 8)));
+  }
+}
+#else
+void MicroKernel(int kc, float alpha, const float* pa, const float* pb, float* c, int ldc) {
+  float acc[kMR][kNR] = {};
+  for (int k = 0; k < kc; ++k) {
+    for (int i = 0; i < kMR; ++i) {
+      for (int j = 0; j < kNR; ++j) {
+        acc[i][j] += pa[i] * pb[j];
+      }
+    }
+    pa += kMR;
+    pb += kNR;
+  }
+  for (int i = 0; i < kMR; ++i) {
+    for (int j = 0; j < kNR; ++j) {
+      c[i * ldc + j] += alpha * acc[i][j];
+    }
+  }
+}
+#endif
+
+// Handle the tiles on the border of C, which are smaller than kMR x kNR.
+void MicroKernelEdge(int kc, float alpha, const float* pa, const float* pb, float* c, int ldc, int mr, int nr) {
+  alignas(kAlignment) float tile[kMR * kNR] = {};
+  MicroKernel(kc, alpha, pa, pb, tile, kNR);
+  for (int i = 0; i < mr; ++i) {
+    for (int j = 0; j < nr; ++j) {
+      c[i * ldc + j] += tile[i * kNR + j];
+    }
+  }
+}
+
+inline float Activate(float x, cinn_gemm_activation_t activation) {
+  switch (activation) {
+    case cinn_gemm_activation_relu:
+      return std::max(x, 0.f);
+    case cinn_gemm_activation_relu6:
+      return std::min(std::max(x, 0.f), 6.f);
+    case cinn_gemm_activation_sigmoid:
+      return 1.f / (1.f + std::exp(-x));
+    default:
+      return x;
+  }
+}
+
+// Scale the mc x nc block of C by beta before the first rank-kc update.
+void ScaleC(float beta, float* c, int ldc, int mc, int nc) {
+  for (int i = 0; i < mc; ++i) {
+    float* row = c + i * ldc;
+    if (beta == 0.f) {
+      std::fill(row, row + nc, 0.f);
+    } else if (beta != 1.f) {
+      for (int j = 0; j < nc; ++j) row[j] *= beta;
+    }
+  }
+}
+
+// Add bias and apply activation on the mc x nc block of C while it is still in cache.
+void Epilogue(float* c, int ldc, int mc, int nc, const float* bias, cinn_gemm_activation_t activation) {
+  if (bias == nullptr && activation == cinn_gemm_activation_none) return;
+  for (int i = 0; i < mc; ++i) {
+    float* row = c + i * ldc;
+    for (int j = 0; j < nc; ++j) {
+      float v = bias ? row[j] + bias[j] : row[j];
+      row[j]  = Activate(v, activation);
+    }
+  }
+}
+
+struct GemmContext {
+  float alpha;
+  int M;
+  int K;
+  bool ta;
+  bool tb;
+  const float* A;
+  int lda;
+  const float* B;
+  int ldb;
+  float beta;
+  float* C;
+  int ldc;
+  const float* bias;
+  cinn_gemm_activation_t activation;
+
+  // the current jc/pc iteration
+  int jc;
+  int nc;
+  int pc;
+  int kc;
+  float* packed_b;
+  std::vector<AlignedBuffer>* packed_a;
+};
+
+int PackBTask(int task_id, int num_task, void* datas) {
+  auto* ctx      = reinterpret_cast<GemmContext*>(datas);
+  int num_panels = (ctx->nc + kNR - 1) / kNR;
+  for (int p = task_id; p < num_panels; p += num_task) {
+    int jr = p * kNR;
+    PackBPanel(ctx->B,
+               ctx->ldb,
+               ctx->tb,
+               ctx->pc,
+               ctx->jc + jr,
+               ctx->kc,
+               std::min(kNR, ctx->nc - jr),
+               ctx->packed_b + p * kNR * ctx->kc);
+  }
+  return 0;
+}
+
+int ComputeTask(int task_id, int num_task, void* datas) {
+  auto* ctx       = reinterpret_cast<GemmContext*>(datas);
+  float* packed_a = (*ctx->packed_a)[task_id].data;
+  bool first_k    = ctx->pc == 0;
+  bool last_k     = ctx->pc + ctx->kc == ctx->K;
+  int num_blocks  = (ctx->M + kMC - 1) / kMC;
+  for (int block = task_id; block < num_blocks; block += num_task) {
+    int ic   = block * kMC;
+    int mc   = std::min(kMC, ctx->M - ic);
+    float* c = ctx->C + ic * ctx->ldc + ctx->jc;
+    if (first_k) ScaleC(ctx->beta, c, ctx->ldc, mc, ctx->nc);
+    PackA(ctx->A, ctx->lda, ctx->ta, ic, ctx->pc, mc, ctx->kc, packed_a);
+    for (int jr = 0; jr < ctx->nc; jr += kNR) {
+      int nr          = std::min(kNR, ctx->nc - jr);
+      const float* pb = ctx->packed_b + (jr / kNR) * kNR * ctx->kc;
+      for (int ir = 0; ir < mc; ir += kMR) {
+        int mr          = std::min(kMR, mc - ir);
+        const float* pa = packed_a + (ir / kMR) * kMR * ctx->kc;
+        float* c_tile   = c + ir * ctx->ldc + jr;
+        if (mr == kMR && nr == kNR) {
+          MicroKernel(ctx->kc, ctx->alpha, pa, pb, c_tile, ctx->ldc);
+        } else {
+          MicroKernelEdge(ctx->kc, ctx->alpha, pa, pb, c_tile, ctx->ldc, mr, nr);
+        }
+      }
+    }
+    if (last_k) Epilogue(c, ctx->ldc, mc, ctx->nc, ctx->bias ? ctx->bias + ctx->jc : nullptr, ctx->activation);
+  }
+  return 0;
+}
+
+void Launch(FCINNParallelLambda flambda, GemmContext* ctx, int num_task) {
+  if (num_task <= 1) {
+    flambda(0, 1, ctx);
+  } else {
+    cinn_backend_parallel_launch(flambda, ctx, num_task);
+  }
+}
+
+}  // namespace
+
+void PackedSgemm(float alpha,
+                 int M,
+                 int N,
+                 int K,
+                 bool ta,
+                 bool tb,
+                 const float* A,
+                 int lda,
+                 const float* B,
+                 int ldb,
+                 float beta,
+                 float* C,
+                 int ldc,
+                 const float* bias,
+                 cinn_gemm_activation_t activation) {
+  if (M <= 0 || N <= 0) return;
+  if (K <= 0) {
+    ScaleC(beta, C, ldc, M, N);
+    Epilogue(C, ldc, M, N, bias, activation);
+    return;
+  }
+
+  int num_blocks = (M + kMC - 1) / kMC;
+  int num_task   = std::min(max_concurrency(), num_blocks);
+
+  std::vector<AlignedBuffer> packed_a;
+  packed_a.reserve(num_task);
+  for (int i = 0; i < num_task; ++i) {
+    packed_a.emplace_back(kMC * kKC);
+  }
+  AlignedBuffer packed_b(static_cast<size_t>(kKC) * ((std::min(N, kNC) + kNR - 1) / kNR * kNR));
+
+  GemmContext ctx{alpha, M, K, ta, tb, A, lda, B, ldb, beta, C, ldc, bias, activation};
+  ctx.packed_b = packed_b.data;
+  ctx.packed_a = &packed_a;
+  for (int jc = 0; jc < N; jc += kNC) {
+    ctx.jc = jc;
+    ctx.nc = std::min(kNC, N - jc);
+    for (int pc = 0; pc < K; pc += kKC) {
+      ctx.pc = pc;
+      ctx.kc = std::min(kKC, K - pc);
+      Launch(PackBTask, &ctx, std::min(num_task, (ctx.nc + kNR - 1) / kNR));
+      Launch(ComputeTask, &ctx, num_task);
+    }
+  }
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
+
+void cinn_cpu_packed_gemm_fp32(float alpha,
+                               int M,
+                               int N,
+                               int K,
+                               bool ta,
+                               bool tb,
+                               int lda,
+                               int ldb,
+                               int ldc,
+                               float beta,
+                               int activation,
+                               cinn_buffer_t* A,
+                               cinn_buffer_t* B,
+                               cinn_buffer_t* C) {
+  cinn::runtime::cpu::PackedSgemm(alpha,
+                                  M,
+                                  N,
+                                  K,
+                                  ta,
+                                  tb,
+                                  reinterpret_cast<float*>(A->memory),
+                                  lda,
+                                  reinterpret_cast<float*>(B->memory),
+                                  ldb,
+                                  beta,
+                                  reinterpret_cast<float*>(C->memory),
+                                  ldc,
+                                  nullptr,
+                                  static_cast<cinn_gemm_activation_t>(activation));
+}
+
+void cinn_cpu_packed_gemm_bias_fp32(float alpha,
+                                    int M,
+                                    int N,
+                                    int K,
+                                    bool ta,
+                                    bool tb,
+                                    int lda,
+                                    int ldb,
+                                    int ldc,
+                                    float beta,
+                                    int activation,
+                                    cinn_buffer_t* A,
+                                    cinn_buffer_t* B,
+                                    cinn_buffer_t* bias,
+                                    cinn_buffer_t* C) {
+  cinn::runtime::cpu::PackedSgemm(alpha,
+                                  M,
+                                  N,
+                                  K,
+                                  ta,
+                                  tb,
+                                  reinterpret_cast<float*>(A->memory),
+                                  lda,
+                                  reinterpret_cast<float*>(B->memory),
+                                  ldb,
+                                  beta,
+                                  reinterpret_cast<float*>(C->memory),
+                                  ldc,
+                                  reinterpret_cast<float*>(bias->memory),
+                                  static_cast<cinn_gemm_activation_t>(activation));
+}
+
+void cinn_cpu_packed_gemm_batch_fp32(float alpha,
+                                     int batch_size,
+                                     int M,
+                                     int N,
+                                     int K,
+                                     bool ta,
+                                     bool tb,
+                                     int lda,
+                                     int ldb,
+                                     int ldc,
+                                     int a_stride,
+                                     int b_stride,
+                                     int c_stride,
+                                     float beta,
+                                     int activation,
+                                     cinn_buffer_t* A,
+                                     cinn_buffer_t* B,
+                                     cinn_buffer_t* C) {
+  for (int i = 0; i < batch_size; ++i) {
+    cinn::runtime::cpu::PackedSgemm(alpha,
+                                    M,
+                                    N,
+                                    K,
+                                    ta,
+                                    tb,
+                                    reinterpret_cast<float*>(A->memory) + i * a_stride,
+                                    lda,
+                                    reinterpret_cast<float*>(B->memory) + i * b_stride,
+                                    ldb,
+                                    beta,
+                                    reinterpret_cast<float*>(C->memory) + i * c_stride,
+                                    ldc,
+                                    nullptr,
+                                    static_cast<cinn_gemm_activation_t>(activation));
+  }
+}
+
+#ifndef CINN_AOT_RUNTIME
+CINN_REGISTER_HELPER(cinn_cpu_packed_gemm) {
+  using namespace cinn;  // NOLINT
+  using backends::FunctionProto;
+  auto host_target = common::DefaultHostTarget();
+
+  auto inference_shape_gemm = [](int num_args) -> FunctionProto::shape_inference_t {
+    return [=](const std::vector<Expr>& args, int offset) {
+      CHECK_EQ(offset, 0UL) << "Only one output";
+      CHECK_EQ(args.size(), static_cast<size_t>(num_args)) << "Wrong number of arguments passed in";
+      auto M = common::AutoSimplify(args[1]);
+      auto N = common::AutoSimplify(args[2]);
+      std::vector<Expr> shape;
+      shape.push_back(M);
+      shape.push_back(N);
+      return shape;
+    };
+  };
+
+  FunctionProto::shape_inference_t inference_shape_gemm_batch = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 17UL) << "Wrong number of arguments passed in";
+    auto& A       = args[15];
+    auto A_tensor = A.as_tensor();
+    CHECK(A_tensor);
+
+    auto batch_size        = common::AutoSimplify(args[1]);
+    int32_t batch_size_val = batch_size.as_int32();
+
+    auto M = common::AutoSimplify(args[2]);
+    auto N = common::AutoSimplify(args[3]);
+
+    std::vector<Expr> shape;
+    int total = 1;
+    for (auto& v : A_tensor->shape) {
+      auto val = common::AutoSimplify(v);
+      CHECK(val.is_constant());
+      shape.push_back(val);
+      total *= val.as_int32();
+      if (total >= batch_size_val) break;
+    }
+    shape.push_back(M);
+    shape.push_back(N);
+    return shape;
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_packed_gemm_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldb
+      .AddInputType<int>()              // ldc
+      .AddInputType<float>()            // beta
+      .AddInputType<int>()              // activation
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_gemm(13))
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_packed_gemm_bias_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldb
+      .AddInputType<int>()              // ldc
+      .AddInputType<float>()            // beta
+      .AddInputType<int>()              // activation
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddInputType<cinn_buffer_t*>()   // bias
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_gemm(14))
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_packed_gemm_batch_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // batch
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldb
+      .AddInputType<int>()              // ldc
+      .AddInputType<int>()              // a_stride
+      .AddInputType<int>()              // b_stride
+      .AddInputType<int>()              // c_stride
+      .AddInputType<float>()            // beta
+      .AddInputType<int>()              // activation
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_gemm_batch)
+      .End();
+
+  return true;
+}
+#endif  // CINN_AOT_RUNTIME
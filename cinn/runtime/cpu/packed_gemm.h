@@ -0,0 +1,123 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+//! \file This file defines a builtin packed GEMM which does not depend on any BLAS library.
+#include "cinn/runtime/cinn_runtime.h"
+
+extern "C" {
+
+//! The activation applied to C in the epilogue of the packed GEMM.
+typedef enum cinn_gemm_activation_t {
+  cinn_gemm_activation_none    = 0,  //! C = alpha * A * B + beta * C (+ bias)
+  cinn_gemm_activation_relu    = 1,  //! max(C, 0)
+  cinn_gemm_activation_relu6   = 2,  //! min(max(C, 0), 6)
+  cinn_gemm_activation_sigmoid = 3,  //! 1 / (1 + exp(-C))
+} cinn_gemm_activation_t;
+
+/**
+ * \brief Do GEMM on buffer A and B and write result to buffer C, the arguments have the same meaning as those of
+ * `cinn_cpu_mkl_gemm_fp32`.
+ *
+ * The panels of A and B are packed into contiguous blocks and the product is computed by register-blocked FMA
+ * micro-kernels, multi-threaded by `cinn_backend_parallel_launch`.
+ * @param activation The cinn_gemm_activation_t applied to C after the product is accumulated.
+ */
+void cinn_cpu_packed_gemm_fp32(float alpha,
+                               int M,
+                               int N,
+                               int K,
+                               bool ta,
+                               bool tb,
+                               int lda,
+                               int ldb,
+                               int ldc,
+                               float beta,
+                               int activation,
+                               cinn_buffer_t* A,
+                               cinn_buffer_t* B,
+                               cinn_buffer_t* C);
+
+/**
+ * \brief The same as `cinn_cpu_packed_gemm_fp32`, but adds \param bias of shape [N] to each row of C before the
+ * activation is applied.
+ */
+void cinn_cpu_packed_gemm_bias_fp32(float alpha,
+                                    int M,
+                                    int N,
+                                    int K,
+                                    bool ta,
+                                    bool tb,
+                                    int lda,
+                                    int ldb,
+                                    int ldc,
+                                    float beta,
+                                    int activation,
+                                    cinn_buffer_t* A,
+                                    cinn_buffer_t* B,
+                                    cinn_buffer_t* bias,
+                                    cinn_buffer_t* C);
+
+/**
+ * \brief Do batched GEMM on buffer A and B and write result to buffer C, the arguments have the same meaning as those
+ * of `cinn_cpu_mkl_gemm_batch_fp32`.
+ * @param activation The cinn_gemm_activation_t applied to C after the product is accumulated.
+ */
+void cinn_cpu_packed_gemm_batch_fp32(float alpha,
+                                     int batch_size,
+                                     int M,
+                                     int N,
+                                     int K,
+                                     bool ta,
+                                     bool tb,
+                                     int lda,
+                                     int ldb,
+                                     int ldc,
+                                     int a_stride,
+                                     int b_stride,
+                                     int c_stride,
+                                     float beta,
+                                     int activation,
+                                     cinn_buffer_t* A,
+                                     cinn_buffer_t* B,
+                                     cinn_buffer_t* C);
+}  // extern "C"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+/**
+ * The packed GEMM on raw pointers, row-major, C[M, N] = act(alpha * op(A)[M, K] * op(B)[K, N] + beta * C + bias).
+ * @param bias The bias of shape [N], ignored if null.
+ */
+void PackedSgemm(float alpha,
+                 int M,
+                 int N,
+                 int K,
+                 bool ta,
+                 bool tb,
+                 const float* A,
+                 int lda,
+                 const float* B,
+                 int ldb,
+                 float beta,
+                 float* C,
+                 int ldc,
+                 const float* bias,
+                 cinn_gemm_activation_t activation);
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
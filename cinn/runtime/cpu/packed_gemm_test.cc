@@ -0,0 +1,189 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/packed_gemm.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cinn/backends/llvm/simple_jit.h"
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/runtime/cpu/use_extern_funcs.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+void NaiveSgemm(float alpha,
+                int M,
+                int N,
+                int K,
+                bool ta,
+                bool tb,
+                const float *A,
+                int lda,
+                const float *B,
+                int ldb,
+                float beta,
+                float *C,
+                int ldc,
+                const float *bias,
+                cinn_gemm_activation_t activation) {
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      float sum = 0.f;
+      for (int k = 0; k < K; ++k) {
+        float a = ta ? A[k * lda + i] : A[i * lda + k];
+        float b = tb ? B[j * ldb + k] : B[k * ldb + j];
+        sum    += a * b;
+      }
+      float v = alpha * sum + beta * C[i * ldc + j] + (bias ? bias[j] : 0.f);
+      if (activation == cinn_gemm_activation_relu) v = std::max(v, 0.f);
+      if (activation == cinn_gemm_activation_relu6) v = std::min(std::max(v, 0.f), 6.f);
+      if (activation == cinn_gemm_activation_sigmoid) v = 1.f / (1.f + std::exp(-v));
+      C[i * ldc + j] = v;
+    }
+  }
+}
+
+std::vector<float> RandomVector(int size) {
+  std::vector<float> res(size);
+  for (auto &v : res) {
+    v = static_cast<float>(rand()) / RAND_MAX - 0.5f;  // NOLINT
+  }
+  return res;
+}
+
+TEST(PackedSgemm, compare_with_naive) {
+  // cover the full and partial register tiles as well as multiple cache blocks on each dimension
+  for (int M : {1, 7, 130}) {
+    for (int N : {3, 16, 2100}) {
+      for (int K : {1, 300}) {
+        for (bool ta : {false, true}) {
+          for (bool tb : {false, true}) {
+            for (auto act : {cinn_gemm_activation_none, cinn_gemm_activation_relu, cinn_gemm_activation_sigmoid}) {
+              auto A      = RandomVector(M * K);
+              auto B      = RandomVector(K * N);
+              auto bias   = RandomVector(N);
+              auto C      = RandomVector(M * N);
+              auto expect = C;
+              int lda     = ta ? M : K;
+              int ldb     = tb ? K : N;
+              NaiveSgemm(1.5f, M, N, K, ta, tb, A.data(), lda, B.data(), ldb, 0.5f, expect.data(), N, bias.data(), act);
+              PackedSgemm(1.5f, M, N, K, ta, tb, A.data(), lda, B.data(), ldb, 0.5f, C.data(), N, bias.data(), act);
+              for (int i = 0; i < M * N; ++i) {
+                ASSERT_NEAR(C[i], expect[i], 1e-3 * (1 + std::abs(expect[i])))
+                    << "M=" << M << ", N=" << N << ", K=" << K << ", ta=" << ta << ", tb=" << tb << ", i=" << i;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(cinn_cpu_packed_gemm_fp32, test) {
+  Expr M(30);
+  Expr N(20);
+  Expr K(40);
+
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_packed_gemm_fp32",
+                                {
+                                    common::make_one<float>(),   // alpha
+                                    M,                           // M
+                                    N,                           // N
+                                    K,                           // K
+                                    common::make_bool(false),    // ta
+                                    common::make_bool(false),    // tb
+                                    K,                           // lda
+                                    N,                           // ldb
+                                    N,                           // ldc
+                                    common::make_zero<float>(),  // beta
+                                    Expr(1),                     // activation: relu
+                                    A.tensor(),                  // A
+                                    B.tensor(),                  // B
+                                });
+      },
+      "extern_call");
+
+  auto out = call->TupleGet(0);
+  out->WithBuffer(Float(32));
+
+  auto stages = CreateStages({call, out});
+
+  auto target = common::DefaultHostTarget();
+  target.arch = Target::Arch::X86;
+  ir::Module::Builder builder("module0", target);
+
+  auto func = Lower("fn", stages, {A, B, out, call});
+  builder.AddFunction(func);
+
+  LOG(INFO) << "func:\n" << func;
+
+  auto jit    = backends::SimpleJIT::Create();
+  auto module = builder.Build();
+
+  jit->Link(module, /*optimize=*/true);
+  auto fn     = jit->Lookup("fn");
+  auto fn_ptr = reinterpret_cast<void (*)(void *, int32_t)>(fn);
+
+  // test with real data
+  auto *A_buf = common::BufferBuilder(Float(32), {M.as_int32(), K.as_int32()}).set_random().Build();
+  auto *B_buf = common::BufferBuilder(Float(32), {K.as_int32(), N.as_int32()}).set_random().Build();
+  auto *C_buf = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_zero().Build();
+
+  auto args = common::ArgsBuilder().Add(A_buf).Add(B_buf).Add(C_buf).Build();
+
+  fn_ptr(args.data(), args.size());
+
+  std::vector<float> expect(M.as_int32() * N.as_int32(), 0.f);
+  NaiveSgemm(1.f,
+             M.as_int32(),
+             N.as_int32(),
+             K.as_int32(),
+             false,
+             false,
+             reinterpret_cast<float *>(A_buf->memory),
+             K.as_int32(),
+             reinterpret_cast<float *>(B_buf->memory),
+             N.as_int32(),
+             0.f,
+             expect.data(),
+             N.as_int32(),
+             nullptr,
+             cinn_gemm_activation_relu);
+  auto *C_data = reinterpret_cast<float *>(C_buf->memory);
+  for (int i = 0; i < expect.size(); ++i) {
+    ASSERT_NEAR(C_data[i], expect[i], 1e-4);
+  }
+
+  cinn_buffer_free(nullptr, A_buf);
+  cinn_buffer_free(nullptr, B_buf);
+  cinn_buffer_free(nullptr, C_buf);
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
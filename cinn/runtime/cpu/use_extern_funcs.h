@@ -17,6 +17,8 @@
 #include "cinn/backends/extern_func_jit_register.h"
 
 CINN_USE_REGISTER(host_intrinsics)
+CINN_USE_REGISTER(cinn_cpu_packed_gemm)
+CINN_USE_REGISTER(cinn_cpu_flash_attention)
 #ifdef CINN_WITH_MKL_CBLAS
 CINN_USE_REGISTER(mkl_math)
 CINN_USE_REGISTER(cinn_cpu_mkl)
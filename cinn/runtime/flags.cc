@@ -37,12 +37,69 @@ DEFINE_int32(cinn_parallel_compile_size,
              Int32FromEnv("FLAGS_cinn_parallel_compile_size", 0),
              "When use parallel compile, set the number of group compiled by each thread.");
 
+DEFINE_int32(cinn_compile_num_threads,
+             Int32FromEnv("FLAGS_cinn_compile_num_threads", 1),
+             "The number of threads lowering the fusion groups, optimizing the functions of a module and generating "
+             "their LLVM code concurrently when the parallel compile is not used, 0 means the number of cores.");
+
+DEFINE_bool(cinn_tiered_jit,
+            BoolFromEnv("FLAGS_cinn_tiered_jit", false),
+            "Whether to compile the X86 functions at O0 first and switch them to the O3 versions recompiled by a "
+            "background thread, the hottest function first.");
+
 DEFINE_bool(cinn_use_op_fusion, BoolFromEnv("FLAGS_cinn_use_op_fusion", true), "Whether to use op fusion pass.");
 
+DEFINE_bool(cinn_use_fusion_cost_model,
+            BoolFromEnv("FLAGS_cinn_use_fusion_cost_model", false),
+            "Whether to decide the fusions by the analytic cost model of memory traffic and computation.");
+
+DEFINE_bool(cinn_use_horizontal_fusion,
+            BoolFromEnv("FLAGS_cinn_use_horizontal_fusion", false),
+            "Whether to pack the independent small fusion groups into one kernel by the HorizontalFusionPass.");
+
+DEFINE_bool(cinn_use_algebraic_simplifier,
+            BoolFromEnv("FLAGS_cinn_use_algebraic_simplifier", false),
+            "Whether to rewrite the instructions by algebraic identities with the AlgebraicSimplifier pass.");
+
+DEFINE_bool(cinn_algebraic_simplifier_fast_math,
+            BoolFromEnv("FLAGS_cinn_algebraic_simplifier_fast_math", false),
+            "Whether the AlgebraicSimplifier also folds exp(log(x)) and log(exp(x)) into x, which changes the results "
+            "where x is not positive or exp(x) overflows.");
+
+DEFINE_bool(cinn_use_common_subexpression_elimination,
+            BoolFromEnv("FLAGS_cinn_use_common_subexpression_elimination", false),
+            "Whether to merge the instructions computing the same values by the CommonSubexpressionElimination pass.");
+
 DEFINE_bool(cinn_use_cudnn_conv, BoolFromEnv("FLAGS_cinn_use_cudnn_conv", true), "Whether to use cudnn convolution.");
 
 DEFINE_bool(cinn_use_cublas_gemm, BoolFromEnv("FLAGS_cinn_use_cublas_gemm", true), "Whether to use cublas gemm.");
 
+DEFINE_bool(cinn_use_packed_gemm,
+            BoolFromEnv("FLAGS_cinn_use_packed_gemm", true),
+            "Whether to use the builtin packed gemm for matmul on x86 when CINN is compiled without MKL.");
+
+DEFINE_bool(cinn_use_winograd_conv,
+            BoolFromEnv("FLAGS_cinn_use_winograd_conv", false),
+            "Whether to compute the 3x3 convolutions with stride 1 by winograd on x86, whose weight transform only "
+            "runs once in PreRun if the weight is constant and AlterLayout and PrePackWeights are applied.");
+
+DEFINE_int32(cinn_prefetch_distance,
+             Int32FromEnv("FLAGS_cinn_prefetch_distance", 0),
+             "The number of iterations to prefetch ahead for the loads missing the cache on X86, 0 means no prefetch.");
+
+DEFINE_bool(cinn_inplace_buffer_reuse,
+            BoolFromEnv("FLAGS_cinn_inplace_buffer_reuse", true),
+            "Whether to compute the outputs of elementwise instructions in place into the buffers of dying inputs.");
+
+DEFINE_bool(cinn_ir_arena,
+            BoolFromEnv("FLAGS_cinn_ir_arena", false),
+            "Whether to allocate the IR nodes of one compilation from an arena and intern the constants.");
+
+DEFINE_int64(cinn_rematerialization_memory_budget,
+             Int64FromEnv("FLAGS_cinn_rematerialization_memory_budget", 0L),
+             "The peak memory budget in bytes of the variables, the Rematerialization pass recomputes the cheap ops "
+             "to fit into it, 0 means no budget.");
+
 DEFINE_bool(cinn_use_fill_constant_folding,
             BoolFromEnv("FLAGS_cinn_use_fill_constant_folding", false),
             "Whether use the FillConstantFolding pass.");
@@ -60,6 +117,14 @@ DEFINE_bool(cinn_ir_schedule,
             BoolFromEnv("FLAGS_cinn_ir_schedule", true),
             "Whether use reconstructed schedule primitives.");
 
+DEFINE_bool(cinn_poly_ast_cache,
+            BoolFromEnv("FLAGS_cinn_poly_ast_cache", true),
+            "Whether to memoize the ISL ASTs on each thread, reused by the stages of the same schedules up to names.");
+
+DEFINE_bool(cinn_poly_rectangular_fast_path,
+            BoolFromEnv("FLAGS_cinn_poly_rectangular_fast_path", true),
+            "Whether to generate the loops of a single stage with a box domain and no transform without ISL.");
+
 // FLAGS for performance analysis and accuracy debug
 DEFINE_bool(cinn_sync_run,
             BoolFromEnv("FLAGS_cinn_sync_run", false),
@@ -81,6 +146,31 @@ DEFINE_string(cinn_source_code_save_path,
               StringFromEnv("FLAGS_cinn_source_code_save_path", ""),
               "Specify the directory path of generated source code, which is used for debug.");
 
+DEFINE_string(cinn_compile_profile_path,
+              StringFromEnv("FLAGS_cinn_compile_profile_path", ""),
+              "If set, profile the compilation pipeline and save the Chrome trace of the passes to this path "
+              "every time GraphCompiler::Build finishes, the later builds are saved to the numbered paths such as "
+              "profile.1.json.");
+
+DEFINE_string(cinn_runtime_profile_path,
+              StringFromEnv("FLAGS_cinn_runtime_profile_path", ""),
+              "If set, time every instruction run by the runtime programs and save the Chrome trace and the roofline "
+              "summary of the instructions of each program to this path when it is destroyed, the later programs are "
+              "saved to the numbered paths such as profile.1.json.");
+
+DEFINE_string(cinn_aot_runtime_library,
+              StringFromEnv("FLAGS_cinn_aot_runtime_library", ""),
+              "The path of the static aot_runtime library linked into the shared libraries compiled ahead of time.");
+
+DEFINE_string(cinn_aot_link_libraries,
+              StringFromEnv("FLAGS_cinn_aot_link_libraries", ""),
+              "The external libraries the aot_runtime depends on, e.g. the MKL libraries, separated by commas, "
+              "which are linked into the shared libraries compiled ahead of time.");
+
+DEFINE_string(cinn_aot_cxx,
+              StringFromEnv("FLAGS_cinn_aot_cxx", "c++"),
+              "The compiler driver building the shared libraries compiled ahead of time.");
+
 DEFINE_bool(enable_auto_tuner, BoolFromEnv("FLAGS_enable_auto_tuner", false), "Whether enable auto tuner.");
 
 DEFINE_bool(auto_schedule_use_cost_model,
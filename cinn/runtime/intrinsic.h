@@ -82,6 +82,9 @@ static const char* pod_values_to_array_repr = "pod_values_to_array";
 
 static const char* get_address_repr = "get_address";
 
+//! Prefetch the address of a Load, with the read/write and the temporal locality hints of `__builtin_prefetch`.
+static const char* prefetch_repr = "cinn_prefetch";
+
 static const char* args_construct_repr = "cinn_args_construct";
 
 static const char* builtin_intrin_repr = "cinn_builtin_intrin";
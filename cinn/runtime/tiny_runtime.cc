@@ -16,8 +16,10 @@
 #include <omp.h>
 
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -25,6 +27,9 @@
 
 extern "C" {
 int max_num_workers = std::thread::hardware_concurrency();
+
+typedef void (*func_t)(cinn_pod_value_t *, int);
+
 // move to standlone file
 struct param_context_t {
   int major_v;
@@ -35,28 +40,12 @@ struct param_context_t {
   std::vector<std::string> instructions;
   std::vector<int> inst_argc;
   std::vector<cinn_pod_value_t *> inst_argv;
+  // resolved on the first run if not given when the program is loaded
+  std::vector<func_t> inst_funcs;
 };
 
-void *load_program(const char *paramfile) {
-  FILE *f = fopen(paramfile, "r");
-  fseek(f, 0, SEEK_END);
-  int fsize = ftell(f);
-  rewind(f);
-  if (fsize < 32) {
-    fclose(f);
-    return nullptr;
-  }
-
-  std::unique_ptr<param_context_t> ctx(new param_context_t{});
-  int alignment = std::max(alignof(cinn_pod_value_t), alignof(cinn_buffer_t));
-  ctx->buf.resize(fsize + alignment);
-  uint8_t *buf = ctx->buf.data();
-  if ((uintptr_t)buf % alignment) {
-    buf = buf + alignment - ((uintptr_t)buf % alignment);
-  }
-  fread(buf, 1, fsize, f);
-  fclose(f);
-
+// parse the param file of Program::Export copied into the aligned \p buf
+static param_context_t *parse_program(std::unique_ptr<param_context_t> ctx, uint8_t *buf, int fsize) {
   if (std::string(buf, buf + 4) != "CINN") {
     // TODO LOG fatal
     return nullptr;
@@ -115,23 +104,83 @@ void *load_program(const char *paramfile) {
     }
     ctx->inst_argv.push_back(argv);
   }
+  ctx->inst_funcs.resize(ctx->instructions.size(), nullptr);
   return ctx.release();
 }
 
+// allocate \p size bytes aligned for the buffers and pod values in the param file
+static uint8_t *alloc_param_buffer(param_context_t *ctx, int size) {
+  int alignment = std::max(alignof(cinn_pod_value_t), alignof(cinn_buffer_t));
+  ctx->buf.resize(size + alignment);
+  uint8_t *buf = ctx->buf.data();
+  if ((uintptr_t)buf % alignment) {
+    buf = buf + alignment - ((uintptr_t)buf % alignment);
+  }
+  return buf;
+}
+
+void *load_program(const char *paramfile) {
+  FILE *f = fopen(paramfile, "r");
+  fseek(f, 0, SEEK_END);
+  int fsize = ftell(f);
+  rewind(f);
+  if (fsize < 32) {
+    fclose(f);
+    return nullptr;
+  }
+
+  std::unique_ptr<param_context_t> ctx(new param_context_t{});
+  uint8_t *buf = alloc_param_buffer(ctx.get(), fsize);
+  fread(buf, 1, fsize, f);
+  fclose(f);
+  return parse_program(std::move(ctx), buf, fsize);
+}
+
+void *load_program_from_memory(
+    const void *data, int size, const char **symbol_names, void **symbol_addresses, int num_symbols) {
+  if (size < 32) {
+    return nullptr;
+  }
+  // every program owns a copy of the params, since the buffers are relocated in place and the weights may be updated.
+  std::unique_ptr<param_context_t> ctx(new param_context_t{});
+  uint8_t *buf = alloc_param_buffer(ctx.get(), size);
+  memcpy(buf, data, size);
+  param_context_t *pc = parse_program(std::move(ctx), buf, size);
+  if (!pc) {
+    return nullptr;
+  }
+
+  std::map<std::string, void *> symbols;
+  for (int i = 0; i < num_symbols; i++) {
+    symbols[symbol_names[i]] = symbol_addresses[i];
+  }
+  for (int i = 0; i < pc->instructions.size(); i++) {
+    auto it = symbols.find(pc->instructions[i]);
+    if (it != symbols.end()) {
+      pc->inst_funcs[i] = (func_t)it->second;
+    }
+  }
+  return pc;
+}
+
+void destroy_program(void *ctx) { delete (param_context_t *)ctx; }
+
 int set_maxconcurrency(int c) {
   int old_c       = max_num_workers;
   max_num_workers = c;
   return old_c;
 }
 
-typedef void (*func_t)(cinn_pod_value_t *, int);
+// the number of tasks the builtin kernels of the aot_runtime, e.g. the packed gemm, split their work into
+int max_concurrency() { return max_num_workers; }
+
 void run_program(void *ctx) {
   param_context_t *pc = (param_context_t *)ctx;
   for (int i = 0; i < pc->instructions.size(); i++) {
-    const char *sym = pc->instructions[i].c_str();
-    void *p         = dlsym(RTLD_DEFAULT, sym);
-    func_t f        = (func_t)p;
-    f(pc->inst_argv[i], pc->inst_argc[i]);
+    if (!pc->inst_funcs[i]) {
+      pc->inst_funcs[i] = (func_t)dlsym(RTLD_DEFAULT, pc->instructions[i].c_str());
+    }
+    pc->inst_funcs[i](pc->inst_argv[i], pc->inst_argc[i]);
   }
 }
 
@@ -143,6 +192,11 @@ cinn_pod_value_t *get_pod_value(void *ctx, const char *tname) {
   return nullptr;
 }
 
+void *get_buffer_memory(void *ctx, const char *tname) {
+  cinn_pod_value_t *value = get_pod_value(ctx, tname);
+  return value ? ((cinn_buffer_t *)*value)->memory : nullptr;
+}
+
 typedef int (*FCINNParallelLambda)(int task_id, int num_task, void *datas);
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void *datas, int num_task) {
   int num_workers = max_num_workers;
@@ -0,0 +1,309 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/utils/event.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <unordered_map>
+
+DECLARE_string(cinn_compile_profile_path);
+DECLARE_string(cinn_runtime_profile_path);
+
+namespace cinn {
+namespace utils {
+
+const char* EventTypeToString(EventType type) {
+  switch (type) {
+    case EventType::kOrdinary:
+      return "Ordinary";
+    case EventType::kProgram:
+      return "Program";
+    case EventType::kGraph:
+      return "Graph";
+    case EventType::kLower:
+      return "Lower";
+    case EventType::kSchedule:
+      return "Schedule";
+    case EventType::kOptimize:
+      return "Optimize";
+    case EventType::kCodeGen:
+      return "CodeGen";
+    case EventType::kCompile:
+      return "Compile";
+    case EventType::kInstruction:
+      return "Instruction";
+    default:
+      LOG(FATAL) << "Unknown event type: " << static_cast<int>(type);
+  }
+  return "";
+}
+
+HostEventRecorder& HostEventRecorder::GetInstance() {
+  static HostEventRecorder recorder;
+  return recorder;
+}
+
+bool HostEventRecorder::IsEnabled(EventType type) {
+  if (type == EventType::kInstruction) {
+    return !FLAGS_cinn_runtime_profile_path.empty();
+  }
+  return !FLAGS_cinn_compile_profile_path.empty();
+}
+
+void HostEventRecorder::RecordEvent(HostEvent&& event) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  events_.emplace_back(std::move(event));
+}
+
+std::vector<HostEvent> HostEventRecorder::TakeEvents(bool instruction_events) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  std::vector<HostEvent> taken, kept;
+  for (auto& event : events_) {
+    if ((event.type == EventType::kInstruction) == instruction_events) {
+      taken.emplace_back(std::move(event));
+    } else {
+      kept.emplace_back(std::move(event));
+    }
+  }
+  events_.swap(kept);
+  return taken;
+}
+
+std::vector<HostEvent> HostEventRecorder::TakeEvents(const void* owner) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  std::vector<HostEvent> taken, kept;
+  for (auto& event : events_) {
+    if (event.type == EventType::kInstruction && event.owner == owner) {
+      taken.emplace_back(std::move(event));
+    } else {
+      kept.emplace_back(std::move(event));
+    }
+  }
+  events_.swap(kept);
+  return taken;
+}
+
+namespace {
+
+std::string EscapeJson(const std::string& s) {
+  std::ostringstream os;
+  for (char c : s) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+          os << c;
+        }
+    }
+  }
+  return os.str();
+}
+
+struct EventStat {
+  int calls       = 0;
+  int64_t total   = 0;
+  int64_t max_dur = 0;
+  double bytes    = 0;
+  double flops    = 0;
+};
+
+void PrintStats(const std::string& title,
+                const std::vector<std::pair<std::string, EventStat>>& stats,
+                int64_t wall_ns,
+                std::ostream& os) {
+  size_t name_width = title.size();
+  bool roofline     = false;
+  for (auto& item : stats) {
+    name_width = std::max(name_width, item.first.size());
+    roofline   = roofline || item.second.bytes > 0 || item.second.flops > 0;
+  }
+  os << std::left << std::setw(name_width + 2) << title << std::right << std::setw(8) << "Calls" << std::setw(14)
+     << "Total(ms)" << std::setw(12) << "Avg(ms)" << std::setw(12) << "Max(ms)" << std::setw(10) << "Ratio";
+  if (roofline) {
+    os << std::setw(12) << "GB/s" << std::setw(12) << "GFLOP/s" << std::setw(10) << "FLOP/B";
+  }
+  os << "\n";
+  for (auto& item : stats) {
+    const auto& stat = item.second;
+    os << std::left << std::setw(name_width + 2) << item.first << std::right << std::setw(8) << stat.calls
+       << std::fixed << std::setprecision(3) << std::setw(14) << stat.total / 1e6 << std::setw(12)
+       << stat.total / 1e6 / stat.calls << std::setw(12) << stat.max_dur / 1e6 << std::setprecision(2)
+       << std::setw(9) << (wall_ns > 0 ? 100.0 * stat.total / wall_ns : 0.0) << "%";
+    if (roofline) {
+      // bytes (flops) per ns is GB/s (GFLOP/s)
+      double total = std::max<int64_t>(stat.total, 1);
+      os << std::setw(12) << stat.bytes / total << std::setw(12) << stat.flops / total << std::setw(10)
+         << (stat.bytes > 0 ? stat.flops / stat.bytes : 0.0);
+    }
+    os << "\n";
+  }
+}
+
+std::vector<std::pair<std::string, EventStat>> SortByTotal(const std::map<std::string, EventStat>& stats) {
+  std::vector<std::pair<std::string, EventStat>> sorted(stats.begin(), stats.end());
+  std::stable_sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.total > rhs.second.total;
+  });
+  return sorted;
+}
+
+}  // namespace
+
+std::string EventsToChromeTrace(const std::vector<HostEvent>& events) {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    os << (i ? ",\n" : "\n") << "{\"name\": \"" << EscapeJson(event.annotation) << "\", \"cat\": \""
+       << EventTypeToString(event.type) << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << event.thread_id
+       << ", \"ts\": " << event.start_ns / 1e3 << ", \"dur\": " << (event.end_ns - event.start_ns) / 1e3
+       << ", \"args\": {";
+    bool first_arg = true;
+    if (!event.group.empty()) {
+      os << "\"group\": \"" << EscapeJson(event.group) << "\"";
+      first_arg = false;
+    }
+    for (auto& arg : event.args) {
+      os << (first_arg ? "" : ", ") << "\"" << EscapeJson(arg.first) << "\": " << arg.second;
+      first_arg = false;
+    }
+    os << "}}";
+  }
+  os << "\n]}\n";
+  return os.str();
+}
+
+std::string SummarizeEvents(const std::vector<HostEvent>& events) {
+  if (events.empty()) {
+    return "";
+  }
+  int64_t start_ns = events.front().start_ns;
+  int64_t end_ns   = events.front().end_ns;
+  std::map<std::string, EventStat> annotation_stats;
+  std::map<std::string, EventStat> group_stats;
+  for (auto& event : events) {
+    start_ns    = std::min(start_ns, event.start_ns);
+    end_ns      = std::max(end_ns, event.end_ns);
+    int64_t dur = event.end_ns - event.start_ns;
+
+    double bytes = 0, flops = 0;
+    for (auto& arg : event.args) {
+      if (arg.first == "bytes") {
+        bytes = arg.second;
+      } else if (arg.first == "flops") {
+        flops = arg.second;
+      }
+    }
+    auto update = [&](EventStat* stat) {
+      stat->calls  += 1;
+      stat->total  += dur;
+      stat->max_dur = std::max(stat->max_dur, dur);
+      stat->bytes  += bytes;
+      stat->flops  += flops;
+    };
+    update(&annotation_stats[std::string(EventTypeToString(event.type)) + "/" + event.annotation]);
+    if (!event.group.empty()) {
+      update(&group_stats[event.group]);
+    }
+  }
+
+  std::ostringstream os;
+  os << "Profiled " << events.size() << " events in " << std::fixed << std::setprecision(3) << (end_ns - start_ns) / 1e6
+     << " ms\n";
+  PrintStats("Event", SortByTotal(annotation_stats), end_ns - start_ns, os);
+  if (!group_stats.empty()) {
+    os << "\n";
+    PrintStats("Group", SortByTotal(group_stats), end_ns - start_ns, os);
+  }
+  return os.str();
+}
+
+namespace {
+
+// The path of the next report saved to \p path: \p path itself the first time, then the index of the report is inserted
+// before the extension, e.g. profile.json, profile.1.json, profile.2.json, so the earlier reports are kept.
+std::string NextReportPath(const std::string& path) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, int> report_nums;
+  int index = 0;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    index = report_nums[path]++;
+  }
+  if (index == 0) {
+    return path;
+  }
+  auto dot   = path.rfind('.');
+  auto slash = path.rfind('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return path + "." + std::to_string(index);
+  }
+  return path.substr(0, dot) + "." + std::to_string(index) + path.substr(dot);
+}
+
+void WriteEventsReport(const std::string& base_path, const std::vector<HostEvent>& events, const char* kind) {
+  if (events.empty()) {
+    return;
+  }
+  std::string path = NextReportPath(base_path);
+  std::ofstream of(path, std::ofstream::out | std::ofstream::trunc);
+  CHECK(of.is_open()) << "Failed to open " << path;
+  of << EventsToChromeTrace(events);
+  of.close();
+  LOG(INFO) << "The " << kind << " profile is saved to " << path << "\n" << SummarizeEvents(events);
+}
+
+}  // namespace
+
+void SaveEventsReport(const std::string& path, bool instruction_events) {
+  if (path.empty()) {
+    return;
+  }
+  WriteEventsReport(path,
+                    HostEventRecorder::GetInstance().TakeEvents(instruction_events),
+                    instruction_events ? "runtime" : "compile-time");
+}
+
+void SaveProgramEventsReport(const std::string& path, const void* owner) {
+  if (path.empty()) {
+    return;
+  }
+  WriteEventsReport(path, HostEventRecorder::GetInstance().TakeEvents(owner), "runtime");
+}
+
+}  // namespace utils
+}  // namespace cinn
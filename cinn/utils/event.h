@@ -0,0 +1,120 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+//! The stage of the pipeline an event belongs to, used to categorize the events in the reports.
+enum class EventType {
+  kOrdinary,     // not categorized
+  kProgram,      // frontend program passes
+  kGraph,        // graph passes
+  kLower,        // lowering a fusion group to CINN IR
+  kSchedule,     // poly/ISL scheduling
+  kOptimize,     // optimization passes on CINN IR
+  kCodeGen,      // generating the source code or the LLVM IR
+  kCompile,      // compiling the generated code by LLVM or NVRTC and linking it by the JIT
+  kInstruction,  // running the instructions of a runtime program
+};
+
+const char* EventTypeToString(EventType type);
+
+//! An event recorded on the host, the time points are nanoseconds of the steady clock.
+struct HostEvent {
+  std::string annotation;
+  EventType type;
+  // the fusion group the event works on, empty if the event is not specific to a group
+  std::string group;
+  int64_t start_ns;
+  int64_t end_ns;
+  int thread_id;
+  // the counters attached to the event, e.g. the number of IR nodes before and after an optimization pass
+  std::vector<std::pair<std::string, int64_t>> args;
+  // the runtime program running when the event is recorded, null if there is none, see ScopedEventOwner
+  const void* owner;
+};
+
+/**
+ * HostEventRecorder collects the events of RecordEvent. The compile-time events are recorded only when
+ * FLAGS_cinn_compile_profile_path is set, and the runtime events (EventType::kInstruction) only when
+ * FLAGS_cinn_runtime_profile_path is set.
+ */
+class HostEventRecorder {
+ public:
+  static HostEventRecorder& GetInstance();
+
+  //! Whether the events of the type are recorded.
+  static bool IsEnabled(EventType type);
+
+  void RecordEvent(HostEvent&& event);
+
+  //! Take the compile-time events recorded so far, or the runtime ones if \p instruction_events is true.
+  std::vector<HostEvent> TakeEvents(bool instruction_events = false);
+
+  //! Take the runtime events recorded so far while \p owner is running, the ones of the other programs are kept.
+  std::vector<HostEvent> TakeEvents(const void* owner);
+
+ private:
+  HostEventRecorder() = default;
+
+  std::mutex mtx_;
+  std::vector<HostEvent> events_;
+};
+
+//! Convert the events to the Chrome trace event format, which can be loaded by chrome://tracing or Perfetto.
+std::string EventsToChromeTrace(const std::vector<HostEvent>& events);
+
+/**
+ * Summarize the events as two tables sorted by the total time: one of each annotation and one of each fusion group.
+ * The time of the nested events is also counted in their enclosing events. If the events have the counters "bytes"
+ * and "flops", the achieved GB/s, GFLOP/s and the arithmetic intensity are reported as well.
+ */
+std::string SummarizeEvents(const std::vector<HostEvent>& events);
+
+/**
+ * Take the events recorded so far, save them as a Chrome trace to \p path and log their summary.
+ * Nothing is done if \p path is empty or no event is taken, so an existing report is not overwritten by an empty one.
+ * The reports saved later to the same path in the process are numbered instead of overwriting the first one, e.g.
+ * profile.json, profile.1.json, profile.2.json for the reports of three builds.
+ * @param instruction_events Whether to report the runtime events instead of the compile-time ones.
+ */
+void SaveEventsReport(const std::string& path, bool instruction_events = false);
+
+//! The same as SaveEventsReport, but only reports the runtime events of the program \p owner, so each program
+//! destroyed in the process saves its own numbered report.
+void SaveProgramEventsReport(const std::string& path, const void* owner);
+
+//! Call SaveEventsReport when going out of scope, so the events of the whole scope are included in the report.
+class ScopedEventsReport {
+ public:
+  explicit ScopedEventsReport(const std::string& path, bool instruction_events = false)
+      : path_(path), instruction_events_(instruction_events) {}
+  ~ScopedEventsReport() { SaveEventsReport(path_, instruction_events_); }
+
+ private:
+  std::string path_;
+  bool instruction_events_;
+};
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,196 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/utils/event.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "cinn/utils/profiler.h"
+
+DECLARE_string(cinn_compile_profile_path);
+DECLARE_string(cinn_runtime_profile_path);
+
+namespace cinn {
+namespace utils {
+
+TEST(HostEventRecorder, RecordEvent) {
+  HostEventRecorder::GetInstance().TakeEvents();
+  std::string origin_path = FLAGS_cinn_compile_profile_path;
+
+  FLAGS_cinn_compile_profile_path = "";
+  { RecordEvent record("disabled", EventType::kGraph); }
+  ASSERT_TRUE(HostEventRecorder::GetInstance().TakeEvents().empty());
+
+  FLAGS_cinn_compile_profile_path = "./compile_profile.json";
+  {
+    RecordEvent outer("OpLowerer::Lower", EventType::kLower, "fn_group_0");
+    RecordEvent inner("Simplify", EventType::kOptimize);
+    ASSERT_TRUE(inner.recorded());
+    inner.AddArg("ir_nodes_before", 10);
+    inner.AddArg("ir_nodes_after", 6);
+  }
+  // the runtime events are not recorded by the compile-time profiler
+  { RecordEvent record("fn_group_0", EventType::kInstruction); }
+  FLAGS_cinn_compile_profile_path = origin_path;
+
+  std::vector<HostEvent> events = HostEventRecorder::GetInstance().TakeEvents();
+  ASSERT_EQ(events.size(), 2);
+  // the inner event finishes first
+  EXPECT_EQ(events[0].annotation, "Simplify");
+  EXPECT_EQ(events[1].annotation, "OpLowerer::Lower");
+  EXPECT_EQ(events[1].group, "fn_group_0");
+  EXPECT_LE(events[1].start_ns, events[0].start_ns);
+  EXPECT_GE(events[1].end_ns, events[0].end_ns);
+  ASSERT_EQ(events[0].args.size(), 2);
+  EXPECT_EQ(events[0].args[1].first, "ir_nodes_after");
+  EXPECT_EQ(events[0].args[1].second, 6);
+
+  std::string trace = EventsToChromeTrace(events);
+  EXPECT_NE(trace.find("\"name\": \"Simplify\", \"cat\": \"Optimize\", \"ph\": \"X\""), std::string::npos);
+  EXPECT_NE(trace.find("\"ir_nodes_before\": 10, \"ir_nodes_after\": 6"), std::string::npos);
+  EXPECT_NE(trace.find("\"group\": \"fn_group_0\""), std::string::npos);
+
+  std::string summary = SummarizeEvents(events);
+  EXPECT_NE(summary.find("Optimize/Simplify"), std::string::npos);
+  EXPECT_NE(summary.find("Lower/OpLowerer::Lower"), std::string::npos);
+  EXPECT_NE(summary.find("fn_group_0"), std::string::npos);
+  EXPECT_EQ(summary.find("GFLOP/s"), std::string::npos);
+}
+
+TEST(HostEventRecorder, RuntimeEvents) {
+  HostEventRecorder::GetInstance().TakeEvents();
+  HostEventRecorder::GetInstance().TakeEvents(/*instruction_events=*/true);
+  std::string origin_compile_path = FLAGS_cinn_compile_profile_path;
+  std::string origin_runtime_path = FLAGS_cinn_runtime_profile_path;
+
+  FLAGS_cinn_compile_profile_path = "";
+  FLAGS_cinn_runtime_profile_path = "./runtime_profile.json";
+  for (int i = 0; i < 3; ++i) {
+    RecordEvent record("fn_matmul_0", EventType::kInstruction);
+    ASSERT_TRUE(record.recorded());
+    record.AddArg("flops", 2 * 64 * 64 * 64);
+    record.AddArg("bytes", 3 * 64 * 64 * 4);
+  }
+  { RecordEvent record("fn_group_0", EventType::kGraph); }
+  FLAGS_cinn_compile_profile_path = origin_compile_path;
+  FLAGS_cinn_runtime_profile_path = origin_runtime_path;
+
+  // the runtime events are taken apart from the compile-time ones
+  ASSERT_TRUE(HostEventRecorder::GetInstance().TakeEvents().empty());
+  std::vector<HostEvent> events = HostEventRecorder::GetInstance().TakeEvents(/*instruction_events=*/true);
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_EQ(events[0].type, EventType::kInstruction);
+
+  std::string summary = SummarizeEvents(events);
+  EXPECT_NE(summary.find("Instruction/fn_matmul_0"), std::string::npos);
+  EXPECT_NE(summary.find("GFLOP/s"), std::string::npos);
+  EXPECT_NE(summary.find("FLOP/B"), std::string::npos);
+  // the arithmetic intensity is (2 * 64) / (3 * 4)
+  EXPECT_NE(summary.find("10.67"), std::string::npos);
+}
+
+TEST(HostEventRecorder, ProgramEvents) {
+  HostEventRecorder::GetInstance().TakeEvents(/*instruction_events=*/true);
+  std::string origin_runtime_path = FLAGS_cinn_runtime_profile_path;
+  // the addresses of the two objects stand for two runtime programs
+  int program_a = 0, program_b = 0;
+
+  FLAGS_cinn_runtime_profile_path = "./program_profile.json";
+  {
+    ScopedEventOwner owner(&program_a);
+    { RecordEvent record("fn_a", EventType::kInstruction); }
+    {
+      ScopedEventOwner nested(&program_b);
+      RecordEvent record("fn_b", EventType::kInstruction);
+    }
+    { RecordEvent record("fn_a", EventType::kInstruction); }
+  }
+  { RecordEvent record("fn_none", EventType::kInstruction); }
+  FLAGS_cinn_runtime_profile_path = origin_runtime_path;
+
+  std::vector<HostEvent> events_a = HostEventRecorder::GetInstance().TakeEvents(&program_a);
+  ASSERT_EQ(events_a.size(), 2);
+  EXPECT_EQ(events_a[0].annotation, "fn_a");
+  EXPECT_EQ(events_a[1].annotation, "fn_a");
+
+  // the events of the other programs are kept
+  std::vector<HostEvent> events_b = HostEventRecorder::GetInstance().TakeEvents(&program_b);
+  ASSERT_EQ(events_b.size(), 1);
+  EXPECT_EQ(events_b[0].annotation, "fn_b");
+  std::vector<HostEvent> events = HostEventRecorder::GetInstance().TakeEvents(/*instruction_events=*/true);
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_EQ(events[0].annotation, "fn_none");
+  EXPECT_EQ(events[0].owner, nullptr);
+
+  // a program without events does not overwrite the report saved before
+  std::string path = "./program_profile.json";
+  { std::ofstream(path, std::ofstream::out | std::ofstream::trunc) << "saved"; }
+  SaveProgramEventsReport(path, &program_a);
+  std::ifstream in(path);
+  std::string content;
+  in >> content;
+  EXPECT_EQ(content, "saved");
+
+  // each program saves its own report instead of overwriting the one of the program destroyed before
+  FLAGS_cinn_runtime_profile_path = "./programs_profile.json";
+  for (auto* program : {&program_a, &program_b}) {
+    ScopedEventOwner owner(program);
+    RecordEvent record(program == &program_a ? "fn_a" : "fn_b", EventType::kInstruction);
+  }
+  FLAGS_cinn_runtime_profile_path = origin_runtime_path;
+  std::remove("./programs_profile.1.json");
+  SaveProgramEventsReport("./programs_profile.json", &program_a);
+  SaveProgramEventsReport("./programs_profile.json", &program_b);
+  std::ifstream in_a("./programs_profile.json");
+  std::ifstream in_b("./programs_profile.1.json");
+  std::string report_a((std::istreambuf_iterator<char>(in_a)), std::istreambuf_iterator<char>());
+  std::string report_b((std::istreambuf_iterator<char>(in_b)), std::istreambuf_iterator<char>());
+  EXPECT_NE(report_a.find("fn_a"), std::string::npos);
+  EXPECT_EQ(report_a.find("fn_b"), std::string::npos);
+  EXPECT_NE(report_b.find("fn_b"), std::string::npos);
+}
+
+TEST(HostEventRecorder, NumberedReports) {
+  HostEventRecorder::GetInstance().TakeEvents();
+  std::string origin_path = FLAGS_cinn_compile_profile_path;
+  std::string path        = "./numbered_profile.json";
+  std::remove("./numbered_profile.1.json");
+
+  // two builds saving their reports to the same path
+  FLAGS_cinn_compile_profile_path = path;
+  for (int i = 0; i < 2; ++i) {
+    ScopedEventsReport report(path);
+    RecordEvent record("OpLowerer::Lower", EventType::kLower, "fn_group_" + std::to_string(i));
+  }
+  FLAGS_cinn_compile_profile_path = origin_path;
+
+  auto read_file = [](const std::string& file_path) {
+    std::ifstream in(file_path);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  };
+  // the report of the second build doesn't overwrite the first one
+  EXPECT_NE(read_file(path).find("fn_group_0"), std::string::npos);
+  EXPECT_NE(read_file("./numbered_profile.1.json").find("fn_group_1"), std::string::npos);
+}
+
+}  // namespace utils
+}  // namespace cinn
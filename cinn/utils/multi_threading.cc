@@ -14,8 +14,10 @@
 
 #include "cinn/utils/multi_threading.h"
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <future>
 #include <thread>
 #include <utility>
@@ -23,6 +25,9 @@
 
 #include "cinn/utils/string.h"
 
+DECLARE_int32(cinn_compile_num_threads);
+DECLARE_int32(cinn_parallel_compile_size);
+
 namespace cinn {
 namespace utils {
 
@@ -92,5 +97,17 @@ void parallel_run(const WorkerFuncType& fn, JobDispatcher&& dispatcher, int num_
   }
 }
 
+int GetCompileThreadNum(int num_jobs) {
+  // the ParallelCompiler already compiles the groups in parallel
+  if (FLAGS_cinn_parallel_compile_size) {
+    return 1;
+  }
+  int num_threads = FLAGS_cinn_compile_num_threads;
+  if (num_threads <= 0) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  return std::max(std::min(num_threads, num_jobs), 1);
+}
+
 }  // namespace utils
 }  // namespace cinn
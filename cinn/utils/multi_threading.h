@@ -15,6 +15,7 @@
 #pragma once
 #include <atomic>
 #include <functional>
+#include <limits>
 
 namespace cinn {
 namespace utils {
@@ -58,5 +59,11 @@ class SequenceDispatcher : public JobDispatcher {
  */
 void parallel_run(const WorkerFuncType& fn, JobDispatcher&& dispatcher, int num_threads = -1);
 
+/**
+ * \brief Get the number of threads to run \p num_jobs independent compile jobs with, which is decided by
+ * FLAGS_cinn_compile_num_threads and is no more than \p num_jobs. It is 1 if the ParallelCompiler is used.
+ */
+int GetCompileThreadNum(int num_jobs = std::numeric_limits<int>::max());
+
 }  // namespace utils
 }  // namespace cinn
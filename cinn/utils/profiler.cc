@@ -14,6 +14,10 @@
 
 #include "cinn/utils/profiler.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <utility>
+
 #ifdef CINN_WITH_NVTX
 #include <nvToolsExt.h>
 #endif
@@ -27,6 +31,54 @@
 namespace cinn {
 namespace utils {
 
+namespace {
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// a small sequential id of the current thread, readable in the trace viewers
+int CurrentThreadId() {
+  static std::atomic<int> next_id{0};
+  thread_local int id = next_id++;
+  return id;
+}
+
+// the owner of the events recorded by the current thread, set by ScopedEventOwner
+thread_local const void* current_owner = nullptr;
+
+}  // namespace
+
+RecordEvent::RecordEvent(const std::string& name, EventType type, const std::string& group) {
+#ifdef CINN_WITH_NVTX
+  nvtxRangePushA(name.c_str());
+#endif
+  if (HostEventRecorder::IsEnabled(type)) {
+    event_.reset(new HostEvent{name, type, group, NowNs(), 0, CurrentThreadId(), {}, current_owner});
+  }
+}
+
+RecordEvent::~RecordEvent() {
+#ifdef CINN_WITH_NVTX
+  nvtxRangePop();
+#endif
+  if (event_) {
+    event_->end_ns = NowNs();
+    HostEventRecorder::GetInstance().RecordEvent(std::move(*event_));
+  }
+}
+
+void RecordEvent::AddArg(const std::string& key, int64_t value) {
+  if (event_) {
+    event_->args.emplace_back(key, value);
+  }
+}
+
+ScopedEventOwner::ScopedEventOwner(const void* owner) : previous_(current_owner) { current_owner = owner; }
+
+ScopedEventOwner::~ScopedEventOwner() { current_owner = previous_; }
+
 void SynchronizeAllDevice() {
 #ifdef CINN_WITH_CUDA
   int current_device_id;
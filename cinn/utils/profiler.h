@@ -14,27 +14,49 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 
-#ifdef CINN_WITH_NVTX
-#include <nvToolsExt.h>
-#endif
+#include "cinn/utils/event.h"
 
 namespace cinn {
 namespace utils {
 
+/**
+ * RecordEvent marks its lifetime as an NVTX range, and records it as a HostEvent if the events of its type are
+ * enabled, see HostEventRecorder.
+ *
+ * @param name The annotation of the event.
+ * @param type The stage of the pipeline the event belongs to.
+ * @param group The fusion group the event works on, empty if the event is not specific to a group.
+ */
 class RecordEvent {
  public:
-  RecordEvent(const std::string& name) {
-#ifdef CINN_WITH_NVTX
-    nvtxRangePushA(name.c_str());
-#endif
-  }
-  ~RecordEvent() {
-#ifdef CINN_WITH_NVTX
-    nvtxRangePop();
-#endif
-  }
+  RecordEvent(const std::string& name, EventType type = EventType::kOrdinary, const std::string& group = "");
+  ~RecordEvent();
+
+  //! Whether the event is recorded, the counters are only worth computing if it is.
+  bool recorded() const { return event_ != nullptr; }
+
+  //! Attach a counter to the event, ignored if the event is not recorded.
+  void AddArg(const std::string& key, int64_t value);
+
+ private:
+  std::unique_ptr<HostEvent> event_;
+};
+
+/**
+ * ScopedEventOwner tags the events recorded by the current thread during its lifetime with \p owner, so the events of
+ * a runtime program can be taken apart from those of the other programs, see HostEventRecorder::TakeEvents.
+ */
+class ScopedEventOwner {
+ public:
+  explicit ScopedEventOwner(const void* owner);
+  ~ScopedEventOwner();
+
+ private:
+  const void* previous_;
 };
 
 void SynchronizeAllDevice();
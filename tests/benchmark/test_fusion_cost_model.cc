@@ -0,0 +1,166 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+#include "cinn/utils/timer.h"
+
+DECLARE_bool(cinn_use_fusion_cost_model);
+
+namespace cinn {
+namespace tests {
+
+using frontend::NetBuilder;
+using frontend::Variable;
+
+struct FusionResult {
+  size_t group_num;
+  float latency;
+  std::vector<float> output;
+};
+
+// Compile the program with the fusion passes and return the average latency of `repeat` executions.
+FusionResult RunWithFusion(const frontend::Program& program,
+                           const std::vector<std::string>& input_names,
+                           const std::string& output_name,
+                           bool use_cost_model,
+                           int repeat = 100) {
+  bool origin_flag                 = FLAGS_cinn_use_fusion_cost_model;
+  FLAGS_cinn_use_fusion_cost_model = use_cost_model;
+  Target target                    = common::DefaultTarget();
+  auto graph                       = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+  FLAGS_cinn_use_fusion_cost_model = origin_flag;
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  for (size_t i = 0; i < input_names.size(); ++i) {
+    SetRandData<float>(scope->GetTensor(input_names[i]), target, i + 1);
+  }
+
+  // warm up
+  runtime_program->Execute();
+  utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; ++i) {
+    runtime_program->Execute();
+  }
+  float latency = timer.Stop() / repeat;
+  return {graph->fusion_groups.size(), latency, GetTensorData<float>(scope->GetTensor(output_name), target)};
+}
+
+void CompareFusion(const std::string& name,
+                   const std::function<frontend::Program(std::vector<std::string>*, std::string*)>& build_program) {
+  std::vector<std::string> input_names;
+  std::string output_name;
+  auto program = build_program(&input_names, &output_name);
+
+  auto base  = RunWithFusion(program, input_names, output_name, false);
+  auto model = RunWithFusion(program, input_names, output_name, true);
+  LOG(INFO) << name << ": relation table " << base.group_num << " groups, " << base.latency << " ms; cost model "
+            << model.group_num << " groups, " << model.latency << " ms; speedup " << base.latency / model.latency;
+
+  ASSERT_EQ(base.output.size(), model.output.size());
+  for (size_t i = 0; i < base.output.size(); ++i) {
+    ASSERT_NEAR(base.output[i], model.output[i], 1e-4 * (1 + std::abs(base.output[i]))) << name << ", i=" << i;
+  }
+}
+
+// The residual tail of a ResNet bottleneck block: scale-shift, add the shortcut and activate.
+TEST(FusionCostModel, residual_block) {
+  CompareFusion("residual_block", [](std::vector<std::string>* input_names, std::string* output_name) {
+    NetBuilder builder("residual_block");
+    auto x        = builder.CreateInput(Float(32), {32, 256, 28, 28}, "x");
+    auto shortcut = builder.CreateInput(Float(32), {32, 256, 28, 28}, "shortcut");
+    auto scale    = builder.CreateInput(Float(32), {256}, "scale");
+    auto bias     = builder.CreateInput(Float(32), {256}, "bias");
+    auto y        = builder.Add(builder.Multiply(x, scale, 1), bias, 1);
+    auto out      = builder.Relu(builder.Add(y, shortcut));
+    *input_names  = {"x", "shortcut", "scale", "bias"};
+    *output_name  = out->id;
+    return builder.Build();
+  });
+}
+
+// The softmax of the attention scores in a BERT encoder layer.
+TEST(FusionCostModel, softmax) {
+  CompareFusion("softmax", [](std::vector<std::string>* input_names, std::string* output_name) {
+    NetBuilder builder("softmax");
+    auto x       = builder.CreateInput(Float(32), {32, 12, 128, 128}, "x");
+    auto x_max   = builder.ReduceMax(x, {3}, true);
+    auto x_exp   = builder.Exp(builder.Subtract(x, x_max));
+    auto out     = builder.Divide(x_exp, builder.ReduceSum(x_exp, {3}, true));
+    *input_names = {"x"};
+    *output_name = out->id;
+    return builder.Build();
+  });
+}
+
+// The layer normalization after the feed forward network in a BERT encoder layer.
+TEST(FusionCostModel, layer_norm) {
+  CompareFusion("layer_norm", [](std::vector<std::string>* input_names, std::string* output_name) {
+    NetBuilder builder("layer_norm");
+    auto x        = builder.CreateInput(Float(32), {4096, 768}, "x");
+    auto scale    = builder.CreateInput(Float(32), {768}, "scale");
+    auto bias     = builder.CreateInput(Float(32), {768}, "bias");
+    auto factor   = builder.FillConstant<float>({4096, 1}, 1.0f / 768, "factor");
+    auto epsilon  = builder.FillConstant<float>({4096, 1}, 1e-5f, "epsilon");
+    auto mean     = builder.Multiply(builder.ReduceSum(x, {1}, true), factor);
+    auto diff     = builder.Subtract(x, mean);
+    auto variance = builder.Multiply(builder.ReduceSum(builder.Multiply(diff, diff), {1}, true), factor);
+    auto std_dev  = builder.Sqrt(builder.Add(variance, epsilon));
+    auto out      = builder.Add(builder.Multiply(builder.Divide(diff, std_dev), scale, 1), bias, 1);
+    *input_names  = {"x", "scale", "bias"};
+    *output_name  = out->id;
+    return builder.Build();
+  });
+}
+
+// A long chain of activations and elementwise ops which exceeds the per-kernel budget when fused as a whole.
+TEST(FusionCostModel, elementwise_chain) {
+  CompareFusion("elementwise_chain", [](std::vector<std::string>* input_names, std::string* output_name) {
+    NetBuilder builder("elementwise_chain");
+    auto x       = builder.CreateInput(Float(32), {1024, 1024}, "x");
+    auto y       = builder.CreateInput(Float(32), {1024, 1024}, "y");
+    Variable out = x;
+    for (int i = 0; i < 80; ++i) {
+      out = i % 2 ? builder.Add(out, y) : builder.Relu(out);
+    }
+    *input_names = {"x", "y"};
+    *output_name = out->id;
+    return builder.Build();
+  });
+}
+
+}  // namespace tests
+}  // namespace cinn
@@ -0,0 +1,99 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+#include "cinn/utils/timer.h"
+
+DECLARE_bool(cinn_ir_arena);
+
+namespace cinn {
+namespace tests {
+
+using frontend::NetBuilder;
+using frontend::Variable;
+
+struct CompileResult {
+  float compile_time;
+  std::vector<float> output;
+};
+
+// Compile the program with or without the IR arena and return the compile time and the output of one execution.
+CompileResult CompileWithArena(const frontend::Program& program, const std::string& output_name, bool use_arena) {
+  Target target = common::DefaultTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+  auto scope = BuildScope(target, graph);
+
+  bool origin_flag    = FLAGS_cinn_ir_arena;
+  FLAGS_cinn_ir_arena = use_arena;
+  utils::Timer timer;
+  timer.Start();
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  float compile_time   = timer.Stop();
+  FLAGS_cinn_ir_arena  = origin_flag;
+
+  SetRandData<float>(scope->GetTensor("x"), target, 1);
+  SetRandData<float>(scope->GetTensor("y"), target, 2);
+  runtime_program->Execute();
+  return {compile_time, GetTensorData<float>(scope->GetTensor(output_name), target)};
+}
+
+// A deep stack of layer-normalized residual blocks, standing in for a large model with many fusion groups.
+TEST(IrArena, compile_time) {
+  NetBuilder builder("ir_arena");
+  auto x       = builder.CreateInput(Float(32), {64, 128}, "x");
+  auto y       = builder.CreateInput(Float(32), {64, 128}, "y");
+  auto factor  = builder.FillConstant<float>({64, 1}, 1.0f / 128, "factor");
+  Variable out = x;
+  for (int i = 0; i < 64; ++i) {
+    auto mean = builder.Multiply(builder.ReduceSum(out, {1}, true), factor);
+    auto diff = builder.Subtract(out, mean);
+    out       = builder.Add(builder.Relu(builder.Multiply(diff, y)), out);
+  }
+  auto program = builder.Build();
+
+  // warm up the op strategies and the JIT.
+  CompileWithArena(program, out->id, false);
+  auto base  = CompileWithArena(program, out->id, false);
+  auto arena = CompileWithArena(program, out->id, true);
+  LOG(INFO) << "compile time: heap " << base.compile_time << " ms, arena " << arena.compile_time << " ms; speedup "
+            << base.compile_time / arena.compile_time;
+
+  ASSERT_EQ(base.output.size(), arena.output.size());
+  for (size_t i = 0; i < base.output.size(); ++i) {
+    ASSERT_NEAR(base.output[i], arena.output[i], 1e-4 * (1 + std::abs(base.output[i]))) << "i=" << i;
+  }
+}
+
+}  // namespace tests
+}  // namespace cinn
@@ -203,6 +203,30 @@ std::vector<ir::Tensor> MatmulArrayPackingTester::CreateSpecificStrategy(const s
   return outs;
 }
 
+// packed gemm
+std::vector<ir::Tensor> MatmulPackedGemmTester::CreateSpecificStrategy(const std::vector<ir::Tensor> &inputs,
+                                                                       poly::StageMap *stages) {
+  CHECK_EQ(inputs.size(), 2U) << "matmul's input tensor should be 2.\n";
+  std::vector<ir::Tensor> outs = hlir::pe::MatmulPackedGemm(inputs[0], inputs[1]);
+  for (auto &out : outs) {
+    (*stages)->InsertLazily(out);
+  }
+  return outs;
+}
+
+#ifdef CINN_WITH_MKL_CBLAS
+// mkl
+std::vector<ir::Tensor> MatmulMKLTester::CreateSpecificStrategy(const std::vector<ir::Tensor> &inputs,
+                                                                poly::StageMap *stages) {
+  CHECK_EQ(inputs.size(), 2U) << "matmul's input tensor should be 2.\n";
+  std::vector<ir::Tensor> outs = hlir::pe::MatmulMKL(inputs[0], inputs[1]);
+  for (auto &out : outs) {
+    (*stages)->InsertLazily(out);
+  }
+  return outs;
+}
+#endif
+
 TEST(test_matmul, default) {
   int M = 1024;
   int N = 1024;
@@ -301,5 +325,35 @@ TEST(test_matmul, array_packing) {
   matmul_tester.TestOp("matmul_array_packing", input_tensors, attrs, input_types, output_types, false);
 }
 
+TEST(test_matmul, packed_gemm) {
+  int M = 1024;
+  int N = 1024;
+  int K = 1024;
+  std::vector<std::vector<int>> input_shapes{{M, K}, {K, N}};
+  std::string op_name = "matmul";
+  hlir::framework::NodeAttr attrs;
+  MatmulPackedGemmTester matmul_tester(op_name, input_shapes);
+  std::vector<Type> input_types{Float(32), Float(32)};
+  std::vector<Type> output_types{Float(32), Float(32)};
+  auto input_tensors = matmul_tester.CreateInputTensors<float>();
+  matmul_tester.TestOp("matmul_packed_gemm", input_tensors, attrs, input_types, output_types, false);
+}
+
+#ifdef CINN_WITH_MKL_CBLAS
+TEST(test_matmul, mkl) {
+  int M = 1024;
+  int N = 1024;
+  int K = 1024;
+  std::vector<std::vector<int>> input_shapes{{M, K}, {K, N}};
+  std::string op_name = "matmul";
+  hlir::framework::NodeAttr attrs;
+  MatmulMKLTester matmul_tester(op_name, input_shapes);
+  std::vector<Type> input_types{Float(32), Float(32)};
+  std::vector<Type> output_types{Float(32), Float(32)};
+  auto input_tensors = matmul_tester.CreateInputTensors<float>();
+  matmul_tester.TestOp("matmul_mkl", input_tensors, attrs, input_types, output_types, false);
+}
+#endif
+
 }  // namespace tests
 }  // namespace cinn
@@ -118,5 +118,33 @@ class MatmulArrayPackingTester : public MatmulTester {
   std::vector<std::vector<int>> input_shapes_;
 };
 
+class MatmulPackedGemmTester : public MatmulTester {
+ public:
+  MatmulPackedGemmTester(const std::string &op_name,
+                         const std::vector<std::vector<int>> &input_shapes,
+                         const common::Target &target = common::DefaultHostTarget(),
+                         int repeat                   = 10,
+                         float diff                   = 1e-5)
+      : MatmulTester(op_name, input_shapes, target, repeat, diff) {}
+
+  std::vector<ir::Tensor> CreateSpecificStrategy(const std::vector<ir::Tensor> &inputs,
+                                                 poly::StageMap *stages) override;
+};
+
+#ifdef CINN_WITH_MKL_CBLAS
+class MatmulMKLTester : public MatmulTester {
+ public:
+  MatmulMKLTester(const std::string &op_name,
+                  const std::vector<std::vector<int>> &input_shapes,
+                  const common::Target &target = common::DefaultHostTarget(),
+                  int repeat                   = 10,
+                  float diff                   = 1e-5)
+      : MatmulTester(op_name, input_shapes, target, repeat, diff) {}
+
+  std::vector<ir::Tensor> CreateSpecificStrategy(const std::vector<ir::Tensor> &inputs,
+                                                 poly::StageMap *stages) override;
+};
+#endif
+
 }  // namespace tests
 }  // namespace cinn